@@ -0,0 +1,94 @@
+// Сравнение пропускной способности: один поток io_context с асинхронным пулом соединений
+// против модели "поток на запрос" с синхронным UseCasesImpl.
+//
+// Использование: BOOKYPEDIA_DB_URL=... async_db_bench [queries] [in_flight] [pool_size]
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/app/async_use_cases_impl.h"
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/author.h"
+#include "../src/postgres/async_postgres.h"
+#include "../src/postgres/postgres.h"
+
+using namespace std::literals;
+namespace net = boost::asio;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double RunAsync(const std::string& url, int queries, int in_flight, int pool_size) {
+    net::io_context ioc;
+    postgres::AsyncDatabase db{ioc.get_executor(), url, static_cast<std::size_t>(pool_size)};
+    app::AsyncUseCasesImpl use_cases{db.GetUnitOfWorkFactory()};
+
+    int remaining = queries;
+    auto worker = [&]() -> net::awaitable<void> {
+        while (remaining > 0) {
+            --remaining;
+            co_await use_cases.GetAuthorById(domain::AuthorId::New());
+        }
+    };
+
+    const auto start = Clock::now();
+    for (int i = 0; i < in_flight; ++i) {
+        net::co_spawn(ioc, worker(), net::detached);
+    }
+    ioc.run();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double RunThreads(const std::string& url, int queries, int threads) {
+    std::vector<std::thread> workers;
+    const auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&url, per_thread = queries / threads] {
+            postgres::Database db{url};
+            app::UseCasesImpl use_cases{db.GetUnitOfWorkFactoryFactory()};
+            for (int i = 0; i < per_thread; ++i) {
+                use_cases.GetAuthorById(domain::AuthorId::New());
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const char* url = std::getenv("BOOKYPEDIA_DB_URL");
+    if (url == nullptr) {
+        std::cerr << "BOOKYPEDIA_DB_URL environment variable not found"sv << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int queries = argc > 1 ? std::stoi(argv[1]) : 20000;
+    const int in_flight = argc > 2 ? std::stoi(argv[2]) : 256;
+    const int pool_size = argc > 3 ? std::stoi(argv[3]) : 16;
+
+    try {
+        const double async_seconds = RunAsync(url, queries, in_flight, pool_size);
+        std::cout << "async: 1 thread, "sv << in_flight << " in flight, "sv << pool_size << " connections: "sv
+                  << queries / async_seconds << " queries/s"sv << std::endl;
+
+        for (int threads : {1, pool_size, in_flight}) {
+            const double seconds = RunThreads(url, queries, threads);
+            std::cout << "sync: "sv << threads << " threads: "sv << queries / seconds << " queries/s"sv << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
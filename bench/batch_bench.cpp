@@ -0,0 +1,102 @@
+// Сравнение интерактивного пути (Menu + View, транзакция на каждую команду)
+// с пакетным режимом (одна транзакция или порции по chunk_size команд).
+// Оба прогона добавляют авторов и книги, а затем правят книги.
+//
+// Использование: BOOKYPEDIA_DB_URL=... batch_bench [edits] [chunk_size]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/batch/batch.h"
+#include "../src/menu/menu.h"
+#include "../src/postgres/postgres.h"
+#include "../src/ui/view.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Каждая тройка команд: автор, его книга и правка этой книги
+std::string MakeInteractiveScript(const std::string& prefix, int edits) {
+    std::ostringstream script;
+    for (int i = 0; i < edits / 3; ++i) {
+        const std::string author = prefix + " author "s + std::to_string(i);
+        const std::string title = prefix + " book "s + std::to_string(i);
+        script << "AddAuthor "sv << author << '\n';
+        // Имя автора и пустая строка тегов в ответ на вопросы View
+        script << "AddBook 2000 "sv << title << '\n' << author << "\n\n"sv;
+        // Новое название, год и теги в ответ на вопросы EditBook
+        script << "EditBook "sv << title << "\n\n2001\nedited\n"sv;
+    }
+    script << "Exit\n"sv;
+    return script.str();
+}
+
+std::string MakeBatchScript(const std::string& prefix, int edits) {
+    std::ostringstream script;
+    for (int i = 0; i < edits / 3; ++i) {
+        const std::string author = prefix + " author "s + std::to_string(i);
+        const std::string title = prefix + " book "s + std::to_string(i);
+        script << "AddAuthor "sv << author << '\n';
+        script << "AddBook 2000 "sv << title << " | "sv << author << '\n';
+        script << "EditBook "sv << title << " | year=2001 | tags=edited\n"sv;
+    }
+    return script.str();
+}
+
+double RunInteractive(postgres::Database& db, const std::string& script) {
+    app::UseCasesImpl use_cases{db.GetUnitOfWorkFactoryFactory()};
+    std::istringstream input{script};
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    menu.AddAction("Exit"s, {}, "Exit program"s, [](std::string_view) {
+        return false;
+    });
+    ui::View view{menu, use_cases, input, output};
+
+    const auto start = Clock::now();
+    menu.Run();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double RunBatch(postgres::Database& db, const std::string& script, std::size_t chunk_size) {
+    std::istringstream input{script};
+    std::ostringstream output;
+
+    const auto start = Clock::now();
+    const std::vector<batch::Command> commands = batch::ParseCommands(input);
+    const batch::BatchResult result
+        = batch::BatchRunner{db.GetUnitOfWorkFactoryFactory(), chunk_size}.Run(commands, output);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (result.failed) {
+        std::cerr << output.str();
+    }
+    return seconds;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const char* url = std::getenv("BOOKYPEDIA_DB_URL");
+    if (!url) {
+        std::cerr << "BOOKYPEDIA_DB_URL is not set"sv << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int edits = argc > 1 ? std::stoi(argv[1]) : 100'000;
+    const std::size_t chunk_size = argc > 2 ? std::stoul(argv[2]) : 0;
+    const std::string prefix = "bench "s + std::to_string(Clock::now().time_since_epoch().count());
+
+    postgres::Database db{url};
+    const double interactive = RunInteractive(db, MakeInteractiveScript(prefix + " i"s, edits));
+    const double batch = RunBatch(db, MakeBatchScript(prefix + " b"s, edits), chunk_size);
+
+    std::cout << "interactive: "sv << edits / interactive << " commands/s ("sv << interactive << " s)\n"sv;
+    std::cout << "batch (chunk "sv << chunk_size << "): "sv << edits / batch << " commands/s ("sv << batch << " s)"sv
+              << std::endl;
+}
@@ -0,0 +1,121 @@
+// Печать списка из N книг, прочитанного из PostgreSQL, прямо из буфера pqxx::result
+// через postgres::ResultBookRows, как это делает ShowBooks. Запрос выполняется один раз,
+// замеряется только вывод в /dev/null.
+//
+// Использование: BOOKYPEDIA_DB_URL=... book_print_bench [books] [authors]
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <pqxx/pqxx>
+#include <string>
+
+#include "../src/domain/book_rows.h"
+#include "../src/postgres/result_rows.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::size_t allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (void* ptr = std::malloc(size)) {
+        ++allocations;
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Тот же набор столбцов, что и в BookRepository::GetAllBooks
+constexpr auto kSelectBooks = R"(
+    SELECT
+        bench_books.id AS book_id,
+        author_id,
+        bench_authors.name AS name,
+        title,
+        publication_year
+    FROM bench_books
+    INNER JOIN bench_authors ON bench_authors.id = author_id
+    ORDER BY title, name, publication_year;
+)";
+
+void Fill(pqxx::connection& connection, int books, int authors) {
+    pqxx::work work{connection};
+    work.exec("CREATE TEMP TABLE bench_authors (id UUID PRIMARY KEY, name varchar(100) NOT NULL);");
+    work.exec("CREATE TEMP TABLE bench_books (id UUID PRIMARY KEY, author_id UUID NOT NULL, "
+              "title varchar(100) NOT NULL, publication_year integer);");
+    work.exec_params(
+        "INSERT INTO bench_authors SELECT gen_random_uuid(), 'Author with a reasonably long name #' || i "
+        "FROM generate_series(1, $1) AS i;",
+        authors
+    );
+    work.exec_params(
+        "INSERT INTO bench_books SELECT gen_random_uuid(), a.id, 'Collected stories, volume ' || i, 1900 + i % 120 "
+        "FROM generate_series(1, $1) AS i "
+        "JOIN (SELECT id, row_number() OVER () - 1 AS n FROM bench_authors) AS a ON a.n = i % $2;",
+        books, authors
+    );
+    work.commit();
+}
+
+template <typename Fn>
+void Measure(std::string_view name, std::ostream& out, Fn&& print) {
+    const std::size_t allocations_before = allocations;
+    const auto start = Clock::now();
+    print(out);
+    out.flush();
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << name << ": "sv << ms << " ms, "sv << allocations - allocations_before << " allocations"sv << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const char* url = std::getenv("BOOKYPEDIA_DB_URL");
+    if (!url) {
+        std::cerr << "BOOKYPEDIA_DB_URL is not set"sv << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int books = argc > 1 ? std::stoi(argv[1]) : 1'000'000;
+    const int authors = argc > 2 ? std::stoi(argv[2]) : 10'000;
+
+    pqxx::connection connection{url};
+    Fill(connection, books, authors);
+
+    pqxx::result result;
+    {
+        pqxx::work work{connection};
+        result = work.exec(kSelectBooks);
+        work.commit();
+    }
+    std::cout << "fetched "sv << result.size() << " books"sv << std::endl;
+
+    std::ofstream out{"/dev/null"};
+
+    Measure("postgres::ResultBookRows"sv, out, [&](std::ostream& out) {
+        const domain::BookRows rows{std::make_unique<postgres::ResultBookRows>(result)};
+        int i = 1;
+        for (const domain::BookRow book : rows) {
+            out << i++ << ' ' << book.GetTitle() << " by "sv << book.GetAuthorName() << ", "sv
+                << book.GetPublicationYear() << '\n';
+        }
+    });
+}
@@ -0,0 +1,139 @@
+// Масштабирование чтения по ядрам при одновременной записи: чтение из снимка каталога
+// (app::CatalogUseCases) против того же каталога под std::shared_mutex.
+// Читатели ищут автора по имени и обходят его книги, один писатель раз в write_period_us
+// меняет год книги. Хранилище — репозитории в памяти из тестов, база данных не нужна.
+//
+// Использование: catalog_bench [authors] [books_per_author] [write_period_us]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/app/catalog_use_cases.h"
+#include "../src/app/use_cases_impl.h"
+#include "../tests/mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kDuration = std::chrono::seconds{1};
+
+struct Setup {
+    std::vector<std::string> names;
+    domain::BookId edited_book;
+};
+
+Setup Fill(app::UseCases& use_cases, int authors, int books_per_author) {
+    Setup setup;
+    for (int i = 0; i < authors; ++i) {
+        setup.names.push_back("Author #"s + std::to_string(i));
+        use_cases.AddAuthor(setup.names.back());
+        const domain::AuthorId id = use_cases.GetAuthorByName(setup.names.back())->GetId();
+        for (int j = 0; j < books_per_author; ++j) {
+            use_cases.AddBookByAuthorId(id, "Book #"s + std::to_string(j), 1900 + j, {});
+        }
+    }
+    setup.edited_book = use_cases.GetAllBooks()[0].GetId();
+    return setup;
+}
+
+// Чтение, которое выполняют потоки: поиск автора и обход его книг
+std::uint64_t ReadOnce(const app::UseCases& use_cases, const std::string& name) {
+    std::uint64_t sum = 0;
+    if (const std::optional<domain::Author> author = use_cases.GetAuthorByName(name)) {
+        for (const domain::BookRow book : use_cases.GetBooksByAuthorId(author->GetId())) {
+            sum += static_cast<std::uint64_t>(book.GetPublicationYear());
+        }
+    }
+    return sum;
+}
+
+// Число чтений в секунду для readers потоков; read и write выполняются с нужной синхронизацией
+template <typename Read, typename Write>
+double Run(unsigned readers, std::chrono::microseconds write_period, const Setup& setup, Read read, Write write) {
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> total_reads{0};
+    std::atomic<std::uint64_t> checksum{0};
+
+    std::thread writer{[&] {
+        int year = 2000;
+        while (!stop.load(std::memory_order_relaxed)) {
+            write(setup.edited_book, year++ % 2 == 0 ? 2000 : 2001);
+            std::this_thread::sleep_for(write_period);
+        }
+    }};
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 random{t};
+            std::uniform_int_distribution<std::size_t> pick{0, setup.names.size() - 1};
+            std::uint64_t reads = 0;
+            std::uint64_t sum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sum += read(setup.names[pick(random)]);
+                ++reads;
+            }
+            total_reads += reads;
+            checksum += sum;
+        });
+    }
+
+    std::this_thread::sleep_for(kDuration);
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    writer.join();
+    return static_cast<double>(total_reads) / std::chrono::duration<double>(kDuration).count();
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const int authors = argc > 1 ? std::stoi(argv[1]) : 1'000;
+    const int books_per_author = argc > 2 ? std::stoi(argv[2]) : 10;
+    const std::chrono::microseconds write_period{argc > 3 ? std::stoll(argv[3]) : 1'000};
+
+    mock::Storage storage;
+    storage.Reserve(static_cast<std::size_t>(authors) * books_per_author + 1);
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    const Setup setup = Fill(use_cases, authors, books_per_author);
+    app::CatalogUseCases catalog{use_cases};
+    std::shared_mutex mutex;
+
+    const unsigned max_readers = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "readers  shared_mutex reads/s  snapshot reads/s"sv << std::endl;
+    for (unsigned readers = 1; readers <= max_readers; readers *= 2) {
+        const double locked = Run(readers, write_period, setup,
+            [&](const std::string& name) {
+                std::shared_lock lock{mutex};
+                return ReadOnce(catalog, name);
+            },
+            [&](const domain::BookId& id, int year) {
+                std::unique_lock lock{mutex};
+                catalog.EditBook(id, "Book #0"sv, year, {});
+            });
+        const double snapshot = Run(readers, write_period, setup,
+            [&](const std::string& name) {
+                return ReadOnce(catalog, name);
+            },
+            [&](const domain::BookId& id, int year) {
+                catalog.EditBook(id, "Book #0"sv, year, {});
+            });
+        std::cout << readers << "        "sv << static_cast<std::uint64_t>(locked) << "              "sv
+                  << static_cast<std::uint64_t>(snapshot) << std::endl;
+    }
+}
@@ -0,0 +1,112 @@
+// Арена команды (std::pmr::monotonic_buffer_resource во View) против глобального аллокатора
+// для команд AddBook и ShowBooks при нескольких потоках. Каждый поток — отдельная сессия
+// со своими Menu, View и хранилищем в памяти из тестов, база данных не нужна,
+// поэтому замер показывает именно стоимость аллокаций на пути команды.
+//
+// Использование: command_arena_bench [commands_per_thread] [books_to_show]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "../tests/mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int ch) override {
+        return ch;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+// Имя автора уже есть в хранилище, теги длиннее буфера SSO
+std::string MakeAddBookScript(int commands) {
+    std::ostringstream script;
+    for (int i = 0; i < commands; ++i) {
+        script << "AddBook "sv << 1900 + i % 100 << " Book number "sv << i << "\nJack London\n"sv
+               << "adventure stories, classic literature, northern wilderness\n"sv;
+    }
+    return script.str();
+}
+
+std::string MakeShowBooksScript(int commands) {
+    std::string script;
+    for (int i = 0; i < commands; ++i) {
+        script += "ShowBooks\n"sv;
+    }
+    return script;
+}
+
+void RunSession(const std::string& script, int books, bool use_arena) {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    use_cases.AddAuthor("Jack London"s);
+    const domain::AuthorId author_id = use_cases.GetAuthorByName("Jack London"sv)->GetId();
+    for (int i = 0; i < books; ++i) {
+        use_cases.AddBookByAuthorId(author_id, "Shown book "s + std::to_string(i), 1900 + i % 100, {});
+    }
+
+    std::istringstream input{script};
+    NullBuffer null_buffer;
+    std::ostream output{&null_buffer};
+    menu::Menu menu{input, output};
+    ui::View view{menu, use_cases, input, output, use_arena};
+    menu.Run();
+}
+
+// Команд в секунду суммарно по всем потокам
+double Run(unsigned threads, const std::string& script, int commands, int books, bool use_arena) {
+    const auto start = Clock::now();
+    std::vector<std::thread> sessions;
+    for (unsigned t = 0; t < threads; ++t) {
+        sessions.emplace_back([&] {
+            RunSession(script, books, use_arena);
+        });
+    }
+    for (std::thread& session : sessions) {
+        session.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(commands) * threads / seconds;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const int commands = argc > 1 ? std::stoi(argv[1]) : 20'000;
+    const int books = argc > 2 ? std::stoi(argv[2]) : 50;
+    const std::string add_book = MakeAddBookScript(commands);
+    const std::string show_books = MakeShowBooksScript(commands);
+
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "threads  command    global cmd/s  arena cmd/s"sv << std::endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        for (const auto& [name, script, shown] : {std::tuple{"AddBook  "sv, &add_book, 0},
+                                                  std::tuple{"ShowBooks"sv, &show_books, books}}) {
+            const double global = Run(threads, *script, commands, shown, false);
+            const double arena = Run(threads, *script, commands, shown, true);
+            std::cout << threads << "        "sv << name << "  "sv << static_cast<std::uint64_t>(global) << "        "sv
+                      << static_cast<std::uint64_t>(arena) << std::endl;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// Нагрузочный тест bookypedia-server: keep-alive клиенты шлют запросы в течение заданного времени,
+// для 1, 8 и 64 одновременных клиентов выводятся запросы/с и задержки.
+//
+// Использование: http_load_test [host] [port] [target] [seconds]
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/metrics/metrics.h"
+
+using namespace std::literals;
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadResult {
+    metrics::Histogram latency_ns;
+    std::uint64_t errors = 0;
+};
+
+void RunClient(const std::string& host, const std::string& port, const std::string& target,
+               Clock::time_point deadline, LoadResult& result) {
+    net::io_context ioc;
+    tcp::resolver resolver{ioc};
+    beast::tcp_stream stream{ioc};
+    stream.connect(resolver.resolve(host, port));
+
+    http::request<http::string_body> request{http::verb::get, target, 11};
+    request.set(http::field::host, host);
+    request.keep_alive(true);
+
+    beast::flat_buffer buffer;
+    while (Clock::now() < deadline) {
+        const auto start = Clock::now();
+        http::write(stream, request);
+        http::response<http::string_body> response;
+        http::read(stream, buffer, response);
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        result.latency_ns.Record(static_cast<std::uint64_t>(duration.count()));
+        if (response.result() != http::status::ok) {
+            ++result.errors;
+        }
+    }
+    beast::error_code ec;
+    stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const std::string host = argc > 1 ? argv[1] : "127.0.0.1"s;
+    const std::string port = argc > 2 ? argv[2] : "8080"s;
+    const std::string target = argc > 3 ? argv[3] : "/api/v1/authors"s;
+    const int seconds = argc > 4 ? std::stoi(argv[4]) : 10;
+
+    std::cout << std::left << std::setw(10) << "Clients"sv << std::setw(14) << "Requests/s"sv
+              << std::setw(12) << "p50 ms"sv << std::setw(12) << "p99 ms"sv << std::setw(12) << "max ms"sv
+              << "Errors"sv << std::endl;
+    for (int clients : {1, 8, 64}) {
+        std::vector<LoadResult> results(clients);
+        std::vector<std::thread> threads;
+        const auto start = Clock::now();
+        const auto deadline = start + std::chrono::seconds{seconds};
+        for (int i = 0; i < clients; ++i) {
+            threads.emplace_back([&, i] {
+                try {
+                    RunClient(host, port, target, deadline, results[i]);
+                } catch (const std::exception& e) {
+                    ++results[i].errors;
+                    std::cerr << e.what() << std::endl;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        LoadResult total;
+        for (const LoadResult& result : results) {
+            total.latency_ns.Merge(result.latency_ns);
+            total.errors += result.errors;
+        }
+        std::cout << std::setw(10) << clients
+                  << std::setw(14) << static_cast<double>(total.latency_ns.total_count) / elapsed
+                  << std::setw(12) << static_cast<double>(total.latency_ns.ValueAtQuantile(0.5)) / 1e6
+                  << std::setw(12) << static_cast<double>(total.latency_ns.ValueAtQuantile(0.99)) / 1e6
+                  << std::setw(12) << static_cast<double>(total.latency_ns.max) / 1e6
+                  << total.errors << std::endl;
+    }
+}
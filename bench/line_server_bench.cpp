@@ -0,0 +1,92 @@
+// Нагрузочный тест TCP-режима (bookypedia --listen <port>): сотни одновременных сессий
+// выполняют один и тот же сценарий команд. Часть сессий "зависает" в интерактивном
+// выборе автора, чтобы проверить, что они не мешают остальным.
+//
+// Использование: line_server_bench [host] [port] [sessions] [stalled_sessions]
+
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/metrics/metrics.h"
+
+using namespace std::literals;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::string_view kScript =
+    "ShowAuthors\n"
+    "ShowBooks\n"
+    "ShowBook Nonexistent title\n"
+    "Help\n"
+    "Exit\n";
+
+std::uint64_t RunScriptedSession(const std::string& host, const std::string& port) {
+    const auto start = Clock::now();
+    tcp::iostream stream{host, port};
+    stream << kScript << std::flush;
+    std::string line;
+    while (std::getline(stream, line)) {
+    }
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+void RunStalledSession(const std::string& host, const std::string& port, std::chrono::seconds stall) {
+    tcp::iostream stream{host, port};
+    // Сервер спрашивает начало имени автора и ждёт ответа, который клиент не торопится отправлять;
+    // затем пустые строки выводят первых авторов и отменяют выбор
+    stream << "ShowAuthorBooks\n"sv << std::flush;
+    std::this_thread::sleep_for(stall);
+    stream << "\n\nExit\n"sv << std::flush;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const std::string host = argc > 1 ? argv[1] : "127.0.0.1"s;
+    const std::string port = argc > 2 ? argv[2] : "9090"s;
+    const int sessions = argc > 3 ? std::stoi(argv[3]) : 200;
+    const int stalled_sessions = argc > 4 ? std::stoi(argv[4]) : 20;
+
+    std::vector<std::thread> stalled;
+    for (int i = 0; i < stalled_sessions; ++i) {
+        stalled.emplace_back([&] { RunStalledSession(host, port, 30s); });
+    }
+
+    std::vector<metrics::Histogram> latencies(sessions);
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for (int i = 0; i < sessions; ++i) {
+        threads.emplace_back([&, i] {
+            try {
+                latencies[i].Record(RunScriptedSession(host, port));
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    metrics::Histogram total;
+    for (const metrics::Histogram& latency : latencies) {
+        total.Merge(latency);
+    }
+    std::cout << sessions << " scripted sessions ("sv << stalled_sessions << " stalled) in "sv << elapsed << " s: "sv
+              << static_cast<double>(total.total_count) / elapsed << " sessions/s, p50 "sv
+              << static_cast<double>(total.ValueAtQuantile(0.5)) / 1e6 << " ms, p99 "sv
+              << static_cast<double>(total.ValueAtQuantile(0.99)) / 1e6 << " ms"sv << std::endl;
+
+    for (std::thread& thread : stalled) {
+        thread.join();
+    }
+}
@@ -0,0 +1,82 @@
+// Масштабирование чтения по репликам: одинаковая нагрузка из потоков-клиентов
+// при 0, 1, ..., N репликах. С --mixed каждый десятый запрос — запись с read-your-writes.
+//
+// Использование: BOOKYPEDIA_DB_URL=... BOOKYPEDIA_DB_REPLICA_URLS="url1;url2" \
+//     replica_bench [threads] [queries] [round-robin|least-loaded] [--mixed]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/author.h"
+#include "../src/postgres/postgres.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Run(const std::string& url, const postgres::ReplicaConfig& replicas, int threads, int queries, bool mixed) {
+    postgres::Database db{url, static_cast<std::size_t>(threads), {}, replicas};
+    app::UseCasesImpl use_cases{db.GetUnitOfWorkFactoryFactory()};
+
+    std::atomic<int> remaining{queries};
+    std::vector<std::thread> workers;
+    const auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; remaining.fetch_sub(1, std::memory_order_relaxed) > 0; ++i) {
+                if (mixed && i % 10 == 0) {
+                    use_cases.AddAuthor("replica_bench "s + std::to_string(t) + "-"s + std::to_string(i)
+                                        + "-"s + std::to_string(Clock::now().time_since_epoch().count()));
+                } else {
+                    use_cases.GetAllAuthors();
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const char* url = std::getenv("BOOKYPEDIA_DB_URL");
+    if (url == nullptr) {
+        std::cerr << "BOOKYPEDIA_DB_URL environment variable not found"sv << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<std::string> replica_urls;
+    if (const char* urls = std::getenv("BOOKYPEDIA_DB_REPLICA_URLS")) {
+        replica_urls = postgres::ParseUrlList(urls);
+    }
+    const int threads = argc > 1 ? std::stoi(argv[1]) : 16;
+    const int queries = argc > 2 ? std::stoi(argv[2]) : 20000;
+    const postgres::ReplicaRouting routing = argc > 3 ? postgres::ParseReplicaRouting(argv[3])
+                                                      : postgres::ReplicaRouting::kRoundRobin;
+    const bool mixed = argc > 4 && argv[4] == "--mixed"sv;
+
+    try {
+        for (std::size_t count = 0; count <= replica_urls.size(); ++count) {
+            postgres::ReplicaConfig replicas;
+            replicas.urls.assign(replica_urls.begin(), replica_urls.begin() + count);
+            replicas.routing = routing;
+            const double seconds = Run(url, replicas, threads, queries, mixed);
+            std::cout << count << " replicas, "sv << threads << " threads: "sv
+                      << queries / seconds << " queries/s"sv << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+// Статистика каталога: чтение поддерживаемых триггерами счётчиков (GetStatistics)
+// против подсчёта тех же топов по books и book_tags при каждом запросе.
+// Заполняет базу синтетическим каталогом, если в ней меньше books книг; запускать на отдельной базе.
+//
+// Использование: BOOKYPEDIA_DB_URL=... statistics_bench [books] [queries]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <pqxx/pqxx>
+#include <string>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/statistics.h"
+#include "../src/postgres/postgres.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kAuthors = 100'000;
+constexpr int kTags = 1000;
+constexpr int kBooksPerStatement = 100'000;
+
+// Книги вставляются пачками с двумя тегами каждая: счётчики обновляются триггерами
+void Fill(pqxx::connection& connection, long long books) {
+    pqxx::work work{connection};
+    const long long existing = work.query_value<long long>("SELECT count(*) FROM books;");
+    if (existing >= books) {
+        return;
+    }
+    work.exec("INSERT INTO authors (id, name) SELECT gen_random_uuid(), 'statistics_bench ' || i "
+              "FROM generate_series(1, " + std::to_string(kAuthors) + ") AS i ON CONFLICT DO NOTHING;");
+    work.commit();
+
+    const auto start = Clock::now();
+    for (long long done = existing; done < books; done += kBooksPerStatement) {
+        pqxx::work batch{connection};
+        batch.exec(
+            "WITH ids AS (SELECT array_agg(id) AS ids FROM authors WHERE deleted_at IS NULL), "
+            "inserted AS ("
+            "  INSERT INTO books (id, author_id, title, publication_year) "
+            "  SELECT gen_random_uuid(), ids[1 + floor(random() * array_length(ids, 1))::int], 'Book ' || i, "
+            "         1800 + (i % 225)::int "
+            "  FROM generate_series(1, " + std::to_string(kBooksPerStatement) + ") AS i, ids "
+            "  RETURNING id) "
+            "INSERT INTO book_tags (book_id, tag) "
+            "SELECT id, 'tag ' || floor(random() * " + std::to_string(kTags) + ")::int FROM inserted, generate_series(1, 2);"
+        );
+        batch.commit();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Filled "sv << books - existing << " books in "sv << seconds << " s"sv << std::endl;
+}
+
+template <typename Fn>
+double AverageMillis(int queries, Fn&& fn) {
+    const auto start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / queries;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const char* url = std::getenv("BOOKYPEDIA_DB_URL");
+    if (url == nullptr) {
+        std::cerr << "BOOKYPEDIA_DB_URL environment variable not found"sv << std::endl;
+        return EXIT_FAILURE;
+    }
+    const long long books = argc > 1 ? std::stoll(argv[1]) : 10'000'000;
+    const int queries = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    postgres::Database db{url};
+    app::UseCasesImpl use_cases{db.GetUnitOfWorkFactoryFactory()};
+    pqxx::connection connection{url};
+    Fill(connection, books);
+
+    const double counters = AverageMillis(queries, [&use_cases] {
+        use_cases.GetStatistics(10);
+    });
+    const double on_demand = AverageMillis(std::max(1, queries / 10), [&connection] {
+        pqxx::work work{connection};
+        work.exec("SELECT author_id, count(*) AS books FROM books GROUP BY author_id ORDER BY books DESC LIMIT 10;");
+        work.exec("SELECT tag, count(*) AS books FROM book_tags GROUP BY tag ORDER BY books DESC LIMIT 10;");
+        work.exec("SELECT publication_year, count(*) FROM books GROUP BY publication_year ORDER BY publication_year;");
+        work.commit();
+    });
+    std::cout << "GetStatistics: "sv << counters << " ms, counting on demand: "sv << on_demand << " ms"sv << std::endl;
+}
@@ -0,0 +1,134 @@
+// Автодополнение тегов по app::TagIndex: время построения, память и задержка Complete
+// для коротких и длинных префиксов, а также стоимость Add. База данных не нужна:
+// теги генерируются из случайных слогов, число книг распределено по закону Ципфа.
+//
+// Использование: tag_index_bench [tags] [queries]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/app/tag_index.h"
+#include "../src/domain/statistics.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::size_t live_bytes = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (void* ptr = std::malloc(size)) {
+        live_bytes += malloc_usable_size(ptr);
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        live_bytes -= malloc_usable_size(ptr);
+        std::free(ptr);
+    }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kLimit = 10;
+
+std::string RandomTag(std::mt19937& random) {
+    static constexpr std::string_view kSyllables[] = {
+        "ad"sv, "ven"sv, "ture"sv, "clas"sv, "sic"sv, "sea"sv, "sci"sv, "ence"sv, "fic"sv, "tion"sv,
+        "his"sv, "to"sv, "ry"sv, "po"sv, "em"sv, "dra"sv, "ma"sv, "no"sv, "vel"sv, "war"sv
+    };
+    std::string tag;
+    const int syllables = std::uniform_int_distribution<int>{2, 6}(random);
+    for (int i = 0; i < syllables; ++i) {
+        tag += kSyllables[std::uniform_int_distribution<std::size_t>{0, std::size(kSyllables) - 1}(random)];
+    }
+    tag += std::to_string(random() % 1000);
+    return tag;
+}
+
+template <typename Fn>
+void MeasureQueries(std::string_view name, const std::vector<std::string>& prefixes, Fn&& complete) {
+    std::vector<double> latencies;
+    latencies.reserve(prefixes.size());
+    std::size_t found = 0;
+    for (const std::string& prefix : prefixes) {
+        const auto start = Clock::now();
+        found += complete(prefix).size();
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << name << ": p50 "sv << latencies[latencies.size() / 2] << " us, p99 "sv
+              << latencies[latencies.size() * 99 / 100] << " us, max "sv << latencies.back() << " us, "sv
+              << static_cast<double>(found) / static_cast<double>(prefixes.size()) << " tags per query"sv << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const std::size_t tag_count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    const std::size_t queries = argc > 2 ? std::stoul(argv[2]) : 100'000;
+
+    std::mt19937 random{1};
+    std::vector<domain::TagBookCount> tags;
+    tags.reserve(tag_count);
+    for (std::size_t i = 0; i < tag_count; ++i) {
+        tags.push_back({RandomTag(random), static_cast<std::int64_t>(1'000'000 / (i + 1) + 1)});
+    }
+    std::vector<std::string> names;
+    names.reserve(tags.size());
+    for (const domain::TagBookCount& tag : tags) {
+        names.push_back(tag.tag);
+    }
+
+    const std::size_t bytes_before = live_bytes;
+    const auto build_start = Clock::now();
+    // Копия входа освобождается внутри замера, поэтому прирост памяти — это сам индекс
+    app::TagIndex index{tags};
+    const double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+    std::cout << index.Size() << " tags: built in "sv << build_ms << " ms, "sv
+              << static_cast<double>(live_bytes - bytes_before) / (1024 * 1024) << " MiB retained, MemoryUsage "sv
+              << static_cast<double>(index.MemoryUsage()) / (1024 * 1024) << " MiB"sv << std::endl;
+
+    // Префиксы существующих тегов длиной 1, 3 и 6: от миллиона кандидатов до единиц
+    for (const std::size_t length : {1u, 3u, 6u}) {
+        std::vector<std::string> prefixes;
+        prefixes.reserve(queries);
+        for (std::size_t i = 0; i < queries; ++i) {
+            prefixes.push_back(names[random() % names.size()].substr(0, length));
+        }
+        MeasureQueries("Complete, prefix of "s + std::to_string(length), prefixes, [&index](const std::string& prefix) {
+            return index.Complete(prefix, kLimit);
+        });
+    }
+
+    const auto add_start = Clock::now();
+    for (std::size_t i = 0; i < queries; ++i) {
+        // Каждое десятое изменение — новый тег, остальные меняют счётчик известного
+        if (i % 10 == 0) {
+            index.Add(RandomTag(random) + "-new"s, 1);
+        } else {
+            index.Add(names[random() % names.size()], 1);
+        }
+    }
+    const double add_us = std::chrono::duration<double, std::micro>(Clock::now() - add_start).count();
+    std::cout << "Add: "sv << add_us / static_cast<double>(queries) << " us per update"sv << std::endl;
+}
@@ -0,0 +1,200 @@
+// Нечёткий поиск по app::TrigramIndex: время построения, память и задержка Find для точных
+// и искажённых названий, а также стоимость Set и Erase. База данных не нужна: названия
+// собираются из случайных слов, а слова — из слогов.
+//
+// Использование: trigram_index_bench [titles] [queries]
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/app/trigram_index.h"
+#include "../src/domain/book.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::size_t live_bytes = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (void* ptr = std::malloc(size)) {
+        live_bytes += malloc_usable_size(ptr);
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        live_bytes -= malloc_usable_size(ptr);
+        std::free(ptr);
+    }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kLimit = 10;
+// Слов в словаре: первые из них повторяются во многих названиях, как "The" или "War"
+constexpr std::size_t kWords = 50'000;
+
+std::string RandomWord(std::mt19937& random) {
+    // Слоги из начала, гласной и конца дают несколько тысяч различных триграмм, как в живых текстах
+    static constexpr std::string_view kOnsets[] = {
+        ""sv, "b"sv, "br"sv, "c"sv, "ch"sv, "d"sv, "dr"sv, "f"sv, "g"sv, "gr"sv, "h"sv, "k"sv,
+        "l"sv, "m"sv, "n"sv, "p"sv, "r"sv, "s"sv, "sh"sv, "st"sv, "t"sv, "th"sv, "tr"sv, "v"sv, "w"sv
+    };
+    static constexpr std::string_view kVowels[] = {"a"sv, "e"sv, "i"sv, "o"sv, "u"sv, "ea"sv, "ou"sv, "y"sv};
+    static constexpr std::string_view kCodas[] = {
+        ""sv, ""sv, ""sv, "n"sv, "r"sv, "s"sv, "t"sv, "l"sv, "nd"sv, "ng"sv, "st"sv, "ck"sv
+    };
+    const auto pick = [&random](const auto& parts) {
+        return parts[std::uniform_int_distribution<std::size_t>{0, std::size(parts) - 1}(random)];
+    };
+    std::string word;
+    const int syllables = std::uniform_int_distribution<int>{1, 3}(random);
+    for (int i = 0; i < syllables; ++i) {
+        word += pick(kOnsets);
+        word += pick(kVowels);
+        word += pick(kCodas);
+    }
+    word[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+    return word;
+}
+
+std::string RandomTitle(std::mt19937& random, const std::vector<std::string>& words) {
+    // Частота слова убывает с его номером: квадрат равномерной величины сдвигает выбор к началу
+    std::uniform_real_distribution<double> uniform{0, 1};
+    std::string title;
+    const int count = std::uniform_int_distribution<int>{2, 5}(random);
+    for (int i = 0; i < count; ++i) {
+        const double u = uniform(random);
+        title += (i == 0 ? ""sv : " "sv);
+        title += words[static_cast<std::size_t>(u * u * static_cast<double>(words.size() - 1))];
+    }
+    return title;
+}
+
+// Опечатка: пропуск, замена или перестановка соседних букв
+std::string Misspell(std::mt19937& random, std::string text) {
+    const std::size_t pos = random() % (text.size() - 1);
+    switch (random() % 3) {
+    case 0:
+        text.erase(pos, 1);
+        break;
+    case 1:
+        text[pos] = static_cast<char>('a' + random() % 26);
+        break;
+    default:
+        std::swap(text[pos], text[pos + 1]);
+        break;
+    }
+    return text;
+}
+
+template <typename Fn>
+void MeasureQueries(std::string_view name, const std::vector<std::string>& texts, Fn&& find) {
+    std::vector<double> latencies;
+    latencies.reserve(texts.size());
+    std::size_t found = 0;
+    for (const std::string& text : texts) {
+        const auto start = Clock::now();
+        found += find(text).size();
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << name << ": p50 "sv << latencies[latencies.size() / 2] << " us, p99 "sv
+              << latencies[latencies.size() * 99 / 100] << " us, max "sv << latencies.back() << " us, "sv
+              << static_cast<double>(found) / static_cast<double>(texts.size()) << " matches per query"sv << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const std::size_t title_count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    const std::size_t queries = argc > 2 ? std::stoul(argv[2]) : 10'000;
+
+    std::mt19937 random{1};
+    std::vector<std::string> words;
+    words.reserve(kWords);
+    for (std::size_t i = 0; i < kWords; ++i) {
+        words.push_back(RandomWord(random));
+    }
+    // В среднем двадцать книг на автора
+    std::vector<domain::AuthorId> authors;
+    for (std::size_t i = 0; i < std::max<std::size_t>(title_count / 20, 1); ++i) {
+        authors.push_back(domain::AuthorId::New());
+    }
+    std::vector<domain::BookId> ids;
+    std::vector<std::string> titles;
+    ids.reserve(title_count);
+    titles.reserve(title_count);
+    for (std::size_t i = 0; i < title_count; ++i) {
+        ids.push_back(domain::BookId::New());
+        titles.push_back(RandomTitle(random, words));
+    }
+
+    const std::size_t bytes_before = live_bytes;
+    const auto build_start = Clock::now();
+    app::TrigramIndex index;
+    for (std::size_t i = 0; i < title_count; ++i) {
+        index.Set(ids[i], titles[i], authors[i % authors.size()], 1800 + static_cast<int>(i % 200));
+    }
+    index.ShrinkToFit();
+    const double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+    std::cout << index.Size() << " titles: built in "sv << build_ms << " ms, "sv
+              << static_cast<double>(live_bytes - bytes_before) / (1024 * 1024) << " MiB retained, MemoryUsage "sv
+              << static_cast<double>(index.MemoryUsage()) / (1024 * 1024) << " MiB"sv << std::endl;
+
+    std::vector<std::string> exact;
+    std::vector<std::string> misspelled;
+    exact.reserve(queries);
+    misspelled.reserve(queries);
+    for (std::size_t i = 0; i < queries; ++i) {
+        exact.push_back(titles[random() % titles.size()]);
+        misspelled.push_back(Misspell(random, exact.back()));
+    }
+    MeasureQueries("Find, exact title"sv, exact, [&index](const std::string& text) {
+        return index.Find(text, kLimit);
+    });
+    MeasureQueries("Find, one typo"sv, misspelled, [&index](const std::string& text) {
+        return index.Find(text, kLimit);
+    });
+
+    // Качество ранжирования: для какой доли опечаток исходное название оказывается первым
+    std::size_t first = 0;
+    for (std::size_t i = 0; i < queries; ++i) {
+        const std::vector<domain::FuzzyMatch> matches = index.Find(misspelled[i], 1);
+        first += !matches.empty() && matches.front().text == exact[i];
+    }
+    std::cout << "Original title ranked first for "sv << 100.0 * static_cast<double>(first) / static_cast<double>(queries)
+              << "% of typos"sv << std::endl;
+
+    const auto update_start = Clock::now();
+    for (std::size_t i = 0; i < queries; ++i) {
+        // Половина изменений переименовывает книгу, половина удаляет её
+        const std::size_t victim = random() % ids.size();
+        if (i % 2 == 0) {
+            index.Set(ids[victim], RandomTitle(random, words), authors[victim % authors.size()], 2000);
+        } else {
+            index.Erase(ids[victim]);
+        }
+    }
+    const double update_us = std::chrono::duration<double, std::micro>(Clock::now() - update_start).count();
+    std::cout << "Set/Erase: "sv << update_us / static_cast<double>(queries) << " us per update"sv << std::endl;
+}
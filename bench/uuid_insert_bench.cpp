@@ -0,0 +1,68 @@
+// Вставка строк с первичным ключом UUIDv4 и UUIDv7: пропускная способность
+// и размер btree-индекса первичного ключа после вставки.
+//
+// Использование: BOOKYPEDIA_DB_URL=... uuid_insert_bench [rows] [rows_per_transaction]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <pqxx/pqxx>
+#include <string>
+
+#include "../src/util/tagged_uuid.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RandomTag {};
+struct TimeOrderedTag {
+    static constexpr util::UUIDVersion kUUIDVersion = util::UUIDVersion::kTimeOrdered;
+};
+
+template <typename Id>
+void RunInserts(pqxx::connection& connection, const std::string& table, int rows, int rows_per_transaction) {
+    {
+        pqxx::work work{connection};
+        work.exec("DROP TABLE IF EXISTS " + table + ";");
+        work.exec("CREATE TABLE " + table + " (id UUID PRIMARY KEY, payload varchar(100) NOT NULL);");
+        work.commit();
+    }
+    const std::string insert = "INSERT INTO " + table + " VALUES ($1, $2);";
+
+    const auto start = Clock::now();
+    for (int done = 0; done < rows;) {
+        pqxx::work work{connection};
+        for (int i = 0; i < rows_per_transaction && done < rows; ++i, ++done) {
+            work.exec_params(insert, Id::New().ToString(), "payload"sv);
+        }
+        work.commit();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    pqxx::work work{connection};
+    const auto index_size = work.query_value<std::string>(
+        "SELECT pg_size_pretty(pg_relation_size('" + table + "_pkey'));");
+    work.exec("DROP TABLE " + table + ";");
+    work.commit();
+
+    std::cout << table << ": "sv << rows / seconds << " rows/s, primary key index "sv << index_size << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    const char* url = std::getenv("BOOKYPEDIA_DB_URL");
+    if (!url) {
+        std::cerr << "BOOKYPEDIA_DB_URL is not set"sv << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int rows = argc > 1 ? std::stoi(argv[1]) : 1'000'000;
+    const int rows_per_transaction = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+    pqxx::connection connection{url};
+    RunInserts<util::TaggedUUID<RandomTag>>(connection, "uuid_bench_v4"s, rows, rows_per_transaction);
+    RunInserts<util::TaggedUUID<TimeOrderedTag>>(connection, "uuid_bench_v7"s, rows, rows_per_transaction);
+}
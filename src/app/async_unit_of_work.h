@@ -0,0 +1,28 @@
+#pragma once
+
+#include <boost/asio/awaitable.hpp>
+#include <memory>
+
+#include "../domain/async_repositories.h"
+
+namespace app {
+
+class AsyncUnitOfWork {
+public:
+    virtual boost::asio::awaitable<void> Commit() = 0;
+    virtual domain::AsyncAuthorRepository& GetAuthorRepository() = 0;
+    virtual domain::AsyncBookRepository& GetBookRepository() = 0;
+    virtual domain::AsyncBookTagRepository& GetBookTagRepository() = 0;
+
+    virtual ~AsyncUnitOfWork() = default;
+};
+
+class AsyncUnitOfWorkFactory {
+public:
+    virtual boost::asio::awaitable<std::unique_ptr<AsyncUnitOfWork>> CreateUnitOfWork() = 0;
+
+protected:
+    ~AsyncUnitOfWorkFactory() = default;
+};
+
+}  // namespace app
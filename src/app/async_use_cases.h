@@ -0,0 +1,67 @@
+#pragma once
+
+#include <boost/asio/awaitable.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../domain/author_fwd.h"
+#include "../domain/book_fwd.h"
+
+namespace app {
+
+template <typename T>
+using awaitable = boost::asio::awaitable<T>;
+
+// Асинхронный аналог UseCases: каждый сценарий — корутина Boost.Asio
+class AsyncUseCases {
+public:
+    // // // --- AUTHOR --- // // //
+
+    virtual awaitable<void> AddAuthor(std::string name) = 0;
+    virtual awaitable<bool> EditAuthor(domain::AuthorId id, std::string new_name) = 0;
+    virtual awaitable<bool> DeleteAuthor(domain::AuthorId id) = 0;
+
+    virtual awaitable<std::optional<domain::Author>> GetAuthorByName(std::string name) = 0;
+    virtual awaitable<std::optional<domain::Author>> GetAuthorById(domain::AuthorId id) = 0;
+
+    virtual awaitable<std::vector<domain::Author>> GetAllAuthors() = 0;
+
+    // // // --- AUTHOR --- // // //
+    //
+    //
+    //
+    // // // --- BOOK --- // // //
+
+    virtual awaitable<void> AddBookByAuthorId(
+        domain::AuthorId author_id,
+        std::string title,
+        int publication_year,
+        std::vector<std::string> tags
+    ) = 0;
+    virtual awaitable<void> AddBookByAuthorName(
+        std::string author_name,
+        std::string title,
+        int publication_year,
+        std::vector<std::string> tags
+    ) = 0;
+    virtual awaitable<bool> EditBook(
+        domain::BookId id,
+        std::string title,
+        int publication_year,
+        std::vector<std::string> tags
+    ) = 0;
+    virtual awaitable<bool> DeleteBook(domain::BookId id) = 0;
+
+    virtual awaitable<std::optional<domain::Book>> GetBook(domain::BookId id) = 0;
+    virtual awaitable<std::vector<domain::Book>> GetBooksByTitle(std::string title) = 0;
+    virtual awaitable<std::vector<domain::Book>> GetAllBooks() = 0;
+    virtual awaitable<std::vector<domain::Book>> GetBooksByAuthorId(domain::AuthorId author_id) = 0;
+
+    // // // --- BOOK --- // // //
+
+protected:
+    ~AsyncUseCases() = default;
+};
+
+}  // namespace app
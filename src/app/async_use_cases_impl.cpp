@@ -0,0 +1,207 @@
+#include "async_use_cases_impl.h"
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "../metrics/metrics.h"
+
+namespace app {
+
+using namespace domain;
+using namespace std::literals;
+
+// Имя текущего use case не выставляется (is_use_case = false): корутины разных
+// сценариев чередуются в одном потоке, и thread_local-имя было бы неверным.
+
+// // // --- AUTHOR --- // // //
+
+awaitable<void> AsyncUseCasesImpl::AddAuthor(std::string name) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "AddAuthor"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    co_await uow_transaction->GetAuthorRepository().Save(Author{AuthorId::New(), std::move(name)});
+    co_await uow_transaction->Commit();
+}
+
+awaitable<bool> AsyncUseCasesImpl::EditAuthor(AuthorId id, std::string new_name) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "EditAuthor"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    const std::optional<Author> author = co_await uow_transaction->GetAuthorRepository().GetAuthorById(id);
+    if (author.has_value()) {
+        co_await uow_transaction->GetAuthorRepository().Edit(author->GetId(), std::move(new_name));
+    }
+    co_await uow_transaction->Commit();
+    co_return author.has_value();
+}
+
+awaitable<bool> AsyncUseCasesImpl::DeleteAuthor(AuthorId id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "DeleteAuthor"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    const std::optional<Author> author = co_await uow_transaction->GetAuthorRepository().GetAuthorById(id);
+    if (author.has_value()) {
+        // Как и в UseCasesImpl: книги и теги удалит PurgeWorker
+        co_await uow_transaction->GetAuthorRepository().MarkDeleted(author->GetId());
+    }
+    co_await uow_transaction->Commit();
+    co_return author.has_value();
+}
+
+awaitable<std::optional<Author>> AsyncUseCasesImpl::GetAuthorByName(std::string name) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetAuthorByName"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::optional<Author> author = co_await uow_transaction->GetAuthorRepository().GetAuthorByName(std::move(name));
+    co_await uow_transaction->Commit();
+    co_return author;
+}
+
+awaitable<std::optional<Author>> AsyncUseCasesImpl::GetAuthorById(AuthorId id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetAuthorById"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::optional<Author> author = co_await uow_transaction->GetAuthorRepository().GetAuthorById(id);
+    co_await uow_transaction->Commit();
+    co_return author;
+}
+
+awaitable<std::vector<Author>> AsyncUseCasesImpl::GetAllAuthors() {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetAllAuthors"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::vector<Author> authors = co_await uow_transaction->GetAuthorRepository().GetAllAuthors();
+    co_await uow_transaction->Commit();
+    call.SetRows(authors.size());
+    co_return authors;
+}
+
+// // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // //
+
+awaitable<void> AsyncUseCasesImpl::AddBookByAuthorId(
+    AuthorId author_id,
+    std::string title,
+    int publication_year,
+    std::vector<std::string> tags
+) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "AddBookByAuthorId"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    BookId book_id = BookId::New();
+    co_await uow_transaction->GetBookRepository().Save(Book{book_id, author_id, std::move(title), publication_year});
+    for (std::string& tag : tags) {
+        co_await uow_transaction->GetBookTagRepository().Save(BookTag{book_id, std::move(tag)});
+    }
+    co_await uow_transaction->Commit();
+}
+
+awaitable<void> AsyncUseCasesImpl::AddBookByAuthorName(
+    std::string author_name,
+    std::string title,
+    int publication_year,
+    std::vector<std::string> tags
+) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "AddBookByAuthorName"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    AuthorId author_id = AuthorId::New();
+    co_await uow_transaction->GetAuthorRepository().Save(Author{author_id, std::move(author_name)});
+
+    BookId book_id = BookId::New();
+    co_await uow_transaction->GetBookRepository().Save(Book{book_id, author_id, std::move(title), publication_year});
+
+    for (std::string& tag : tags) {
+        co_await uow_transaction->GetBookTagRepository().Save(BookTag{book_id, std::move(tag)});
+    }
+    co_await uow_transaction->Commit();
+}
+
+awaitable<bool> AsyncUseCasesImpl::EditBook(
+    BookId id,
+    std::string title,
+    int publication_year,
+    std::vector<std::string> tags
+) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "EditBook"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    const std::optional<Book> book = co_await uow_transaction->GetBookRepository().GetBookById(id);
+    if (book.has_value()) {
+        co_await uow_transaction->GetBookRepository().Edit(book->GetId(), std::move(title), publication_year);
+        co_await uow_transaction->GetBookTagRepository().DeleteByBookId(book->GetId());
+        for (std::string& tag : tags) {
+            co_await uow_transaction->GetBookTagRepository().Save(BookTag{book->GetId(), std::move(tag)});
+        }
+    }
+    co_await uow_transaction->Commit();
+    co_return book.has_value();
+}
+
+awaitable<bool> AsyncUseCasesImpl::DeleteBook(BookId id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "DeleteBook"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    const std::optional<Book> book = co_await uow_transaction->GetBookRepository().GetBookById(id);
+    if (book.has_value()) {
+        co_await uow_transaction->GetBookTagRepository().DeleteByBookId(book->GetId());
+        co_await uow_transaction->GetBookRepository().Delete(book->GetId());
+    }
+    co_await uow_transaction->Commit();
+    co_return book.has_value();
+}
+
+awaitable<std::optional<Book>> AsyncUseCasesImpl::GetBook(BookId id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetBook"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::optional<Book> book = co_await uow_transaction->GetBookRepository().GetBookById(id);
+    if (book.has_value()) {
+        std::vector<BookTag> book_tags = co_await uow_transaction->GetBookTagRepository().GetBookTags(id);
+        std::vector<std::string> tags;
+        tags.reserve(book_tags.size());
+        for (const BookTag& book_tag : book_tags) {
+            tags.push_back(book_tag.GetTag());
+        }
+        book->SetTags(std::move(tags));
+    }
+    co_await uow_transaction->Commit();
+    co_return book;
+}
+
+awaitable<std::vector<Book>> AsyncUseCasesImpl::GetBooksByTitle(std::string title) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetBooksByTitle"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::vector<Book> books = co_await uow_transaction->GetBookRepository().GetBooksByTitle(std::move(title));
+    co_await uow_transaction->Commit();
+    call.SetRows(books.size());
+    co_return books;
+}
+
+awaitable<std::vector<Book>> AsyncUseCasesImpl::GetAllBooks() {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetAllBooks"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::vector<Book> books = co_await uow_transaction->GetBookRepository().GetAllBooks();
+    co_await uow_transaction->Commit();
+    call.SetRows(books.size());
+    co_return books;
+}
+
+awaitable<std::vector<Book>> AsyncUseCasesImpl::GetBooksByAuthorId(AuthorId author_id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kAsyncUseCase, "GetBooksByAuthorId"sv);
+    metrics::ScopedCall call{stats};
+    std::unique_ptr<AsyncUnitOfWork> uow_transaction = co_await unit_of_work_factory_.CreateUnitOfWork();
+    std::vector<Book> books = co_await uow_transaction->GetBookRepository().GetBooksByAuthorId(author_id);
+    co_await uow_transaction->Commit();
+    call.SetRows(books.size());
+    co_return books;
+}
+
+// // // --- BOOK --- // // //
+
+}  // namespace app
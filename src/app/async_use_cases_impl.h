@@ -0,0 +1,64 @@
+#pragma once
+
+#include "async_unit_of_work.h"
+#include "async_use_cases.h"
+
+namespace app {
+
+class AsyncUseCasesImpl : public AsyncUseCases {
+public:
+    explicit AsyncUseCasesImpl(AsyncUnitOfWorkFactory& unit_of_work_factory)
+    : unit_of_work_factory_{unit_of_work_factory}
+    {
+
+    }
+
+    // // // --- AUTHOR --- // // //
+
+    awaitable<void> AddAuthor(std::string name) override;
+    awaitable<bool> EditAuthor(domain::AuthorId id, std::string new_name) override;
+    awaitable<bool> DeleteAuthor(domain::AuthorId id) override;
+
+    awaitable<std::optional<domain::Author>> GetAuthorByName(std::string name) override;
+    awaitable<std::optional<domain::Author>> GetAuthorById(domain::AuthorId id) override;
+
+    awaitable<std::vector<domain::Author>> GetAllAuthors() override;
+
+    // // // --- AUTHOR --- // // //
+    //
+    //
+    //
+    // // // --- BOOK --- // // //
+
+    awaitable<void> AddBookByAuthorId(
+        domain::AuthorId author_id,
+        std::string title,
+        int publication_year,
+        std::vector<std::string> tags
+    ) override;
+    awaitable<void> AddBookByAuthorName(
+        std::string author_name,
+        std::string title,
+        int publication_year,
+        std::vector<std::string> tags
+    ) override;
+    awaitable<bool> EditBook(
+        domain::BookId id,
+        std::string title,
+        int publication_year,
+        std::vector<std::string> tags
+    ) override;
+    awaitable<bool> DeleteBook(domain::BookId id) override;
+
+    awaitable<std::optional<domain::Book>> GetBook(domain::BookId id) override;
+    awaitable<std::vector<domain::Book>> GetBooksByTitle(std::string title) override;
+    awaitable<std::vector<domain::Book>> GetAllBooks() override;
+    awaitable<std::vector<domain::Book>> GetBooksByAuthorId(domain::AuthorId author_id) override;
+
+    // // // --- BOOK --- // // //
+
+private:
+    AsyncUnitOfWorkFactory& unit_of_work_factory_;
+};
+
+}  // namespace app
@@ -0,0 +1,130 @@
+#include "catalog.h"
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+namespace app {
+
+namespace {
+
+bool BookRefLess(const Catalog::BookRef& lhs, const Catalog::BookRef& rhs) noexcept {
+    const Catalog::BookEntry& l = lhs.GetBook();
+    const Catalog::BookEntry& r = rhs.GetBook();
+    return std::tie(l.title, lhs.author->author.GetName(), l.publication_year)
+         < std::tie(r.title, rhs.author->author.GetName(), r.publication_year);
+}
+
+bool AuthorLess(const Catalog::AuthorPtr& lhs, const Catalog::AuthorPtr& rhs) noexcept {
+    return lhs->author.GetName() < rhs->author.GetName();
+}
+
+void AppendBookRefs(const Catalog::AuthorEntry& entry, std::vector<Catalog::BookRef>& refs) {
+    for (std::uint32_t i = 0; i < entry.books.size(); ++i) {
+        refs.push_back({&entry, i});
+    }
+}
+
+}  // namespace
+
+std::shared_ptr<const Catalog> Catalog::Build(std::vector<AuthorPtr> authors) {
+    std::shared_ptr<Catalog> catalog{new Catalog};
+    catalog->authors_ = std::move(authors);
+    std::sort(catalog->authors_.begin(), catalog->authors_.end(), AuthorLess);
+
+    for (const AuthorPtr& entry : catalog->authors_) {
+        AppendBookRefs(*entry, catalog->books_);
+    }
+    std::sort(catalog->books_.begin(), catalog->books_.end(), BookRefLess);
+
+    catalog->BuildAuthorIndexes();
+    return catalog;
+}
+
+std::shared_ptr<const Catalog> Catalog::WithAuthor(const domain::AuthorId& id, AuthorPtr entry) const {
+    const AuthorEntry* old_entry = FindAuthorById(id);
+
+    std::shared_ptr<Catalog> catalog{new Catalog};
+    catalog->authors_.reserve(authors_.size() + 1);
+    std::copy_if(authors_.begin(), authors_.end(), std::back_inserter(catalog->authors_), [old_entry](const AuthorPtr& author) {
+        return author.get() != old_entry;
+    });
+    if (entry) {
+        const auto pos = std::upper_bound(catalog->authors_.begin(), catalog->authors_.end(), entry, AuthorLess);
+        catalog->authors_.insert(pos, entry);
+    }
+
+    // Книги остальных авторов уже упорядочены: достаточно слить их с книгами нового автора
+    std::vector<BookRef> kept;
+    kept.reserve(books_.size());
+    std::copy_if(books_.begin(), books_.end(), std::back_inserter(kept), [old_entry](const BookRef& ref) {
+        return ref.author != old_entry;
+    });
+    std::vector<BookRef> added;
+    if (entry) {
+        AppendBookRefs(*entry, added);
+        std::sort(added.begin(), added.end(), BookRefLess);
+    }
+    catalog->books_.reserve(kept.size() + added.size());
+    std::merge(kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter(catalog->books_), BookRefLess);
+
+    catalog->BuildAuthorIndexes();
+    return catalog;
+}
+
+const Catalog::AuthorEntry* Catalog::FindAuthorById(const domain::AuthorId& id) const noexcept {
+    const auto it = by_id_.find(*id);
+    return it == by_id_.end() ? nullptr : it->second;
+}
+
+const Catalog::AuthorEntry* Catalog::FindAuthorByName(std::string_view name) const noexcept {
+    const auto it = by_name_.find(name);
+    return it == by_name_.end() ? nullptr : it->second;
+}
+
+std::span<const Catalog::BookRef> Catalog::FindBooksByTitle(std::string_view title) const noexcept {
+    const auto begin = std::partition_point(books_.begin(), books_.end(), [title](const BookRef& ref) {
+        return ref.GetBook().title < title;
+    });
+    const auto end = std::partition_point(begin, books_.end(), [title](const BookRef& ref) {
+        return ref.GetBook().title == title;
+    });
+    return {begin, end};
+}
+
+std::span<const Catalog::AuthorPtr> Catalog::FindAuthorsByNamePrefix(std::string_view prefix) const noexcept {
+    const auto begin = std::partition_point(authors_.begin(), authors_.end(), [prefix](const AuthorPtr& entry) {
+        return entry->author.GetName() < prefix;
+    });
+    const auto end = std::partition_point(begin, authors_.end(), [prefix](const AuthorPtr& entry) {
+        return entry->author.GetName().starts_with(prefix);
+    });
+    return {begin, end};
+}
+
+std::span<const Catalog::BookRef> Catalog::FindBooksByTitlePrefix(std::string_view prefix) const noexcept {
+    const auto begin = std::partition_point(books_.begin(), books_.end(), [prefix](const BookRef& ref) {
+        return ref.GetBook().title < prefix;
+    });
+    const auto end = std::partition_point(begin, books_.end(), [prefix](const BookRef& ref) {
+        return ref.GetBook().title.starts_with(prefix);
+    });
+    return {begin, end};
+}
+
+void Catalog::SortAuthorBooks(std::vector<BookEntry>& books) {
+    std::sort(books.begin(), books.end(), [](const BookEntry& lhs, const BookEntry& rhs) {
+        return std::tie(lhs.publication_year, lhs.title) < std::tie(rhs.publication_year, rhs.title);
+    });
+}
+
+void Catalog::BuildAuthorIndexes() {
+    by_id_.reserve(authors_.size());
+    by_name_.reserve(authors_.size());
+    for (const AuthorPtr& entry : authors_) {
+        by_id_.emplace(*entry->author.GetId(), entry.get());
+        by_name_.emplace(entry->author.GetName(), entry.get());
+    }
+}
+
+}  // namespace app
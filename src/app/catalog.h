@@ -0,0 +1,91 @@
+#pragma once
+
+#include <boost/uuid/uuid_hash.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+
+namespace app {
+
+/**
+ * Неизменяемый снимок каталога: авторы и их книги с индексами для чтения.
+ * Снимок никогда не меняется после построения, поэтому читается из любого числа
+ * потоков без синхронизации. Изменение порождает новый снимок (WithAuthor),
+ * который разделяет с предыдущим записи всех незатронутых авторов.
+ *
+ * Строки сравниваются побайтово, поэтому порядок может отличаться от порядка
+ * ORDER BY в базе с нестандартной сортировкой (collation).
+ */
+class Catalog {
+public:
+    struct BookEntry {
+        domain::BookId id;
+        std::string title;
+        int publication_year;
+    };
+
+    // Автор вместе со своими книгами, упорядоченными по году и названию
+    struct AuthorEntry {
+        domain::Author author;
+        std::vector<BookEntry> books;
+    };
+
+    using AuthorPtr = std::shared_ptr<const AuthorEntry>;
+
+    struct BookRef {
+        const AuthorEntry* author;
+        std::uint32_t index;
+
+        const BookEntry& GetBook() const noexcept {
+            return author->books[index];
+        }
+    };
+
+    static std::shared_ptr<const Catalog> Build(std::vector<AuthorPtr> authors);
+
+    // Новый снимок, в котором автор с идентификатором id заменён на entry.
+    // Если entry пуст, автор удаляется; если автора не было, он добавляется.
+    // Стоит O(A + B) копирований указателей, строки не копируются.
+    std::shared_ptr<const Catalog> WithAuthor(const domain::AuthorId& id, AuthorPtr entry) const;
+
+    const AuthorEntry* FindAuthorById(const domain::AuthorId& id) const noexcept;
+    const AuthorEntry* FindAuthorByName(std::string_view name) const noexcept;
+
+    // Авторы по имени
+    std::span<const AuthorPtr> GetAuthors() const noexcept {
+        return authors_;
+    }
+
+    // Книги по названию, имени автора и году
+    std::span<const BookRef> GetBooks() const noexcept {
+        return books_;
+    }
+
+    std::span<const BookRef> FindBooksByTitle(std::string_view title) const noexcept;
+
+    // Отрезки GetAuthors и GetBooks, имена и названия в которых начинаются с prefix
+    std::span<const AuthorPtr> FindAuthorsByNamePrefix(std::string_view prefix) const noexcept;
+    std::span<const BookRef> FindBooksByTitlePrefix(std::string_view prefix) const noexcept;
+
+    // Упорядочивает книги автора так же, как их возвращает GetBooksByAuthorId
+    static void SortAuthorBooks(std::vector<BookEntry>& books);
+
+private:
+    Catalog() = default;
+
+    void BuildAuthorIndexes();
+
+    std::vector<AuthorPtr> authors_;
+    std::vector<BookRef> books_;
+    std::unordered_map<util::detail::UUIDType, const AuthorEntry*> by_id_;
+    std::unordered_map<std::string_view, const AuthorEntry*> by_name_;
+};
+
+}  // namespace app
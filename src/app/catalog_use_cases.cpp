@@ -0,0 +1,434 @@
+#include "catalog_use_cases.h"
+
+#include <algorithm>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/search.h"
+#include "../domain/statistics.h"
+#include "../metrics/metrics.h"
+#include "unit_of_work.h"
+
+namespace app {
+
+using namespace std::literals;
+
+namespace {
+
+// Номера версий уникальны для всех экземпляров, поэтому кэш потока не спутает
+// снимки разных объектов, даже если новый объект займёт адрес удалённого
+std::atomic<std::uint64_t> next_version{1};
+
+struct ThreadSnapshot {
+    const CatalogUseCases* owner = nullptr;
+    std::uint64_t version = 0;
+    std::shared_ptr<const Catalog> catalog;
+};
+
+thread_local ThreadSnapshot thread_snapshot;
+
+// Отрезок authors списка авторов снимка catalog
+class SnapshotAuthorRows : public domain::AuthorRowSource {
+public:
+    SnapshotAuthorRows(std::shared_ptr<const Catalog> catalog, std::span<const Catalog::AuthorPtr> authors) noexcept
+    : catalog_{std::move(catalog)}, authors_{authors}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return authors_.size();
+    }
+
+    AuthorId GetId(std::size_t row) const override {
+        return authors_[row]->author.GetId();
+    }
+
+    std::string_view GetName(std::size_t row) const noexcept override {
+        return authors_[row]->author.GetName();
+    }
+
+private:
+    // Держит снимок, которому принадлежит отрезок
+    std::shared_ptr<const Catalog> catalog_;
+    std::span<const Catalog::AuthorPtr> authors_;
+};
+
+// Отрезок books списка книг снимка catalog
+class SnapshotBookRows : public domain::BookRowSource {
+public:
+    SnapshotBookRows(std::shared_ptr<const Catalog> catalog, std::span<const Catalog::BookRef> books) noexcept
+    : catalog_{std::move(catalog)}, books_{books}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return books_.size();
+    }
+
+    BookId GetId(std::size_t row) const override {
+        return Book(row).id;
+    }
+
+    AuthorId GetAuthorId(std::size_t row) const override {
+        return books_[row].author->author.GetId();
+    }
+
+    std::string_view GetTitle(std::size_t row) const noexcept override {
+        return Book(row).title;
+    }
+
+    int GetPublicationYear(std::size_t row) const override {
+        return Book(row).publication_year;
+    }
+
+    std::string_view GetAuthorName(std::size_t row) const noexcept override {
+        return books_[row].author->author.GetName();
+    }
+
+private:
+    const Catalog::BookEntry& Book(std::size_t row) const noexcept {
+        return books_[row].GetBook();
+    }
+
+    std::shared_ptr<const Catalog> catalog_;
+    std::span<const Catalog::BookRef> books_;
+};
+
+class SnapshotAuthorBookRows : public domain::BookRowSource {
+public:
+    SnapshotAuthorBookRows(std::shared_ptr<const Catalog> catalog, const Catalog::AuthorEntry& author) noexcept
+    : catalog_{std::move(catalog)}, author_{author}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return author_.books.size();
+    }
+
+    BookId GetId(std::size_t row) const override {
+        return author_.books[row].id;
+    }
+
+    AuthorId GetAuthorId(std::size_t) const override {
+        return author_.author.GetId();
+    }
+
+    std::string_view GetTitle(std::size_t row) const noexcept override {
+        return author_.books[row].title;
+    }
+
+    int GetPublicationYear(std::size_t row) const override {
+        return author_.books[row].publication_year;
+    }
+
+    std::string_view GetAuthorName(std::size_t) const noexcept override {
+        return author_.author.GetName();
+    }
+
+private:
+    // Держит снимок, которому принадлежит запись автора
+    std::shared_ptr<const Catalog> catalog_;
+    const Catalog::AuthorEntry& author_;
+};
+
+std::vector<Catalog::BookEntry> ToBookEntries(const domain::BookRows& rows) {
+    std::vector<Catalog::BookEntry> books;
+    books.reserve(rows.Size());
+    for (const domain::BookRow row : rows) {
+        books.push_back({row.GetId(), std::string{row.GetTitle()}, row.GetPublicationYear()});
+    }
+    Catalog::SortAuthorBooks(books);
+    return books;
+}
+
+}  // namespace
+
+CatalogUseCases::CatalogUseCases(UseCases& inner)
+    : inner_{inner} {
+    Reload();
+}
+
+void CatalogUseCases::Reload() {
+    std::lock_guard lock{write_mutex_};
+
+    std::unordered_map<util::detail::UUIDType, std::vector<Catalog::BookEntry>> books_by_author;
+    for (const domain::BookRow row : inner_.GetAllBooks()) {
+        books_by_author[*row.GetAuthorId()].push_back({row.GetId(), std::string{row.GetTitle()}, row.GetPublicationYear()});
+    }
+
+    std::vector<Catalog::AuthorPtr> authors;
+    const domain::AuthorRows author_rows = inner_.GetAllAuthors();
+    authors.reserve(author_rows.Size());
+    for (const domain::AuthorRow row : author_rows) {
+        const AuthorId id = row.GetId();
+        std::vector<Catalog::BookEntry> books;
+        if (const auto it = books_by_author.find(*id); it != books_by_author.end()) {
+            books = std::move(it->second);
+            Catalog::SortAuthorBooks(books);
+        }
+        authors.push_back(std::make_shared<const Catalog::AuthorEntry>(
+            Catalog::AuthorEntry{domain::Author{id, std::string{row.GetName()}}, std::move(books)}
+        ));
+    }
+    Publish(Catalog::Build(std::move(authors)));
+}
+
+std::shared_ptr<const Catalog> CatalogUseCases::GetSnapshot() const {
+    return CurrentSnapshot();
+}
+
+const std::shared_ptr<const Catalog>& CatalogUseCases::CurrentSnapshot() const {
+    const std::uint64_t version = version_.load(std::memory_order_acquire);
+    if (thread_snapshot.owner != this || thread_snapshot.version != version) {
+        thread_snapshot.catalog = LoadSnapshot();
+        thread_snapshot.owner = this;
+        thread_snapshot.version = version;
+    }
+    return thread_snapshot.catalog;
+}
+
+std::shared_ptr<const Catalog> CatalogUseCases::LoadSnapshot() const {
+    std::lock_guard lock{snapshot_mutex_};
+    return snapshot_;
+}
+
+void CatalogUseCases::Publish(std::shared_ptr<const Catalog> catalog) {
+    {
+        std::lock_guard lock{snapshot_mutex_};
+        snapshot_ = std::move(catalog);
+    }
+    // Номер версии меняется после указателя: читатель, увидевший новую версию, получит новый снимок
+    version_.store(next_version.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+}
+
+void CatalogUseCases::RefreshAuthor(const AuthorId& id) {
+    const PrimaryReadScope primary_read;
+    const std::shared_ptr<const Catalog> current = LoadSnapshot();
+    const std::optional<domain::Author> author = inner_.GetAuthorById(id);
+    if (!author) {
+        Publish(current->WithAuthor(id, nullptr));
+        return;
+    }
+    Publish(current->WithAuthor(id, std::make_shared<const Catalog::AuthorEntry>(
+        Catalog::AuthorEntry{*author, ToBookEntries(inner_.GetBooksByAuthorId(id))}
+    )));
+}
+
+// // // --- AUTHOR --- // // //
+
+AuthorId CatalogUseCases::AddAuthor(std::string name) {
+    std::lock_guard lock{write_mutex_};
+    const AuthorId id = inner_.AddAuthor(std::move(name));
+    RefreshAuthor(id);
+    return id;
+}
+
+bool CatalogUseCases::EditAuthor(const AuthorId& id, std::string_view new_name) {
+    std::lock_guard lock{write_mutex_};
+    if (!inner_.EditAuthor(id, new_name)) {
+        return false;
+    }
+    RefreshAuthor(id);
+    return true;
+}
+
+bool CatalogUseCases::DeleteAuthor(const AuthorId& id) {
+    std::lock_guard lock{write_mutex_};
+    if (!inner_.DeleteAuthor(id)) {
+        return false;
+    }
+    Publish(LoadSnapshot()->WithAuthor(id, nullptr));
+    return true;
+}
+
+std::optional<domain::Author> CatalogUseCases::GetAuthorByName(std::string_view name) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAuthorByName"sv);
+    metrics::ScopedCall call{stats, true};
+    if (const Catalog::AuthorEntry* entry = CurrentSnapshot()->FindAuthorByName(name)) {
+        call.SetRows(1);
+        return entry->author;
+    }
+    return std::nullopt;
+}
+
+std::optional<domain::Author> CatalogUseCases::GetAuthorById(const AuthorId& id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAuthorById"sv);
+    metrics::ScopedCall call{stats, true};
+    if (const Catalog::AuthorEntry* entry = CurrentSnapshot()->FindAuthorById(id)) {
+        call.SetRows(1);
+        return entry->author;
+    }
+    return std::nullopt;
+}
+
+domain::AuthorRows CatalogUseCases::GetAllAuthors() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAllAuthors"sv);
+    metrics::ScopedCall call{stats, true};
+    const std::shared_ptr<const Catalog>& catalog = CurrentSnapshot();
+    domain::AuthorRows authors{std::make_unique<SnapshotAuthorRows>(catalog, catalog->GetAuthors())};
+    call.SetRows(authors.Size());
+    return authors;
+}
+
+domain::AuthorRows CatalogUseCases::GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAuthorsByNamePrefix"sv);
+    metrics::ScopedCall call{stats, true};
+    const std::shared_ptr<const Catalog>& catalog = CurrentSnapshot();
+    const std::span<const Catalog::AuthorPtr> found = catalog->FindAuthorsByNamePrefix(prefix);
+    domain::AuthorRows authors{std::make_unique<SnapshotAuthorRows>(catalog, found.first(std::min(found.size(), limit)))};
+    call.SetRows(authors.Size());
+    return authors;
+}
+
+// // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // //
+
+BookId CatalogUseCases::AddBookByAuthorId(
+    const domain::AuthorId& author_id,
+    std::string title,
+    int publication_year,
+    std::span<const std::string> tags
+) {
+    std::lock_guard lock{write_mutex_};
+    const BookId id = inner_.AddBookByAuthorId(author_id, std::move(title), publication_year, tags);
+    RefreshAuthor(author_id);
+    return id;
+}
+
+BookId CatalogUseCases::AddBookByAuthorName(
+    std::string author_name,
+    std::string title,
+    int publication_year,
+    std::span<const std::string> tags
+) {
+    std::lock_guard lock{write_mutex_};
+    const BookId id = inner_.AddBookByAuthorName(author_name, std::move(title), publication_year, tags);
+    const PrimaryReadScope primary_read;
+    if (const std::optional<domain::Author> author = inner_.GetAuthorByName(author_name)) {
+        RefreshAuthor(author->GetId());
+    }
+    return id;
+}
+
+std::optional<domain::Book> CatalogUseCases::EditBook(
+    const BookId& id,
+    std::string_view title,
+    int publication_year,
+    std::span<const std::string> tags
+) {
+    std::lock_guard lock{write_mutex_};
+    // В снимке нет индекса по книгам: автора книги сообщает сама запись
+    std::optional<domain::Book> book = inner_.EditBook(id, title, publication_year, tags);
+    if (book) {
+        RefreshAuthor(book->GetAuthorId());
+    }
+    return book;
+}
+
+std::optional<domain::Book> CatalogUseCases::DeleteBook(const BookId& id) {
+    std::lock_guard lock{write_mutex_};
+    std::optional<domain::Book> book = inner_.DeleteBook(id);
+    if (book) {
+        RefreshAuthor(book->GetAuthorId());
+    }
+    return book;
+}
+
+std::optional<domain::Book> CatalogUseCases::GetBook(const BookId& id) const {
+    return inner_.GetBook(id);
+}
+
+std::vector<domain::Book> CatalogUseCases::GetBooksByTitle(std::string_view title) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByTitle"sv);
+    metrics::ScopedCall call{stats, true};
+    const std::span<const Catalog::BookRef> refs = CurrentSnapshot()->FindBooksByTitle(title);
+    std::vector<domain::Book> books;
+    books.reserve(refs.size());
+    for (const Catalog::BookRef& ref : refs) {
+        const Catalog::BookEntry& book = ref.GetBook();
+        books.emplace_back(book.id, ref.author->author.GetId(), book.title, book.publication_year, ref.author->author.GetName());
+    }
+    call.SetRows(books.size());
+    return books;
+}
+
+domain::BookRows CatalogUseCases::GetAllBooks() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAllBooks"sv);
+    metrics::ScopedCall call{stats, true};
+    const std::shared_ptr<const Catalog>& catalog = CurrentSnapshot();
+    domain::BookRows books{std::make_unique<SnapshotBookRows>(catalog, catalog->GetBooks())};
+    call.SetRows(books.Size());
+    return books;
+}
+
+domain::BookRows CatalogUseCases::GetBooksByAuthorId(const domain::AuthorId& author_id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByAuthorId"sv);
+    metrics::ScopedCall call{stats, true};
+    const std::shared_ptr<const Catalog>& catalog = CurrentSnapshot();
+    const Catalog::AuthorEntry* author = catalog->FindAuthorById(author_id);
+    if (!author) {
+        return {};
+    }
+    domain::BookRows books{std::make_unique<SnapshotAuthorBookRows>(catalog, *author)};
+    call.SetRows(books.Size());
+    return books;
+}
+
+domain::BookRows CatalogUseCases::GetBooksByYearRange(int from, int to) const {
+    // В снимке нет индекса по году; в базе диапазон читается только из нужных секций
+    return inner_.GetBooksByYearRange(from, to);
+}
+
+domain::BookRows CatalogUseCases::GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByTitlePrefix"sv);
+    metrics::ScopedCall call{stats, true};
+    const std::shared_ptr<const Catalog>& catalog = CurrentSnapshot();
+    const std::span<const Catalog::BookRef> found = catalog->FindBooksByTitlePrefix(prefix);
+    domain::BookRows books{std::make_unique<SnapshotBookRows>(catalog, found.first(std::min(found.size(), limit)))};
+    call.SetRows(books.Size());
+    return books;
+}
+
+std::vector<domain::TagBookCount> CatalogUseCases::GetTagsByAuthorId(const domain::AuthorId& author_id) const {
+    // Теги книг в снимке не хранятся
+    return inner_.GetTagsByAuthorId(author_id);
+}
+
+// // // --- BOOK --- // // //
+//
+//
+//
+// // // --- STATISTICS --- // // //
+
+domain::CatalogStatistics CatalogUseCases::GetStatistics(std::size_t top_n) const {
+    // Счётчики в базе обновляются вместе с записью и дешевле пересчёта по снимку
+    return inner_.GetStatistics(top_n);
+}
+
+// // // --- STATISTICS --- // // //
+//
+//
+//
+// // // --- SEARCH --- // // //
+
+std::vector<domain::TagBookCount> CatalogUseCases::CompleteTag(std::string_view prefix, std::size_t limit) const {
+    // Теги книг в снимке не хранятся
+    return inner_.CompleteTag(prefix, limit);
+}
+
+std::vector<domain::FuzzyMatch> CatalogUseCases::FuzzyFind(std::string_view text, std::size_t limit) const {
+    return inner_.FuzzyFind(text, limit);
+}
+
+// // // --- SEARCH --- // // //
+
+}  // namespace app
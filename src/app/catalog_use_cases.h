@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "catalog.h"
+#include "use_cases.h"
+
+namespace app {
+
+/**
+ * Обслуживает чтение списков авторов и книг из неизменяемого снимка каталога (см. Catalog),
+ * а запись передаёт в inner. После успешной записи затронутый автор перечитывается из
+ * хранилища, и публикуется новый снимок.
+ *
+ * Читатели не берут блокировок и не пишут в общую память: каждый поток держит ссылку
+ * на последний увиденный снимок и перечитывает указатель (под коротким мьютексом),
+ * только когда меняется номер версии, т.е. не чаще одного раза на запись.
+ * Старый снимок освобождается, когда его отпустит последний читатель
+ * (подсчёт ссылок shared_ptr). Писатели выполняются по одному.
+ *
+ * Снимок видит только изменения, прошедшие через этот объект; изменения, сделанные
+ * в базе в обход него, становятся видны после Reload. Теги книг в снимке не хранятся,
+ * поэтому GetBook читается из хранилища.
+ */
+class CatalogUseCases : public UseCases {
+public:
+    explicit CatalogUseCases(UseCases& inner);
+
+    CatalogUseCases(const CatalogUseCases&) = delete;
+    CatalogUseCases& operator=(const CatalogUseCases&) = delete;
+
+    // Строит снимок заново по содержимому хранилища
+    void Reload();
+
+    std::shared_ptr<const Catalog> GetSnapshot() const;
+
+    // // // --- AUTHOR --- // // //
+
+    AuthorId AddAuthor(std::string name) override;
+    bool EditAuthor(const AuthorId& id, std::string_view new_name) override;
+    bool DeleteAuthor(const AuthorId& id) override;
+
+    std::optional<domain::Author> GetAuthorByName(std::string_view name) const override;
+    std::optional<domain::Author> GetAuthorById(const AuthorId& id) const override;
+
+    domain::AuthorRows GetAllAuthors() const override;
+    domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override;
+
+    // // // --- AUTHOR --- // // //
+    //
+    //
+    //
+    // // // --- BOOK --- // // //
+
+    BookId AddBookByAuthorId(
+        const domain::AuthorId& author_id,
+        std::string title,
+        int publication_year,
+        std::span<const std::string> tags
+    ) override;
+    BookId AddBookByAuthorName(
+        std::string author_name,
+        std::string title,
+        int publication_year,
+        std::span<const std::string> tags
+    ) override;
+    std::optional<domain::Book> EditBook(
+        const BookId& id,
+        std::string_view title,
+        int publication_year,
+        std::span<const std::string> tags
+    ) override;
+    std::optional<domain::Book> DeleteBook(const BookId& id) override;
+
+    std::optional<domain::Book> GetBook(const BookId& id) const override;
+    std::vector<domain::Book> GetBooksByTitle(std::string_view title) const override;
+    domain::BookRows GetAllBooks() const override;
+    domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const override;
+    domain::BookRows GetBooksByYearRange(int from, int to) const override;
+    domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override;
+    std::vector<domain::TagBookCount> GetTagsByAuthorId(const domain::AuthorId& author_id) const override;
+
+    // // // --- BOOK --- // // //
+    //
+    //
+    //
+    // // // --- STATISTICS --- // // //
+
+    domain::CatalogStatistics GetStatistics(std::size_t top_n) const override;
+
+    // // // --- STATISTICS --- // // //
+    //
+    //
+    //
+    // // // --- SEARCH --- // // //
+
+    std::vector<domain::TagBookCount> CompleteTag(std::string_view prefix, std::size_t limit) const override;
+    std::vector<domain::FuzzyMatch> FuzzyFind(std::string_view text, std::size_t limit) const override;
+
+    // // // --- SEARCH --- // // //
+
+private:
+    // Снимок, закэшированный текущим потоком; действителен до следующего вызова в этом потоке
+    const std::shared_ptr<const Catalog>& CurrentSnapshot() const;
+
+    // Перечитывает автора и его книги из inner и публикует снимок с обновлённой записью.
+    // Вызывается под write_mutex_ сразу после записи, поэтому читает в основной базе
+    void RefreshAuthor(const AuthorId& id);
+    void Publish(std::shared_ptr<const Catalog> catalog);
+
+    std::shared_ptr<const Catalog> LoadSnapshot() const;
+
+    UseCases& inner_;
+    std::mutex write_mutex_;
+    // Защищает только указатель на снимок: запись в базу идёт под write_mutex_,
+    // чтобы читатели, обновляющие кэш, не ждали её окончания
+    mutable std::mutex snapshot_mutex_;
+    std::shared_ptr<const Catalog> snapshot_;
+    std::atomic<std::uint64_t> version_{0};
+};
+
+}  // namespace app
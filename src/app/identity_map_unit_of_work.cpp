@@ -0,0 +1,270 @@
+#include "identity_map_unit_of_work.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace app {
+
+IdentityMapUnitOfWork::IdentityMapUnitOfWork(std::unique_ptr<UnitOfWork> inner, IdentityMapUnitOfWorkFactory* factory)
+    : inner_{std::move(inner)}
+    , factory_{factory} {
+}
+
+IdentityMapUnitOfWork::~IdentityMapUnitOfWork() {
+    if (factory_) {
+        factory_->AddCounters(counters_);
+    }
+}
+
+void IdentityMapUnitOfWork::Commit() {
+    inner_->Commit();
+}
+
+// // // --- AUTHOR --- // // //
+
+void IdentityMapUnitOfWork::Authors::Save(const domain::Author& author) {
+    uow_.CountWrite();
+    uow_.inner_->GetAuthorRepository().Save(author);
+    uow_.authors_by_id_.insert_or_assign(*author.GetId(), author);
+}
+
+void IdentityMapUnitOfWork::Authors::Edit(const domain::AuthorId& id, std::string_view new_name) {
+    uow_.CountWrite();
+    uow_.inner_->GetAuthorRepository().Edit(id, new_name);
+    if (const auto it = uow_.authors_by_id_.find(*id); it != uow_.authors_by_id_.end() && it->second) {
+        it->second.emplace(id, std::string{new_name});
+    }
+    // В книгах хранится имя автора
+    for (auto& [book_id, book] : uow_.books_by_id_) {
+        if (book && book->GetAuthorId() == id) {
+            book.emplace(book->GetId(), id, book->GetTitle(), book->GetPublicationYear(), std::string{new_name});
+        }
+    }
+}
+
+void IdentityMapUnitOfWork::Authors::Delete(const domain::AuthorId& id) {
+    uow_.CountWrite();
+    uow_.inner_->GetAuthorRepository().Delete(id);
+    uow_.authors_by_id_.insert_or_assign(*id, std::nullopt);
+    // Книги автора к этому моменту уже удалены: иначе базу не пустит внешний ключ
+    for (auto& [book_id, book] : uow_.books_by_id_) {
+        if (book && book->GetAuthorId() == id) {
+            book.reset();
+        }
+    }
+}
+
+void IdentityMapUnitOfWork::Authors::MarkDeleted(const domain::AuthorId& id) {
+    uow_.CountWrite();
+    uow_.inner_->GetAuthorRepository().MarkDeleted(id);
+    uow_.authors_by_id_.insert_or_assign(*id, std::nullopt);
+    // Книги помеченного автора остаются в базе, но чтения их уже не видят
+    for (auto& [book_id, book] : uow_.books_by_id_) {
+        if (book && book->GetAuthorId() == id) {
+            book.reset();
+            uow_.tags_by_book_.erase(book_id);
+        }
+    }
+}
+
+domain::AuthorRows IdentityMapUnitOfWork::Authors::GetAllAuthors() const {
+    uow_.CountRead();
+    return uow_.inner_->GetAuthorRepository().GetAllAuthors();
+}
+
+domain::AuthorRows IdentityMapUnitOfWork::Authors::GetAuthorsByNamePrefix(std::string_view prefix,
+                                                                         std::size_t limit) const {
+    uow_.CountRead();
+    return uow_.inner_->GetAuthorRepository().GetAuthorsByNamePrefix(prefix, limit);
+}
+
+std::optional<domain::Author> IdentityMapUnitOfWork::Authors::GetAuthorByName(std::string_view name) const {
+    uow_.CountRead();
+    std::optional<domain::Author> author = uow_.inner_->GetAuthorRepository().GetAuthorByName(name);
+    if (author) {
+        uow_.authors_by_id_.insert_or_assign(*author->GetId(), author);
+    }
+    return author;
+}
+
+std::optional<domain::Author> IdentityMapUnitOfWork::Authors::GetAuthorById(const domain::AuthorId& id) const {
+    if (const auto it = uow_.authors_by_id_.find(*id); it != uow_.authors_by_id_.end()) {
+        uow_.CountHit();
+        return it->second;
+    }
+    uow_.CountRead();
+    std::optional<domain::Author> author = uow_.inner_->GetAuthorRepository().GetAuthorById(id);
+    uow_.authors_by_id_.emplace(*id, author);
+    return author;
+}
+
+std::vector<domain::AuthorId> IdentityMapUnitOfWork::Authors::GetDeletedAuthorIds() const {
+    uow_.CountRead();
+    return uow_.inner_->GetAuthorRepository().GetDeletedAuthorIds();
+}
+
+// // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // //
+
+void IdentityMapUnitOfWork::Books::Save(const domain::Book& book) {
+    uow_.CountWrite();
+    uow_.inner_->GetBookRepository().Save(book);
+    // Сохраняемая книга не содержит имени автора, следующее чтение возьмёт его из базы
+    uow_.books_by_id_.erase(*book.GetId());
+}
+
+void IdentityMapUnitOfWork::Books::Edit(const domain::BookId& id, std::string_view title, int publication_year) {
+    uow_.CountWrite();
+    uow_.inner_->GetBookRepository().Edit(id, title, publication_year);
+    if (const auto it = uow_.books_by_id_.find(*id); it != uow_.books_by_id_.end() && it->second) {
+        const domain::Book& book = *it->second;
+        domain::Book edited{book.GetId(), book.GetAuthorId(), std::string{title}, publication_year,
+                            book.GetAuthorName().value_or(std::string{})};
+        it->second.emplace(std::move(edited));
+    }
+}
+
+void IdentityMapUnitOfWork::Books::Delete(const domain::BookId& id) {
+    uow_.CountWrite();
+    uow_.inner_->GetBookRepository().Delete(id);
+    uow_.books_by_id_.insert_or_assign(*id, std::nullopt);
+    uow_.tags_by_book_.erase(*id);
+}
+
+std::optional<domain::Book> IdentityMapUnitOfWork::Books::GetBookById(const domain::BookId& id) {
+    if (const auto it = uow_.books_by_id_.find(*id); it != uow_.books_by_id_.end()) {
+        uow_.CountHit();
+        return it->second;
+    }
+    uow_.CountRead();
+    std::optional<domain::Book> book = uow_.inner_->GetBookRepository().GetBookById(id);
+    uow_.books_by_id_.emplace(*id, book);
+    return book;
+}
+
+std::optional<domain::Book> IdentityMapUnitOfWork::Books::GetBookByIdForUpdate(const domain::BookId& id) {
+    // Блокировку строки берёт только хранилище, поэтому карта здесь не используется,
+    // а прочитанные до блокировки теги книги перечитываются
+    uow_.CountRead();
+    std::optional<domain::Book> book = uow_.inner_->GetBookRepository().GetBookByIdForUpdate(id);
+    uow_.books_by_id_.insert_or_assign(*id, book);
+    uow_.tags_by_book_.erase(*id);
+    return book;
+}
+
+std::vector<domain::Book> IdentityMapUnitOfWork::Books::GetBooksByTitle(std::string_view title) {
+    uow_.CountRead();
+    return uow_.inner_->GetBookRepository().GetBooksByTitle(title);
+}
+
+domain::BookRows IdentityMapUnitOfWork::Books::GetAllBooks() {
+    uow_.CountRead();
+    return uow_.inner_->GetBookRepository().GetAllBooks();
+}
+
+domain::BookRows IdentityMapUnitOfWork::Books::GetBooksByAuthorId(const domain::AuthorId& author_id) const {
+    uow_.CountRead();
+    return uow_.inner_->GetBookRepository().GetBooksByAuthorId(author_id);
+}
+
+domain::BookRows IdentityMapUnitOfWork::Books::GetBooksByYearRange(int from, int to) const {
+    uow_.CountRead();
+    return uow_.inner_->GetBookRepository().GetBooksByYearRange(from, to);
+}
+
+domain::BookRows IdentityMapUnitOfWork::Books::GetBooksByTitlePrefix(std::string_view prefix,
+                                                                   std::size_t limit) const {
+    uow_.CountRead();
+    return uow_.inner_->GetBookRepository().GetBooksByTitlePrefix(prefix, limit);
+}
+
+std::vector<domain::BookId> IdentityMapUnitOfWork::Books::GetBookIdsByAuthorId(const domain::AuthorId& author_id,
+                                                                              std::size_t limit) const {
+    uow_.CountRead();
+    return uow_.inner_->GetBookRepository().GetBookIdsByAuthorId(author_id, limit);
+}
+
+void IdentityMapUnitOfWork::Books::DeleteBooksByAuthorId(const domain::AuthorId& author_id) {
+    uow_.CountWrite();
+    uow_.inner_->GetBookRepository().DeleteBooksByAuthorId(author_id);
+    for (auto& [id, book] : uow_.books_by_id_) {
+        if (book && book->GetAuthorId() == author_id) {
+            book.reset();
+            uow_.tags_by_book_.erase(id);
+        }
+    }
+}
+
+// // // --- BOOK --- // // //
+//
+//
+//
+// // // --- BOOK_TAG --- // // //
+
+void IdentityMapUnitOfWork::BookTags::Save(const domain::BookId& book_id, std::string_view tag) {
+    uow_.CountWrite();
+    uow_.inner_->GetBookTagRepository().Save(book_id, tag);
+    if (const auto it = uow_.tags_by_book_.find(*book_id); it != uow_.tags_by_book_.end()) {
+        std::vector<std::string>& tags = it->second;
+        tags.emplace(std::upper_bound(tags.begin(), tags.end(), tag), tag);
+    }
+}
+
+void IdentityMapUnitOfWork::BookTags::DeleteByBookId(const domain::BookId& book_id) {
+    uow_.CountWrite();
+    uow_.inner_->GetBookTagRepository().DeleteByBookId(book_id);
+    uow_.tags_by_book_.insert_or_assign(*book_id, std::vector<std::string>{});
+}
+
+std::vector<std::string> IdentityMapUnitOfWork::BookTags::GetTags(const domain::BookId& book_id) const {
+    if (const auto it = uow_.tags_by_book_.find(*book_id); it != uow_.tags_by_book_.end()) {
+        uow_.CountHit();
+        return it->second;
+    }
+    uow_.CountRead();
+    std::vector<std::string> tags = uow_.inner_->GetBookTagRepository().GetTags(book_id);
+    uow_.tags_by_book_.emplace(*book_id, tags);
+    return tags;
+}
+
+std::vector<domain::TagBookCount> IdentityMapUnitOfWork::BookTags::GetTagCountsByAuthorId(
+    const domain::AuthorId& author_id
+) const {
+    uow_.CountRead();
+    return uow_.inner_->GetBookTagRepository().GetTagCountsByAuthorId(author_id);
+}
+
+// // // --- BOOK_TAG --- // // //
+//
+//
+//
+// // // --- FACTORY --- // // //
+
+std::unique_ptr<UnitOfWork> IdentityMapUnitOfWorkFactory::CreateUnitOfWork() {
+    return std::make_unique<IdentityMapUnitOfWork>(factory_.CreateUnitOfWork(), this);
+}
+
+std::unique_ptr<UnitOfWork> IdentityMapUnitOfWorkFactory::CreateReadOnlyUnitOfWork() {
+    return std::make_unique<IdentityMapUnitOfWork>(factory_.CreateReadOnlyUnitOfWork(), this);
+}
+
+QueryCounters IdentityMapUnitOfWorkFactory::GetCounters() const noexcept {
+    return {
+        reads_.load(std::memory_order_relaxed),
+        hits_.load(std::memory_order_relaxed),
+        writes_.load(std::memory_order_relaxed)
+    };
+}
+
+void IdentityMapUnitOfWorkFactory::AddCounters(const QueryCounters& counters) noexcept {
+    reads_.fetch_add(counters.reads, std::memory_order_relaxed);
+    hits_.fetch_add(counters.hits, std::memory_order_relaxed);
+    writes_.fetch_add(counters.writes, std::memory_order_relaxed);
+}
+
+// // // --- FACTORY --- // // //
+
+}  // namespace app
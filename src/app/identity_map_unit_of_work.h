@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "unit_of_work.h"
+
+namespace app {
+
+class IdentityMapUnitOfWorkFactory;
+
+struct QueryCounters {
+    // Чтения, переданные в репозитории нижнего уровня (запросы к базе)
+    std::uint64_t reads = 0;
+    // Чтения, обслуженные из карты идентичности
+    std::uint64_t hits = 0;
+    std::uint64_t writes = 0;
+};
+
+/**
+ * Единица работы с картой идентичности: GetAuthorById, GetBookById и GetTags
+ * для одного и того же id выполняются в базе не более одного раза за транзакцию,
+ * повторные вызовы возвращают копию сохранённого экземпляра. Отсутствие сущности
+ * тоже запоминается. Запись через репозитории этой единицы работы обновляет карту,
+ * поэтому последующие чтения видят собственные изменения транзакции.
+ * Списки (GetAllBooks, GetBooksByTitle и т.п.) не кэшируются.
+ */
+class IdentityMapUnitOfWork : public UnitOfWork {
+public:
+    // Если задана фабрика, при разрушении счётчики добавляются к её сумме
+    explicit IdentityMapUnitOfWork(std::unique_ptr<UnitOfWork> inner, IdentityMapUnitOfWorkFactory* factory = nullptr);
+
+    void Commit() override;
+
+    domain::AuthorRepository& GetAuthorRepository() override {
+        return authors_;
+    }
+
+    domain::BookRepository& GetBookRepository() override {
+        return books_;
+    }
+
+    domain::BookTagRepository& GetBookTagRepository() override {
+        return book_tags_;
+    }
+
+    // Сводные счётчики не кэшируются и не учитываются в QueryCounters
+    domain::StatisticsRepository& GetStatisticsRepository() override {
+        return inner_->GetStatisticsRepository();
+    }
+
+    const QueryCounters& GetCounters() const noexcept {
+        return counters_;
+    }
+
+    ~IdentityMapUnitOfWork() override;
+
+private:
+    using UUIDType = util::detail::UUIDType;
+
+    class Authors : public domain::AuthorRepository {
+    public:
+        explicit Authors(IdentityMapUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        void Save(const domain::Author& author) override;
+        void Edit(const domain::AuthorId& id, std::string_view new_name) override;
+        void Delete(const domain::AuthorId& id) override;
+        void MarkDeleted(const domain::AuthorId& id) override;
+
+        domain::AuthorRows GetAllAuthors() const override;
+        domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override;
+        std::optional<domain::Author> GetAuthorByName(std::string_view name) const override;
+        std::optional<domain::Author> GetAuthorById(const domain::AuthorId& id) const override;
+        std::vector<domain::AuthorId> GetDeletedAuthorIds() const override;
+
+    private:
+        IdentityMapUnitOfWork& uow_;
+    };
+
+    class Books : public domain::BookRepository {
+    public:
+        explicit Books(IdentityMapUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        void Save(const domain::Book& book) override;
+        void Edit(const domain::BookId& id, std::string_view title, int publication_year) override;
+        void Delete(const domain::BookId& id) override;
+
+        std::optional<domain::Book> GetBookById(const domain::BookId& id) override;
+        std::optional<domain::Book> GetBookByIdForUpdate(const domain::BookId& id) override;
+        std::vector<domain::Book> GetBooksByTitle(std::string_view title) override;
+        domain::BookRows GetAllBooks() override;
+        domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const override;
+        domain::BookRows GetBooksByYearRange(int from, int to) const override;
+        domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override;
+        std::vector<domain::BookId> GetBookIdsByAuthorId(const domain::AuthorId& author_id,
+                                                         std::size_t limit) const override;
+
+        void DeleteBooksByAuthorId(const domain::AuthorId& author_id) override;
+
+    private:
+        IdentityMapUnitOfWork& uow_;
+    };
+
+    class BookTags : public domain::BookTagRepository {
+    public:
+        explicit BookTags(IdentityMapUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        void Save(const domain::BookId& book_id, std::string_view tag) override;
+        void DeleteByBookId(const domain::BookId& book_id) override;
+
+        std::vector<std::string> GetTags(const domain::BookId& book_id) const override;
+        std::vector<domain::TagBookCount> GetTagCountsByAuthorId(const domain::AuthorId& author_id) const override;
+
+    private:
+        IdentityMapUnitOfWork& uow_;
+    };
+
+    void CountRead() noexcept {
+        ++counters_.reads;
+    }
+
+    void CountHit() noexcept {
+        ++counters_.hits;
+    }
+
+    void CountWrite() noexcept {
+        ++counters_.writes;
+    }
+
+    std::unique_ptr<UnitOfWork> inner_;
+    IdentityMapUnitOfWorkFactory* factory_;
+    QueryCounters counters_;
+
+    // nullopt — сущность запрашивалась и не найдена (или удалена в этой транзакции)
+    std::map<UUIDType, std::optional<domain::Author>> authors_by_id_;
+    std::map<UUIDType, std::optional<domain::Book>> books_by_id_;
+    std::map<UUIDType, std::vector<std::string>> tags_by_book_;
+
+    Authors authors_{*this};
+    Books books_{*this};
+    BookTags book_tags_{*this};
+};
+
+/**
+ * Оборачивает единицы работы другой фабрики в IdentityMapUnitOfWork
+ * и суммирует их счётчики запросов. Потокобезопасна, если потокобезопасна исходная фабрика.
+ */
+class IdentityMapUnitOfWorkFactory : public UnitOfWorkFactory {
+public:
+    explicit IdentityMapUnitOfWorkFactory(UnitOfWorkFactory& factory)
+    : factory_{factory}
+    {
+
+    }
+
+    std::unique_ptr<UnitOfWork> CreateUnitOfWork() override;
+    std::unique_ptr<UnitOfWork> CreateReadOnlyUnitOfWork() override;
+
+    // Сумма счётчиков всех завершённых единиц работы
+    QueryCounters GetCounters() const noexcept;
+
+private:
+    friend class IdentityMapUnitOfWork;
+
+    void AddCounters(const QueryCounters& counters) noexcept;
+
+    UnitOfWorkFactory& factory_;
+    std::atomic<std::uint64_t> reads_{0};
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> writes_{0};
+};
+
+}  // namespace app
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace app {
+
+// Строка одной из сливаемых частей
+struct RowRef {
+    std::uint32_t part;
+    std::uint32_t index;
+};
+
+/**
+ * Слияние k отсортированных частей за O(n log k): в куче лежит по одному курсору на часть.
+ * sizes[i] — число строк i-й части, less(RowRef, RowRef) сравнивает строки.
+ * Слияние устойчиво: равные строки идут в порядке номеров частей. Слияние останавливается
+ * после первых limit строк.
+ */
+template <typename Less>
+std::vector<RowRef> MergeSorted(std::span<const std::size_t> sizes, Less less,
+                                std::size_t limit = std::numeric_limits<std::size_t>::max()) {
+    std::size_t total = 0;
+    std::vector<RowRef> heap;
+    heap.reserve(sizes.size());
+    for (std::size_t part = 0; part < sizes.size(); ++part) {
+        total += sizes[part];
+        if (sizes[part] != 0) {
+            heap.push_back({static_cast<std::uint32_t>(part), 0});
+        }
+    }
+
+    // std::*_heap строят max-кучу, поэтому сравнение обратное
+    const auto greater = [&less](const RowRef& lhs, const RowRef& rhs) {
+        if (less(rhs, lhs)) {
+            return true;
+        }
+        if (less(lhs, rhs)) {
+            return false;
+        }
+        return lhs.part > rhs.part;
+    };
+    std::make_heap(heap.begin(), heap.end(), greater);
+
+    std::vector<RowRef> order;
+    order.reserve(std::min(total, limit));
+    while (!heap.empty() && order.size() < limit) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        RowRef& cursor = heap.back();
+        order.push_back(cursor);
+        if (++cursor.index < sizes[cursor.part]) {
+            std::push_heap(heap.begin(), heap.end(), greater);
+        } else {
+            heap.pop_back();
+        }
+    }
+    return order;
+}
+
+}  // namespace app
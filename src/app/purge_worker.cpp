@@ -0,0 +1,137 @@
+#include "purge_worker.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "../metrics/metrics.h"
+
+namespace app {
+
+using namespace std::literals;
+
+// // // --- PURGE_BACKOFF --- // // //
+
+bool PurgeBackoff::IsDeferred(const domain::AuthorId& id, Clock::time_point now) const {
+    const auto it = retries_.find(*id);
+    return it != retries_.end() && now < it->second.at;
+}
+
+void PurgeBackoff::OnFailure(const domain::AuthorId& id, Clock::time_point now) {
+    const auto [it, inserted] = retries_.try_emplace(*id, Retry{now, retry_delay_});
+    if (!inserted) {
+        it->second.delay = std::min(it->second.delay * 2, max_retry_delay_);
+    }
+    it->second.at = now + it->second.delay;
+}
+
+void PurgeBackoff::OnSuccess(const domain::AuthorId& id) {
+    retries_.erase(*id);
+}
+
+void PurgeBackoff::Retain(std::span<const domain::AuthorId> pending) {
+    std::erase_if(retries_, [pending](const auto& entry) {
+        return std::none_of(pending.begin(), pending.end(), [&entry](const domain::AuthorId& id) {
+            return *id == entry.first;
+        });
+    });
+}
+
+// // // --- PURGE_BACKOFF --- // // //
+
+bool PurgeNextBatch(UnitOfWorkFactory& factory, std::size_t batch_size, PurgeBackoff* backoff) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kBackground, "PurgeWorker::Batch"sv);
+    static metrics::Gauge& backlog = metrics::Registry::Get().RegisterGauge("purge_backlog_authors"sv);
+
+    std::unique_ptr<UnitOfWork> uow = factory.CreateUnitOfWork();
+    const std::vector<domain::AuthorId> pending = uow->GetAuthorRepository().GetDeletedAuthorIds();
+    backlog.Set(static_cast<std::int64_t>(pending.size()));
+    if (pending.empty()) {
+        uow->Commit();
+        return false;
+    }
+
+    auto next = pending.begin();
+    if (backoff) {
+        backoff->Retain(pending);
+        const PurgeBackoff::Clock::time_point now = PurgeBackoff::Clock::now();
+        next = std::find_if(pending.begin(), pending.end(), [backoff, now](const domain::AuthorId& id) {
+            return !backoff->IsDeferred(id, now);
+        });
+        if (next == pending.end()) {
+            uow->Commit();
+            return false;
+        }
+    }
+
+    metrics::ScopedCall call{stats};
+    const domain::AuthorId& author_id = *next;
+    std::vector<domain::BookId> books;
+    bool author_done = false;
+    try {
+        books = uow->GetBookRepository().GetBookIdsByAuthorId(author_id, batch_size);
+        for (const domain::BookId& book_id : books) {
+            uow->GetBookTagRepository().DeleteByBookId(book_id);
+            uow->GetBookRepository().Delete(book_id);
+        }
+        // Неполная порция — последняя: других книг у автора нет
+        author_done = books.size() < batch_size;
+        if (author_done) {
+            uow->GetAuthorRepository().Delete(author_id);
+        }
+        uow->Commit();
+    } catch (const std::exception&) {
+        if (backoff) {
+            backoff->OnFailure(author_id, PurgeBackoff::Clock::now());
+        }
+        throw;
+    }
+    if (backoff) {
+        backoff->OnSuccess(author_id);
+    }
+
+    call.SetRows(books.size());
+    if (author_done) {
+        backlog.Set(static_cast<std::int64_t>(pending.size() - 1));
+    }
+    return true;
+}
+
+PurgeWorker::PurgeWorker(UnitOfWorkFactory& factory, PurgeSettings settings)
+    : factory_{factory}
+    , settings_{settings}
+    , backoff_{settings.retry_delay, settings.max_retry_delay}
+    , thread_{[this] { Loop(); }} {
+}
+
+PurgeWorker::~PurgeWorker() {
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    thread_.join();
+}
+
+void PurgeWorker::Loop() {
+    std::unique_lock lock{mutex_};
+    while (!stop_) {
+        lock.unlock();
+        bool more = false;
+        try {
+            more = PurgeNextBatch(factory_, settings_.batch_size, &backoff_);
+        } catch (const std::exception&) {
+            // Ошибка учтена в метриках пакета. Автор пакета отложен, остальные очищаются после паузы;
+            // если не удалось прочитать саму очередь, всё повторится целиком
+        }
+        lock.lock();
+        stop_cv_.wait_for(lock, more ? settings_.batch_pause : settings_.idle_period, [this] { return stop_; });
+    }
+}
+
+}  // namespace app
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <span>
+#include <thread>
+
+#include "../domain/author.h"
+#include "unit_of_work.h"
+
+namespace app {
+
+struct PurgeSettings {
+    // Не больше стольких книг (вместе с тегами) удаляется одной транзакцией
+    std::size_t batch_size = 100;
+    // Пауза между пакетами ограничивает нагрузку очистки на базу
+    std::chrono::milliseconds batch_pause{50};
+    // Период проверки новых удалений, когда очередь пуста или база недоступна
+    std::chrono::milliseconds idle_period{std::chrono::seconds{1}};
+    // Пауза перед повтором очистки автора после ошибки; удваивается с каждой ошибкой подряд
+    std::chrono::milliseconds retry_delay{std::chrono::seconds{5}};
+    std::chrono::milliseconds max_retry_delay{std::chrono::minutes{5}};
+};
+
+/**
+ * Авторы, очистка которых завершилась ошибкой, и время, до которого их не стоит трогать.
+ * Без этого автор, на котором пакет падает каждый раз, навсегда занял бы начало очереди.
+ */
+class PurgeBackoff {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PurgeBackoff(std::chrono::milliseconds retry_delay, std::chrono::milliseconds max_retry_delay) noexcept
+    : retry_delay_{retry_delay}, max_retry_delay_{max_retry_delay}
+    {
+
+    }
+
+    bool IsDeferred(const domain::AuthorId& id, Clock::time_point now) const;
+    void OnFailure(const domain::AuthorId& id, Clock::time_point now);
+    void OnSuccess(const domain::AuthorId& id);
+    // Забывает авторов, которых больше нет в очереди
+    void Retain(std::span<const domain::AuthorId> pending);
+
+private:
+    struct Retry {
+        Clock::time_point at;
+        std::chrono::milliseconds delay;
+    };
+
+    std::chrono::milliseconds retry_delay_;
+    std::chrono::milliseconds max_retry_delay_;
+    std::map<util::detail::UUIDType, Retry> retries_;
+};
+
+/**
+ * Удаляет очередную порцию данных авторов, помеченных AuthorRepository::MarkDeleted:
+ * до batch_size книг первого автора в очереди вместе с тегами, а когда книг не осталось —
+ * самого автора. Всё выполняется одной транзакцией, поэтому прерванный пакет откатывается
+ * целиком, а следующий вызов продолжает с того же места. Возвращает false, если очередь пуста.
+ *
+ * С backoff авторы, чья очистка недавно не удалась, пропускаются (если других нет, возвращается
+ * false), а ошибка пакета откладывает очищаемого автора перед тем, как исключение уйдёт дальше.
+ */
+bool PurgeNextBatch(UnitOfWorkFactory& factory, std::size_t batch_size, PurgeBackoff* backoff = nullptr);
+
+/**
+ * Фоновый поток, вызывающий PurgeNextBatch с паузами из PurgeSettings. Пометки об удалении
+ * хранятся в базе, поэтому после перезапуска очистка продолжается сама. Автор, на котором
+ * пакет завершился ошибкой, откладывается (PurgeBackoff), и очистка переходит к следующим.
+ *
+ * Метрики: вызовы "PurgeWorker::Batch" (rows — удалённые книги, errors — неудачные пакеты)
+ * и величина "purge_backlog_authors" — число авторов, ожидающих очистки.
+ */
+class PurgeWorker {
+public:
+    explicit PurgeWorker(UnitOfWorkFactory& factory, PurgeSettings settings = {});
+    // Дожидается текущего пакета; недочищенные авторы остаются в очереди
+    ~PurgeWorker();
+
+    PurgeWorker(const PurgeWorker&) = delete;
+    PurgeWorker& operator=(const PurgeWorker&) = delete;
+
+private:
+    void Loop();
+
+    UnitOfWorkFactory& factory_;
+    PurgeSettings settings_;
+    // Используется только потоком очистки
+    PurgeBackoff backoff_;
+
+    std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+}  // namespace app
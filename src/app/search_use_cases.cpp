@@ -0,0 +1,259 @@
+#include "search_use_cases.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/search.h"
+#include "../domain/statistics.h"
+#include "../metrics/metrics.h"
+#include "unit_of_work.h"
+
+namespace app {
+
+using namespace std::literals;
+
+SearchUseCases::SearchUseCases(UseCases& inner)
+    : inner_{inner} {
+    Reload();
+}
+
+void SearchUseCases::Reload() {
+    TagIndex tags{inner_.CompleteTag({}, std::numeric_limits<std::size_t>::max())};
+    TrigramIndex names;
+    for (const domain::AuthorRow author : inner_.GetAllAuthors()) {
+        names.Set(author.GetId(), author.GetName());
+    }
+    for (const domain::BookRow book : inner_.GetAllBooks()) {
+        names.Set(book.GetId(), book.GetTitle(), book.GetAuthorId(), book.GetPublicationYear());
+    }
+    names.ShrinkToFit();
+    std::lock_guard index_lock{index_mutex_};
+    tags_ = std::move(tags);
+    names_ = std::move(names);
+}
+
+void SearchUseCases::UpdateTags(std::span<const std::string> tags, std::int64_t delta) {
+    std::vector<std::string_view> distinct{tags.begin(), tags.end()};
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    for (const std::string_view tag : distinct) {
+        tags_.Add(tag, delta);
+    }
+}
+
+std::mutex& SearchUseCases::BookWriteMutex(const BookId& id) {
+    const util::detail::UUIDType& uuid = *id;
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+    std::memcpy(&high, uuid.data, sizeof(high));
+    std::memcpy(&low, uuid.data + sizeof(high), sizeof(low));
+    return book_write_mutexes_[(high ^ low) % book_write_mutexes_.size()];
+}
+
+// // // --- AUTHOR --- // // //
+
+AuthorId SearchUseCases::AddAuthor(std::string name) {
+    const std::string indexed_name = name;
+    const AuthorId id = inner_.AddAuthor(std::move(name));
+    std::lock_guard index_lock{index_mutex_};
+    names_.Set(id, indexed_name);
+    return id;
+}
+
+bool SearchUseCases::EditAuthor(const AuthorId& id, std::string_view new_name) {
+    if (!inner_.EditAuthor(id, new_name)) {
+        return false;
+    }
+    std::lock_guard index_lock{index_mutex_};
+    names_.Set(id, new_name);
+    return true;
+}
+
+bool SearchUseCases::DeleteAuthor(const AuthorId& id) {
+    // Книги удалённого автора больше не читаются и не учитываются в статистике:
+    // их названия и теги уходят из индексов вместе с ним
+    // Прежнее состояние читается с основной базы: устаревшая реплика дала бы не те теги
+    const PrimaryReadScope primary_read;
+    std::vector<domain::BookId> books;
+    for (const domain::BookRow book : inner_.GetBooksByAuthorId(id)) {
+        books.push_back(book.GetId());
+    }
+    const std::vector<domain::TagBookCount> tags = inner_.GetTagsByAuthorId(id);
+    if (!inner_.DeleteAuthor(id)) {
+        return false;
+    }
+    std::lock_guard index_lock{index_mutex_};
+    for (const domain::TagBookCount& tag : tags) {
+        tags_.Add(tag.tag, -tag.books);
+    }
+    names_.Erase(id);
+    for (const domain::BookId& book_id : books) {
+        names_.Erase(book_id);
+    }
+    return true;
+}
+
+std::optional<domain::Author> SearchUseCases::GetAuthorByName(std::string_view name) const {
+    return inner_.GetAuthorByName(name);
+}
+
+std::optional<domain::Author> SearchUseCases::GetAuthorById(const AuthorId& id) const {
+    return inner_.GetAuthorById(id);
+}
+
+domain::AuthorRows SearchUseCases::GetAllAuthors() const {
+    return inner_.GetAllAuthors();
+}
+
+domain::AuthorRows SearchUseCases::GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const {
+    return inner_.GetAuthorsByNamePrefix(prefix, limit);
+}
+
+// // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // //
+
+BookId SearchUseCases::AddBookByAuthorId(
+    const domain::AuthorId& author_id,
+    std::string title,
+    int publication_year,
+    std::span<const std::string> tags
+) {
+    const std::string indexed_title = title;
+    const BookId id = inner_.AddBookByAuthorId(author_id, std::move(title), publication_year, tags);
+    std::lock_guard index_lock{index_mutex_};
+    UpdateTags(tags, 1);
+    names_.Set(id, indexed_title, author_id, publication_year);
+    return id;
+}
+
+BookId SearchUseCases::AddBookByAuthorName(
+    std::string author_name,
+    std::string title,
+    int publication_year,
+    std::span<const std::string> tags
+) {
+    const std::string indexed_title = title;
+    const std::string indexed_name = author_name;
+    const BookId id = inner_.AddBookByAuthorName(std::move(author_name), std::move(title), publication_year, tags);
+    // Автор мог быть создан вместе с книгой
+    const std::optional<domain::Author> author = [&] {
+        const PrimaryReadScope primary_read;
+        return inner_.GetAuthorByName(indexed_name);
+    }();
+    std::lock_guard index_lock{index_mutex_};
+    UpdateTags(tags, 1);
+    if (author) {
+        names_.Set(id, indexed_title, author->GetId(), publication_year);
+        if (!names_.Contains(author->GetId())) {
+            names_.Set(author->GetId(), author->GetName());
+        }
+    }
+    return id;
+}
+
+std::optional<domain::Book> SearchUseCases::EditBook(
+    const BookId& id,
+    std::string_view title,
+    int publication_year,
+    std::span<const std::string> tags
+) {
+    // Прежние теги, которые нужно вычесть из индекса, возвращает сама запись
+    std::lock_guard write_lock{BookWriteMutex(id)};
+    std::optional<domain::Book> book = inner_.EditBook(id, title, publication_year, tags);
+    if (!book) {
+        return book;
+    }
+    std::lock_guard index_lock{index_mutex_};
+    UpdateTags(book->GetTags(), -1);
+    UpdateTags(tags, 1);
+    names_.Set(id, title, book->GetAuthorId(), publication_year);
+    return book;
+}
+
+std::optional<domain::Book> SearchUseCases::DeleteBook(const BookId& id) {
+    std::lock_guard write_lock{BookWriteMutex(id)};
+    std::optional<domain::Book> book = inner_.DeleteBook(id);
+    if (!book) {
+        return book;
+    }
+    std::lock_guard index_lock{index_mutex_};
+    UpdateTags(book->GetTags(), -1);
+    names_.Erase(id);
+    return book;
+}
+
+std::optional<domain::Book> SearchUseCases::GetBook(const BookId& id) const {
+    return inner_.GetBook(id);
+}
+
+std::vector<domain::Book> SearchUseCases::GetBooksByTitle(std::string_view title) const {
+    return inner_.GetBooksByTitle(title);
+}
+
+domain::BookRows SearchUseCases::GetAllBooks() const {
+    return inner_.GetAllBooks();
+}
+
+domain::BookRows SearchUseCases::GetBooksByAuthorId(const domain::AuthorId& author_id) const {
+    return inner_.GetBooksByAuthorId(author_id);
+}
+
+domain::BookRows SearchUseCases::GetBooksByYearRange(int from, int to) const {
+    return inner_.GetBooksByYearRange(from, to);
+}
+
+domain::BookRows SearchUseCases::GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const {
+    return inner_.GetBooksByTitlePrefix(prefix, limit);
+}
+
+std::vector<domain::TagBookCount> SearchUseCases::GetTagsByAuthorId(const domain::AuthorId& author_id) const {
+    return inner_.GetTagsByAuthorId(author_id);
+}
+
+// // // --- BOOK --- // // //
+//
+//
+//
+// // // --- STATISTICS --- // // //
+
+domain::CatalogStatistics SearchUseCases::GetStatistics(std::size_t top_n) const {
+    return inner_.GetStatistics(top_n);
+}
+
+// // // --- STATISTICS --- // // //
+//
+//
+//
+// // // --- SEARCH --- // // //
+
+std::vector<domain::TagBookCount> SearchUseCases::CompleteTag(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "CompleteTag"sv);
+    metrics::ScopedCall call{stats, true};
+    std::shared_lock lock{index_mutex_};
+    std::vector<domain::TagBookCount> tags = tags_.Complete(prefix, limit);
+    call.SetRows(tags.size());
+    return tags;
+}
+
+std::vector<domain::FuzzyMatch> SearchUseCases::FuzzyFind(std::string_view text, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "FuzzyFind"sv);
+    metrics::ScopedCall call{stats, true};
+    std::shared_lock lock{index_mutex_};
+    std::vector<domain::FuzzyMatch> matches = names_.Find(text, limit);
+    call.SetRows(matches.size());
+    return matches;
+}
+
+// // // --- SEARCH --- // // //
+
+}  // namespace app
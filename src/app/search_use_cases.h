@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+#include "tag_index.h"
+#include "trigram_index.h"
+#include "use_cases.h"
+
+namespace app {
+
+/**
+ * Обслуживает поиск из индексов в памяти процесса, остальное передаёт в inner.
+ *
+ * Индекс тегов (TagIndex) строится при создании по счётчикам inner.CompleteTag и после
+ * каждой успешной записи книги через этот объект получает изменения её тегов. Индекс
+ * триграмм (TrigramIndex) строится по всем авторам и книгам и так же следует за записями
+ * авторов и книг. Записи разных сессий идут в хранилище параллельно: прежние теги книги
+ * возвращает сама запись, а блокировка индексов берётся только на время их обновления.
+ * Правки и удаления одной книги идут по очереди вместе с обновлением индексов, чтобы
+ * индексы получали их в порядке фиксации.
+ *
+ * Как и из счётчиков статистики, книги удалённого автора убираются из обоих индексов сразу,
+ * не дожидаясь их очистки. Изменения, сделанные в обход этого объекта, а также книга,
+ * добавленная автору одновременно с его удалением, видны индексам после Reload.
+ */
+class SearchUseCases : public UseCases {
+public:
+    explicit SearchUseCases(UseCases& inner);
+
+    SearchUseCases(const SearchUseCases&) = delete;
+    SearchUseCases& operator=(const SearchUseCases&) = delete;
+
+    // Строит индексы заново по содержимому хранилища; записи, идущие через этот объект
+    // во время перестроения, могут в новые индексы не попасть
+    void Reload();
+
+    // // // --- AUTHOR --- // // //
+
+    AuthorId AddAuthor(std::string name) override;
+    bool EditAuthor(const AuthorId& id, std::string_view new_name) override;
+    bool DeleteAuthor(const AuthorId& id) override;
+
+    std::optional<domain::Author> GetAuthorByName(std::string_view name) const override;
+    std::optional<domain::Author> GetAuthorById(const AuthorId& id) const override;
+
+    domain::AuthorRows GetAllAuthors() const override;
+    domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override;
+
+    // // // --- AUTHOR --- // // //
+    //
+    //
+    //
+    // // // --- BOOK --- // // //
+
+    BookId AddBookByAuthorId(
+        const domain::AuthorId& author_id,
+        std::string title,
+        int publication_year,
+        std::span<const std::string> tags
+    ) override;
+    BookId AddBookByAuthorName(
+        std::string author_name,
+        std::string title,
+        int publication_year,
+        std::span<const std::string> tags
+    ) override;
+    std::optional<domain::Book> EditBook(
+        const BookId& id,
+        std::string_view title,
+        int publication_year,
+        std::span<const std::string> tags
+    ) override;
+    std::optional<domain::Book> DeleteBook(const BookId& id) override;
+
+    std::optional<domain::Book> GetBook(const BookId& id) const override;
+    std::vector<domain::Book> GetBooksByTitle(std::string_view title) const override;
+    domain::BookRows GetAllBooks() const override;
+    domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const override;
+    domain::BookRows GetBooksByYearRange(int from, int to) const override;
+    domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override;
+    std::vector<domain::TagBookCount> GetTagsByAuthorId(const domain::AuthorId& author_id) const override;
+
+    // // // --- BOOK --- // // //
+    //
+    //
+    //
+    // // // --- STATISTICS --- // // //
+
+    domain::CatalogStatistics GetStatistics(std::size_t top_n) const override;
+
+    // // // --- STATISTICS --- // // //
+    //
+    //
+    //
+    // // // --- SEARCH --- // // //
+
+    std::vector<domain::TagBookCount> CompleteTag(std::string_view prefix, std::size_t limit) const override;
+    std::vector<domain::FuzzyMatch> FuzzyFind(std::string_view text, std::size_t limit) const override;
+
+    // // // --- SEARCH --- // // //
+
+private:
+    // Добавляет delta к числу книг каждого из различных тегов tags; вызывается под index_mutex_
+    void UpdateTags(std::span<const std::string> tags, std::int64_t delta);
+
+    // Очередь записей книги id; разные книги могут делить одну очередь
+    std::mutex& BookWriteMutex(const BookId& id);
+
+    UseCases& inner_;
+    std::array<std::mutex, 64> book_write_mutexes_;
+    mutable std::shared_mutex index_mutex_;
+    TagIndex tags_;
+    // Имена авторов и названия книг
+    TrigramIndex names_;
+};
+
+}  // namespace app
@@ -0,0 +1,90 @@
+#include "shard_rebalance.h"
+
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "sharded_unit_of_work.h"
+
+namespace app {
+
+using namespace std::literals;
+
+namespace {
+
+struct BookWithTags {
+    domain::Book book;
+    std::vector<std::string> tags;
+};
+
+std::vector<BookWithTags> ReadBooks(UnitOfWork& uow, const domain::AuthorId& author_id) {
+    std::vector<BookWithTags> books;
+    for (const domain::BookRow row : uow.GetBookRepository().GetBooksByAuthorId(author_id)) {
+        domain::Book book{row.GetId(), author_id, std::string{row.GetTitle()}, row.GetPublicationYear()};
+        std::vector<std::string> tags = uow.GetBookTagRepository().GetTags(book.GetId());
+        books.push_back({std::move(book), std::move(tags)});
+    }
+    return books;
+}
+
+}  // namespace
+
+RebalanceStats RebalanceShards(const std::vector<UnitOfWorkFactory*>& shards, bool dry_run, std::ostream* log) {
+    RebalanceStats stats;
+    for (std::size_t source = 0; source < shards.size(); ++source) {
+        std::vector<domain::Author> misplaced;
+        {
+            std::unique_ptr<UnitOfWork> uow = shards[source]->CreateUnitOfWork();
+            for (const domain::AuthorRow row : uow->GetAuthorRepository().GetAllAuthors()) {
+                ++stats.authors_checked;
+                if (ShardOfAuthor(row.GetId(), shards.size()) != source) {
+                    misplaced.emplace_back(row.GetId(), std::string{row.GetName()});
+                }
+            }
+            uow->Commit();
+        }
+
+        for (const domain::Author& author : misplaced) {
+            const std::size_t target = ShardOfAuthor(author.GetId(), shards.size());
+            std::unique_ptr<UnitOfWork> from = shards[source]->CreateUnitOfWork();
+            const std::vector<BookWithTags> books = ReadBooks(*from, author.GetId());
+
+            if (!dry_run) {
+                std::unique_ptr<UnitOfWork> to = shards[target]->CreateUnitOfWork();
+                to->GetAuthorRepository().Save(author);
+                for (const auto& [book, tags] : books) {
+                    to->GetBookRepository().Save(book);
+                    // Копия могла остаться от прерванного запуска: теги перезаписываются целиком
+                    to->GetBookTagRepository().DeleteByBookId(book.GetId());
+                    for (const std::string& tag : tags) {
+                        to->GetBookTagRepository().Save(book.GetId(), tag);
+                    }
+                }
+                to->Commit();
+
+                for (const auto& [book, tags] : books) {
+                    from->GetBookTagRepository().DeleteByBookId(book.GetId());
+                }
+                from->GetBookRepository().DeleteBooksByAuthorId(author.GetId());
+                from->GetAuthorRepository().Delete(author.GetId());
+            }
+            from->Commit();
+
+            ++stats.authors_moved;
+            stats.books_moved += books.size();
+            for (const BookWithTags& book : books) {
+                stats.tags_moved += book.tags.size();
+            }
+            if (log) {
+                *log << author.GetId().ToChars().View() << ' ' << source << " -> "sv << target << " books="sv
+                     << books.size() << '\n';
+            }
+        }
+    }
+    return stats;
+}
+
+}  // namespace app
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+#include "unit_of_work.h"
+
+namespace app {
+
+struct RebalanceStats {
+    std::size_t authors_checked = 0;
+    std::size_t authors_moved = 0;
+    std::size_t books_moved = 0;
+    std::size_t tags_moved = 0;
+};
+
+/**
+ * Переносит каждого автора, лежащего не на шарде ShardOfAuthor, вместе с книгами и тегами.
+ * Используется после добавления шардов в конец списка: благодаря jump consistent hash
+ * авторы переезжают только на новые шарды.
+ *
+ * Автор переносится двумя транзакциями: копия на целевом шарде фиксируется раньше
+ * удаления с исходного, поэтому сбой между ними оставляет дубль, а не потерю данных;
+ * повторный запуск перезаписывает копию и удаляет оригинал. Запись в переносимых
+ * авторов во время работы может потеряться: запускать при остановленной записи.
+ * С dry_run только подсчитывает, что было бы перенесено. Если задан log,
+ * пишет в него строку на каждого перенесённого автора.
+ */
+RebalanceStats RebalanceShards(const std::vector<UnitOfWorkFactory*>& shards, bool dry_run = false,
+                               std::ostream* log = nullptr);
+
+}  // namespace app
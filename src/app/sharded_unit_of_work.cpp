@@ -0,0 +1,607 @@
+#include "sharded_unit_of_work.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../metrics/metrics.h"
+#include "k_way_merge.h"
+
+namespace app {
+
+using namespace std::literals;
+
+namespace {
+
+std::uint64_t Mix(std::uint64_t x) noexcept {
+    // Финализатор splitmix64: у UUIDv7 старшие биты — время, их нужно перемешать
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+std::size_t JumpConsistentHash(std::uint64_t key, std::size_t bucket_count) noexcept {
+    std::int64_t bucket = -1;
+    std::int64_t next = 0;
+    while (next < static_cast<std::int64_t>(bucket_count)) {
+        bucket = next;
+        key = key * 2862933555777941757ull + 1;
+        next = static_cast<std::int64_t>(static_cast<double>(bucket + 1)
+                                         * (static_cast<double>(1ll << 31) / static_cast<double>((key >> 33) + 1)));
+    }
+    return static_cast<std::size_t>(bucket);
+}
+
+// Списки шардов, слитые в один без копирования строк; остаются первые limit строк
+class MergedAuthorRowSource : public domain::AuthorRowSource {
+public:
+    explicit MergedAuthorRowSource(std::vector<domain::AuthorRows> parts,
+                                   std::size_t limit = std::numeric_limits<std::size_t>::max())
+    : parts_{std::move(parts)}
+    {
+        std::vector<std::size_t> sizes;
+        sizes.reserve(parts_.size());
+        for (const domain::AuthorRows& part : parts_) {
+            sizes.push_back(part.Size());
+        }
+        // Порядок частей повторяет ORDER BY name USING ~<~ запроса шарда: оба побайтовые
+        order_ = MergeSorted(sizes, [this](const RowRef& lhs, const RowRef& rhs) {
+            return Row(lhs).GetName() < Row(rhs).GetName();
+        }, limit);
+    }
+
+    std::size_t Size() const noexcept override {
+        return order_.size();
+    }
+
+    domain::AuthorId GetId(std::size_t row) const override {
+        return Row(order_[row]).GetId();
+    }
+
+    std::string_view GetName(std::size_t row) const noexcept override {
+        return Row(order_[row]).GetName();
+    }
+
+private:
+    domain::AuthorRow Row(const RowRef& ref) const noexcept {
+        return parts_[ref.part][ref.index];
+    }
+
+    std::vector<domain::AuthorRows> parts_;
+    std::vector<RowRef> order_;
+};
+
+// Порядок ORDER BY title USING ~<~, name USING ~<~, publication_year запросов GetAllBooks
+// и GetBooksByTitlePrefix: строки сравниваются побайтово, а не по правилам сортировки базы
+bool TitleOrder(const domain::BookRow& lhs, const domain::BookRow& rhs) {
+    return std::tuple{lhs.GetTitle(), lhs.GetAuthorName(), lhs.GetPublicationYear()}
+         < std::tuple{rhs.GetTitle(), rhs.GetAuthorName(), rhs.GetPublicationYear()};
+}
+
+// Порядок ORDER BY publication_year, title USING ~<~, name USING ~<~ запроса GetBooksByYearRange
+bool YearOrder(const domain::BookRow& lhs, const domain::BookRow& rhs) {
+    return std::tuple{lhs.GetPublicationYear(), lhs.GetTitle(), lhs.GetAuthorName()}
+         < std::tuple{rhs.GetPublicationYear(), rhs.GetTitle(), rhs.GetAuthorName()};
+}
+
+class MergedBookRowSource : public domain::BookRowSource {
+public:
+    // Части упорядочены по less, так же будет упорядочен и общий список
+    MergedBookRowSource(std::vector<domain::BookRows> parts, bool (*less)(const domain::BookRow&, const domain::BookRow&),
+                        std::size_t limit = std::numeric_limits<std::size_t>::max())
+    : parts_{std::move(parts)}
+    {
+        std::vector<std::size_t> sizes;
+        sizes.reserve(parts_.size());
+        for (const domain::BookRows& part : parts_) {
+            sizes.push_back(part.Size());
+        }
+        order_ = MergeSorted(sizes, [this, less](const RowRef& lhs, const RowRef& rhs) {
+            return less(Row(lhs), Row(rhs));
+        }, limit);
+    }
+
+    std::size_t Size() const noexcept override {
+        return order_.size();
+    }
+
+    domain::BookId GetId(std::size_t row) const override {
+        return Row(order_[row]).GetId();
+    }
+
+    domain::AuthorId GetAuthorId(std::size_t row) const override {
+        return Row(order_[row]).GetAuthorId();
+    }
+
+    std::string_view GetTitle(std::size_t row) const noexcept override {
+        return Row(order_[row]).GetTitle();
+    }
+
+    int GetPublicationYear(std::size_t row) const override {
+        return Row(order_[row]).GetPublicationYear();
+    }
+
+    std::string_view GetAuthorName(std::size_t row) const noexcept override {
+        return Row(order_[row]).GetAuthorName();
+    }
+
+private:
+    domain::BookRow Row(const RowRef& ref) const noexcept {
+        return parts_[ref.part][ref.index];
+    }
+
+    std::vector<domain::BookRows> parts_;
+    std::vector<RowRef> order_;
+};
+
+}  // namespace
+
+std::size_t ShardOfAuthor(const domain::AuthorId& id, std::size_t shard_count) noexcept {
+    const util::detail::UUIDType& uuid = *id;
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+    std::memcpy(&high, uuid.data, sizeof(high));
+    std::memcpy(&low, uuid.data + sizeof(high), sizeof(low));
+    return JumpConsistentHash(Mix(high ^ Mix(low)), shard_count);
+}
+
+ShardedUnitOfWork::ShardedUnitOfWork(std::vector<UnitOfWorkFactory*> shards, bool read_only)
+    : factories_{std::move(shards)}
+    , read_only_{read_only} {
+    shards_.reserve(factories_.size());
+    for (UnitOfWorkFactory* factory : factories_) {
+        shards_.push_back(read_only_ ? factory->CreateReadOnlyUnitOfWork() : factory->CreateUnitOfWork());
+    }
+}
+
+void ShardedUnitOfWork::Commit() {
+    for (const std::unique_ptr<UnitOfWork>& shard : shards_) {
+        shard->Commit();
+    }
+}
+
+UnitOfWork& ShardedUnitOfWork::Shard(std::size_t index) {
+    return *shards_[index];
+}
+
+std::size_t ShardedUnitOfWork::ShardIndexOf(const domain::AuthorId& author_id) const {
+    if (const auto it = deleted_author_shards_.find(*author_id); it != deleted_author_shards_.end()) {
+        return it->second;
+    }
+    return ShardOfAuthor(author_id, shards_.size());
+}
+
+UnitOfWork& ShardedUnitOfWork::ShardOf(const domain::AuthorId& author_id) {
+    return Shard(ShardIndexOf(author_id));
+}
+
+template <typename Fn>
+auto ShardedUnitOfWork::FanOut(Fn&& fn) {
+    using Result = std::invoke_result_t<Fn&, UnitOfWork&>;
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "ShardedUnitOfWork::FanOut"sv);
+    metrics::ScopedCall call{stats};
+
+    // Соединения уже взяты в конструкторе, в потоках выполняются только запросы
+    std::vector<std::future<Result>> pending;
+    pending.reserve(shards_.size() - 1);
+    for (std::size_t i = 1; i < shards_.size(); ++i) {
+        pending.push_back(std::async(std::launch::async, [&fn, &shard = *shards_[i]] {
+            return fn(shard);
+        }));
+    }
+    std::vector<Result> results;
+    results.reserve(shards_.size());
+    // Если запрос бросит исключение, деструкторы futures дождутся остальных шардов
+    results.push_back(fn(*shards_[0]));
+    for (std::future<Result>& result : pending) {
+        results.push_back(result.get());
+    }
+    call.SetRows(shards_.size());
+    return results;
+}
+
+std::optional<std::size_t> ShardedUnitOfWork::FindBookShard(const domain::BookId& id) {
+    if (const auto it = book_shards_.find(*id); it != book_shards_.end()) {
+        return it->second;
+    }
+    books_.GetBookById(id);
+    if (const auto it = book_shards_.find(*id); it != book_shards_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+// // // --- AUTHOR --- // // //
+
+void ShardedUnitOfWork::Authors::RequireUniqueName(const domain::AuthorId& id, std::string_view name) const {
+    const std::optional<domain::Author> existing = GetAuthorByName(name);
+    if (existing && existing->GetId() != id) {
+        throw std::invalid_argument("Author name is already taken: "s + std::string{name});
+    }
+}
+
+void ShardedUnitOfWork::Authors::Save(const domain::Author& author) {
+    RequireUniqueName(author.GetId(), author.GetName());
+    uow_.ShardOf(author.GetId()).GetAuthorRepository().Save(author);
+}
+
+void ShardedUnitOfWork::Authors::Edit(const domain::AuthorId& id, std::string_view new_name) {
+    RequireUniqueName(id, new_name);
+    uow_.ShardOf(id).GetAuthorRepository().Edit(id, new_name);
+}
+
+void ShardedUnitOfWork::Authors::Delete(const domain::AuthorId& id) {
+    uow_.ShardOf(id).GetAuthorRepository().Delete(id);
+}
+
+void ShardedUnitOfWork::Authors::MarkDeleted(const domain::AuthorId& id) {
+    uow_.ShardOf(id).GetAuthorRepository().MarkDeleted(id);
+}
+
+domain::AuthorRows ShardedUnitOfWork::Authors::GetAllAuthors() const {
+    std::vector<domain::AuthorRows> parts = uow_.FanOut([](UnitOfWork& shard) {
+        return shard.GetAuthorRepository().GetAllAuthors();
+    });
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    return domain::AuthorRows{std::make_unique<MergedAuthorRowSource>(std::move(parts))};
+}
+
+domain::AuthorRows ShardedUnitOfWork::Authors::GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const {
+    // Первые limit общего списка — среди первых limit каждого шарда
+    std::vector<domain::AuthorRows> parts = uow_.FanOut([prefix, limit](UnitOfWork& shard) {
+        return shard.GetAuthorRepository().GetAuthorsByNamePrefix(prefix, limit);
+    });
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    return domain::AuthorRows{std::make_unique<MergedAuthorRowSource>(std::move(parts), limit)};
+}
+
+std::optional<domain::Author> ShardedUnitOfWork::Authors::GetAuthorByName(std::string_view name) const {
+    std::vector<std::optional<domain::Author>> found = uow_.FanOut([name](UnitOfWork& shard) {
+        return shard.GetAuthorRepository().GetAuthorByName(name);
+    });
+    for (std::optional<domain::Author>& author : found) {
+        if (author) {
+            return std::move(author);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<domain::Author> ShardedUnitOfWork::Authors::GetAuthorById(const domain::AuthorId& id) const {
+    return uow_.ShardOf(id).GetAuthorRepository().GetAuthorById(id);
+}
+
+std::vector<domain::AuthorId> ShardedUnitOfWork::Authors::GetDeletedAuthorIds() const {
+    std::vector<std::vector<domain::AuthorId>> parts = uow_.FanOut([](UnitOfWork& shard) {
+        return shard.GetAuthorRepository().GetDeletedAuthorIds();
+    });
+    // Порядок удаления сохраняется только в пределах шарда: очистке он не важен
+    std::vector<domain::AuthorId> ids;
+    for (std::size_t shard = 0; shard < parts.size(); ++shard) {
+        for (domain::AuthorId& id : parts[shard]) {
+            uow_.deleted_author_shards_.insert_or_assign(*id, shard);
+            ids.push_back(std::move(id));
+        }
+    }
+    return ids;
+}
+
+// // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // //
+
+void ShardedUnitOfWork::Books::Save(const domain::Book& book) {
+    const std::size_t shard = ShardOfAuthor(book.GetAuthorId(), uow_.shards_.size());
+    uow_.Shard(shard).GetBookRepository().Save(book);
+    uow_.book_shards_.insert_or_assign(*book.GetId(), shard);
+}
+
+void ShardedUnitOfWork::Books::Edit(const domain::BookId& id, std::string_view title, int publication_year) {
+    if (const std::optional<std::size_t> shard = uow_.FindBookShard(id)) {
+        uow_.Shard(*shard).GetBookRepository().Edit(id, title, publication_year);
+    }
+}
+
+void ShardedUnitOfWork::Books::Delete(const domain::BookId& id) {
+    if (const std::optional<std::size_t> shard = uow_.FindBookShard(id)) {
+        uow_.Shard(*shard).GetBookRepository().Delete(id);
+    }
+}
+
+std::optional<domain::Book> ShardedUnitOfWork::Books::GetBookById(const domain::BookId& id) {
+    if (const auto it = uow_.book_shards_.find(*id); it != uow_.book_shards_.end()) {
+        return uow_.Shard(it->second).GetBookRepository().GetBookById(id);
+    }
+    std::vector<std::optional<domain::Book>> found = uow_.FanOut([&id](UnitOfWork& shard) {
+        return shard.GetBookRepository().GetBookById(id);
+    });
+    for (std::size_t shard = 0; shard < found.size(); ++shard) {
+        if (found[shard]) {
+            uow_.book_shards_.insert_or_assign(*id, shard);
+            return std::move(found[shard]);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<domain::Book> ShardedUnitOfWork::Books::GetBookByIdForUpdate(const domain::BookId& id) {
+    if (const std::optional<std::size_t> shard = uow_.FindBookShard(id)) {
+        return uow_.Shard(*shard).GetBookRepository().GetBookByIdForUpdate(id);
+    }
+    return std::nullopt;
+}
+
+std::vector<domain::Book> ShardedUnitOfWork::Books::GetBooksByTitle(std::string_view title) {
+    std::vector<std::vector<domain::Book>> parts = uow_.FanOut([title](UnitOfWork& shard) {
+        return shard.GetBookRepository().GetBooksByTitle(title);
+    });
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    std::vector<std::size_t> sizes;
+    sizes.reserve(parts.size());
+    for (const std::vector<domain::Book>& part : parts) {
+        sizes.push_back(part.size());
+    }
+    // Порядок частей повторяет ORDER BY name USING ~<~, publication_year запроса шарда
+    const std::vector<RowRef> order = MergeSorted(sizes, [&parts](const RowRef& lhs, const RowRef& rhs) {
+        const domain::Book& left = parts[lhs.part][lhs.index];
+        const domain::Book& right = parts[rhs.part][rhs.index];
+        if (left.GetAuthorName() != right.GetAuthorName()) {
+            return left.GetAuthorName() < right.GetAuthorName();
+        }
+        return left.GetPublicationYear() < right.GetPublicationYear();
+    });
+    std::vector<domain::Book> books;
+    books.reserve(order.size());
+    for (const RowRef& ref : order) {
+        books.push_back(std::move(parts[ref.part][ref.index]));
+    }
+    return books;
+}
+
+domain::BookRows ShardedUnitOfWork::Books::GetAllBooks() {
+    std::vector<domain::BookRows> parts = uow_.FanOut([](UnitOfWork& shard) {
+        return shard.GetBookRepository().GetAllBooks();
+    });
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    return domain::BookRows{std::make_unique<MergedBookRowSource>(std::move(parts), TitleOrder)};
+}
+
+domain::BookRows ShardedUnitOfWork::Books::GetBooksByAuthorId(const domain::AuthorId& author_id) const {
+    const std::size_t shard = ShardOfAuthor(author_id, uow_.shards_.size());
+    domain::BookRows books = uow_.Shard(shard).GetBookRepository().GetBooksByAuthorId(author_id);
+    // DeleteAuthor следом удаляет теги каждой книги: их шард уже известен
+    for (const domain::BookRow book : books) {
+        uow_.book_shards_.insert_or_assign(*book.GetId(), shard);
+    }
+    return books;
+}
+
+domain::BookRows ShardedUnitOfWork::Books::GetBooksByYearRange(int from, int to) const {
+    std::vector<domain::BookRows> parts = uow_.FanOut([from, to](UnitOfWork& shard) {
+        return shard.GetBookRepository().GetBooksByYearRange(from, to);
+    });
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    return domain::BookRows{std::make_unique<MergedBookRowSource>(std::move(parts), YearOrder)};
+}
+
+domain::BookRows ShardedUnitOfWork::Books::GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const {
+    std::vector<domain::BookRows> parts = uow_.FanOut([prefix, limit](UnitOfWork& shard) {
+        return shard.GetBookRepository().GetBooksByTitlePrefix(prefix, limit);
+    });
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    return domain::BookRows{std::make_unique<MergedBookRowSource>(std::move(parts), TitleOrder, limit)};
+}
+
+std::vector<domain::BookId> ShardedUnitOfWork::Books::GetBookIdsByAuthorId(const domain::AuthorId& author_id,
+                                                                          std::size_t limit) const {
+    const std::size_t shard = uow_.ShardIndexOf(author_id);
+    std::vector<domain::BookId> ids = uow_.Shard(shard).GetBookRepository().GetBookIdsByAuthorId(author_id, limit);
+    for (const domain::BookId& id : ids) {
+        uow_.book_shards_.insert_or_assign(*id, shard);
+    }
+    return ids;
+}
+
+void ShardedUnitOfWork::Books::DeleteBooksByAuthorId(const domain::AuthorId& author_id) {
+    uow_.ShardOf(author_id).GetBookRepository().DeleteBooksByAuthorId(author_id);
+}
+
+// // // --- BOOK --- // // //
+//
+//
+//
+// // // --- BOOK_TAG --- // // //
+
+void ShardedUnitOfWork::BookTags::Save(const domain::BookId& book_id, std::string_view tag) {
+    const std::optional<std::size_t> shard = uow_.FindBookShard(book_id);
+    if (!shard) {
+        throw std::logic_error("Tagged book is not stored on any shard"s);
+    }
+    uow_.Shard(*shard).GetBookTagRepository().Save(book_id, tag);
+}
+
+void ShardedUnitOfWork::BookTags::DeleteByBookId(const domain::BookId& book_id) {
+    if (const std::optional<std::size_t> shard = uow_.FindBookShard(book_id)) {
+        uow_.Shard(*shard).GetBookTagRepository().DeleteByBookId(book_id);
+    }
+}
+
+std::vector<std::string> ShardedUnitOfWork::BookTags::GetTags(const domain::BookId& book_id) const {
+    if (const std::optional<std::size_t> shard = uow_.FindBookShard(book_id)) {
+        return uow_.Shard(*shard).GetBookTagRepository().GetTags(book_id);
+    }
+    return {};
+}
+
+std::vector<domain::TagBookCount> ShardedUnitOfWork::BookTags::GetTagCountsByAuthorId(
+    const domain::AuthorId& author_id
+) const {
+    // Книги автора и их теги лежат на его шарде
+    return uow_.Shard(uow_.ShardIndexOf(author_id)).GetBookTagRepository().GetTagCountsByAuthorId(author_id);
+}
+
+// // // --- BOOK_TAG --- // // //
+//
+//
+//
+// // // --- STATISTICS --- // // //
+
+domain::CatalogTotals ShardedUnitOfWork::Statistics::GetTotals() const {
+    const std::vector<domain::CatalogTotals> parts = uow_.FanOut([](UnitOfWork& shard) {
+        return shard.GetStatisticsRepository().GetTotals();
+    });
+    domain::CatalogTotals totals;
+    for (const domain::CatalogTotals& part : parts) {
+        totals.authors += part.authors;
+        totals.books += part.books;
+    }
+    totals.tags = parts.size() == 1 ? parts.front().tags : static_cast<std::int64_t>(GetAllTagCounts({}).size());
+    return totals;
+}
+
+std::vector<domain::AuthorBookCount> ShardedUnitOfWork::Statistics::GetTopAuthors(std::size_t limit) const {
+    std::vector<std::vector<domain::AuthorBookCount>> parts = uow_.FanOut([limit](UnitOfWork& shard) {
+        return shard.GetStatisticsRepository().GetTopAuthors(limit);
+    });
+    std::vector<domain::AuthorBookCount> authors;
+    for (std::vector<domain::AuthorBookCount>& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(authors));
+    }
+    std::sort(authors.begin(), authors.end(), [](const domain::AuthorBookCount& lhs, const domain::AuthorBookCount& rhs) {
+        return std::tie(rhs.books, *lhs.author_id) < std::tie(lhs.books, *rhs.author_id);
+    });
+    if (authors.size() > limit) {
+        authors.erase(authors.begin() + static_cast<std::ptrdiff_t>(limit), authors.end());
+    }
+    return authors;
+}
+
+std::vector<domain::TagBookCount> ShardedUnitOfWork::Statistics::GetTopTags(std::size_t limit) const {
+    return GetTopTagsByPrefix({}, limit);
+}
+
+std::vector<domain::TagBookCount> ShardedUnitOfWork::Statistics::GetTopTagsByPrefix(
+    std::string_view prefix, std::size_t limit
+) const {
+    if (uow_.shards_.size() == 1) {
+        return uow_.Shard(0).GetStatisticsRepository().GetTopTagsByPrefix(prefix, limit);
+    }
+    std::vector<domain::TagBookCount> tags;
+    for (auto& [tag, books] : GetAllTagCounts(prefix)) {
+        tags.push_back({tag, books});
+    }
+    const auto by_books = [](const domain::TagBookCount& lhs, const domain::TagBookCount& rhs) {
+        return std::tie(rhs.books, lhs.tag) < std::tie(lhs.books, rhs.tag);
+    };
+    if (limit < tags.size()) {
+        std::partial_sort(tags.begin(), tags.begin() + static_cast<std::ptrdiff_t>(limit), tags.end(), by_books);
+        tags.erase(tags.begin() + static_cast<std::ptrdiff_t>(limit), tags.end());
+    } else {
+        std::sort(tags.begin(), tags.end(), by_books);
+    }
+    return tags;
+}
+
+std::vector<domain::YearBookCount> ShardedUnitOfWork::Statistics::GetBooksPerYear() const {
+    const std::vector<std::vector<domain::YearBookCount>> parts = uow_.FanOut([](UnitOfWork& shard) {
+        return shard.GetStatisticsRepository().GetBooksPerYear();
+    });
+    std::map<int, std::int64_t> books_per_year;
+    for (const std::vector<domain::YearBookCount>& part : parts) {
+        for (const domain::YearBookCount& year : part) {
+            books_per_year[year.publication_year] += year.books;
+        }
+    }
+    std::vector<domain::YearBookCount> years;
+    years.reserve(books_per_year.size());
+    for (const auto& [year, books] : books_per_year) {
+        years.push_back({year, books});
+    }
+    return years;
+}
+
+domain::StatisticsDrift ShardedUnitOfWork::Statistics::Verify() const {
+    const std::vector<domain::StatisticsDrift> parts = uow_.FanOut([](UnitOfWork& shard) {
+        return shard.GetStatisticsRepository().Verify();
+    });
+    domain::StatisticsDrift drift;
+    for (const domain::StatisticsDrift& part : parts) {
+        drift.authors += part.authors;
+        drift.tags += part.tags;
+        drift.years += part.years;
+        drift.totals += part.totals;
+        drift.orphan_tags += part.orphan_tags;
+        drift.duplicate_books += part.duplicate_books;
+    }
+    return drift;
+}
+
+void ShardedUnitOfWork::Statistics::Rebuild() {
+    for (std::size_t i = 0; i < uow_.shards_.size(); ++i) {
+        uow_.Shard(i).GetStatisticsRepository().Rebuild();
+    }
+}
+
+std::map<std::string, std::int64_t, std::less<>> ShardedUnitOfWork::Statistics::GetAllTagCounts(
+    std::string_view prefix
+) const {
+    std::vector<std::vector<domain::TagBookCount>> parts = uow_.FanOut([prefix](UnitOfWork& shard) {
+        return shard.GetStatisticsRepository().GetTopTagsByPrefix(prefix, std::numeric_limits<std::size_t>::max());
+    });
+    std::map<std::string, std::int64_t, std::less<>> books_per_tag;
+    for (std::vector<domain::TagBookCount>& part : parts) {
+        for (domain::TagBookCount& tag : part) {
+            books_per_tag[std::move(tag.tag)] += tag.books;
+        }
+    }
+    return books_per_tag;
+}
+
+// // // --- STATISTICS --- // // //
+//
+//
+//
+// // // --- FACTORY --- // // //
+
+ShardedUnitOfWorkFactory::ShardedUnitOfWorkFactory(std::vector<UnitOfWorkFactory*> shards)
+    : shards_{std::move(shards)} {
+    if (shards_.empty()) {
+        throw std::invalid_argument("At least one shard is required"s);
+    }
+}
+
+std::unique_ptr<UnitOfWork> ShardedUnitOfWorkFactory::CreateUnitOfWork() {
+    return std::make_unique<ShardedUnitOfWork>(shards_, false);
+}
+
+std::unique_ptr<UnitOfWork> ShardedUnitOfWorkFactory::CreateReadOnlyUnitOfWork() {
+    return std::make_unique<ShardedUnitOfWork>(shards_, true);
+}
+
+// // // --- FACTORY --- // // //
+
+}  // namespace app
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "../domain/statistics.h"
+#include "unit_of_work.h"
+
+namespace app {
+
+// Номер шарда автора: jump consistent hash (Lamping, Veach) от UUID. При переходе
+// от N шардов к N + 1 переезжает только ~1/(N + 1) авторов, и все — на новый шард
+std::size_t ShardOfAuthor(const domain::AuthorId& id, std::size_t shard_count) noexcept;
+
+/**
+ * Единица работы поверх нескольких баз. Автор, его книги и их теги лежат на шарде
+ * ShardOfAuthor, поэтому сценарии одного автора обращаются к одному шарду.
+ * Запросы без автора (списки, поиск по названию и имени, книга по id) выполняются
+ * на всех шардах параллельно, упорядоченные результаты сливаются k-way merge.
+ * Шард книги, найденной или записанной в этой единице работы, запоминается.
+ * Помеченные удалёнными авторы не переносятся перебалансировкой и вычищаются
+ * на том шарде, где их нашёл GetDeletedAuthorIds.
+ *
+ * Единицы работы всех шардов открываются в конструкторе по возрастанию номера шарда:
+ * если бы соединения брались по мере надобности, две единицы работы, взявшие их
+ * в разном порядке, могли бы ждать друг друга бесконечно. Commit фиксирует их
+ * по очереди и атомарен только в пределах одного шарда.
+ * Уникальность имени автора проверяется запросом ко всем шардам перед записью;
+ * одновременные записи одного имени на разные шарды эта проверка не исключает.
+ */
+class ShardedUnitOfWork : public UnitOfWork {
+public:
+    // read_only — единицы работы шардов открываются через CreateReadOnlyUnitOfWork
+    ShardedUnitOfWork(std::vector<UnitOfWorkFactory*> shards, bool read_only);
+
+    void Commit() override;
+
+    domain::AuthorRepository& GetAuthorRepository() override {
+        return authors_;
+    }
+
+    domain::BookRepository& GetBookRepository() override {
+        return books_;
+    }
+
+    domain::BookTagRepository& GetBookTagRepository() override {
+        return book_tags_;
+    }
+
+    domain::StatisticsRepository& GetStatisticsRepository() override {
+        return statistics_;
+    }
+
+private:
+    using UUIDType = util::detail::UUIDType;
+
+    class Authors : public domain::AuthorRepository {
+    public:
+        explicit Authors(ShardedUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        void Save(const domain::Author& author) override;
+        void Edit(const domain::AuthorId& id, std::string_view new_name) override;
+        void Delete(const domain::AuthorId& id) override;
+        void MarkDeleted(const domain::AuthorId& id) override;
+
+        domain::AuthorRows GetAllAuthors() const override;
+        domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override;
+        std::optional<domain::Author> GetAuthorByName(std::string_view name) const override;
+        std::optional<domain::Author> GetAuthorById(const domain::AuthorId& id) const override;
+        std::vector<domain::AuthorId> GetDeletedAuthorIds() const override;
+
+    private:
+        void RequireUniqueName(const domain::AuthorId& id, std::string_view name) const;
+
+        ShardedUnitOfWork& uow_;
+    };
+
+    class Books : public domain::BookRepository {
+    public:
+        explicit Books(ShardedUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        void Save(const domain::Book& book) override;
+        void Edit(const domain::BookId& id, std::string_view title, int publication_year) override;
+        void Delete(const domain::BookId& id) override;
+
+        std::optional<domain::Book> GetBookById(const domain::BookId& id) override;
+        std::optional<domain::Book> GetBookByIdForUpdate(const domain::BookId& id) override;
+        std::vector<domain::Book> GetBooksByTitle(std::string_view title) override;
+        domain::BookRows GetAllBooks() override;
+        domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const override;
+        domain::BookRows GetBooksByYearRange(int from, int to) const override;
+        domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override;
+        std::vector<domain::BookId> GetBookIdsByAuthorId(const domain::AuthorId& author_id,
+                                                         std::size_t limit) const override;
+
+        void DeleteBooksByAuthorId(const domain::AuthorId& author_id) override;
+
+    private:
+        ShardedUnitOfWork& uow_;
+    };
+
+    class BookTags : public domain::BookTagRepository {
+    public:
+        explicit BookTags(ShardedUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        void Save(const domain::BookId& book_id, std::string_view tag) override;
+        void DeleteByBookId(const domain::BookId& book_id) override;
+
+        std::vector<std::string> GetTags(const domain::BookId& book_id) const override;
+        std::vector<domain::TagBookCount> GetTagCountsByAuthorId(const domain::AuthorId& author_id) const override;
+
+    private:
+        ShardedUnitOfWork& uow_;
+    };
+
+    // Счётчики шардов складываются. Автор лежит на одном шарде, поэтому общий топ авторов
+    // собирается из топов шардов; тег встречается на нескольких, поэтому для топа тегов
+    // и числа различных тегов читаются все счётчики тегов каждого шарда
+    class Statistics : public domain::StatisticsRepository {
+    public:
+        explicit Statistics(ShardedUnitOfWork& uow)
+        : uow_{uow}
+        {
+
+        }
+
+        domain::CatalogTotals GetTotals() const override;
+        std::vector<domain::AuthorBookCount> GetTopAuthors(std::size_t limit) const override;
+        std::vector<domain::TagBookCount> GetTopTags(std::size_t limit) const override;
+        std::vector<domain::TagBookCount> GetTopTagsByPrefix(std::string_view prefix, std::size_t limit) const override;
+        std::vector<domain::YearBookCount> GetBooksPerYear() const override;
+
+        domain::StatisticsDrift Verify() const override;
+        void Rebuild() override;
+
+    private:
+        // Суммы по всем шардам для тегов, начинающихся с prefix
+        std::map<std::string, std::int64_t, std::less<>> GetAllTagCounts(std::string_view prefix) const;
+
+        ShardedUnitOfWork& uow_;
+    };
+
+    UnitOfWork& Shard(std::size_t index);
+    // Шард автора: ShardOfAuthor либо, для помеченного удалённым, тот, где его нашёл GetDeletedAuthorIds
+    std::size_t ShardIndexOf(const domain::AuthorId& author_id) const;
+    UnitOfWork& ShardOf(const domain::AuthorId& author_id);
+    // Шард, на котором лежит книга; nullopt, если книги нет ни на одном
+    std::optional<std::size_t> FindBookShard(const domain::BookId& id);
+
+    // Вызывает fn(UnitOfWork&) на каждом шарде, шарды кроме первого — в отдельных потоках.
+    // Результаты возвращаются в порядке шардов
+    template <typename Fn>
+    auto FanOut(Fn&& fn);
+
+    std::vector<UnitOfWorkFactory*> factories_;
+    bool read_only_;
+    std::vector<std::unique_ptr<UnitOfWork>> shards_;
+    std::map<UUIDType, std::size_t> book_shards_;
+    std::map<UUIDType, std::size_t> deleted_author_shards_;
+
+    Authors authors_{*this};
+    Books books_{*this};
+    BookTags book_tags_{*this};
+    Statistics statistics_{*this};
+};
+
+class ShardedUnitOfWorkFactory : public UnitOfWorkFactory {
+public:
+    // Порядок шардов определяет размещение данных; новые шарды добавляются только в конец.
+    // Бросает std::invalid_argument, если список пуст
+    explicit ShardedUnitOfWorkFactory(std::vector<UnitOfWorkFactory*> shards);
+
+    std::unique_ptr<UnitOfWork> CreateUnitOfWork() override;
+    std::unique_ptr<UnitOfWork> CreateReadOnlyUnitOfWork() override;
+
+    std::size_t GetShardCount() const noexcept {
+        return shards_.size();
+    }
+
+private:
+    std::vector<UnitOfWorkFactory*> shards_;
+};
+
+}  // namespace app
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+
+#include "unit_of_work.h"
+
+namespace app {
+
+/**
+ * Фабрика, которая выдаёт все UnitOfWork поверх одной общей транзакции.
+ * Commit у выданных UnitOfWork ничего не делает: транзакция фиксируется только
+ * явным вызовом CommitShared, а при Rollback (или разрушении фабрики) откатывается.
+ * Используется пакетным режимом, чтобы выполнить много use case'ов одной транзакцией.
+ */
+class SharedUnitOfWorkFactory : public UnitOfWorkFactory {
+public:
+    explicit SharedUnitOfWorkFactory(UnitOfWorkFactory& factory)
+    : factory_{factory}
+    {
+
+    }
+
+    std::unique_ptr<UnitOfWork> CreateUnitOfWork() override {
+        if (!shared_) {
+            shared_ = factory_.CreateUnitOfWork();
+        }
+        return std::make_unique<SharedUnitOfWork>(*shared_);
+    }
+
+    // Чтения должны видеть незафиксированные изменения пакета, поэтому не уходят на реплику
+    std::unique_ptr<UnitOfWork> CreateReadOnlyUnitOfWork() override {
+        return CreateUnitOfWork();
+    }
+
+    void CommitShared() {
+        if (shared_) {
+            shared_->Commit();
+            shared_.reset();
+        }
+    }
+
+    void Rollback() noexcept {
+        shared_.reset();
+    }
+
+private:
+    class SharedUnitOfWork : public UnitOfWork {
+    public:
+        explicit SharedUnitOfWork(UnitOfWork& shared)
+        : shared_{shared}
+        {
+
+        }
+
+        void Commit() override {
+        }
+
+        domain::AuthorRepository& GetAuthorRepository() override {
+            return shared_.GetAuthorRepository();
+        }
+
+        domain::BookRepository& GetBookRepository() override {
+            return shared_.GetBookRepository();
+        }
+
+        domain::BookTagRepository& GetBookTagRepository() override {
+            return shared_.GetBookTagRepository();
+        }
+
+        domain::StatisticsRepository& GetStatisticsRepository() override {
+            return shared_.GetStatisticsRepository();
+        }
+
+    private:
+        UnitOfWork& shared_;
+    };
+
+    UnitOfWorkFactory& factory_;
+    std::unique_ptr<UnitOfWork> shared_;
+};
+
+}  // namespace app
@@ -0,0 +1,239 @@
+#include "tag_index.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace app {
+
+using namespace std::literals;
+
+namespace {
+
+// Первый индекс в [begin, end), для которого pred ложен; pred истинен на начале отрезка и ложен на конце
+template <typename Pred>
+std::uint32_t PartitionPoint(std::uint32_t begin, std::uint32_t end, Pred pred) {
+    while (begin < end) {
+        const std::uint32_t middle = begin + (end - begin) / 2;
+        if (pred(middle)) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+}  // namespace
+
+TagIndex::TagIndex(std::vector<domain::TagBookCount> tags) {
+    std::sort(tags.begin(), tags.end(), [](const domain::TagBookCount& lhs, const domain::TagBookCount& rhs) {
+        return lhs.tag < rhs.tag;
+    });
+    // Одинаковые теги суммируются, теги без книг отбрасываются
+    std::vector<domain::TagBookCount> unique;
+    unique.reserve(tags.size());
+    for (domain::TagBookCount& tag : tags) {
+        if (!unique.empty() && unique.back().tag == tag.tag) {
+            unique.back().books += tag.books;
+        } else {
+            unique.push_back(std::move(tag));
+        }
+    }
+    std::erase_if(unique, [](const domain::TagBookCount& tag) {
+        return tag.books <= 0;
+    });
+    Build(std::move(unique));
+}
+
+void TagIndex::Add(std::string_view tag, std::int64_t delta) {
+    if (delta == 0) {
+        return;
+    }
+    const std::uint32_t size = static_cast<std::uint32_t>(counts_.size());
+    const std::uint32_t index = PartitionPoint(0, size, [this, tag](std::uint32_t i) {
+        return GetTag(i) < tag;
+    });
+    if (index < size && GetTag(index) == tag) {
+        counts_[index] += delta;
+        for (std::size_t node = (size + index) / 2; node > 0; node /= 2) {
+            tree_[node] = Better(tree_[2 * node], tree_[2 * node + 1]);
+        }
+        return;
+    }
+
+    auto [it, inserted] = pending_.try_emplace(std::string{tag}, delta);
+    if (!inserted) {
+        it->second += delta;
+    }
+    if (it->second == 0) {
+        pending_.erase(it);
+    } else if (pending_.size() > kMaxPending) {
+        Merge();
+    }
+}
+
+std::vector<domain::TagBookCount> TagIndex::Complete(std::string_view prefix, std::size_t limit) const {
+    std::vector<domain::TagBookCount> tags;
+    if (limit == 0) {
+        return tags;
+    }
+
+    const std::uint32_t size = static_cast<std::uint32_t>(counts_.size());
+    const std::uint32_t begin = PartitionPoint(0, size, [this, prefix](std::uint32_t i) {
+        return GetTag(i) < prefix;
+    });
+    const std::uint32_t end = PartitionPoint(begin, size, [this, prefix](std::uint32_t i) {
+        return GetTag(i).starts_with(prefix);
+    });
+
+    // Очередь отрезков по лучшему тегу в каждом: выданный тег делит свой отрезок на два
+    struct Range {
+        std::uint32_t best;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+    const auto worse = [this](const Range& lhs, const Range& rhs) {
+        return Better(lhs.best, rhs.best) != lhs.best;
+    };
+    std::vector<Range> queue;
+    if (begin < end) {
+        queue.push_back({FindBest(begin, end), begin, end});
+    }
+    while (tags.size() < limit && !queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), worse);
+        const Range range = queue.back();
+        queue.pop_back();
+        if (counts_[range.best] <= 0) {
+            break;
+        }
+        tags.push_back({std::string{GetTag(range.best)}, counts_[range.best]});
+        for (const auto& [part_begin, part_end] : {std::pair{range.begin, range.best}, std::pair{range.best + 1, range.end}}) {
+            if (part_begin < part_end) {
+                queue.push_back({FindBest(part_begin, part_end), part_begin, part_end});
+                std::push_heap(queue.begin(), queue.end(), worse);
+            }
+        }
+    }
+
+    bool has_pending = false;
+    for (auto it = pending_.lower_bound(prefix); it != pending_.end() && it->first.starts_with(prefix); ++it) {
+        if (it->second > 0) {
+            tags.push_back({it->first, it->second});
+            has_pending = true;
+        }
+    }
+    if (has_pending) {
+        std::sort(tags.begin(), tags.end(), [](const domain::TagBookCount& lhs, const domain::TagBookCount& rhs) {
+            return std::tie(rhs.books, lhs.tag) < std::tie(lhs.books, rhs.tag);
+        });
+        if (tags.size() > limit) {
+            tags.erase(tags.begin() + static_cast<std::ptrdiff_t>(limit), tags.end());
+        }
+    }
+    return tags;
+}
+
+std::size_t TagIndex::MemoryUsage() const noexcept {
+    // Узел std::map: три указателя и цвет поверх пары; длинные строки — отдельным блоком
+    constexpr std::size_t kNodeOverhead = 4 * sizeof(void*);
+    std::size_t pending_bytes = 0;
+    for (const auto& [tag, books] : pending_) {
+        pending_bytes += kNodeOverhead + sizeof(std::pair<const std::string, std::int64_t>);
+        if (tag.capacity() > std::string{}.capacity()) {
+            pending_bytes += tag.capacity() + 1;
+        }
+    }
+    return sizeof(*this) + chars_.capacity() + offsets_.capacity() * sizeof(std::uint32_t)
+         + counts_.capacity() * sizeof(std::int64_t) + tree_.capacity() * sizeof(std::uint32_t) + pending_bytes;
+}
+
+std::uint32_t TagIndex::Better(std::uint32_t lhs, std::uint32_t rhs) const noexcept {
+    if (lhs == kNone) {
+        return rhs;
+    }
+    if (rhs == kNone) {
+        return lhs;
+    }
+    // Теги упорядочены, поэтому меньший индекс при равенстве — меньший по алфавиту тег
+    if (counts_[lhs] != counts_[rhs]) {
+        return counts_[lhs] > counts_[rhs] ? lhs : rhs;
+    }
+    return std::min(lhs, rhs);
+}
+
+std::uint32_t TagIndex::FindBest(std::uint32_t begin, std::uint32_t end) const noexcept {
+    const std::size_t size = counts_.size();
+    std::uint32_t best = kNone;
+    for (std::size_t left = begin + size, right = end + size; left < right; left /= 2, right /= 2) {
+        if (left % 2 == 1) {
+            best = Better(best, tree_[left++]);
+        }
+        if (right % 2 == 1) {
+            best = Better(best, tree_[--right]);
+        }
+    }
+    return best;
+}
+
+void TagIndex::Build(std::vector<domain::TagBookCount> tags) {
+    if (tags.size() >= kNone) {
+        throw std::length_error("Too many tags for the tag index"s);
+    }
+    std::size_t chars_size = 0;
+    for (const domain::TagBookCount& tag : tags) {
+        chars_size += tag.tag.size();
+    }
+    if (chars_size > UINT32_MAX) {
+        throw std::length_error("Tags are too long for the tag index"s);
+    }
+
+    chars_.clear();
+    chars_.reserve(chars_size);
+    offsets_.clear();
+    offsets_.reserve(tags.size() + 1);
+    counts_.clear();
+    counts_.reserve(tags.size());
+    for (const domain::TagBookCount& tag : tags) {
+        offsets_.push_back(static_cast<std::uint32_t>(chars_.size()));
+        chars_ += tag.tag;
+        counts_.push_back(tag.books);
+    }
+    offsets_.push_back(static_cast<std::uint32_t>(chars_.size()));
+
+    const std::size_t size = counts_.size();
+    tree_.assign(2 * size, kNone);
+    for (std::size_t i = 0; i < size; ++i) {
+        tree_[size + i] = static_cast<std::uint32_t>(i);
+    }
+    for (std::size_t node = size; node-- > 1;) {
+        tree_[node] = Better(tree_[2 * node], tree_[2 * node + 1]);
+    }
+}
+
+void TagIndex::Merge() {
+    std::vector<domain::TagBookCount> tags;
+    tags.reserve(counts_.size() + pending_.size());
+    auto pending = pending_.begin();
+    for (std::uint32_t i = 0; i < counts_.size(); ++i) {
+        const std::string_view tag = GetTag(i);
+        for (; pending != pending_.end() && pending->first < tag; ++pending) {
+            if (pending->second > 0) {
+                tags.push_back({pending->first, pending->second});
+            }
+        }
+        if (counts_[i] > 0) {
+            tags.push_back({std::string{tag}, counts_[i]});
+        }
+    }
+    for (; pending != pending_.end(); ++pending) {
+        if (pending->second > 0) {
+            tags.push_back({pending->first, pending->second});
+        }
+    }
+    pending_.clear();
+    Build(std::move(tags));
+}
+
+}  // namespace app
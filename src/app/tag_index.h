@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../domain/statistics.h"
+
+namespace app {
+
+/**
+ * Индекс для автодополнения тегов: различные теги в побайтовом порядке с числом книг.
+ * Теги с общим префиксом занимают непрерывный диапазон массива, его границы находятся
+ * двоичным поиском, а k тегов с наибольшим числом книг в диапазоне — по дереву отрезков
+ * максимумов за O(k log n), без просмотра всего диапазона.
+ *
+ * Строки лежат подряд в одном буфере: на тег приходятся смещение, счётчик и два узла дерева.
+ * Изменение числа книг известного тега стоит O(log n). Новые теги копятся в небольшом
+ * упорядоченном дополнении и вливаются в основной массив, когда их наберётся kMaxPending.
+ *
+ * Индекс не синхронизирован: одновременные чтения допустимы, запись — только монопольно.
+ */
+class TagIndex {
+public:
+    // Размер дополнения, после которого новые теги вливаются в основной массив
+    static constexpr std::size_t kMaxPending = 1024;
+
+    TagIndex() = default;
+    explicit TagIndex(std::vector<domain::TagBookCount> tags);
+
+    // Меняет число книг тега на delta; теги без книг не предлагаются
+    void Add(std::string_view tag, std::int64_t delta);
+
+    // До limit тегов, начинающихся с prefix, по убыванию числа книг, при равенстве — по алфавиту
+    std::vector<domain::TagBookCount> Complete(std::string_view prefix, std::size_t limit) const;
+
+    // Число тегов в индексе, включая оставшиеся без книг до ближайшего слияния
+    std::size_t Size() const noexcept {
+        return counts_.size() + pending_.size();
+    }
+
+    // Приблизительный объём памяти индекса в байтах
+    std::size_t MemoryUsage() const noexcept;
+
+private:
+    static constexpr std::uint32_t kNone = UINT32_MAX;
+
+    std::string_view GetTag(std::uint32_t index) const noexcept {
+        return std::string_view{chars_}.substr(offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    // Индекс тега, который Complete выдаст раньше; kNone проигрывает любому
+    std::uint32_t Better(std::uint32_t lhs, std::uint32_t rhs) const noexcept;
+    // Лучший тег в [begin, end) основного массива
+    std::uint32_t FindBest(std::uint32_t begin, std::uint32_t end) const noexcept;
+
+    void Build(std::vector<domain::TagBookCount> tags);
+    void Merge();
+
+    // Основной массив: тег i занимает chars_[offsets_[i], offsets_[i + 1])
+    std::string chars_;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::int64_t> counts_;
+    // Дерево отрезков снизу вверх: лист tree_[n + i] = i, узел — лучший из двух потомков
+    std::vector<std::uint32_t> tree_;
+    // Теги, которых нет в основном массиве
+    std::map<std::string, std::int64_t, std::less<>> pending_;
+};
+
+}  // namespace app
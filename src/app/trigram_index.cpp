@@ -0,0 +1,427 @@
+#include "trigram_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "k_way_merge.h"
+
+namespace app {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+bool IsWordByte(unsigned char c) noexcept {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+unsigned char ToLower(unsigned char c) noexcept {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+// 1, если value есть в возрастающем list среди элементов с позиции pos, иначе 0.
+// Значения, которые ищутся в одном списке, должны возрастать: pos только растёт
+std::uint32_t ContainsFrom(std::span<const std::uint32_t> list, std::size_t& pos, std::uint32_t value) noexcept {
+    constexpr std::size_t kBlock = TrigramIndex::kBlock;
+    // Галоп: окно удваивается, пока его последний элемент меньше value
+    std::size_t step = kBlock;
+    while (pos + step <= list.size() && list[pos + step - 1] < value) {
+        pos += step;
+        step *= 2;
+    }
+    // Value может быть только в [pos, pos + step): окно сужается до одного блока
+    while (step > kBlock) {
+        step /= 2;
+        if (pos + step <= list.size() && list[pos + step - 1] < value) {
+            pos += step;
+        }
+    }
+
+    std::uint32_t found = 0;
+    if (pos + kBlock <= list.size()) {
+        // Цикл постоянной длины без ранних выходов компилируется в векторные сравнения
+        const std::uint32_t* block = list.data() + pos;
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            found |= block[i] == value;
+        }
+    } else {
+        for (std::size_t i = pos; i < list.size(); ++i) {
+            found |= list[i] == value;
+        }
+    }
+    return found;
+}
+
+using List = std::span<const std::uint32_t>;
+
+// Запись и число списков запроса, в которых она встретилась
+struct Candidate {
+    std::uint32_t document;
+    std::uint32_t shared;
+};
+
+// Кандидаты из коротких списков слиянием; длинные списки только досчитывают вхождения,
+// и кандидат, которому уже не набрать min_shared даже по оставшимся спискам, отбрасывается
+std::vector<Candidate> CountSparse(std::span<const List> lists, std::size_t short_lists, std::size_t min_shared) {
+    std::vector<std::size_t> sizes;
+    sizes.reserve(short_lists);
+    for (std::size_t i = 0; i < short_lists; ++i) {
+        sizes.push_back(lists[i].size());
+    }
+    std::vector<Candidate> candidates;
+    for (const RowRef& ref : MergeSorted(sizes, [lists](const RowRef& lhs, const RowRef& rhs) {
+        return lists[lhs.part][lhs.index] < lists[rhs.part][rhs.index];
+    })) {
+        const std::uint32_t document = lists[ref.part][ref.index];
+        if (!candidates.empty() && candidates.back().document == document) {
+            ++candidates.back().shared;
+        } else {
+            candidates.push_back({document, 1});
+        }
+    }
+
+    for (std::size_t i = short_lists; i < lists.size() && !candidates.empty(); ++i) {
+        const std::size_t remaining = lists.size() - i - 1;
+        std::size_t pos = 0;
+        std::size_t kept = 0;
+        for (Candidate candidate : candidates) {
+            candidate.shared += ContainsFrom(lists[i], pos, candidate.document);
+            if (candidate.shared + remaining >= min_shared) {
+                candidates[kept++] = candidate;
+            }
+        }
+        candidates.resize(kept);
+    }
+    return candidates;
+}
+
+// Вхождения всех списков в счётчиках по номерам записей: дешевле слияния, когда
+// кандидатов сравнимо с числом записей
+std::vector<Candidate> CountDense(std::span<const List> lists, std::size_t documents, std::size_t min_shared) {
+    // Различных триграмм в запросе и в записи длины не больше kMaxTextSize меньше 2^16
+    std::vector<std::uint16_t> counts(documents);
+    for (const List list : lists) {
+        for (const std::uint32_t document : list) {
+            ++counts[document];
+        }
+    }
+    std::vector<Candidate> candidates;
+    for (std::size_t document = 0; document < documents; ++document) {
+        if (counts[document] >= min_shared) {
+            candidates.push_back({static_cast<std::uint32_t>(document), counts[document]});
+        }
+    }
+    return candidates;
+}
+
+std::size_t CountShared(const std::vector<std::uint32_t>& lhs, const std::vector<std::uint32_t>& rhs) {
+    std::size_t shared = 0;
+    for (auto l = lhs.begin(), r = rhs.begin(); l != lhs.end() && r != rhs.end();) {
+        if (*l < *r) {
+            ++l;
+        } else if (*r < *l) {
+            ++r;
+        } else {
+            ++shared;
+            ++l;
+            ++r;
+        }
+    }
+    return shared;
+}
+
+}  // namespace
+
+void TrigramIndex::Set(const domain::AuthorId& id, std::string_view name) {
+    Set(Kind::kAuthor, *id, name, {}, 0);
+}
+
+void TrigramIndex::Set(
+    const domain::BookId& id, std::string_view title, const domain::AuthorId& author_id, int publication_year
+) {
+    Set(Kind::kBook, *id, title, *author_id, publication_year);
+}
+
+void TrigramIndex::Erase(const domain::AuthorId& id) {
+    Erase(Kind::kAuthor, *id);
+}
+
+void TrigramIndex::Erase(const domain::BookId& id) {
+    Erase(Kind::kBook, *id);
+}
+
+bool TrigramIndex::Contains(const domain::AuthorId& id) const {
+    return Contains(Kind::kAuthor, *id);
+}
+
+bool TrigramIndex::Contains(const domain::BookId& id) const {
+    return Contains(Kind::kBook, *id);
+}
+
+std::vector<domain::FuzzyMatch> TrigramIndex::Find(std::string_view text, std::size_t limit, double threshold) const {
+    std::vector<domain::FuzzyMatch> matches;
+    // Запрос приходит от клиента: длина ограничена так же, как у записей, и CountDense не переполняется
+    if (limit == 0 || text.size() > kMaxTextSize) {
+        return matches;
+    }
+    const std::vector<std::uint32_t> query = Trigrams(text);
+    if (query.empty()) {
+        return matches;
+    }
+
+    // Сходство c / (|Q| + |D| - c) не выше c / |Q|, поэтому у подходящей записи не меньше
+    // min_shared общих с запросом триграмм; поправка защищает от ошибки округления произведения
+    const std::size_t min_shared = std::clamp<std::size_t>(
+        static_cast<std::size_t>(std::ceil(threshold * static_cast<double>(query.size()) - 1e-9)), 1, query.size()
+    );
+
+    // Отсутствующая в индексе триграмма — пустой список: она тоже входит в |Q|
+    std::vector<List> lists;
+    lists.reserve(query.size());
+    for (const std::uint32_t trigram : query) {
+        const auto it = postings_.find(trigram);
+        lists.push_back(it == postings_.end() ? List{} : List{it->second});
+    }
+    std::sort(lists.begin(), lists.end(), [](List lhs, List rhs) {
+        return lhs.size() < rhs.size();
+    });
+
+    // Запись с min_shared общими триграммами есть хотя бы в одном из |Q| - min_shared + 1
+    // самых коротких списков. Если в них мало номеров, кандидаты берутся только оттуда
+    const std::size_t short_lists = query.size() - min_shared + 1;
+    std::size_t short_total = 0;
+    for (std::size_t i = 0; i < short_lists; ++i) {
+        short_total += lists[i].size();
+    }
+    const std::vector<Candidate> candidates = short_total * kDenseRatio < documents_.size()
+        ? CountSparse(lists, short_lists, min_shared)
+        : CountDense(lists, documents_.size(), min_shared);
+
+    std::vector<std::pair<double, std::uint32_t>> scored;
+    for (const Candidate& candidate : candidates) {
+        const Document& document = documents_[candidate.document];
+        if (!document.alive || candidate.shared < min_shared) {
+            continue;
+        }
+        const double similarity = static_cast<double>(candidate.shared)
+                                / static_cast<double>(query.size() + document.trigrams - candidate.shared);
+        if (similarity >= threshold) {
+            scored.emplace_back(similarity, candidate.document);
+        }
+    }
+    const auto better = [this](const std::pair<double, std::uint32_t>& lhs, const std::pair<double, std::uint32_t>& rhs) {
+        if (lhs.first != rhs.first) {
+            return lhs.first > rhs.first;
+        }
+        return std::tuple{GetText(documents_[lhs.second]), lhs.second} < std::tuple{GetText(documents_[rhs.second]), rhs.second};
+    };
+    const auto top = scored.begin() + static_cast<std::ptrdiff_t>(std::min(limit, scored.size()));
+    std::partial_sort(scored.begin(), top, scored.end(), better);
+
+    matches.reserve(static_cast<std::size_t>(top - scored.begin()));
+    for (auto it = scored.begin(); it != top; ++it) {
+        const Document& document = documents_[it->second];
+        domain::FuzzyMatch& match = matches.emplace_back();
+        if (document.kind == Kind::kAuthor) {
+            match.id = domain::AuthorId{document.id};
+        } else {
+            match.id = domain::BookId{document.id};
+            const BookDetails& details = details_[it->second];
+            match.publication_year = details.publication_year;
+            if (const auto author = by_id_.find(details.author_id);
+                author != by_id_.end() && documents_[author->second].kind == Kind::kAuthor) {
+                match.author_name = GetText(documents_[author->second]);
+            }
+        }
+        match.text = GetText(document);
+        match.similarity = it->first;
+    }
+    return matches;
+}
+
+void TrigramIndex::ShrinkToFit() {
+    for (auto& [trigram, list] : postings_) {
+        list.shrink_to_fit();
+    }
+    documents_.shrink_to_fit();
+    details_.shrink_to_fit();
+    chars_.shrink_to_fit();
+}
+
+std::size_t TrigramIndex::MemoryUsage() const noexcept {
+    // Узел хеш-таблицы: указатель на следующий и пара, плюс ячейка массива корзин
+    constexpr std::size_t kNodeOverhead = 2 * sizeof(void*);
+    std::size_t postings_bytes = postings_.bucket_count() * sizeof(void*);
+    for (const auto& [trigram, list] : postings_) {
+        postings_bytes += kNodeOverhead + sizeof(std::pair<const std::uint32_t, std::vector<std::uint32_t>>)
+                        + list.capacity() * sizeof(std::uint32_t);
+    }
+    const std::size_t ids_bytes = by_id_.bucket_count() * sizeof(void*)
+                                + by_id_.size() * (kNodeOverhead + sizeof(std::pair<const UUIDType, std::uint32_t>));
+    return sizeof(*this) + documents_.capacity() * sizeof(Document) + details_.capacity() * sizeof(BookDetails)
+         + chars_.capacity() + postings_bytes + ids_bytes;
+}
+
+std::vector<std::uint32_t> TrigramIndex::Trigrams(std::string_view text) {
+    std::vector<std::uint32_t> trigrams;
+    trigrams.reserve(text.size() + 2);
+    std::uint32_t window = 0;
+    std::size_t filled = 0;
+    const auto push = [&](unsigned char c) {
+        window = ((window << 8) | c) & 0xFFFFFF;
+        if (++filled >= 3) {
+            trigrams.push_back(window);
+        }
+    };
+
+    for (std::size_t i = 0; i < text.size();) {
+        if (!IsWordByte(static_cast<unsigned char>(text[i]))) {
+            ++i;
+            continue;
+        }
+        filled = 0;
+        push(' ');
+        push(' ');
+        for (; i < text.size() && IsWordByte(static_cast<unsigned char>(text[i])); ++i) {
+            push(ToLower(static_cast<unsigned char>(text[i])));
+        }
+        push(' ');
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+double TrigramIndex::Similarity(std::string_view lhs, std::string_view rhs) {
+    return Similarity(Trigrams(lhs), Trigrams(rhs));
+}
+
+double TrigramIndex::Similarity(const std::vector<std::uint32_t>& lhs, const std::vector<std::uint32_t>& rhs) {
+    const std::size_t shared = CountShared(lhs, rhs);
+    const std::size_t total = lhs.size() + rhs.size() - shared;
+    return total == 0 ? 0.0 : static_cast<double>(shared) / static_cast<double>(total);
+}
+
+void TrigramIndex::Set(
+    Kind kind, const UUIDType& id, std::string_view text, const UUIDType& author_id, int publication_year
+) {
+    if (text.size() > kMaxTextSize) {
+        throw std::length_error("Text is too long for the trigram index"s);
+    }
+    if (const auto it = by_id_.find(id); it != by_id_.end()) {
+        Document& document = documents_[it->second];
+        if (document.kind == kind && GetText(document) == text) {
+            // Триграммы не изменились: достаточно обновить автора и год на месте
+            details_[it->second] = {author_id, publication_year};
+            return;
+        }
+        document.alive = false;
+        ++dead_;
+        by_id_.erase(it);
+    }
+    if (documents_.size() >= kNone || chars_.size() + text.size() > kNone) {
+        Compact();
+        if (documents_.size() >= kNone || chars_.size() + text.size() > kNone) {
+            throw std::length_error("Too many entries for the trigram index"s);
+        }
+    }
+
+    const std::vector<std::uint32_t> trigrams = Trigrams(text);
+    const std::uint32_t number = static_cast<std::uint32_t>(documents_.size());
+    documents_.push_back({
+        id,
+        static_cast<std::uint32_t>(chars_.size()),
+        static_cast<std::uint16_t>(text.size()),
+        static_cast<std::uint16_t>(trigrams.size()),
+        kind,
+        true
+    });
+    details_.push_back({author_id, publication_year});
+    chars_ += text;
+    for (const std::uint32_t trigram : trigrams) {
+        postings_[trigram].push_back(number);
+    }
+    by_id_.emplace(id, number);
+
+    if (dead_ >= kMinCompaction && dead_ * 4 >= documents_.size()) {
+        Compact();
+    }
+}
+
+void TrigramIndex::Erase(Kind kind, const UUIDType& id) {
+    const auto it = by_id_.find(id);
+    if (it == by_id_.end() || documents_[it->second].kind != kind) {
+        return;
+    }
+    documents_[it->second].alive = false;
+    ++dead_;
+    by_id_.erase(it);
+    if (dead_ >= kMinCompaction && dead_ * 4 >= documents_.size()) {
+        Compact();
+    }
+}
+
+bool TrigramIndex::Contains(Kind kind, const UUIDType& id) const {
+    const auto it = by_id_.find(id);
+    return it != by_id_.end() && documents_[it->second].kind == kind;
+}
+
+void TrigramIndex::Compact() {
+    // Живые записи сохраняют взаимный порядок, поэтому списки остаются возрастающими
+    std::vector<std::uint32_t> renumbered(documents_.size(), kNone);
+    std::vector<Document> documents;
+    documents.reserve(documents_.size() - dead_);
+    std::vector<BookDetails> details;
+    details.reserve(documents_.size() - dead_);
+    std::string chars;
+    chars.reserve(chars_.size());
+    for (std::size_t i = 0; i < documents_.size(); ++i) {
+        Document document = documents_[i];
+        if (!document.alive) {
+            continue;
+        }
+        renumbered[i] = static_cast<std::uint32_t>(documents.size());
+        const std::string_view text = GetText(document);
+        document.text_offset = static_cast<std::uint32_t>(chars.size());
+        chars += text;
+        documents.push_back(document);
+        details.push_back(details_[i]);
+    }
+
+    for (auto it = postings_.begin(); it != postings_.end();) {
+        std::vector<std::uint32_t>& list = it->second;
+        std::size_t kept = 0;
+        for (const std::uint32_t number : list) {
+            if (renumbered[number] != kNone) {
+                list[kept++] = renumbered[number];
+            }
+        }
+        if (kept == 0) {
+            it = postings_.erase(it);
+            continue;
+        }
+        list.resize(kept);
+        list.shrink_to_fit();
+        ++it;
+    }
+    for (auto& [id, number] : by_id_) {
+        number = renumbered[number];
+    }
+
+    documents_ = std::move(documents);
+    details_ = std::move(details);
+    chars_ = std::move(chars);
+    chars_.shrink_to_fit();
+    dead_ = 0;
+}
+
+}  // namespace app
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <boost/uuid/uuid_hash.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../domain/search.h"
+
+namespace app {
+
+/**
+ * Нечёткий поиск по именам авторов и названиям книг: инвертированный индекс триграмм.
+ * Текст приводится к нижнему регистру (только латиница), делится на слова, и каждое слово,
+ * дополненное как в pg_trgm двумя пробелами спереди и одним сзади, даёт свои триграммы.
+ * Сходство записи с запросом — доля общих триграмм от их объединения (коэффициент Жаккара).
+ *
+ * Для каждой триграммы хранится возрастающий список номеров записей. Запись со сходством
+ * не ниже порога содержит не меньше t триграмм запроса, поэтому она встречается хотя бы
+ * в одном из |Q| - t + 1 самых коротких списков: кандидаты берутся только из них, а длинные
+ * списки лишь проверяют кандидатов галопирующим поиском. Последний шаг поиска сравнивает
+ * значение сразу с блоком из kBlock элементов без ветвлений, и компилятор выполняет его
+ * векторными инструкциями. Если же в коротких списках больше 1/kDenseRatio всех записей
+ * (запрос из частых слов), вхождения всех списков считаются в плотном массиве счётчиков.
+ *
+ * Запись книги хранит её автора и год издания. Find отдаёт имя автора из его собственной
+ * записи, поэтому переименование автора сразу видно в найденных книгах.
+ *
+ * Новая запись получает следующий номер, поэтому попадает в конец своих списков. Удалённая
+ * запись только помечается; когда таких наберётся четверть (но не меньше kMinCompaction),
+ * номера пересчитываются, а списки и буфер текстов уплотняются.
+ *
+ * Индекс не синхронизирован: одновременные чтения допустимы, запись — только монопольно.
+ */
+class TrigramIndex {
+public:
+    // Порог сходства по умолчанию, как у similarity_threshold в pg_trgm
+    static constexpr double kDefaultThreshold = 0.3;
+    // Элементов списка, которые сравниваются с искомым номером за один шаг
+    static constexpr std::size_t kBlock = 8;
+    // Во сколько раз короткие списки должны быть меньше числа записей, чтобы их слияние
+    // обошлось дешевле плотного подсчёта
+    static constexpr std::size_t kDenseRatio = 16;
+    // Удалённых записей, меньше которых уплотнение не запускается
+    static constexpr std::size_t kMinCompaction = 1024;
+    // Наибольшая длина текста записи в байтах
+    static constexpr std::size_t kMaxTextSize = 1024;
+
+    // Добавляет запись или заменяет её текст; текст длиннее kMaxTextSize — std::length_error
+    void Set(const domain::AuthorId& id, std::string_view name);
+    void Set(const domain::BookId& id, std::string_view title, const domain::AuthorId& author_id, int publication_year);
+    // Удаляет запись, если она есть
+    void Erase(const domain::AuthorId& id);
+    void Erase(const domain::BookId& id);
+
+    bool Contains(const domain::BookId& id) const;
+    bool Contains(const domain::AuthorId& id) const;
+
+    // До limit записей со сходством не ниже threshold: по убыванию сходства, затем по тексту.
+    // Запрос длиннее kMaxTextSize, как и такой текст записи, не принимается: ответ пуст
+    std::vector<domain::FuzzyMatch> Find(std::string_view text, std::size_t limit,
+                                         double threshold = kDefaultThreshold) const;
+
+    // Отдаёт лишнюю ёмкость списков, например после начальной загрузки
+    void ShrinkToFit();
+
+    std::size_t Size() const noexcept {
+        return by_id_.size();
+    }
+
+    // Приблизительный объём памяти индекса в байтах
+    std::size_t MemoryUsage() const noexcept;
+
+    // Различные триграммы текста по возрастанию; байты триграммы упакованы в младшие 24 бита
+    static std::vector<std::uint32_t> Trigrams(std::string_view text);
+    // Сходство двух текстов в том же смысле, что и в Find
+    static double Similarity(std::string_view lhs, std::string_view rhs);
+    // То же по заранее посчитанным Trigrams
+    static double Similarity(const std::vector<std::uint32_t>& lhs, const std::vector<std::uint32_t>& rhs);
+
+private:
+    using UUIDType = util::detail::UUIDType;
+
+    enum class Kind : std::uint8_t {
+        kAuthor,
+        kBook,
+    };
+
+    struct Document {
+        UUIDType id;
+        std::uint32_t text_offset;
+        std::uint16_t text_size;
+        std::uint16_t trigrams;
+        Kind kind;
+        bool alive;
+    };
+
+    // Автор и год книги. Хранятся отдельно от Document: отбор кандидатов их не читает
+    struct BookDetails {
+        UUIDType author_id;
+        std::int32_t publication_year;
+    };
+
+    std::string_view GetText(const Document& document) const noexcept {
+        return std::string_view{chars_}.substr(document.text_offset, document.text_size);
+    }
+
+    void Set(Kind kind, const UUIDType& id, std::string_view text, const UUIDType& author_id, int publication_year);
+    void Erase(Kind kind, const UUIDType& id);
+    bool Contains(Kind kind, const UUIDType& id) const;
+    void Compact();
+
+    // Записи по номерам, включая удалённые до ближайшего уплотнения
+    std::vector<Document> documents_;
+    // По тем же номерам; у авторов не заполнены
+    std::vector<BookDetails> details_;
+    // Тексты записей подряд
+    std::string chars_;
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings_;
+    std::unordered_map<UUIDType, std::uint32_t, boost::hash<UUIDType>> by_id_;
+    std::size_t dead_ = 0;
+};
+
+}  // namespace app
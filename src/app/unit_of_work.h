@@ -5,6 +5,7 @@
 #include "../domain/author_fwd.h"
 #include "../domain/book_fwd.h"
 #include "../domain/book_tag_fwd.h"
+#include "../domain/statistics_fwd.h"
 
 namespace app {
 
@@ -14,15 +15,47 @@ public:
     virtual domain::AuthorRepository& GetAuthorRepository() = 0;
     virtual domain::BookRepository& GetBookRepository() = 0;
     virtual domain::BookTagRepository& GetBookTagRepository() = 0;
+    virtual domain::StatisticsRepository& GetStatisticsRepository() = 0;
 
 public:
-  ~UnitOfWork() = default;
+    // Удаляется через std::unique_ptr<UnitOfWork>: деструктор реализации возвращает соединение в пул
+    virtual ~UnitOfWork() = default;
+};
+
+// Пока объект жив, CreateReadOnlyUnitOfWork в этом потоке открывает единицу работы там же,
+// где и пишущие. Нужен сценариям, которые перечитывают только что записанное: реплика может
+// ещё не применить запись, а проверка read-your-writes в реализации бывает отключена
+class PrimaryReadScope {
+public:
+    PrimaryReadScope() noexcept {
+        ++depth_;
+    }
+
+    PrimaryReadScope(const PrimaryReadScope&) = delete;
+    PrimaryReadScope& operator=(const PrimaryReadScope&) = delete;
+
+    ~PrimaryReadScope() {
+        --depth_;
+    }
+
+    static bool IsActive() noexcept {
+        return depth_ != 0;
+    }
+
+private:
+    static inline thread_local int depth_ = 0;
 };
 
 class UnitOfWorkFactory {
 public:
     virtual std::unique_ptr<UnitOfWork> CreateUnitOfWork() = 0;
 
+    // Единица работы для сценариев, которые только читают: реализация может выполнить её
+    // на реплике (кроме как внутри PrimaryReadScope). Изменения через её репозитории не допускаются
+    virtual std::unique_ptr<UnitOfWork> CreateReadOnlyUnitOfWork() {
+        return CreateUnitOfWork();
+    }
+
 protected:
     ~UnitOfWorkFactory() = default;
 };
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../domain/author_fwd.h"
+#include "../domain/author_rows.h"
 #include "../domain/book_fwd.h"
+#include "../domain/book_rows.h"
 #include "../domain/book_tag_fwd.h"
+#include "../domain/search_fwd.h"
+#include "../domain/statistics_fwd.h"
 
 namespace app {
 
@@ -16,14 +23,17 @@ class UseCases {
 public:
     // // // --- AUTHOR --- // // //
 
-    virtual void AddAuthor(const std::string& name) = 0;
-    virtual bool EditAuthor(const AuthorId& id, const std::string& new_name) = 0;
+    // Возвращает идентификатор созданного автора: читать его обратно после записи не нужно
+    virtual AuthorId AddAuthor(std::string name) = 0;
+    virtual bool EditAuthor(const AuthorId& id, std::string_view new_name) = 0;
     virtual bool DeleteAuthor(const AuthorId& id) = 0;
     
-    virtual std::optional<domain::Author> GetAuthorByName(const std::string& name) const = 0;
+    virtual std::optional<domain::Author> GetAuthorByName(std::string_view name) const = 0;
     virtual std::optional<domain::Author> GetAuthorById(const AuthorId& id) const = 0;
 
-    virtual std::vector<domain::Author> GetAllAuthors() const = 0;
+    virtual domain::AuthorRows GetAllAuthors() const = 0;
+    // Не более limit авторов, чьё имя начинается с prefix, по имени
+    virtual domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const = 0;
 
     // // // --- AUTHOR --- // // //
     //
@@ -31,32 +41,60 @@ public:
     //
     // // // --- BOOK --- // // //
     
-    virtual void AddBookByAuthorId(
+    // Возвращают идентификатор созданной книги
+    virtual BookId AddBookByAuthorId(
         const domain::AuthorId& author_id,
-        const std::string& title,
+        std::string title,
         int publication_year,
-        const std::vector<std::string>& tags
+        std::span<const std::string> tags
     ) = 0;
-    virtual void AddBookByAuthorName(
-        const std::string& author_name,
-        const std::string &title,
+    virtual BookId AddBookByAuthorName(
+        std::string author_name,
+        std::string title,
         int publication_year,
-        const std::vector<std::string> &tags
+        std::span<const std::string> tags
     ) = 0;
-    virtual bool EditBook(
+    // Возвращают книгу с тегами в том виде, в каком её застала запись, или nullopt, если книги нет
+    virtual std::optional<domain::Book> EditBook(
         const BookId& id,
-        const std::string& title, 
+        std::string_view title,
         int publication_year,
-        const std::vector<std::string>& tags
+        std::span<const std::string> tags
     ) = 0;
-    virtual bool DeleteBook(const BookId& id) = 0;
+    virtual std::optional<domain::Book> DeleteBook(const BookId& id) = 0;
 
     virtual std::optional<domain::Book> GetBook(const BookId& id) const = 0;
-    virtual std::vector<domain::Book> GetBooksByTitle(const std::string& title) const = 0;
-    virtual std::vector<domain::Book> GetAllBooks() const = 0;
-    virtual std::vector<domain::Book> GetBooksByAuthorId(const domain::AuthorId& author_id) const = 0;
+    virtual std::vector<domain::Book> GetBooksByTitle(std::string_view title) const = 0;
+    virtual domain::BookRows GetAllBooks() const = 0;
+    virtual domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const = 0;
+    // Книги, изданные с from по to включительно; при from > to список пуст
+    virtual domain::BookRows GetBooksByYearRange(int from, int to) const = 0;
+    // Не более limit книг, чьё название начинается с prefix, по названию, имени автора и году
+    virtual domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const = 0;
+    // Теги книг автора с числом его книг у каждого, по алфавиту
+    virtual std::vector<domain::TagBookCount> GetTagsByAuthorId(const domain::AuthorId& author_id) const = 0;
 
     // // // --- BOOK --- // // //
+    //
+    //
+    //
+    // // // --- STATISTICS --- // // //
+
+    // Итоги каталога, top_n авторов и тегов с наибольшим числом книг и число книг по годам
+    virtual domain::CatalogStatistics GetStatistics(std::size_t top_n) const = 0;
+
+    // // // --- STATISTICS --- // // //
+    //
+    //
+    //
+    // // // --- SEARCH --- // // //
+
+    // До limit тегов, начинающихся с prefix, по убыванию числа книг, при равенстве — по алфавиту
+    virtual std::vector<domain::TagBookCount> CompleteTag(std::string_view prefix, std::size_t limit) const = 0;
+    // До limit авторов и книг, чьи имена и названия похожи на text (сходство по триграммам), от самых похожих
+    virtual std::vector<domain::FuzzyMatch> FuzzyFind(std::string_view text, std::size_t limit) const = 0;
+
+    // // // --- SEARCH --- // // //
 
 protected:
     ~UseCases() = default;
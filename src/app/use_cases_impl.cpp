@@ -1,27 +1,39 @@
 #include <algorithm>
 #include <optional>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "use_cases_impl.h"
+#include "trigram_index.h"
 
 #include "../domain/author.h"
 #include "../domain/book.h"
 #include "../domain/book_tag.h"
+#include "../domain/search.h"
+#include "../domain/statistics.h"
+#include "../metrics/metrics.h"
 
 namespace app {
 
 using namespace domain;
+using namespace std::literals;
 
 // // // --- AUTHOR --- // // //
 
-void UseCasesImpl::AddAuthor(const std::string& name) {
+AuthorId UseCasesImpl::AddAuthor(std::string name) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "AddAuthor"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    uow_transaction->GetAuthorRepository().Save(Author{AuthorId::New(), name});
+    const AuthorId author_id = AuthorId::New();
+    uow_transaction->GetAuthorRepository().Save(Author{author_id, std::move(name)});
     uow_transaction->Commit();
+    return author_id;
 }
 
-bool UseCasesImpl::EditAuthor(const AuthorId& id, const std::string& new_name) {
+bool UseCasesImpl::EditAuthor(const AuthorId& id, std::string_view new_name) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "EditAuthor"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
     const std::optional<Author> author = uow_transaction->GetAuthorRepository().GetAuthorById(id);
     if (author.has_value()) {
@@ -34,14 +46,13 @@ bool UseCasesImpl::EditAuthor(const AuthorId& id, const std::string& new_name) {
 }
 
 bool UseCasesImpl::DeleteAuthor(const AuthorId& id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "DeleteAuthor"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
     const std::optional<Author> author = uow_transaction->GetAuthorRepository().GetAuthorById(id);
     if (author.has_value()) {
-        for (const Book& book : uow_transaction->GetBookRepository().GetBooksByAuthorId(author->GetId())) {
-            uow_transaction->GetBookTagRepository().DeleteByBookId(book.GetId());
-        }
-        uow_transaction->GetBookRepository().DeleteBooksByAuthorId(author->GetId());
-        uow_transaction->GetAuthorRepository().Delete(author->GetId());
+        // Книги и теги удалит PurgeWorker; чтения не видят их уже после фиксации пометки
+        uow_transaction->GetAuthorRepository().MarkDeleted(author->GetId());
         uow_transaction->Commit();
         return true;
     }
@@ -49,24 +60,41 @@ bool UseCasesImpl::DeleteAuthor(const AuthorId& id) {
     return false;
 }
     
-std::optional<domain::Author> UseCasesImpl::GetAuthorByName(const std::string& name) const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
+std::optional<domain::Author> UseCasesImpl::GetAuthorByName(std::string_view name) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAuthorByName"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
     const std::optional<Author> author = uow_transaction->GetAuthorRepository().GetAuthorByName(name);
     uow_transaction->Commit();
     return author;
 }
 
 std::optional<domain::Author> UseCasesImpl::GetAuthorById(const AuthorId& id) const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAuthorById"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
     const std::optional<Author> author = uow_transaction->GetAuthorRepository().GetAuthorById(id);
     uow_transaction->Commit();
     return author;
 }
 
-std::vector<domain::Author> UseCasesImpl::GetAllAuthors() const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    const std::vector<domain::Author>& authors = uow_transaction->GetAuthorRepository().GetAllAuthors();
+domain::AuthorRows UseCasesImpl::GetAllAuthors() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAllAuthors"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    domain::AuthorRows authors = uow_transaction->GetAuthorRepository().GetAllAuthors();
+    uow_transaction->Commit();
+    call.SetRows(authors.Size());
+    return authors;
+}
+
+domain::AuthorRows UseCasesImpl::GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAuthorsByNamePrefix"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    domain::AuthorRows authors = uow_transaction->GetAuthorRepository().GetAuthorsByNamePrefix(prefix, limit);
     uow_transaction->Commit();
+    call.SetRows(authors.Size());
     return authors;
 }
 
@@ -76,91 +104,95 @@ std::vector<domain::Author> UseCasesImpl::GetAllAuthors() const {
 //
 // // // --- BOOK --- // // //
 
-void UseCasesImpl::AddBookByAuthorId(
+BookId UseCasesImpl::AddBookByAuthorId(
     const domain::AuthorId& author_id,
-    const std::string& title,
+    std::string title,
     int publication_year,
-    const std::vector<std::string>& tags
+    std::span<const std::string> tags
 ) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "AddBookByAuthorId"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    BookId book_id = BookId::New();
-    uow_transaction->GetBookRepository().Save(Book{book_id, author_id, title, publication_year});
+    const BookId book_id = BookId::New();
+    uow_transaction->GetBookRepository().Save(Book{book_id, author_id, std::move(title), publication_year});
     for (const std::string& tag : tags) {
-        uow_transaction->GetBookTagRepository().Save(BookTag{book_id, tag});
+        uow_transaction->GetBookTagRepository().Save(book_id, tag);
     }
     uow_transaction->Commit();
+    return book_id;
 }
 
-void UseCasesImpl::AddBookByAuthorName(
-    const std::string& author_name,
-    const std::string &title,
+BookId UseCasesImpl::AddBookByAuthorName(
+    std::string author_name,
+    std::string title,
     int publication_year,
-    const std::vector<std::string> &tags
+    std::span<const std::string> tags
 ) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "AddBookByAuthorName"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    AuthorId author_id = AuthorId::New();
-    uow_transaction->GetAuthorRepository().Save(Author{author_id, author_name});
+    const AuthorId author_id = AuthorId::New();
+    uow_transaction->GetAuthorRepository().Save(Author{author_id, std::move(author_name)});
 
-    BookId book_id = BookId::New();
-    uow_transaction->GetBookRepository().Save(Book{book_id, author_id, title, publication_year});
+    const BookId book_id = BookId::New();
+    uow_transaction->GetBookRepository().Save(Book{book_id, author_id, std::move(title), publication_year});
 
     for (const std::string& tag : tags) {
-        uow_transaction->GetBookTagRepository().Save(BookTag{book_id, tag});
+        uow_transaction->GetBookTagRepository().Save(book_id, tag);
     }
     uow_transaction->Commit();
+    return book_id;
 }
 
-bool UseCasesImpl::EditBook(
+std::optional<domain::Book> UseCasesImpl::EditBook(
     const BookId& id,
-    const std::string& title, 
+    std::string_view title,
     int publication_year,
-    const std::vector<std::string>& tags
+    std::span<const std::string> tags
 ) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "EditBook"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    const std::optional<Book> book = uow_transaction->GetBookRepository().GetBookById(id);
+    // Строка книги заблокирована до фиксации, поэтому прежние теги и название не изменит
+    // одновременная запись той же книги
+    std::optional<Book> book = uow_transaction->GetBookRepository().GetBookByIdForUpdate(id);
     if (book.has_value()) {
+        book->SetTags(uow_transaction->GetBookTagRepository().GetTags(id));
         uow_transaction->GetBookRepository().Edit(book->GetId(), title, publication_year);
-        const std::vector<BookTag>& book_tags = uow_transaction->GetBookTagRepository().GetBookTags(book->GetId());
-        if (!book_tags.empty()) {
-            uow_transaction->GetBookTagRepository().DeleteByBookId(book->GetId());
-        }
+        uow_transaction->GetBookTagRepository().DeleteByBookId(book->GetId());
         for (const std::string& tag : tags) {
-            uow_transaction->GetBookTagRepository().Save(BookTag{book->GetId(), tag});
+            uow_transaction->GetBookTagRepository().Save(book->GetId(), tag);
         }
         uow_transaction->Commit();
-        return true;
+        return book;
     }
     uow_transaction->Commit();
-    return false;
+    return std::nullopt;
 }
 
-bool UseCasesImpl::DeleteBook(const BookId& id) {
+std::optional<domain::Book> UseCasesImpl::DeleteBook(const BookId& id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "DeleteBook"sv);
+    metrics::ScopedCall call{stats, true};
     std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    const std::optional<Book> book = uow_transaction->GetBookRepository().GetBookById(id);
+    std::optional<Book> book = uow_transaction->GetBookRepository().GetBookByIdForUpdate(id);
     if (book.has_value()) {
+        book->SetTags(uow_transaction->GetBookTagRepository().GetTags(id));
         uow_transaction->GetBookTagRepository().DeleteByBookId(book->GetId());
         uow_transaction->GetBookRepository().Delete(book->GetId());
         uow_transaction->Commit();
-        return true;
+        return book;
     }
     uow_transaction->Commit();
-    return false;
+    return std::nullopt;
 }
 
 std::optional<domain::Book> UseCasesImpl::GetBook(const BookId& id) const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBook"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
     std::optional<Book> book = uow_transaction->GetBookRepository().GetBookById(id);
     if (book.has_value()) {
-        std::vector<BookTag> book_tags = uow_transaction->GetBookTagRepository().GetBookTags(id);
-        std::vector<std::string> tags;
-        tags.reserve(book_tags.size());
-        std::transform(
-            book_tags.begin(),
-            book_tags.end(),
-            std::inserter(tags, tags.end()),
-            [](const BookTag& book_tag) { return book_tag.GetTag(); }
-        );
-        book->SetTags(tags);
+        book->SetTags(uow_transaction->GetBookTagRepository().GetTags(id));
         uow_transaction->Commit();
         return book;
     }
@@ -168,27 +200,152 @@ std::optional<domain::Book> UseCasesImpl::GetBook(const BookId& id) const {
     return book;
 }
 
-std::vector<domain::Book> UseCasesImpl::GetBooksByTitle(const std::string& title) const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
+std::vector<domain::Book> UseCasesImpl::GetBooksByTitle(std::string_view title) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByTitle"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
     std::vector<domain::Book> books = uow_transaction->GetBookRepository().GetBooksByTitle(title);
     uow_transaction->Commit();
+    call.SetRows(books.size());
     return books;
 }
 
-std::vector<domain::Book> UseCasesImpl::GetAllBooks() const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    std::vector<domain::Book> books = uow_transaction->GetBookRepository().GetAllBooks();
+domain::BookRows UseCasesImpl::GetAllBooks() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAllBooks"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    domain::BookRows books = uow_transaction->GetBookRepository().GetAllBooks();
     uow_transaction->Commit();
+    call.SetRows(books.Size());
     return books;
 }
 
-std::vector<domain::Book> UseCasesImpl::GetBooksByAuthorId(const domain::AuthorId& author_id) const {
-    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateUnitOfWork();
-    std::vector<domain::Book> books = uow_transaction->GetBookRepository().GetBooksByAuthorId(author_id);
+domain::BookRows UseCasesImpl::GetBooksByAuthorId(const domain::AuthorId& author_id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByAuthorId"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    domain::BookRows books = uow_transaction->GetBookRepository().GetBooksByAuthorId(author_id);
+    uow_transaction->Commit();
+    call.SetRows(books.Size());
+    return books;
+}
+
+domain::BookRows UseCasesImpl::GetBooksByYearRange(int from, int to) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByYearRange"sv);
+    metrics::ScopedCall call{stats, true};
+    if (from > to) {
+        return {};
+    }
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    domain::BookRows books = uow_transaction->GetBookRepository().GetBooksByYearRange(from, to);
+    uow_transaction->Commit();
+    call.SetRows(books.Size());
+    return books;
+}
+
+domain::BookRows UseCasesImpl::GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetBooksByTitlePrefix"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    domain::BookRows books = uow_transaction->GetBookRepository().GetBooksByTitlePrefix(prefix, limit);
     uow_transaction->Commit();
+    call.SetRows(books.Size());
     return books;
 }
 
+std::vector<domain::TagBookCount> UseCasesImpl::GetTagsByAuthorId(const domain::AuthorId& author_id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetTagsByAuthorId"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    std::vector<domain::TagBookCount> tags = uow_transaction->GetBookTagRepository().GetTagCountsByAuthorId(author_id);
+    uow_transaction->Commit();
+    call.SetRows(tags.size());
+    return tags;
+}
+
 // // // --- BOOK --- // // //
+//
+//
+//
+// // // --- STATISTICS --- // // //
+
+domain::CatalogStatistics UseCasesImpl::GetStatistics(std::size_t top_n) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetStatistics"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    const StatisticsRepository& repository = uow_transaction->GetStatisticsRepository();
+    domain::CatalogStatistics statistics{
+        repository.GetTotals(),
+        repository.GetTopAuthors(top_n),
+        repository.GetTopTags(top_n),
+        repository.GetBooksPerYear()
+    };
+    uow_transaction->Commit();
+    call.SetRows(statistics.top_authors.size() + statistics.top_tags.size() + statistics.books_per_year.size());
+    return statistics;
+}
+
+// // // --- STATISTICS --- // // //
+//
+//
+//
+// // // --- SEARCH --- // // //
+
+std::vector<domain::TagBookCount> UseCasesImpl::CompleteTag(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "CompleteTag"sv);
+    metrics::ScopedCall call{stats, true};
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    std::vector<domain::TagBookCount> tags = uow_transaction->GetStatisticsRepository().GetTopTagsByPrefix(prefix, limit);
+    uow_transaction->Commit();
+    call.SetRows(tags.size());
+    return tags;
+}
+
+std::vector<domain::FuzzyMatch> UseCasesImpl::FuzzyFind(std::string_view text, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "FuzzyFind"sv);
+    metrics::ScopedCall call{stats, true};
+    // Без индекса в памяти процесса каждая запись сравнивается с запросом: O(авторов + книг)
+    std::vector<domain::FuzzyMatch> matches;
+    // Те же ограничения запроса, что и у TrigramIndex::Find
+    if (limit == 0 || text.size() > TrigramIndex::kMaxTextSize) {
+        return matches;
+    }
+    const std::vector<std::uint32_t> query = TrigramIndex::Trigrams(text);
+    if (query.empty()) {
+        return matches;
+    }
+    const auto consider = [&matches, &query](auto id, std::string_view candidate) -> domain::FuzzyMatch* {
+        const double similarity = TrigramIndex::Similarity(query, TrigramIndex::Trigrams(candidate));
+        if (similarity < TrigramIndex::kDefaultThreshold) {
+            return nullptr;
+        }
+        domain::FuzzyMatch& match = matches.emplace_back();
+        match.id = id;
+        match.text = candidate;
+        match.similarity = similarity;
+        return &match;
+    };
+    std::unique_ptr<UnitOfWork> uow_transaction = unit_of_work_factory_.CreateReadOnlyUnitOfWork();
+    for (const domain::AuthorRow author : uow_transaction->GetAuthorRepository().GetAllAuthors()) {
+        consider(author.GetId(), author.GetName());
+    }
+    for (const domain::BookRow book : uow_transaction->GetBookRepository().GetAllBooks()) {
+        if (domain::FuzzyMatch* match = consider(book.GetId(), book.GetTitle())) {
+            match->author_name = book.GetAuthorName();
+            match->publication_year = book.GetPublicationYear();
+        }
+    }
+    uow_transaction->Commit();
+
+    const auto top = matches.begin() + static_cast<std::ptrdiff_t>(std::min(limit, matches.size()));
+    std::partial_sort(matches.begin(), top, matches.end(), [](const domain::FuzzyMatch& lhs, const domain::FuzzyMatch& rhs) {
+        return std::tie(rhs.similarity, lhs.text) < std::tie(lhs.similarity, rhs.text);
+    });
+    matches.erase(top, matches.end());
+    call.SetRows(matches.size());
+    return matches;
+}
+
+// // // --- SEARCH --- // // //
 
 }  // namespace app
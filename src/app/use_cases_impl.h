@@ -15,14 +15,15 @@ public:
 
     // // // --- AUTHOR --- // // //
 
-    void AddAuthor(const std::string& name) override;
-    bool EditAuthor(const AuthorId& id, const std::string& new_name) override;
+    AuthorId AddAuthor(std::string name) override;
+    bool EditAuthor(const AuthorId& id, std::string_view new_name) override;
     bool DeleteAuthor(const AuthorId& id) override;
     
-    std::optional<domain::Author> GetAuthorByName(const std::string& name) const override;
+    std::optional<domain::Author> GetAuthorByName(std::string_view name) const override;
     std::optional<domain::Author> GetAuthorById(const AuthorId& id) const override;
 
-    std::vector<domain::Author> GetAllAuthors() const override;
+    domain::AuthorRows GetAllAuthors() const override;
+    domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override;
 
     // // // --- AUTHOR --- // // //
     //
@@ -30,30 +31,52 @@ public:
     //
     // // // --- BOOK --- // // //
     
-    void AddBookByAuthorId(
+    BookId AddBookByAuthorId(
         const domain::AuthorId& author_id,
-        const std::string& title,
+        std::string title,
         int publication_year,
-        const std::vector<std::string>& tags
+        std::span<const std::string> tags
     ) override;
-    void AddBookByAuthorName(
-        const std::string& author_name,
-        const std::string &title,
+    BookId AddBookByAuthorName(
+        std::string author_name,
+        std::string title,
         int publication_year,
-        const std::vector<std::string> &tags
+        std::span<const std::string> tags
     ) override;
-    bool EditBook(
+    std::optional<domain::Book> EditBook(
         const BookId& id,
-        const std::string& title, 
+        std::string_view title,
         int publication_year,
-        const std::vector<std::string>& tags
+        std::span<const std::string> tags
     ) override;
-    bool DeleteBook(const BookId& id) override;
+    std::optional<domain::Book> DeleteBook(const BookId& id) override;
 
     std::optional<domain::Book> GetBook(const BookId& id) const override;
-    std::vector<domain::Book> GetBooksByTitle(const std::string& title) const override;
-    std::vector<domain::Book> GetAllBooks() const override;
-    std::vector<domain::Book> GetBooksByAuthorId(const domain::AuthorId& author_id) const override;
+    std::vector<domain::Book> GetBooksByTitle(std::string_view title) const override;
+    domain::BookRows GetAllBooks() const override;
+    domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const override;
+    domain::BookRows GetBooksByYearRange(int from, int to) const override;
+    domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override;
+    std::vector<domain::TagBookCount> GetTagsByAuthorId(const domain::AuthorId& author_id) const override;
+
+    // // // --- BOOK --- // // //
+    //
+    //
+    //
+    // // // --- STATISTICS --- // // //
+
+    domain::CatalogStatistics GetStatistics(std::size_t top_n) const override;
+
+    // // // --- STATISTICS --- // // //
+    //
+    //
+    //
+    // // // --- SEARCH --- // // //
+
+    std::vector<domain::TagBookCount> CompleteTag(std::string_view prefix, std::size_t limit) const override;
+    std::vector<domain::FuzzyMatch> FuzzyFind(std::string_view text, std::size_t limit) const override;
+
+    // // // --- SEARCH --- // // //
 
 private:
     UnitOfWorkFactory& unit_of_work_factory_;
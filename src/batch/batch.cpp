@@ -0,0 +1,311 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+#include "../app/identity_map_unit_of_work.h"
+#include "../app/shared_unit_of_work.h"
+#include "../app/use_cases_impl.h"
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "../util/string_util.h"
+
+namespace batch {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::string_view kIdPrefix = "id="sv;
+
+struct Option {
+    std::string key;
+    std::string value;
+};
+
+// Теги нормализуются так же, как в интерактивном режиме: пробелы схлопываются,
+// пустые и повторяющиеся теги отбрасываются. Слишком длинный тег — ошибка строки
+std::vector<std::string> ParseTags(std::string_view str) {
+    std::vector<std::string> tags;
+    while (!str.empty()) {
+        const std::size_t comma = str.find(',');
+        std::string tag = util::NormalizeTag(str.substr(0, comma));
+        if (util::Utf8Length(tag) > domain::kMaxTagLength) {
+            throw std::invalid_argument("Tags must be at most "s + std::to_string(domain::kMaxTagLength) + " characters long"s);
+        }
+        if (!tag.empty()) {
+            tags.push_back(std::move(tag));
+        }
+        str = comma == std::string_view::npos ? std::string_view{} : str.substr(comma + 1);
+    }
+    util::SortUniqueTags(tags);
+    return tags;
+}
+
+Ref ParseRef(const std::string& field) {
+    if (field.starts_with(kIdPrefix)) {
+        return {field.substr(kIdPrefix.size()), true};
+    }
+    return {field, false};
+}
+
+std::vector<Option> ParseOptions(const std::vector<std::string>& fields, std::size_t first) {
+    std::vector<Option> options;
+    for (std::size_t i = first; i < fields.size(); ++i) {
+        const std::size_t eq = fields[i].find('=');
+        if (eq == std::string::npos) {
+            options.push_back({fields[i], {}});
+        } else {
+            std::string key = boost::algorithm::trim_copy(fields[i].substr(0, eq));
+            std::string value = boost::algorithm::trim_copy(fields[i].substr(eq + 1));
+            options.push_back({std::move(key), std::move(value)});
+        }
+    }
+    return options;
+}
+
+// Год разбирается так же, как в интерактивном режиме: число должно занимать всё поле
+int ParseYear(std::string_view str) {
+    const std::optional<int> year = util::ParseInt(str);
+    if (!year) {
+        throw std::invalid_argument("Invalid publication year"s);
+    }
+    return *year;
+}
+
+void RequireNotEmpty(const std::string& value, std::string_view what) {
+    if (value.empty()) {
+        throw std::invalid_argument("Empty "s.append(what).append(" is not allowed"sv));
+    }
+}
+
+Action ParseAction(const std::string& line) {
+    std::vector<std::string> fields;
+    boost::split(fields, line, boost::is_any_of("|"));
+    for (std::string& field : fields) {
+        boost::algorithm::trim(field);
+    }
+
+    std::istringstream head{fields.front()};
+    std::string cmd;
+    head >> cmd;
+    std::string arg;
+    std::getline(head, arg);
+    boost::algorithm::trim(arg);
+
+    if (cmd == "AddAuthor"sv && fields.size() == 1) {
+        RequireNotEmpty(arg, "name"sv);
+        return AddAuthor{std::move(arg)};
+    }
+    if (cmd == "EditAuthor"sv && fields.size() == 2) {
+        RequireNotEmpty(arg, "name"sv);
+        RequireNotEmpty(fields[1], "new name"sv);
+        return EditAuthor{std::move(arg), fields[1]};
+    }
+    if (cmd == "DeleteAuthor"sv && fields.size() == 1) {
+        RequireNotEmpty(arg, "name"sv);
+        return DeleteAuthor{std::move(arg)};
+    }
+    if (cmd == "AddBook"sv && fields.size() >= 2) {
+        AddBook action;
+        const auto [year, title] = util::SplitFirstWord(arg);
+        action.publication_year = ParseYear(year);
+        action.title = title;
+        RequireNotEmpty(action.title, "title"sv);
+        RequireNotEmpty(fields[1], "author"sv);
+        action.author = ParseRef(fields[1]);
+        for (Option& option : ParseOptions(fields, 2)) {
+            if (option.key == "tags"sv) {
+                action.tags = ParseTags(option.value);
+            } else if (option.key == "create-author"sv && !action.author.is_id) {
+                action.create_author = true;
+            } else {
+                throw std::invalid_argument("Unknown option: "s + option.key);
+            }
+        }
+        return action;
+    }
+    if (cmd == "EditBook"sv) {
+        RequireNotEmpty(arg, "title"sv);
+        EditBook action{ParseRef(arg), std::nullopt, std::nullopt, std::nullopt};
+        for (Option& option : ParseOptions(fields, 1)) {
+            if (option.key == "title"sv) {
+                RequireNotEmpty(option.value, "title"sv);
+                action.title = std::move(option.value);
+            } else if (option.key == "year"sv) {
+                action.publication_year = ParseYear(option.value);
+            } else if (option.key == "tags"sv) {
+                action.tags = ParseTags(option.value);
+            } else {
+                throw std::invalid_argument("Unknown option: "s + option.key);
+            }
+        }
+        return action;
+    }
+    if (cmd == "DeleteBook"sv && fields.size() == 1) {
+        RequireNotEmpty(arg, "title"sv);
+        return DeleteBook{ParseRef(arg)};
+    }
+    throw std::invalid_argument("Invalid command: "s + cmd);
+}
+
+// // // --- EXECUTION --- // // //
+
+class Executor {
+public:
+    explicit Executor(app::UseCases& use_cases)
+    : use_cases_{use_cases}
+    {
+
+    }
+
+    void operator()(const AddAuthor& action) const {
+        if (use_cases_.GetAuthorByName(action.name)) {
+            throw std::runtime_error("This author has been added before"s);
+        }
+        use_cases_.AddAuthor(action.name);
+    }
+
+    void operator()(const EditAuthor& action) const {
+        if (!use_cases_.EditAuthor(FindAuthor(action.name).GetId(), action.new_name)) {
+            throw std::runtime_error("Failed to edit author"s);
+        }
+    }
+
+    void operator()(const DeleteAuthor& action) const {
+        if (!use_cases_.DeleteAuthor(FindAuthor(action.name).GetId())) {
+            throw std::runtime_error("Failed to delete author"s);
+        }
+    }
+
+    void operator()(const AddBook& action) const {
+        if (action.author.is_id) {
+            use_cases_.AddBookByAuthorId(
+                domain::AuthorId::FromString(action.author.value), action.title, action.publication_year, action.tags
+            );
+        } else if (std::optional<domain::Author> author = use_cases_.GetAuthorByName(action.author.value)) {
+            use_cases_.AddBookByAuthorId(author->GetId(), action.title, action.publication_year, action.tags);
+        } else if (action.create_author) {
+            use_cases_.AddBookByAuthorName(action.author.value, action.title, action.publication_year, action.tags);
+        } else {
+            throw std::runtime_error("Author not found: "s + action.author.value + " (use create-author)"s);
+        }
+    }
+
+    void operator()(const EditBook& action) const {
+        const domain::Book book = FindBook(action.book);
+        if (!use_cases_.EditBook(
+            book.GetId(),
+            action.title ? std::string_view{*action.title} : std::string_view{book.GetTitle()},
+            action.publication_year.value_or(book.GetPublicationYear()),
+            action.tags ? *action.tags : book.GetTags()
+        )) {
+            throw std::runtime_error("Book not found"s);
+        }
+    }
+
+    void operator()(const DeleteBook& action) const {
+        if (!use_cases_.DeleteBook(FindBook(action.book).GetId())) {
+            throw std::runtime_error("Book not found"s);
+        }
+    }
+
+private:
+    domain::Author FindAuthor(const std::string& name) const {
+        if (std::optional<domain::Author> author = use_cases_.GetAuthorByName(name)) {
+            return *std::move(author);
+        }
+        throw std::runtime_error("Author not found: "s + name);
+    }
+
+    // Вместо интерактивного SelectBook неоднозначное название считается ошибкой
+    domain::Book FindBook(const Ref& ref) const {
+        if (ref.is_id) {
+            if (std::optional<domain::Book> book = use_cases_.GetBook(domain::BookId::FromString(ref.value))) {
+                return *std::move(book);
+            }
+            throw std::runtime_error("Book not found: id="s + ref.value);
+        }
+        std::vector<domain::Book> books = use_cases_.GetBooksByTitle(ref.value);
+        if (books.empty()) {
+            throw std::runtime_error("Book not found: "s + ref.value);
+        }
+        if (books.size() > 1) {
+            throw std::runtime_error("Several books titled "s + ref.value + ", use id=<book id>"s);
+        }
+        // Теги и автор заполняются только в GetBook
+        if (std::optional<domain::Book> book = use_cases_.GetBook(books.front().GetId())) {
+            return *std::move(book);
+        }
+        throw std::runtime_error("Book not found: "s + ref.value);
+    }
+
+    app::UseCases& use_cases_;
+};
+
+}  // namespace
+
+std::vector<Command> ParseCommands(std::istream& input) {
+    std::vector<Command> commands;
+    std::string line;
+    for (std::size_t line_number = 1; std::getline(input, line); ++line_number) {
+        boost::algorithm::trim(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        try {
+            commands.push_back({line_number, ParseAction(line)});
+        } catch (const std::exception& e) {
+            throw ParseError("line "s + std::to_string(line_number) + ": "s + e.what());
+        }
+    }
+    return commands;
+}
+
+BatchResult BatchRunner::Run(const std::vector<Command>& commands, std::ostream& output) {
+    // Транзакция пакета живёт дольше одной команды, поэтому повторные поиски автора
+    // и книги по id внутри неё обслуживаются картой идентичности
+    app::IdentityMapUnitOfWorkFactory identity_map{unit_of_work_factory_};
+    app::SharedUnitOfWorkFactory shared_factory{identity_map};
+    app::UseCasesImpl use_cases{shared_factory};
+    const Executor executor{use_cases};
+
+    BatchResult result;
+    std::size_t in_chunk = 0;
+    auto commit_chunk = [&] {
+        shared_factory.CommitShared();
+        result.applied += in_chunk;
+        ++result.transactions;
+        in_chunk = 0;
+    };
+
+    for (const Command& command : commands) {
+        try {
+            std::visit(executor, command.action);
+            if (++in_chunk == chunk_size_) {
+                commit_chunk();
+            }
+        } catch (const std::exception& e) {
+            shared_factory.Rollback();
+            output << "line "sv << command.line << ": "sv << e.what() << '\n';
+            result.failed = true;
+            return result;
+        }
+    }
+    if (in_chunk != 0) {
+        try {
+            commit_chunk();
+        } catch (const std::exception& e) {
+            output << "commit failed: "sv << e.what() << '\n';
+            result.failed = true;
+        }
+    }
+    return result;
+}
+
+}  // namespace batch
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace app {
+class UnitOfWorkFactory;
+}
+
+namespace batch {
+
+// Ссылка на автора или книгу: либо имя (название), либо явный идентификатор (id=<uuid>)
+struct Ref {
+    std::string value;
+    bool is_id = false;
+};
+
+struct AddAuthor {
+    std::string name;
+};
+
+struct EditAuthor {
+    std::string name;
+    std::string new_name;
+};
+
+struct DeleteAuthor {
+    std::string name;
+};
+
+struct AddBook {
+    int publication_year = 0;
+    std::string title;
+    Ref author;
+    std::vector<std::string> tags;
+    // Создать автора, если автора с таким именем нет (вместо вопроса OfferToAddAuthor)
+    bool create_author = false;
+};
+
+struct EditBook {
+    Ref book;
+    std::optional<std::string> title;
+    std::optional<int> publication_year;
+    // Если не заданы, у книги остаются текущие теги
+    std::optional<std::vector<std::string>> tags;
+};
+
+struct DeleteBook {
+    Ref book;
+};
+
+using Action = std::variant<AddAuthor, EditAuthor, DeleteAuthor, AddBook, EditBook, DeleteBook>;
+
+struct Command {
+    std::size_t line = 0;
+    Action action;
+};
+
+class ParseError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Разбирает весь файл команд до начала выполнения. Формат строки:
+ *
+ *     AddAuthor <name>
+ *     EditAuthor <name> | <new name>
+ *     DeleteAuthor <name>
+ *     AddBook <pub year> <title> | <author name> or id=<author id> [| tags=<t1, t2>] [| create-author]
+ *     EditBook <title> or id=<book id> [| title=<title>] [| year=<pub year>] [| tags=<t1, t2>]
+ *     DeleteBook <title> or id=<book id>
+ *
+ * Пустые строки и строки, начинающиеся с '#', пропускаются.
+ * При ошибке бросает ParseError с номером строки.
+ */
+std::vector<Command> ParseCommands(std::istream& input);
+
+struct BatchResult {
+    std::size_t applied = 0;
+    std::size_t transactions = 0;
+    bool failed = false;
+};
+
+/**
+ * Выполняет разобранные команды через обычные use case'ы, но в общей транзакции:
+ * вся пачка целиком (chunk_size == 0) или порциями по chunk_size команд.
+ * Первая же ошибка откатывает текущую порцию и останавливает выполнение,
+ * уже зафиксированные порции остаются в базе.
+ */
+class BatchRunner {
+public:
+    BatchRunner(app::UnitOfWorkFactory& unit_of_work_factory, std::size_t chunk_size)
+    : unit_of_work_factory_{unit_of_work_factory}, chunk_size_{chunk_size}
+    {
+
+    }
+
+    // Сообщения об ошибках пишутся в output
+    BatchResult Run(const std::vector<Command>& commands, std::ostream& output);
+
+private:
+    app::UnitOfWorkFactory& unit_of_work_factory_;
+    std::size_t chunk_size_;
+};
+
+}  // namespace batch
@@ -1,7 +1,15 @@
 #include "bookypedia.h"
 
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
+#include "batch/batch.h"
 #include "menu/menu.h"
 #include "postgres/postgres.h"
 #include "ui/view.h"
@@ -9,22 +17,110 @@
 namespace bookypedia {
 
 using namespace std::literals;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
 
 Application::Application(const AppConfig& config)
-    : db_{pqxx::connection{config.db_url}} {
+    : listen_port_{config.listen_port}
+    , batch_file_{config.batch_file}
+    , batch_chunk_size_{config.batch_chunk_size}
+    , db_{config.db_url, config.db_shard_urls, config.db_pool_size, config.query_tracing, config.db_replicas}
+    , purge_worker_{db_.GetUnitOfWorkFactory(), config.purge} {
+    app::UseCases* use_cases = &use_cases_impl_;
+    if (config.catalog_cache) {
+        catalog_ = std::make_unique<app::CatalogUseCases>(use_cases_impl_);
+        use_cases = catalog_.get();
+    }
+    // Индексы поиска строятся по всему каталогу, а пакетный режим к ним не обращается
+    if (!batch_file_) {
+        search_ = std::make_unique<app::SearchUseCases>(*use_cases);
+    }
+    if (config.metrics_file) {
+        metrics_exporter_ = std::make_unique<metrics::PeriodicExporter>(
+            metrics::Registry::Get(), *config.metrics_file, config.metrics_period
+        );
+    }
+    if (config.profile_file) {
+        metrics::SetProfilingEnabled(true);
+        profile_exporter_ = std::make_unique<metrics::PeriodicExporter>(
+            metrics::Registry::Get(), *config.profile_file, config.metrics_period, metrics::ExportFormat::kProfile
+        );
+    }
 }
 
 void Application::Run() {
-    menu::Menu menu{std::cin, std::cout};
-    menu.AddAction("Help"s, {}, "Show instructions"s, [&menu](std::istream&) {
+    if (batch_file_) {
+        RunBatch(*batch_file_, batch_chunk_size_);
+    } else if (listen_port_) {
+        ServeTcp(*listen_port_);
+    } else {
+        RunSession(std::cin, std::cout);
+    }
+}
+
+void Application::RunSession(std::istream& input, std::ostream& output) {
+    menu::Menu menu{input, output};
+    menu.AddAction("Help"s, {}, "Show instructions"s, [&menu](std::string_view) {
         menu.ShowInstructions();
         return true;
     });
-    menu.AddAction("Exit"s, {}, "Exit program"s, [&menu](std::istream&) {
+    menu.AddAction("Stats"s, {}, "Show per-call latency statistics"s, [&output](std::string_view) {
+        metrics::Registry::Get().WriteSummary(output);
+        return true;
+    });
+    menu.AddAction("Exit"s, {}, "Exit program"s, [&menu](std::string_view) {
         return false;
     });
-    ui::View view{menu, use_cases_, std::cin, std::cout};
+    ui::View view{menu, *search_, input, output};
     menu.Run();
 }
 
+void Application::ServeTcp(unsigned short port) {
+    net::io_context ioc;
+    tcp::acceptor acceptor{ioc, tcp::endpoint{tcp::v4(), port}};
+    std::cout << "Listening on port "sv << port << std::endl;
+
+    // Сессия занимает поток на всё время соединения, но соединение с базой — только
+    // на время отдельного use case, поэтому ожидание ввода клиента не блокирует остальных
+    while (true) {
+        auto stream = std::make_unique<tcp::iostream>(acceptor.accept());
+        std::thread{[this, stream = std::move(stream)] {
+            try {
+                RunSession(*stream, *stream);
+            } catch (const std::exception& e) {
+                std::cerr << "Session failed: "sv << e.what() << std::endl;
+            }
+        }}.detach();
+    }
+}
+
+void Application::RunBatch(const std::filesystem::path& path, std::size_t chunk_size) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error("Failed to open batch file "s + path.string());
+    }
+
+    // Вывод копится в буфере и выводится одной записью в конце
+    std::ostringstream output;
+    std::vector<batch::Command> commands;
+    try {
+        commands = batch::ParseCommands(file);
+    } catch (const batch::ParseError& e) {
+        std::cout << e.what() << std::endl;
+        throw;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const batch::BatchResult result
+        = batch::BatchRunner{db_.GetUnitOfWorkFactory(), chunk_size}.Run(commands, output);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    output << "Applied "sv << result.applied << " of "sv << commands.size() << " commands in "sv
+           << result.transactions << " transactions, "sv << seconds << " s"sv << '\n';
+    std::cout << output.str() << std::flush;
+    if (result.failed) {
+        throw std::runtime_error("Batch failed"s);
+    }
+}
+
 }  // namespace bookypedia
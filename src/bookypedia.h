@@ -1,13 +1,49 @@
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <optional>
 #include <pqxx/pqxx>
+#include <string>
+#include <vector>
 
+#include "app/catalog_use_cases.h"
+#include "app/identity_map_unit_of_work.h"
+#include "app/purge_worker.h"
+#include "app/search_use_cases.h"
 #include "app/use_cases_impl.h"
-#include "postgres/postgres.h"
+#include "metrics/metrics.h"
+#include "postgres/sharded_database.h"
 
 namespace bookypedia {
 
 struct AppConfig {
+    // Основная база: все записи и чтения, если реплики не заданы
     std::string db_url;
+    // Реплики для сценариев, которые только читают
+    postgres::ReplicaConfig db_replicas;
+    // Дополнительные шарды: авторы с книгами распределяются между db_url и ими (см. app::ShardOfAuthor)
+    std::vector<std::string> db_shard_urls;
+    // Если задан, метрики периодически выгружаются в этот файл в формате Prometheus
+    std::optional<std::filesystem::path> metrics_file;
+    std::chrono::milliseconds metrics_period{std::chrono::seconds{15}};
+    // Если задан, use case'ы и команды профилируются аппаратными счётчиками,
+    // сводка выгружается в этот файл с тем же периодом, что и метрики
+    std::optional<std::filesystem::path> profile_file;
+    postgres::QueryTracingConfig query_tracing;
+    // Если задан, команды принимаются по TCP: каждое соединение получает собственное меню
+    std::optional<unsigned short> listen_port;
+    std::size_t db_pool_size = 1;
+    // Если задан, команды пакетного режима выполняются из файла без интерактивных вопросов
+    std::optional<std::filesystem::path> batch_file;
+    // Число команд в одной транзакции пакетного режима, 0 — весь файл одной транзакцией
+    std::size_t batch_chunk_size = 0;
+    // Читать списки авторов и книг из снимка каталога в памяти (см. app::CatalogUseCases)
+    bool catalog_cache = false;
+    // Фоновая очистка книг и тегов удалённых авторов (см. app::PurgeWorker)
+    app::PurgeSettings purge;
 };
 
 class Application {
@@ -17,8 +53,25 @@ public:
     void Run();
 
 private:
-    postgres::Database db_;
-    app::UseCasesImpl use_cases_{db_.GetUnitOfWorkFactoryFactory()};
+    // Выполняет команды из input до конца потока или команды Exit
+    void RunSession(std::istream& input, std::ostream& output);
+    void ServeTcp(unsigned short port);
+    void RunBatch(const std::filesystem::path& path, std::size_t chunk_size);
+
+    std::optional<unsigned short> listen_port_;
+    std::optional<std::filesystem::path> batch_file_;
+    std::size_t batch_chunk_size_;
+    postgres::ShardedDatabase db_;
+    app::IdentityMapUnitOfWorkFactory identity_map_{db_.GetUnitOfWorkFactory()};
+    app::UseCasesImpl use_cases_impl_{identity_map_};
+    std::unique_ptr<app::CatalogUseCases> catalog_;
+    // Поверх снимка каталога, если он включён: записи через него обновляют индекс тегов.
+    // Только для интерактивного режима и TCP
+    std::unique_ptr<app::SearchUseCases> search_;
+    std::unique_ptr<metrics::PeriodicExporter> metrics_exporter_;
+    std::unique_ptr<metrics::PeriodicExporter> profile_exporter_;
+    // Объявлен после db_: останавливается раньше, чем закрываются соединения
+    app::PurgeWorker purge_worker_;
 };
 
 }  // namespace bookypedia
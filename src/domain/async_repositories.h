@@ -0,0 +1,61 @@
+#pragma once
+
+#include <boost/asio/awaitable.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "author.h"
+#include "book.h"
+#include "book_tag.h"
+
+namespace domain {
+
+// Асинхронные аналоги AuthorRepository, BookRepository и BookTagRepository.
+// Аргументы принимаются по значению, так как живут в кадре корутины.
+
+class AsyncAuthorRepository {
+public:
+    virtual boost::asio::awaitable<void> Save(Author author) = 0;
+    virtual boost::asio::awaitable<void> Edit(AuthorId id, std::string new_name) = 0;
+    virtual boost::asio::awaitable<void> Delete(AuthorId id) = 0;
+    virtual boost::asio::awaitable<void> MarkDeleted(AuthorId id) = 0;
+
+    virtual boost::asio::awaitable<std::vector<Author>> GetAllAuthors() = 0;
+    virtual boost::asio::awaitable<std::optional<Author>> GetAuthorByName(std::string name) = 0;
+    virtual boost::asio::awaitable<std::optional<Author>> GetAuthorById(AuthorId id) = 0;
+
+protected:
+    ~AsyncAuthorRepository() = default;
+};
+
+class AsyncBookRepository {
+public:
+    virtual boost::asio::awaitable<void> Save(Book book) = 0;
+    virtual boost::asio::awaitable<void> Edit(BookId id, std::string title, int publication_year) = 0;
+    virtual boost::asio::awaitable<void> Delete(BookId id) = 0;
+
+    virtual boost::asio::awaitable<std::optional<Book>> GetBookById(BookId id) = 0;
+    virtual boost::asio::awaitable<std::vector<Book>> GetBooksByTitle(std::string title) = 0;
+    virtual boost::asio::awaitable<std::vector<Book>> GetAllBooks() = 0;
+    virtual boost::asio::awaitable<std::vector<Book>> GetBooksByAuthorId(AuthorId author_id) = 0;
+
+    virtual boost::asio::awaitable<void> DeleteBooksByAuthorId(AuthorId author_id) = 0;
+
+protected:
+    ~AsyncBookRepository() = default;
+};
+
+class AsyncBookTagRepository {
+public:
+    virtual boost::asio::awaitable<void> Save(BookTag book_tag) = 0;
+    virtual boost::asio::awaitable<void> DeleteByBookId(BookId book_id) = 0;
+    virtual boost::asio::awaitable<void> DeleteByAuthorId(AuthorId author_id) = 0;
+
+    virtual boost::asio::awaitable<std::vector<BookTag>> GetBookTags(BookId book_id) = 0;
+
+protected:
+    ~AsyncBookTagRepository() = default;
+};
+
+}  // namespace domain
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../util/tagged_uuid.h"
 #include "author_fwd.h"
+#include "author_rows.h"
 
 namespace domain {
 
@@ -35,12 +38,20 @@ private:
 class AuthorRepository {
 public:
     virtual void Save(const Author& author) = 0;
-    virtual void Edit(const AuthorId& id, const std::string& new_name) = 0;
+    virtual void Edit(const AuthorId& id, std::string_view new_name) = 0;
+    // Удаляет строку автора сразу; его книги к этому моменту должны быть удалены
     virtual void Delete(const AuthorId& id) = 0;
-
-    virtual std::vector<Author> GetAllAuthors() const = 0;
-    virtual std::optional<Author> GetAuthorByName(const std::string& name) const = 0;
+    // Помечает автора удалённым: чтения больше не видят ни его, ни его книг,
+    // а сами строки позже удаляет фоновая очистка (см. app::PurgeWorker)
+    virtual void MarkDeleted(const AuthorId& id) = 0;
+
+    virtual AuthorRows GetAllAuthors() const = 0;
+    // Не более limit авторов, чьё имя начинается с prefix, по имени (побайтово)
+    virtual AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const = 0;
+    virtual std::optional<Author> GetAuthorByName(std::string_view name) const = 0;
     virtual std::optional<Author> GetAuthorById(const AuthorId& id) const = 0;
+    // Помеченные удалёнными и ещё не вычищенные авторы в порядке удаления
+    virtual std::vector<AuthorId> GetDeletedAuthorIds() const = 0;
 
 protected:
     ~AuthorRepository() = default;
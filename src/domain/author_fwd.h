@@ -9,7 +9,9 @@ class Author;
 class AuthorRepository;
 
 namespace detail {
-struct AuthorTag {};
+struct AuthorTag {
+    static constexpr util::UUIDVersion kUUIDVersion = util::UUIDVersion::kTimeOrdered;
+};
 }  // namespace detail
 
 using AuthorId = util::TaggedUUID<detail::AuthorTag>;
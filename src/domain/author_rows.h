@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "author_fwd.h"
+#include "row_set.h"
+
+namespace domain {
+
+class AuthorRowSource {
+public:
+    virtual std::size_t Size() const noexcept = 0;
+    virtual AuthorId GetId(std::size_t row) const = 0;
+    virtual std::string_view GetName(std::size_t row) const noexcept = 0;
+
+    virtual ~AuthorRowSource() = default;
+};
+
+class AuthorRow {
+public:
+    AuthorRow(const AuthorRowSource& source, std::size_t index) noexcept
+    : source_{&source}, index_{index}
+    {
+
+    }
+
+    AuthorId GetId() const {
+        return source_->GetId(index_);
+    }
+
+    std::string_view GetName() const noexcept {
+        return source_->GetName(index_);
+    }
+
+private:
+    const AuthorRowSource* source_;
+    std::size_t index_;
+};
+
+using AuthorRows = RowSet<AuthorRowSource, AuthorRow>;
+
+}  // namespace domain
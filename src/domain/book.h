@@ -1,12 +1,15 @@
 #pragma once
 
-#include <string>
+#include <cstddef>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "../util/tagged_uuid.h"
 #include "book_fwd.h"
 #include "author.h"
+#include "book_rows.h"
 
 namespace domain {
 
@@ -21,7 +24,7 @@ public:
 
     }
 
-    Book(BookId id, AuthorId author_id, std::string title, int publication_year, const std::string& author_name) 
+    Book(BookId id, AuthorId author_id, std::string title, int publication_year, std::string author_name)
     : id_(std::move(id)), author_id_(std::move(author_id)), 
     title_(std::move(title)), publication_year_(publication_year), author_name_{std::move(author_name)}
     {
@@ -44,7 +47,7 @@ public:
         return publication_year_;
     }
 
-    std::optional<std::string> GetAuthorName() const noexcept {
+    const std::optional<std::string>& GetAuthorName() const noexcept {
         return author_name_;
     }
 
@@ -52,7 +55,7 @@ public:
         return tags_;
     }
     
-    void SetTags(const std::vector<std::string>& tags) {
+    void SetTags(std::vector<std::string> tags) noexcept {
         tags_ = std::move(tags);
     }
 
@@ -68,13 +71,23 @@ private:
 class BookRepository {
 public:
     virtual void Save(const Book& book) = 0;
-    virtual void Edit(const BookId& id, const std::string& title, int publication_year) = 0;
+    virtual void Edit(const BookId& id, std::string_view title, int publication_year) = 0;
     virtual void Delete(const BookId& id) = 0;
 
     virtual std::optional<Book> GetBookById(const BookId& id) = 0;
-    virtual std::vector<Book> GetBooksByTitle(const std::string& title) = 0;
-    virtual std::vector<Book> GetAllBooks() = 0;
-    virtual std::vector<Book> GetBooksByAuthorId(const AuthorId& author_id) const = 0;
+    // Как GetBookById, но строка книги блокируется от чужих записей до конца транзакции
+    virtual std::optional<Book> GetBookByIdForUpdate(const BookId& id) = 0;
+    // Книги возвращаются вместе с именем автора
+    virtual std::vector<Book> GetBooksByTitle(std::string_view title) = 0;
+    // Списки читаются прямо из результата запроса, книги — вместе с именем автора
+    virtual BookRows GetAllBooks() = 0;
+    virtual BookRows GetBooksByAuthorId(const AuthorId& author_id) const = 0;
+    // Книги, изданные с from по to включительно, по году и названию
+    virtual BookRows GetBooksByYearRange(int from, int to) const = 0;
+    // Не более limit книг, чьё название начинается с prefix, по названию, имени автора и году (побайтово)
+    virtual BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const = 0;
+    // Не более limit книг автора без сортировки, в том числе автора, помеченного удалённым
+    virtual std::vector<BookId> GetBookIdsByAuthorId(const AuthorId& author_id, std::size_t limit) const = 0;
 
     virtual void DeleteBooksByAuthorId(const AuthorId& author_id) = 0;
     
@@ -9,7 +9,9 @@ class Book;
 class BookRepository;
 
 namespace detail {
-struct BookTag {};
+struct BookTag {
+    static constexpr util::UUIDVersion kUUIDVersion = util::UUIDVersion::kTimeOrdered;
+};
 }  // namespace detail
 
 using BookId = util::TaggedUUID<detail::BookTag>;
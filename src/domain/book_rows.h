@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "author_fwd.h"
+#include "book_fwd.h"
+#include "row_set.h"
+
+namespace domain {
+
+class BookRowSource {
+public:
+    virtual std::size_t Size() const noexcept = 0;
+    virtual BookId GetId(std::size_t row) const = 0;
+    virtual AuthorId GetAuthorId(std::size_t row) const = 0;
+    virtual std::string_view GetTitle(std::size_t row) const noexcept = 0;
+    virtual int GetPublicationYear(std::size_t row) const = 0;
+    virtual std::string_view GetAuthorName(std::size_t row) const noexcept = 0;
+
+    virtual ~BookRowSource() = default;
+};
+
+class BookRow {
+public:
+    BookRow(const BookRowSource& source, std::size_t index) noexcept
+    : source_{&source}, index_{index}
+    {
+
+    }
+
+    BookId GetId() const {
+        return source_->GetId(index_);
+    }
+
+    AuthorId GetAuthorId() const {
+        return source_->GetAuthorId(index_);
+    }
+
+    std::string_view GetTitle() const noexcept {
+        return source_->GetTitle(index_);
+    }
+
+    int GetPublicationYear() const {
+        return source_->GetPublicationYear(index_);
+    }
+
+    std::string_view GetAuthorName() const noexcept {
+        return source_->GetAuthorName(index_);
+    }
+
+private:
+    const BookRowSource* source_;
+    std::size_t index_;
+};
+
+using BookRows = RowSet<BookRowSource, BookRow>;
+
+}  // namespace domain
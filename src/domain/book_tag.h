@@ -1,15 +1,22 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "book.h"
+#include "statistics.h"
 
 namespace domain {
 
+// Длина тега в символах: столбец book_tags.tag — varchar(30)
+inline constexpr std::size_t kMaxTagLength = 30;
+
 class BookTag {
 public:
-    BookTag(BookId book_id, const std::string& tag)
+    BookTag(BookId book_id, std::string tag)
     : book_id_(std::move(book_id)), tag_(std::move(tag)) 
     {
 
@@ -30,10 +37,13 @@ private:
 
 class BookTagRepository {
 public:
-    virtual void Save(const BookTag& book_tag) = 0;
+    virtual void Save(const BookId& book_id, std::string_view tag) = 0;
     virtual void DeleteByBookId(const BookId& book_id) = 0;
 
-    virtual std::vector<BookTag> GetBookTags(const BookId& book_id) const = 0;
+    // Теги книги в алфавитном порядке
+    virtual std::vector<std::string> GetTags(const BookId& book_id) const = 0;
+    // Теги всех книг автора с числом его книг у каждого, одним запросом, в алфавитном порядке
+    virtual std::vector<TagBookCount> GetTagCountsByAuthorId(const AuthorId& author_id) const = 0;
 
 protected:
     ~BookTagRepository() = default;
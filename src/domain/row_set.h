@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace domain {
+
+/**
+ * Результат выборки, который не копирует значения в доменные объекты.
+ * Source хранит данные (например, буфер результата запроса) и отдаёт поля по номеру строки,
+ * Row — лёгкое представление строки, декодирующее поля только при обращении к ним.
+ * Представления строк действительны, пока жив RowSet.
+ */
+template <typename Source, typename Row>
+class RowSet {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Row;
+
+        Iterator(const Source* source, std::size_t index) noexcept
+        : source_{source}, index_{index}
+        {
+
+        }
+
+        Row operator*() const noexcept {
+            return Row{*source_, index_};
+        }
+
+        Iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator prev = *this;
+            ++index_;
+            return prev;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+    private:
+        const Source* source_;
+        std::size_t index_;
+    };
+
+    RowSet() = default;
+
+    explicit RowSet(std::unique_ptr<const Source> source) noexcept
+    : source_{std::move(source)}
+    {
+
+    }
+
+    std::size_t Size() const noexcept {
+        return source_ ? source_->Size() : 0;
+    }
+
+    bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    Row operator[](std::size_t index) const noexcept {
+        return Row{*source_, index};
+    }
+
+    Iterator begin() const noexcept {
+        return Iterator{source_.get(), 0};
+    }
+
+    Iterator end() const noexcept {
+        return Iterator{source_.get(), Size()};
+    }
+
+private:
+    std::unique_ptr<const Source> source_;
+};
+
+}  // namespace domain
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <variant>
+
+#include "author.h"
+#include "book.h"
+#include "search_fwd.h"
+
+namespace domain {
+
+// Автор или книга, чьё имя или название похоже на искомый текст
+struct FuzzyMatch {
+    std::variant<AuthorId, BookId> id;
+    std::string text;
+    // Доля общих триграмм текста и запроса (коэффициент Жаккара), от 0 до 1
+    double similarity = 0;
+    // Для книги: имя автора и год издания, чтобы вывести её, не читая хранилище
+    std::string author_name;
+    int publication_year = 0;
+};
+
+}  // namespace domain
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace domain {
+
+struct FuzzyMatch;
+
+}  // namespace domain
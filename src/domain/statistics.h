@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "author.h"
+#include "statistics_fwd.h"
+
+namespace domain {
+
+struct CatalogTotals {
+    std::int64_t authors = 0;
+    std::int64_t books = 0;
+    // Различных тегов
+    std::int64_t tags = 0;
+};
+
+struct AuthorBookCount {
+    AuthorId author_id;
+    std::string name;
+    std::int64_t books = 0;
+};
+
+struct TagBookCount {
+    std::string tag;
+    std::int64_t books = 0;
+};
+
+struct YearBookCount {
+    int publication_year = 0;
+    std::int64_t books = 0;
+};
+
+struct CatalogStatistics {
+    CatalogTotals totals;
+    std::vector<AuthorBookCount> top_authors;
+    std::vector<TagBookCount> top_tags;
+    std::vector<YearBookCount> books_per_year;
+};
+
+// Число сводных строк, расходящихся с пересчётом по книгам и тегам, и строк, нарушающих
+// связи, которые секционированная таблица книг не проверяет сама
+struct StatisticsDrift {
+    std::size_t authors = 0;
+    std::size_t tags = 0;
+    std::size_t years = 0;
+    std::size_t totals = 0;
+    // Теги несуществующих книг
+    std::size_t orphan_tags = 0;
+    // id книг, встречающиеся в нескольких секциях
+    std::size_t duplicate_books = 0;
+
+    bool Empty() const noexcept {
+        return authors + tags + years + totals + orphan_tags + duplicate_books == 0;
+    }
+};
+
+/**
+ * Сводные счётчики каталога. Реализация обновляет их в той же транзакции, что и запись
+ * книг и тегов, поэтому чтения не пересчитывают исходные таблицы. Книги и теги авторов,
+ * помеченных удалёнными, вычитаются из счётчиков в момент пометки, а не после очистки.
+ */
+class StatisticsRepository {
+public:
+    virtual CatalogTotals GetTotals() const = 0;
+    // Авторы с наибольшим числом книг; при равенстве — в порядке id
+    virtual std::vector<AuthorBookCount> GetTopAuthors(std::size_t limit) const = 0;
+    // Теги с наибольшим числом книг; при равенстве — по алфавиту
+    virtual std::vector<TagBookCount> GetTopTags(std::size_t limit) const = 0;
+    // То же среди тегов, начинающихся с prefix (побайтово)
+    virtual std::vector<TagBookCount> GetTopTagsByPrefix(std::string_view prefix, std::size_t limit) const = 0;
+    // Годы по возрастанию, только с книгами
+    virtual std::vector<YearBookCount> GetBooksPerYear() const = 0;
+
+    // Сравнивает счётчики с полным пересчётом и проверяет связи книг и тегов; читает все книги и теги
+    virtual StatisticsDrift Verify() const = 0;
+    // Пересчитывает счётчики заново; запись книг и тегов на это время блокируется
+    virtual void Rebuild() = 0;
+
+protected:
+    ~StatisticsRepository() = default;
+};
+
+}  // namespace domain
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace domain {
+
+struct CatalogStatistics;
+struct TagBookCount;
+
+class StatisticsRepository;
+
+}  // namespace domain
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
@@ -9,22 +10,93 @@ using namespace std::literals;
 namespace {
 
 constexpr const char DB_URL_ENV_NAME[]{"BOOKYPEDIA_DB_URL"};
+constexpr const char DB_SHARD_URLS_ENV_NAME[]{"BOOKYPEDIA_DB_SHARD_URLS"};
+constexpr const char DB_REPLICA_URLS_ENV_NAME[]{"BOOKYPEDIA_DB_REPLICA_URLS"};
+constexpr const char DB_REPLICA_ROUTING_ENV_NAME[]{"BOOKYPEDIA_DB_REPLICA_ROUTING"};
+constexpr const char DB_READ_YOUR_WRITES_ENV_NAME[]{"BOOKYPEDIA_DB_READ_YOUR_WRITES"};
+constexpr const char METRICS_FILE_ENV_NAME[]{"BOOKYPEDIA_METRICS_FILE"};
+constexpr const char METRICS_PERIOD_ENV_NAME[]{"BOOKYPEDIA_METRICS_PERIOD_MS"};
+constexpr const char SLOW_QUERY_ENV_NAME[]{"BOOKYPEDIA_SLOW_QUERY_MS"};
+constexpr const char QUERY_SAMPLE_RATE_ENV_NAME[]{"BOOKYPEDIA_QUERY_SAMPLE_RATE"};
+constexpr const char QUERY_LOG_ALL_ENV_NAME[]{"BOOKYPEDIA_QUERY_LOG_ALL"};
+constexpr const char DB_POOL_SIZE_ENV_NAME[]{"BOOKYPEDIA_DB_POOL_SIZE"};
+constexpr const char CATALOG_CACHE_ENV_NAME[]{"BOOKYPEDIA_CATALOG_CACHE"};
+constexpr const char PROFILE_FILE_ENV_NAME[]{"BOOKYPEDIA_PROFILE_FILE"};
+constexpr const char PURGE_BATCH_SIZE_ENV_NAME[]{"BOOKYPEDIA_PURGE_BATCH_SIZE"};
+constexpr const char PURGE_PAUSE_ENV_NAME[]{"BOOKYPEDIA_PURGE_PAUSE_MS"};
 
-bookypedia::AppConfig GetConfigFromEnv() {
+// Число соединений с базой в режиме TCP-сервера, если не задано явно
+constexpr std::size_t kDefaultServerPoolSize = 8;
+
+bookypedia::AppConfig GetConfig(int argc, const char* argv[]) {
     bookypedia::AppConfig config;
     if (const auto* url = std::getenv(DB_URL_ENV_NAME)) {
         config.db_url = url;
     } else {
         throw std::runtime_error(DB_URL_ENV_NAME + " environment variable not found"s);
     }
+    if (const auto* urls = std::getenv(DB_SHARD_URLS_ENV_NAME)) {
+        config.db_shard_urls = postgres::ParseUrlList(urls);
+    }
+    if (const auto* urls = std::getenv(DB_REPLICA_URLS_ENV_NAME)) {
+        config.db_replicas.urls = postgres::ParseUrlList(urls);
+    }
+    if (const auto* routing = std::getenv(DB_REPLICA_ROUTING_ENV_NAME)) {
+        config.db_replicas.routing = postgres::ParseReplicaRouting(routing);
+    }
+    if (const auto* read_your_writes = std::getenv(DB_READ_YOUR_WRITES_ENV_NAME)) {
+        config.db_replicas.read_your_writes = read_your_writes != "0"sv;
+    }
+    if (const auto* path = std::getenv(METRICS_FILE_ENV_NAME)) {
+        config.metrics_file = path;
+    }
+    if (const auto* period = std::getenv(METRICS_PERIOD_ENV_NAME)) {
+        config.metrics_period = std::chrono::milliseconds{std::stoll(period)};
+    }
+    if (const auto* path = std::getenv(PROFILE_FILE_ENV_NAME)) {
+        config.profile_file = path;
+    }
+    if (const auto* threshold = std::getenv(SLOW_QUERY_ENV_NAME)) {
+        config.query_tracing.slow_threshold = std::chrono::milliseconds{std::stoll(threshold)};
+    }
+    if (const auto* rate = std::getenv(QUERY_SAMPLE_RATE_ENV_NAME)) {
+        config.query_tracing.sample_rate = std::stod(rate);
+    }
+    if (const auto* log_all = std::getenv(QUERY_LOG_ALL_ENV_NAME)) {
+        config.query_tracing.log_all = log_all == "1"sv;
+    }
+    if (const auto* catalog_cache = std::getenv(CATALOG_CACHE_ENV_NAME)) {
+        config.catalog_cache = catalog_cache == "1"sv;
+    }
+    if (const auto* batch_size = std::getenv(PURGE_BATCH_SIZE_ENV_NAME)) {
+        config.purge.batch_size = std::max<std::size_t>(1, std::stoul(batch_size));
+    }
+    if (const auto* pause = std::getenv(PURGE_PAUSE_ENV_NAME)) {
+        config.purge.batch_pause = std::chrono::milliseconds{std::stoll(pause)};
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == "--listen"sv && i + 1 < argc) {
+            config.listen_port = static_cast<unsigned short>(std::stoul(argv[++i]));
+            config.db_pool_size = kDefaultServerPoolSize;
+        } else if (argv[i] == "--batch"sv && i + 1 < argc) {
+            config.batch_file = argv[++i];
+        } else if (argv[i] == "--chunk-size"sv && i + 1 < argc) {
+            config.batch_chunk_size = std::stoul(argv[++i]);
+        } else {
+            throw std::invalid_argument("Unknown argument: "s + argv[i]);
+        }
+    }
+    if (const auto* pool_size = std::getenv(DB_POOL_SIZE_ENV_NAME)) {
+        config.db_pool_size = std::max<std::size_t>(1, std::stoul(pool_size));
+    }
     return config;
 }
 
 }  // namespace
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] const char* argv[]) {
+int main(int argc, const char* argv[]) {
     try {
-        bookypedia::Application app{GetConfigFromEnv()};
+        bookypedia::Application app{GetConfig(argc, argv)};
         app.Run();
     } catch (const std::exception& e) {
         return EXIT_FAILURE;
@@ -1,10 +1,30 @@
 #include "menu.h"
 
+#include <algorithm>
 #include <iomanip>
-#include <sstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#include "../metrics/metrics.h"
+#include "../util/string_util.h"
 
 namespace menu {
 
+namespace {
+
+// FNV-1a
+constexpr std::uint64_t HashName(std::string_view name) noexcept {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+}  // namespace
+
 Menu::Menu(std::istream& input, std::ostream& output)
     : input_{input}
     , output_{output} {
@@ -12,19 +32,22 @@ Menu::Menu(std::istream& input, std::ostream& output)
 
 void Menu::AddAction(std::string action_name, std::string args, std::string description,
                      Handler handler) {
-    if (!actions_
-             .try_emplace(std::move(action_name), std::move(handler), std::move(args),
-                          std::move(description))
-             .second) {
+    if (FindAction(action_name)) {
         throw std::invalid_argument("A command has been added already");
     }
+    const std::uint64_t hash = HashName(action_name);
+    const auto pos = std::upper_bound(actions_.begin(), actions_.end(), hash, [](std::uint64_t h, const ActionInfo& info) {
+        return h < info.hash;
+    });
+    metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kCommand, action_name);
+    actions_.insert(pos, ActionInfo{hash, std::move(action_name), std::move(handler), &stats, std::move(args),
+                                    std::move(description)});
 }
 
 void Menu::Run() {
-    std::string line;
-    while (std::getline(input_, line)) {
-        std::istringstream cmd_stream{std::move(line)};
-        if (!ParseCommand(cmd_stream)) {
+    // Буфер строки переиспользуется, поэтому после первых команд чтение не выделяет память
+    while (std::getline(input_, line_)) {
+        if (!ParseCommand(line_)) {
             break;
         }
     }
@@ -34,12 +57,18 @@ void Menu::ShowInstructions() const {
     if (actions_.empty()) {
         return;
     }
+    std::vector<const ActionInfo*> sorted;
+    sorted.reserve(actions_.size());
     size_t actions_width = 0;
     size_t args_width = 0;
-    for (const auto& [action_name, info] : actions_) {
-        actions_width = std::max(actions_width, action_name.length());
+    for (const ActionInfo& info : actions_) {
+        sorted.push_back(&info);
+        actions_width = std::max(actions_width, info.name.length());
         args_width = std::max(args_width, info.args.length());
     }
+    std::sort(sorted.begin(), sorted.end(), [](const ActionInfo* lhs, const ActionInfo* rhs) {
+        return lhs->name < rhs->name;
+    });
 
     const auto old_flags = output_.flags();
     const auto old_fill = output_.fill();
@@ -50,10 +79,10 @@ void Menu::ShowInstructions() const {
 
     try {
         output_ << std::left << std::setfill(' ');
-        for (const auto& [action_name, info] : actions_) {
-            output_ << std::setw(actions_width + 1) << action_name;
-            output_ << std::setw(args_width + 1) << info.args;
-            output_ << info.description << std::endl;
+        for (const ActionInfo* info : sorted) {
+            output_ << std::setw(actions_width + 1) << info->name;
+            output_ << std::setw(args_width + 1) << info->args;
+            output_ << info->description << std::endl;
         }
     } catch (...) {
         restore_flags();
@@ -62,14 +91,28 @@ void Menu::ShowInstructions() const {
     restore_flags();
 }
 
-bool Menu::ParseCommand(std::istream& input) {
+const Menu::ActionInfo* Menu::FindAction(std::string_view name) const noexcept {
+    const std::uint64_t hash = HashName(name);
+    auto it = std::lower_bound(actions_.begin(), actions_.end(), hash, [](const ActionInfo& info, std::uint64_t h) {
+        return info.hash < h;
+    });
+    for (; it != actions_.end() && it->hash == hash; ++it) {
+        if (it->name == name) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+bool Menu::ParseCommand(std::string_view line) {
     using namespace std::literals;
 
     try {
-        std::string cmd;
-        if (input >> cmd) {
-            if (const auto it = actions_.find(cmd); it != actions_.cend()) {
-                if (!it->second.handler(input)) {
+        const auto [cmd, args] = util::SplitFirstWord(line);
+        if (!cmd.empty()) {
+            if (const ActionInfo* action = FindAction(cmd)) {
+                metrics::ScopedCall call{*action->stats};
+                if (!action->handler(args)) {
                     return false;
                 }
             } else {
@@ -1,14 +1,22 @@
 #pragma once
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
-#include <map>
 #include <string>
+#include <string_view>
+#include <vector>
+
+namespace metrics {
+class CallStats;
+}  // namespace metrics
 
 namespace menu {
 
 class Menu {
 public:
-    using Handler = std::function<bool(std::istream&)>;
+    // Обработчик получает аргументы команды без пробелов по краям. Строка, на которую
+    // ссылается string_view, действительна только во время вызова обработчика
+    using Handler = std::function<bool(std::string_view)>;
 
     Menu(std::istream& input, std::ostream& output);
 
@@ -21,16 +29,24 @@ public:
 
 private:
     struct ActionInfo {
+        std::uint64_t hash;
+        std::string name;
         Handler handler;
+        // Счётчики вызовов команды (вид metrics::kCommand)
+        metrics::CallStats* stats;
         std::string args;
         std::string description;
     };
 
-    [[nodiscard]] bool ParseCommand(std::istream& input);
+    [[nodiscard]] bool ParseCommand(std::string_view line);
+    const ActionInfo* FindAction(std::string_view name) const noexcept;
 
     std::istream& input_;
     std::ostream& output_;
-    std::map<std::string, ActionInfo> actions_;
+    // Плоская таблица, упорядоченная по хэшу имени команды: поиск без аллокаций
+    // и без посимвольного сравнения строк на каждом шаге
+    std::vector<ActionInfo> actions_;
+    std::string line_;
 };
 
 }  // namespace menu
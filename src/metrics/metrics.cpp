@@ -0,0 +1,453 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace metrics {
+
+using namespace std::literals;
+
+namespace {
+
+thread_local std::string_view current_use_case;
+std::atomic<bool> profiling_enabled{false};
+
+// Границы корзин, публикуемые в Prometheus, в наносекундах
+constexpr std::array<std::uint64_t, 17> kExportBoundsNs{
+    50'000, 100'000, 250'000, 500'000,
+    1'000'000, 2'500'000, 5'000'000, 10'000'000, 25'000'000, 50'000'000,
+    100'000'000, 250'000'000, 500'000'000,
+    1'000'000'000, 2'500'000'000, 5'000'000'000, 10'000'000'000
+};
+
+void AtomicMax(std::atomic<std::uint64_t>& target, std::uint64_t value) noexcept {
+    std::uint64_t current = target.load(std::memory_order_relaxed);
+    while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+double NsToSeconds(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e9;
+}
+
+double NsToMillis(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+}  // namespace
+
+// // // --- HISTOGRAM --- // // //
+
+std::size_t Histogram::BucketIndex(std::uint64_t value) noexcept {
+    if (value < kLinearCount) {
+        return static_cast<std::size_t>(value);
+    }
+    const std::size_t exponent = std::bit_width(value) - 1;
+    const std::size_t sub_bucket = static_cast<std::size_t>(value >> (exponent - kSubBucketBits)) - kSubBucketCount;
+    return kLinearCount + (exponent - kSubBucketBits - 1) * kSubBucketCount + sub_bucket;
+}
+
+std::uint64_t Histogram::BucketLowerBound(std::size_t index) noexcept {
+    if (index < kLinearCount) {
+        return index;
+    }
+    const std::size_t exponent = (index - kLinearCount) / kSubBucketCount + kSubBucketBits + 1;
+    const std::uint64_t sub_bucket = (index - kLinearCount) % kSubBucketCount;
+    return (kSubBucketCount + sub_bucket) << (exponent - kSubBucketBits);
+}
+
+std::uint64_t Histogram::BucketUpperBound(std::size_t index) noexcept {
+    if (index + 1 >= kBucketCount) {
+        return UINT64_MAX;
+    }
+    return BucketLowerBound(index + 1) - 1;
+}
+
+void Histogram::Record(std::uint64_t value) noexcept {
+    ++counts[BucketIndex(value)];
+    ++total_count;
+    sum += value;
+    max = std::max(max, value);
+}
+
+void Histogram::Merge(const Histogram& other) noexcept {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total_count += other.total_count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+std::uint64_t Histogram::ValueAtQuantile(double q) const noexcept {
+    if (total_count == 0) {
+        return 0;
+    }
+    const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(total_count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(BucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+std::uint64_t Histogram::CountAtOrBelow(std::uint64_t value) const noexcept {
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < kBucketCount && BucketUpperBound(i) <= value; ++i) {
+        result += counts[i];
+    }
+    return result;
+}
+
+// // // --- HISTOGRAM --- // // //
+//
+//
+//
+// // // --- CALL STATS --- // // //
+
+CallStats::CallStats(std::string kind, std::string name)
+    : kind_{std::move(kind)}, name_{std::move(name)} {
+}
+
+std::size_t CallStats::CurrentShard() noexcept {
+    static std::atomic<std::size_t> next_shard{0};
+    thread_local const std::size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return shard;
+}
+
+void CallStats::Record(std::uint64_t duration_ns, bool failed, std::uint64_t rows) noexcept {
+    Shard& shard = shards_[CurrentShard()];
+    shard.calls.fetch_add(1, std::memory_order_relaxed);
+    if (failed) {
+        shard.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (rows != 0) {
+        shard.rows.fetch_add(rows, std::memory_order_relaxed);
+    }
+    shard.sum.fetch_add(duration_ns, std::memory_order_relaxed);
+    AtomicMax(shard.max, duration_ns);
+    shard.buckets[Histogram::BucketIndex(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void CallStats::RecordProfile(std::uint64_t duration_ns, const PerfSample& delta) noexcept {
+    Shard& shard = shards_[CurrentShard()];
+    shard.profiled_calls.fetch_add(1, std::memory_order_relaxed);
+    shard.profiled_wall_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+    shard.cycles.fetch_add(delta.cycles, std::memory_order_relaxed);
+    shard.instructions.fetch_add(delta.instructions, std::memory_order_relaxed);
+    shard.cache_misses.fetch_add(delta.cache_misses, std::memory_order_relaxed);
+    shard.branch_misses.fetch_add(delta.branch_misses, std::memory_order_relaxed);
+    shard.voluntary_switches.fetch_add(delta.voluntary_switches, std::memory_order_relaxed);
+    shard.involuntary_switches.fetch_add(delta.involuntary_switches, std::memory_order_relaxed);
+    shard.cpu_ns.fetch_add(delta.cpu_ns, std::memory_order_relaxed);
+}
+
+CallSnapshot CallStats::Snapshot() const {
+    CallSnapshot snapshot;
+    snapshot.kind = kind_;
+    snapshot.name = name_;
+    for (const Shard& shard : shards_) {
+        snapshot.calls += shard.calls.load(std::memory_order_relaxed);
+        snapshot.errors += shard.errors.load(std::memory_order_relaxed);
+        snapshot.rows += shard.rows.load(std::memory_order_relaxed);
+        snapshot.latency_ns.sum += shard.sum.load(std::memory_order_relaxed);
+        snapshot.latency_ns.max = std::max(snapshot.latency_ns.max, shard.max.load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < Histogram::kBucketCount; ++i) {
+            const std::uint64_t count = shard.buckets[i].load(std::memory_order_relaxed);
+            snapshot.latency_ns.counts[i] += count;
+            snapshot.latency_ns.total_count += count;
+        }
+        snapshot.profiled_calls += shard.profiled_calls.load(std::memory_order_relaxed);
+        snapshot.profiled_wall_ns += shard.profiled_wall_ns.load(std::memory_order_relaxed);
+        snapshot.profile.cycles += shard.cycles.load(std::memory_order_relaxed);
+        snapshot.profile.instructions += shard.instructions.load(std::memory_order_relaxed);
+        snapshot.profile.cache_misses += shard.cache_misses.load(std::memory_order_relaxed);
+        snapshot.profile.branch_misses += shard.branch_misses.load(std::memory_order_relaxed);
+        snapshot.profile.voluntary_switches += shard.voluntary_switches.load(std::memory_order_relaxed);
+        snapshot.profile.involuntary_switches += shard.involuntary_switches.load(std::memory_order_relaxed);
+        snapshot.profile.cpu_ns += shard.cpu_ns.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+// // // --- CALL STATS --- // // //
+//
+//
+//
+// // // --- REGISTRY --- // // //
+
+Registry& Registry::Get() {
+    static Registry registry;
+    return registry;
+}
+
+CallStats& Registry::Register(std::string_view kind, std::string_view name) {
+    std::lock_guard lock{mutex_};
+    const auto it = std::find_if(stats_.begin(), stats_.end(), [kind, name](const CallStats& stats) {
+        return stats.GetKind() == kind && stats.GetName() == name;
+    });
+    if (it != stats_.end()) {
+        return *it;
+    }
+    return stats_.emplace_back(std::string{kind}, std::string{name});
+}
+
+Gauge& Registry::RegisterGauge(std::string_view name) {
+    std::lock_guard lock{mutex_};
+    const auto it = std::find_if(gauges_.begin(), gauges_.end(), [name](const Gauge& gauge) {
+        return gauge.GetName() == name;
+    });
+    if (it != gauges_.end()) {
+        return *it;
+    }
+    return gauges_.emplace_back(std::string{name});
+}
+
+std::vector<CallSnapshot> Registry::TakeSnapshots() const {
+    std::vector<CallSnapshot> snapshots;
+    std::lock_guard lock{mutex_};
+    snapshots.reserve(stats_.size());
+    for (const CallStats& stats : stats_) {
+        snapshots.emplace_back(stats.Snapshot());
+    }
+    return snapshots;
+}
+
+void Registry::WriteSummary(std::ostream& out) const {
+    const std::vector<CallSnapshot> snapshots = TakeSnapshots();
+
+    const auto old_flags = out.flags();
+    const auto old_precision = out.precision();
+    out << std::left << std::fixed << std::setprecision(3);
+    out << std::setw(11) << "Kind"sv << std::setw(40) << "Name"sv
+        << std::setw(10) << "Calls"sv << std::setw(8) << "Errors"sv << std::setw(10) << "Rows"sv
+        << std::setw(10) << "p50 ms"sv << std::setw(10) << "p99 ms"sv << "max ms"sv << '\n';
+    for (const CallSnapshot& s : snapshots) {
+        if (s.calls == 0) {
+            continue;
+        }
+        out << std::setw(11) << s.kind << std::setw(40) << s.name
+            << std::setw(10) << s.calls << std::setw(8) << s.errors << std::setw(10) << s.rows
+            << std::setw(10) << NsToMillis(s.latency_ns.ValueAtQuantile(0.5))
+            << std::setw(10) << NsToMillis(s.latency_ns.ValueAtQuantile(0.99))
+            << NsToMillis(s.latency_ns.max) << '\n';
+    }
+    {
+        std::lock_guard lock{mutex_};
+        for (const Gauge& gauge : gauges_) {
+            out << gauge.GetName() << ": "sv << gauge.Get() << '\n';
+        }
+    }
+    out << "Transactions: "sv << GetTransactionCount() << std::endl;
+    out.flags(old_flags);
+    out.precision(old_precision);
+}
+
+void Registry::WritePrometheus(std::ostream& out) const {
+    const std::vector<CallSnapshot> snapshots = TakeSnapshots();
+
+    auto labels = [](const CallSnapshot& s) {
+        return "kind=\""s.append(s.kind).append("\",name=\"").append(s.name).append("\"");
+    };
+
+    out << "# TYPE bookypedia_calls_total counter\n"sv;
+    for (const CallSnapshot& s : snapshots) {
+        out << "bookypedia_calls_total{"sv << labels(s) << "} "sv << s.calls << '\n';
+    }
+    out << "# TYPE bookypedia_errors_total counter\n"sv;
+    for (const CallSnapshot& s : snapshots) {
+        out << "bookypedia_errors_total{"sv << labels(s) << "} "sv << s.errors << '\n';
+    }
+    out << "# TYPE bookypedia_rows_total counter\n"sv;
+    for (const CallSnapshot& s : snapshots) {
+        out << "bookypedia_rows_total{"sv << labels(s) << "} "sv << s.rows << '\n';
+    }
+    out << "# TYPE bookypedia_call_duration_seconds histogram\n"sv;
+    for (const CallSnapshot& s : snapshots) {
+        const std::string l = labels(s);
+        for (std::uint64_t bound : kExportBoundsNs) {
+            out << "bookypedia_call_duration_seconds_bucket{"sv << l << ",le=\""sv << NsToSeconds(bound) << "\"} "sv
+                << s.latency_ns.CountAtOrBelow(bound) << '\n';
+        }
+        out << "bookypedia_call_duration_seconds_bucket{"sv << l << ",le=\"+Inf\"} "sv << s.calls << '\n';
+        out << "bookypedia_call_duration_seconds_sum{"sv << l << "} "sv << NsToSeconds(s.latency_ns.sum) << '\n';
+        out << "bookypedia_call_duration_seconds_count{"sv << l << "} "sv << s.calls << '\n';
+    }
+    out << "# TYPE bookypedia_transactions_total counter\n"sv;
+    out << "bookypedia_transactions_total "sv << GetTransactionCount() << '\n';
+    out << "# TYPE bookypedia_gauge gauge\n"sv;
+    std::lock_guard lock{mutex_};
+    for (const Gauge& gauge : gauges_) {
+        out << "bookypedia_gauge{name=\""sv << gauge.GetName() << "\"} "sv << gauge.Get() << '\n';
+    }
+}
+
+void Registry::WriteProfile(std::ostream& out) const {
+    const std::vector<CallSnapshot> snapshots = TakeSnapshots();
+    const unsigned available = PerfCounters::GetAvailableEvents();
+    auto has = [available](PerfCounters::Event event) {
+        return (available & (1u << event)) != 0;
+    };
+
+    const auto old_flags = out.flags();
+    const auto old_precision = out.precision();
+    out << std::left << std::fixed << std::setprecision(3);
+    if (available == 0) {
+        const int error = PerfCounters::GetOpenError();
+        out << "Hardware counters are unavailable"sv;
+        if (error != 0) {
+            out << " (perf_event_open: "sv << std::strerror(error) << ')';
+        }
+        out << ", only CPU time and context switches are measured\n"sv;
+    }
+    // Все значения — средние на один профилированный вызов. Off-CPU — время, когда поток
+    // не выполнялся: ожидание сокета базы или клиента, блокировки, вытеснение
+    out << std::setw(11) << "Kind"sv << std::setw(40) << "Name"sv << std::setw(10) << "Calls"sv
+        << std::setw(11) << "Wall ms"sv << std::setw(11) << "CPU ms"sv << std::setw(11) << "Off-CPU ms"sv
+        << std::setw(14) << "Cycles"sv << std::setw(7) << "IPC"sv
+        << std::setw(12) << "Cache miss"sv << std::setw(12) << "Branch miss"sv
+        << std::setw(10) << "Vol. sw"sv << "Invol. sw"sv << '\n';
+    for (const CallSnapshot& s : snapshots) {
+        if (s.profiled_calls == 0) {
+            continue;
+        }
+        const double calls = static_cast<double>(s.profiled_calls);
+        auto per_call = [calls](std::uint64_t value) {
+            return static_cast<double>(value) / calls;
+        };
+        auto counter = [&](PerfCounters::Event event, int width, std::uint64_t value) {
+            out << std::setw(width);
+            if (has(event)) {
+                out << per_call(value);
+            } else {
+                out << '-';
+            }
+        };
+        const std::uint64_t off_cpu_ns = s.profiled_wall_ns > s.profile.cpu_ns ? s.profiled_wall_ns - s.profile.cpu_ns : 0;
+        out << std::setw(11) << s.kind << std::setw(40) << s.name << std::setw(10) << s.profiled_calls
+            << std::setw(11) << per_call(s.profiled_wall_ns) / 1e6 << std::setw(11) << per_call(s.profile.cpu_ns) / 1e6
+            << std::setw(11) << per_call(off_cpu_ns) / 1e6;
+        counter(PerfCounters::kCycles, 14, s.profile.cycles);
+        out << std::setw(7);
+        if (has(PerfCounters::kCycles) && has(PerfCounters::kInstructions) && s.profile.cycles != 0) {
+            out << static_cast<double>(s.profile.instructions) / static_cast<double>(s.profile.cycles);
+        } else {
+            out << '-';
+        }
+        counter(PerfCounters::kCacheMisses, 12, s.profile.cache_misses);
+        counter(PerfCounters::kBranchMisses, 12, s.profile.branch_misses);
+        out << std::setw(10) << per_call(s.profile.voluntary_switches) << per_call(s.profile.involuntary_switches)
+            << '\n';
+    }
+    out.flags(old_flags);
+    out.precision(old_precision);
+}
+
+// // // --- REGISTRY --- // // //
+//
+//
+//
+// // // --- SCOPED CALL --- // // //
+
+ScopedCall::ScopedCall(CallStats& stats, bool is_use_case) noexcept
+    : stats_{stats}
+    , start_{std::chrono::steady_clock::now()}
+    , uncaught_exceptions_{std::uncaught_exceptions()}
+    , is_use_case_{is_use_case}
+    , profiled_{IsProfilingEnabled()} {
+    if (is_use_case_) {
+        prev_use_case_ = current_use_case;
+        current_use_case = stats_.GetName();
+    }
+    if (profiled_) {
+        profile_start_ = PerfCounters::ForCurrentThread().Read();
+    }
+}
+
+ScopedCall::~ScopedCall() {
+    const auto duration = std::chrono::steady_clock::now() - start_;
+    const auto duration_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    if (profiled_) {
+        stats_.RecordProfile(duration_ns, PerfCounters::ForCurrentThread().Read() - profile_start_);
+    }
+    stats_.Record(duration_ns, std::uncaught_exceptions() > uncaught_exceptions_, rows_);
+    if (is_use_case_) {
+        current_use_case = prev_use_case_;
+    }
+}
+
+std::string_view CurrentUseCase() noexcept {
+    return current_use_case;
+}
+
+void SetProfilingEnabled(bool enabled) noexcept {
+    profiling_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsProfilingEnabled() noexcept {
+    return profiling_enabled.load(std::memory_order_relaxed);
+}
+
+// // // --- SCOPED CALL --- // // //
+//
+//
+//
+// // // --- PERIODIC EXPORTER --- // // //
+
+PeriodicExporter::PeriodicExporter(const Registry& registry, std::filesystem::path path, std::chrono::milliseconds period,
+                                   ExportFormat format)
+    : registry_{registry}
+    , path_{std::move(path)}
+    , period_{period}
+    , format_{format}
+    , thread_{[this] { Loop(); }} {
+}
+
+PeriodicExporter::~PeriodicExporter() {
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    thread_.join();
+    WriteNow();
+}
+
+void PeriodicExporter::WriteNow() const {
+    std::filesystem::path tmp_path = path_;
+    tmp_path += ".tmp"s;
+    {
+        std::ofstream out{tmp_path, std::ios::trunc};
+        if (!out) {
+            return;
+        }
+        if (format_ == ExportFormat::kProfile) {
+            registry_.WriteProfile(out);
+        } else {
+            registry_.WritePrometheus(out);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path_, ec);
+}
+
+void PeriodicExporter::Loop() {
+    std::unique_lock lock{mutex_};
+    while (!stop_cv_.wait_for(lock, period_, [this] { return stop_; })) {
+        lock.unlock();
+        WriteNow();
+        lock.lock();
+    }
+}
+
+// // // --- PERIODIC EXPORTER --- // // //
+
+}  // namespace metrics
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <iosfwd>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "perf_counters.h"
+
+namespace metrics {
+
+/**
+ * Гистограмма в стиле HDR: логарифмические корзины по 8 подкорзин в каждой,
+ * т.е. относительная погрешность не хуже 12.5% на всём диапазоне uint64_t.
+ * Значения 0..15 хранятся точно.
+ */
+class Histogram {
+public:
+    static constexpr std::size_t kSubBucketBits = 3;
+    static constexpr std::size_t kSubBucketCount = std::size_t{1} << kSubBucketBits;
+    static constexpr std::size_t kLinearCount = kSubBucketCount * 2;
+    static constexpr std::size_t kBucketCount = kLinearCount + (64 - kSubBucketBits - 1 - 1) * kSubBucketCount
+                                                + kSubBucketCount;
+
+    static std::size_t BucketIndex(std::uint64_t value) noexcept;
+    static std::uint64_t BucketLowerBound(std::size_t index) noexcept;
+    static std::uint64_t BucketUpperBound(std::size_t index) noexcept;
+
+    std::array<std::uint64_t, kBucketCount> counts{};
+    std::uint64_t total_count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+
+    void Record(std::uint64_t value) noexcept;
+    void Merge(const Histogram& other) noexcept;
+
+    // Верхняя граница корзины, в которую попадает квантиль q (0..1)
+    std::uint64_t ValueAtQuantile(double q) const noexcept;
+    std::uint64_t CountAtOrBelow(std::uint64_t value) const noexcept;
+};
+
+struct CallSnapshot {
+    std::string_view kind;
+    std::string_view name;
+    std::uint64_t calls = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t rows = 0;
+    Histogram latency_ns;
+    // Вызовы, выполненные при включённом профилировании, и сумма их показаний
+    std::uint64_t profiled_calls = 0;
+    std::uint64_t profiled_wall_ns = 0;
+    PerfSample profile;
+};
+
+/**
+ * Счётчики одного вызова (use case или метода репозитория).
+ * Запись идёт в шард текущего потока relaxed-атомиками без блокировок,
+ * суммирование шардов выполняется только при снятии снимка.
+ */
+class CallStats {
+public:
+    CallStats(std::string kind, std::string name);
+
+    CallStats(const CallStats&) = delete;
+    CallStats& operator=(const CallStats&) = delete;
+
+    void Record(std::uint64_t duration_ns, bool failed, std::uint64_t rows) noexcept;
+    void RecordProfile(std::uint64_t duration_ns, const PerfSample& delta) noexcept;
+
+    CallSnapshot Snapshot() const;
+
+    const std::string& GetKind() const noexcept {
+        return kind_;
+    }
+
+    const std::string& GetName() const noexcept {
+        return name_;
+    }
+
+private:
+    static constexpr std::size_t kShardCount = 8;
+
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> errors{0};
+        std::atomic<std::uint64_t> rows{0};
+        std::atomic<std::uint64_t> sum{0};
+        std::atomic<std::uint64_t> max{0};
+        std::array<std::atomic<std::uint64_t>, Histogram::kBucketCount> buckets{};
+        std::atomic<std::uint64_t> profiled_calls{0};
+        std::atomic<std::uint64_t> profiled_wall_ns{0};
+        std::atomic<std::uint64_t> cycles{0};
+        std::atomic<std::uint64_t> instructions{0};
+        std::atomic<std::uint64_t> cache_misses{0};
+        std::atomic<std::uint64_t> branch_misses{0};
+        std::atomic<std::uint64_t> voluntary_switches{0};
+        std::atomic<std::uint64_t> involuntary_switches{0};
+        std::atomic<std::uint64_t> cpu_ns{0};
+    };
+
+    static std::size_t CurrentShard() noexcept;
+
+    std::string kind_;
+    std::string name_;
+    std::array<Shard, kShardCount> shards_;
+};
+
+/**
+ * Текущее значение величины (например, длины очереди), а не накопленный счётчик
+ */
+class Gauge {
+public:
+    explicit Gauge(std::string name)
+    : name_{std::move(name)}
+    {
+
+    }
+
+    Gauge(const Gauge&) = delete;
+    Gauge& operator=(const Gauge&) = delete;
+
+    void Set(std::int64_t value) noexcept {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    std::int64_t Get() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+    const std::string& GetName() const noexcept {
+        return name_;
+    }
+
+private:
+    std::string name_;
+    std::atomic<std::int64_t> value_{0};
+};
+
+class Registry {
+public:
+    static Registry& Get();
+
+    // Возвращает счётчики с заданным видом и именем, создавая их при первом обращении.
+    // Ссылка действительна до конца работы программы, поэтому её удобно кэшировать
+    // в локальной статической переменной.
+    CallStats& Register(std::string_view kind, std::string_view name);
+    // То же для величин с текущим значением
+    Gauge& RegisterGauge(std::string_view name);
+
+    void CountTransaction() noexcept {
+        transactions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t GetTransactionCount() const noexcept {
+        return transactions_.load(std::memory_order_relaxed);
+    }
+
+    // Краткая таблица для команды Stats
+    void WriteSummary(std::ostream& out) const;
+    // Текстовый формат экспорта Prometheus
+    void WritePrometheus(std::ostream& out) const;
+    // Средние показания счётчиков на вызов для профилированных вызовов (см. SetProfilingEnabled)
+    void WriteProfile(std::ostream& out) const;
+
+private:
+    Registry() = default;
+
+    std::vector<CallSnapshot> TakeSnapshots() const;
+
+    mutable std::mutex mutex_;
+    std::list<CallStats> stats_;
+    std::list<Gauge> gauges_;
+    std::atomic<std::uint64_t> transactions_{0};
+};
+
+/**
+ * Замеряет длительность вызова и учитывает его в CallStats при выходе из области видимости.
+ * Вызов считается ошибочным, если область покидается из-за исключения.
+ * Для use case'ов также запоминает имя текущего сценария в потоке (см. CurrentUseCase).
+ * При включённом профилировании дополнительно снимает показания PerfCounters текущего потока.
+ */
+class ScopedCall {
+public:
+    explicit ScopedCall(CallStats& stats, bool is_use_case = false) noexcept;
+    ~ScopedCall();
+
+    ScopedCall(const ScopedCall&) = delete;
+    ScopedCall& operator=(const ScopedCall&) = delete;
+
+    void SetRows(std::uint64_t rows) noexcept {
+        rows_ = rows;
+    }
+
+private:
+    CallStats& stats_;
+    std::chrono::steady_clock::time_point start_;
+    int uncaught_exceptions_;
+    std::uint64_t rows_ = 0;
+    std::string_view prev_use_case_;
+    bool is_use_case_;
+    bool profiled_;
+    PerfSample profile_start_;
+};
+
+enum class ExportFormat {
+    kPrometheus,
+    kProfile
+};
+
+/**
+ * Периодически записывает метрики реестра в файл в формате Prometheus
+ * (например, для node_exporter textfile collector) или сводку профилирования.
+ * Файл заменяется атомарно.
+ */
+class PeriodicExporter {
+public:
+    PeriodicExporter(const Registry& registry, std::filesystem::path path, std::chrono::milliseconds period,
+                     ExportFormat format = ExportFormat::kPrometheus);
+    ~PeriodicExporter();
+
+    PeriodicExporter(const PeriodicExporter&) = delete;
+    PeriodicExporter& operator=(const PeriodicExporter&) = delete;
+
+    void WriteNow() const;
+
+private:
+    void Loop();
+
+    const Registry& registry_;
+    std::filesystem::path path_;
+    std::chrono::milliseconds period_;
+    ExportFormat format_;
+
+    std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+// Имя use case'а, выполняющегося в текущем потоке, либо пустая строка
+std::string_view CurrentUseCase() noexcept;
+
+// Профилирование выключено по умолчанию: замер счётчиков стоит нескольких системных вызовов
+void SetProfilingEnabled(bool enabled) noexcept;
+bool IsProfilingEnabled() noexcept;
+
+inline constexpr std::string_view kUseCase = "use_case";
+inline constexpr std::string_view kAsyncUseCase = "async_use_case";
+inline constexpr std::string_view kRepository = "repository";
+inline constexpr std::string_view kCommand = "command";
+inline constexpr std::string_view kBackground = "background";
+
+}  // namespace metrics
@@ -0,0 +1,126 @@
+#include "perf_counters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <ctime>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace metrics {
+
+namespace {
+
+constexpr std::array<std::uint64_t, PerfCounters::kEventCount> kEventConfigs{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+std::atomic<unsigned> available_events{0};
+std::atomic<int> open_error{0};
+
+int OpenEvent(std::uint64_t config, int group_fd) noexcept {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    if (fd < 0) {
+        int expected = 0;
+        open_error.compare_exchange_strong(expected, errno, std::memory_order_relaxed);
+        return -1;
+    }
+    return static_cast<int>(fd);
+}
+
+std::uint64_t ThreadCpuNs() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+}  // namespace
+
+PerfCounters& PerfCounters::ForCurrentThread() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+unsigned PerfCounters::GetAvailableEvents() noexcept {
+    return available_events.load(std::memory_order_relaxed);
+}
+
+int PerfCounters::GetOpenError() noexcept {
+    return open_error.load(std::memory_order_relaxed);
+}
+
+PerfCounters::PerfCounters() {
+    slots_.fill(kEventCount);
+    fds_.fill(-1);
+    // Первое открывшееся событие становится лидером группы: все счётчики группы
+    // планируются на PMU вместе и читаются одним системным вызовом
+    for (unsigned event = 0; event < kEventCount; ++event) {
+        const int fd = OpenEvent(kEventConfigs[event], group_fd_);
+        if (fd < 0) {
+            continue;
+        }
+        if (group_fd_ < 0) {
+            group_fd_ = fd;
+        }
+        fds_[event] = fd;
+        slots_[event] = opened_++;
+        available_events.fetch_or(1u << event, std::memory_order_relaxed);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+PerfSample PerfCounters::Read() const noexcept {
+    PerfSample sample;
+    if (group_fd_ >= 0) {
+        // nr, time_enabled, time_running, values[nr]
+        std::array<std::uint64_t, 3 + kEventCount> buffer{};
+        const ssize_t size = read(group_fd_, buffer.data(), sizeof(buffer));
+        if (size >= static_cast<ssize_t>((3 + opened_) * sizeof(std::uint64_t))) {
+            const std::uint64_t enabled = buffer[1];
+            const std::uint64_t running = buffer[2];
+            // Если ядро мультиплексирует PMU между группами, значения экстраполируются
+            auto value = [&](Event event) -> std::uint64_t {
+                if (slots_[event] == kEventCount) {
+                    return 0;
+                }
+                const std::uint64_t raw = buffer[3 + slots_[event]];
+                if (running == 0 || running == enabled) {
+                    return raw;
+                }
+                return static_cast<std::uint64_t>(static_cast<double>(raw) * static_cast<double>(enabled)
+                                                  / static_cast<double>(running));
+            };
+            sample.cycles = value(kCycles);
+            sample.instructions = value(kInstructions);
+            sample.cache_misses = value(kCacheMisses);
+            sample.branch_misses = value(kBranchMisses);
+        }
+    }
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        sample.voluntary_switches = static_cast<std::uint64_t>(usage.ru_nvcsw);
+        sample.involuntary_switches = static_cast<std::uint64_t>(usage.ru_nivcsw);
+    }
+    sample.cpu_ns = ThreadCpuNs();
+    return sample;
+}
+
+}  // namespace metrics
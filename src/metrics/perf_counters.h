@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace metrics {
+
+/**
+ * Показания счётчиков текущего потока. Аппаратные счётчики берутся из perf_event_open
+ * (только пользовательский режим), процессорное время — из CLOCK_THREAD_CPUTIME_ID,
+ * переключения контекста — из getrusage(RUSAGE_THREAD). Добровольные переключения
+ * означают, что поток уснул сам (например, ждал ответа базы на сокете).
+ */
+struct PerfSample {
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cache_misses = 0;
+    std::uint64_t branch_misses = 0;
+    std::uint64_t voluntary_switches = 0;
+    std::uint64_t involuntary_switches = 0;
+    std::uint64_t cpu_ns = 0;
+};
+
+inline PerfSample operator-(const PerfSample& lhs, const PerfSample& rhs) noexcept {
+    return {
+        lhs.cycles - rhs.cycles,
+        lhs.instructions - rhs.instructions,
+        lhs.cache_misses - rhs.cache_misses,
+        lhs.branch_misses - rhs.branch_misses,
+        lhs.voluntary_switches - rhs.voluntary_switches,
+        lhs.involuntary_switches - rhs.involuntary_switches,
+        lhs.cpu_ns - rhs.cpu_ns
+    };
+}
+
+/**
+ * Группа аппаратных счётчиков, открытая для текущего потока. Счётчики работают постоянно,
+ * замер — это разность двух вызовов Read. Если perf_event_open запрещён (perf_event_paranoid,
+ * seccomp, виртуальная машина без PMU), недоступные счётчики читаются как 0,
+ * а процессорное время и переключения контекста остаются.
+ */
+class PerfCounters {
+public:
+    enum Event : unsigned {
+        kCycles,
+        kInstructions,
+        kCacheMisses,
+        kBranchMisses,
+        kEventCount
+    };
+
+    // Счётчики текущего потока, открываются при первом обращении
+    static PerfCounters& ForCurrentThread();
+
+    // Битовая маска событий (1 << Event), которые удалось открыть хотя бы в одном потоке
+    static unsigned GetAvailableEvents() noexcept;
+    // errno первой неудачной попытки открыть событие, 0 — если неудач не было
+    static int GetOpenError() noexcept;
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    PerfSample Read() const noexcept;
+
+private:
+    PerfCounters();
+    ~PerfCounters();
+
+    int group_fd_ = -1;
+    // Позиция события в ответе на групповое чтение, kEventCount — событие не открыто
+    std::array<std::size_t, kEventCount> slots_;
+    std::array<int, kEventCount> fds_;
+    std::size_t opened_ = 0;
+};
+
+}  // namespace metrics
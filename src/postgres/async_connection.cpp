@@ -0,0 +1,210 @@
+#include "async_connection.h"
+
+#include <array>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <charconv>
+#include <optional>
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+std::string GetErrorMessage(PGconn* connection) {
+    std::string message = PQerrorMessage(connection);
+    while (!message.empty() && message.back() == '\n') {
+        message.pop_back();
+    }
+    return message;
+}
+
+}  // namespace
+
+std::uint64_t AsyncResult::AffectedRows() const {
+    const std::string_view tuples = PQcmdTuples(result_.get());
+    std::uint64_t rows = 0;
+    std::from_chars(tuples.data(), tuples.data() + tuples.size(), rows);
+    return rows;
+}
+
+// // // --- CONNECTION --- // // //
+
+AsyncConnection::AsyncConnection(net::any_io_executor executor, const std::string& url)
+    : connection_{PQconnectdb(url.c_str())}
+    , socket_{executor} {
+    if (PQstatus(connection_) != CONNECTION_OK) {
+        const std::string message = GetErrorMessage(connection_);
+        PQfinish(connection_);
+        throw AsyncQueryError("Failed to connect to database: "s + message);
+    }
+    if (PQsetnonblocking(connection_, 1) != 0) {
+        const std::string message = GetErrorMessage(connection_);
+        PQfinish(connection_);
+        throw AsyncQueryError("Failed to switch connection to non-blocking mode: "s + message);
+    }
+    socket_.assign(PQsocket(connection_));
+}
+
+AsyncConnection::~AsyncConnection() {
+    // Дескриптор принадлежит libpq и будет закрыт в PQfinish
+    socket_.release();
+    PQfinish(connection_);
+}
+
+net::awaitable<void> AsyncConnection::Reset() {
+    if (PQstatus(connection_) != CONNECTION_OK) {
+        Reconnect();
+        co_return;
+    }
+    // Корутина, брошенная посреди запроса, оставляет его результаты непрочитанными,
+    // и libpq не примет новую команду, пока они не дочитаны
+    if (PQtransactionStatus(connection_) == PQTRANS_ACTIVE) {
+        if (PGcancel* cancel = PQgetCancel(connection_)) {
+            std::array<char, 256> error{};
+            PQcancel(cancel, error.data(), static_cast<int>(error.size()));
+            PQfreeCancel(cancel);
+        }
+        co_await DiscardResults();
+    }
+    switch (PQtransactionStatus(connection_)) {
+    case PQTRANS_IDLE:
+        break;
+    case PQTRANS_INTRANS:
+    case PQTRANS_INERROR:
+        co_await ExecParams("ROLLBACK;"s);
+        break;
+    default:
+        Reconnect();
+        break;
+    }
+}
+
+net::awaitable<void> AsyncConnection::DiscardResults() {
+    co_await Flush();
+    while (true) {
+        while (PQisBusy(connection_)) {
+            co_await socket_.async_wait(net::posix::stream_descriptor::wait_read, net::use_awaitable);
+            if (!PQconsumeInput(connection_)) {
+                throw AsyncQueryError(GetErrorMessage(connection_));
+            }
+        }
+        PGresult* result = PQgetResult(connection_);
+        if (result == nullptr) {
+            co_return;
+        }
+        PQclear(result);
+    }
+}
+
+void AsyncConnection::Reconnect() {
+    // Сокет после PQreset может быть другим
+    socket_.release();
+    PQreset(connection_);
+    if (PQstatus(connection_) != CONNECTION_OK || PQsetnonblocking(connection_, 1) != 0) {
+        throw AsyncQueryError("Failed to reconnect to database: "s + GetErrorMessage(connection_));
+    }
+    socket_.assign(PQsocket(connection_));
+}
+
+net::awaitable<void> AsyncConnection::Flush() {
+    while (true) {
+        const int rc = PQflush(connection_);
+        if (rc == 0) {
+            co_return;
+        }
+        if (rc < 0) {
+            throw AsyncQueryError(GetErrorMessage(connection_));
+        }
+        co_await socket_.async_wait(net::posix::stream_descriptor::wait_write, net::use_awaitable);
+    }
+}
+
+net::awaitable<AsyncResult> AsyncConnection::ExecParams(std::string query, std::vector<std::string> params) {
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const std::string& param : params) {
+        values.push_back(param.c_str());
+    }
+
+    if (!PQsendQueryParams(connection_, query.c_str(), static_cast<int>(values.size()),
+                           nullptr, values.data(), nullptr, nullptr, 0)) {
+        throw AsyncQueryError(GetErrorMessage(connection_));
+    }
+    co_await Flush();
+
+    std::optional<AsyncResult> last_result;
+    std::optional<std::string> error;
+    while (true) {
+        while (PQisBusy(connection_)) {
+            co_await socket_.async_wait(net::posix::stream_descriptor::wait_read, net::use_awaitable);
+            if (!PQconsumeInput(connection_)) {
+                throw AsyncQueryError(GetErrorMessage(connection_));
+            }
+        }
+        PGresult* raw_result = PQgetResult(connection_);
+        if (raw_result == nullptr) {
+            break;
+        }
+        AsyncResult result{raw_result};
+        const ExecStatusType status = PQresultStatus(raw_result);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            error = PQresultErrorMessage(raw_result);
+        }
+        last_result.emplace(std::move(result));
+    }
+
+    if (error) {
+        throw AsyncQueryError(*error);
+    }
+    if (!last_result) {
+        throw AsyncQueryError("Query returned no result"s);
+    }
+    co_return std::move(*last_result);
+}
+
+// // // --- CONNECTION --- // // //
+//
+//
+//
+// // // --- POOL --- // // //
+
+AsyncConnectionPool::AsyncConnectionPool(net::any_io_executor executor, const std::string& url, std::size_t size)
+    : executor_{executor} {
+    connections_.reserve(size);
+    idle_.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        connections_.emplace_back(std::make_unique<AsyncConnection>(executor_, url));
+        idle_.push_back(connections_.back().get());
+    }
+}
+
+net::awaitable<AsyncConnectionPool::Lease> AsyncConnectionPool::Acquire() {
+    while (idle_.empty()) {
+        auto waiter = std::make_shared<net::steady_timer>(executor_, net::steady_timer::time_point::max());
+        waiters_.push_back(waiter);
+        boost::system::error_code ec;
+        co_await waiter->async_wait(net::redirect_error(net::use_awaitable, ec));
+    }
+    AsyncConnection* connection = idle_.back();
+    idle_.pop_back();
+    Lease lease{*this, *connection};
+
+    // Предыдущий владелец мог не завершить запрос или транзакцию, например из-за исключения
+    co_await connection->Reset();
+    co_return lease;
+}
+
+void AsyncConnectionPool::Release(AsyncConnection& connection) {
+    idle_.push_back(&connection);
+    if (!waiters_.empty()) {
+        std::shared_ptr<net::steady_timer> waiter = std::move(waiters_.front());
+        waiters_.pop_front();
+        waiter->cancel();
+    }
+}
+
+// // // --- POOL --- // // //
+
+}  // namespace postgres
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <libpq-fe.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace postgres {
+
+namespace net = boost::asio;
+
+class AsyncQueryError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Результат запроса, выполненного через неблокирующий интерфейс libpq.
+ * Значения возвращаются в текстовом виде без копирования из буфера PGresult.
+ */
+class AsyncResult {
+public:
+    explicit AsyncResult(PGresult* result) noexcept
+    : result_{result, &PQclear}
+    {
+
+    }
+
+    int Size() const noexcept {
+        return PQntuples(result_.get());
+    }
+
+    bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    std::string_view GetValue(int row, int column) const noexcept {
+        return {PQgetvalue(result_.get(), row, column), static_cast<std::size_t>(PQgetlength(result_.get(), row, column))};
+    }
+
+    bool IsNull(int row, int column) const noexcept {
+        return PQgetisnull(result_.get(), row, column) != 0;
+    }
+
+    std::uint64_t AffectedRows() const;
+
+private:
+    std::unique_ptr<PGresult, decltype(&PQclear)> result_;
+};
+
+/**
+ * Соединение с PostgreSQL в неблокирующем режиме. Ожидание готовности сокета
+ * выполняется через io_context, поэтому поток не блокируется на время запроса.
+ * Одновременно соединение выполняет не более одного запроса.
+ */
+class AsyncConnection {
+public:
+    AsyncConnection(net::any_io_executor executor, const std::string& url);
+    ~AsyncConnection();
+
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+    // Параметры передаются по значению: они должны жить в кадре корутины до окончания запроса
+    net::awaitable<AsyncResult> ExecParams(std::string query, std::vector<std::string> params = {});
+
+    // Параметры собираются в вектор вне кадра корутины: GCC 11-12 не умеет
+    // initializer_list внутри выражения co_await
+    template <typename... Params>
+    net::awaitable<AsyncResult> Exec(std::string query, Params&&... params) {
+        return ExecParams(std::move(query), std::vector<std::string>{std::string(std::forward<Params>(params))...});
+    }
+
+    // Возвращает соединение в исходное состояние после предыдущего владельца: прерывает
+    // незавершённый запрос, дочитывает его результаты и откатывает открытую транзакцию
+    net::awaitable<void> Reset();
+
+private:
+    net::awaitable<void> Flush();
+    // Ждёт и отбрасывает все результаты отправленного запроса
+    net::awaitable<void> DiscardResults();
+    // Переподключается, если соединение разорвано
+    void Reconnect();
+
+    PGconn* connection_;
+    net::posix::stream_descriptor socket_;
+};
+
+/**
+ * Пул асинхронных соединений. Если свободных соединений нет, Acquire ждёт,
+ * пока одно из них не будет возвращено. Пул не потокобезопасен и должен
+ * использоваться из одного потока io_context (или одного strand).
+ */
+class AsyncConnectionPool {
+public:
+    class Lease {
+    public:
+        Lease(AsyncConnectionPool& pool, AsyncConnection& connection) noexcept
+        : pool_{&pool}, connection_{&connection}
+        {
+
+        }
+
+        Lease(Lease&& other) noexcept
+        : pool_{std::exchange(other.pool_, nullptr)}, connection_{std::exchange(other.connection_, nullptr)}
+        {
+
+        }
+
+        Lease& operator=(Lease&&) = delete;
+
+        ~Lease() {
+            if (pool_) {
+                pool_->Release(*connection_);
+            }
+        }
+
+        AsyncConnection& operator*() const noexcept {
+            return *connection_;
+        }
+
+        AsyncConnection* operator->() const noexcept {
+            return connection_;
+        }
+
+    private:
+        AsyncConnectionPool* pool_;
+        AsyncConnection* connection_;
+    };
+
+    AsyncConnectionPool(net::any_io_executor executor, const std::string& url, std::size_t size);
+
+    net::awaitable<Lease> Acquire();
+
+    std::size_t GetSize() const noexcept {
+        return connections_.size();
+    }
+
+private:
+    void Release(AsyncConnection& connection);
+
+    net::any_io_executor executor_;
+    std::vector<std::unique_ptr<AsyncConnection>> connections_;
+    std::vector<AsyncConnection*> idle_;
+    std::deque<std::shared_ptr<net::steady_timer>> waiters_;
+};
+
+}  // namespace postgres
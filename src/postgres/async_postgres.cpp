@@ -0,0 +1,269 @@
+#include "async_postgres.h"
+
+#include <charconv>
+#include <string>
+
+#include "../metrics/metrics.h"
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+int ParseInt(std::string_view value) {
+    int result = 0;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return result;
+}
+
+// Ожидаемый порядок столбцов: id, name
+Author GetAuthorFromRow(const AsyncResult& result, int row) {
+    return Author{AuthorId::FromString(result.GetValue(row, 0)), std::string{result.GetValue(row, 1)}};
+}
+
+// Ожидаемый порядок столбцов: book_id, author_id, title, publication_year[, name]
+Book GetBookFromRow(const AsyncResult& result, int row, bool with_author_name) {
+    if (with_author_name) {
+        return Book{
+            BookId::FromString(result.GetValue(row, 0)),
+            AuthorId::FromString(result.GetValue(row, 1)),
+            std::string{result.GetValue(row, 2)},
+            ParseInt(result.GetValue(row, 3)),
+            std::string{result.GetValue(row, 4)}
+        };
+    }
+    return Book{
+        BookId::FromString(result.GetValue(row, 0)),
+        AuthorId::FromString(result.GetValue(row, 1)),
+        std::string{result.GetValue(row, 2)},
+        ParseInt(result.GetValue(row, 3))
+    };
+}
+
+std::vector<Book> GetBooksFromResult(const AsyncResult& result, bool with_author_name) {
+    std::vector<Book> books;
+    books.reserve(result.Size());
+    for (int row = 0; row < result.Size(); ++row) {
+        books.emplace_back(GetBookFromRow(result, row, with_author_name));
+    }
+    return books;
+}
+
+}  // namespace
+
+// // // --- AUTHOR --- // // // --- AUTHOR --- // // // --- AUTHOR --- // // //
+
+net::awaitable<void> AsyncAuthorRepositoryImpl::Save(Author author) {
+    co_await connection_.Exec(
+        R"(
+            INSERT INTO authors (id, name) VALUES ($1, $2)
+            ON CONFLICT (id) DO UPDATE SET name=$2;
+        )"s,
+        author.GetId().ToString(),
+        author.GetName()
+    );
+}
+
+net::awaitable<void> AsyncAuthorRepositoryImpl::Edit(AuthorId id, std::string new_name) {
+    co_await connection_.Exec(R"(UPDATE authors SET name=$2 WHERE id=$1;)"s, id.ToString(), std::move(new_name));
+}
+
+net::awaitable<void> AsyncAuthorRepositoryImpl::Delete(AuthorId id) {
+    co_await connection_.Exec(R"(DELETE FROM authors WHERE id=$1;)"s, id.ToString());
+}
+
+net::awaitable<void> AsyncAuthorRepositoryImpl::MarkDeleted(AuthorId id) {
+    co_await connection_.Exec(
+        R"(UPDATE authors SET deleted_at = now() WHERE id=$1 AND deleted_at IS NULL;)"s, id.ToString()
+    );
+}
+
+net::awaitable<std::vector<Author>> AsyncAuthorRepositoryImpl::GetAllAuthors() {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(SELECT id, name FROM authors WHERE deleted_at IS NULL ORDER BY name;)"s
+    );
+    std::vector<Author> authors;
+    authors.reserve(result.Size());
+    for (int row = 0; row < result.Size(); ++row) {
+        authors.emplace_back(GetAuthorFromRow(result, row));
+    }
+    co_return authors;
+}
+
+net::awaitable<std::optional<Author>> AsyncAuthorRepositoryImpl::GetAuthorByName(std::string name) {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(SELECT id, name FROM authors WHERE name=$1 AND deleted_at IS NULL;)"s, std::move(name)
+    );
+    if (result.Size() != 1) {
+        co_return std::nullopt;
+    }
+    co_return GetAuthorFromRow(result, 0);
+}
+
+net::awaitable<std::optional<Author>> AsyncAuthorRepositoryImpl::GetAuthorById(AuthorId id) {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(SELECT id, name FROM authors WHERE id=$1 AND deleted_at IS NULL;)"s, id.ToString()
+    );
+    if (result.Size() != 1) {
+        co_return std::nullopt;
+    }
+    co_return GetAuthorFromRow(result, 0);
+}
+
+// // // --- AUTHOR --- // // // --- AUTHOR --- // // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // // --- BOOK --- // // // --- BOOK --- // // //
+
+net::awaitable<void> AsyncBookRepositoryImpl::Save(Book book) {
+    co_await connection_.Exec(
+        R"(
+            INSERT INTO books (id, author_id, title, publication_year) VALUES ($1, $2, $3, $4)
+            ON CONFLICT (id, publication_year) DO UPDATE SET author_id=$2, title=$3;
+        )"s,
+        book.GetId().ToString(),
+        book.GetAuthorId().ToString(),
+        book.GetTitle(),
+        std::to_string(book.GetPublicationYear())
+    );
+}
+
+net::awaitable<void> AsyncBookRepositoryImpl::Edit(BookId id, std::string title, int publication_year) {
+    co_await connection_.Exec(
+        R"(
+            UPDATE books
+            SET title=$2, publication_year=$3
+            WHERE id=$1;
+        )"s,
+        id.ToString(),
+        std::move(title),
+        std::to_string(publication_year)
+    );
+}
+
+net::awaitable<void> AsyncBookRepositoryImpl::Delete(BookId id) {
+    co_await connection_.Exec(R"(DELETE FROM books WHERE id=$1;)"s, id.ToString());
+}
+
+net::awaitable<std::optional<Book>> AsyncBookRepositoryImpl::GetBookById(BookId id) {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(
+            SELECT books.id, author_id, title, publication_year, authors.name
+            FROM books
+            INNER JOIN authors ON authors.id = author_id
+            WHERE books.id=$1 AND authors.deleted_at IS NULL;
+        )"s,
+        id.ToString()
+    );
+    if (result.Size() != 1) {
+        co_return std::nullopt;
+    }
+    co_return GetBookFromRow(result, 0, true);
+}
+
+net::awaitable<std::vector<Book>> AsyncBookRepositoryImpl::GetBooksByTitle(std::string title) {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(
+            SELECT books.id, author_id, title, publication_year
+            FROM books
+            INNER JOIN authors ON authors.id = author_id
+            WHERE title=$1 AND authors.deleted_at IS NULL;
+        )"s,
+        std::move(title)
+    );
+    co_return GetBooksFromResult(result, false);
+}
+
+net::awaitable<std::vector<Book>> AsyncBookRepositoryImpl::GetAllBooks() {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(
+            SELECT books.id, author_id, title, publication_year, authors.name AS name
+            FROM books
+            INNER JOIN authors ON authors.id = author_id
+            WHERE authors.deleted_at IS NULL
+            ORDER BY title, name, publication_year;
+        )"s
+    );
+    co_return GetBooksFromResult(result, true);
+}
+
+net::awaitable<std::vector<Book>> AsyncBookRepositoryImpl::GetBooksByAuthorId(AuthorId author_id) {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(
+            SELECT books.id, author_id, title, publication_year
+            FROM books
+            INNER JOIN authors ON authors.id = author_id
+            WHERE author_id=$1 AND authors.deleted_at IS NULL
+            ORDER BY publication_year, title;
+        )"s,
+        author_id.ToString()
+    );
+    co_return GetBooksFromResult(result, false);
+}
+
+net::awaitable<void> AsyncBookRepositoryImpl::DeleteBooksByAuthorId(AuthorId author_id) {
+    co_await connection_.Exec(R"(DELETE FROM books WHERE author_id=$1;)"s, author_id.ToString());
+}
+
+// // // --- BOOK --- // // // --- BOOK --- // // // --- BOOK --- // // //
+//
+//
+//
+// // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // //
+
+net::awaitable<void> AsyncBookTagRepositoryImpl::Save(BookTag book_tag) {
+    co_await connection_.Exec(
+        R"(INSERT INTO book_tags (book_id, tag) VALUES ($1, $2);)"s,
+        book_tag.GetBookId().ToString(),
+        book_tag.GetTag()
+    );
+}
+
+net::awaitable<void> AsyncBookTagRepositoryImpl::DeleteByBookId(BookId book_id) {
+    co_await connection_.Exec(R"(DELETE FROM book_tags WHERE book_id=$1;)"s, book_id.ToString());
+}
+
+net::awaitable<void> AsyncBookTagRepositoryImpl::DeleteByAuthorId(AuthorId author_id) {
+    co_await connection_.Exec(
+        R"(
+            DELETE FROM book_tags
+            USING books
+            WHERE book_tags.book_id = books.id AND books.author_id=$1;
+        )"s,
+        author_id.ToString()
+    );
+}
+
+net::awaitable<std::vector<BookTag>> AsyncBookTagRepositoryImpl::GetBookTags(BookId book_id) {
+    const AsyncResult result = co_await connection_.Exec(
+        R"(
+            SELECT tag FROM book_tags
+            WHERE book_id=$1
+            ORDER BY tag;
+        )"s,
+        book_id.ToString()
+    );
+    std::vector<BookTag> book_tags;
+    book_tags.reserve(result.Size());
+    for (int row = 0; row < result.Size(); ++row) {
+        book_tags.emplace_back(BookTag{book_id, std::string{result.GetValue(row, 0)}});
+    }
+    co_return book_tags;
+}
+
+// // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // //
+
+net::awaitable<void> AsyncUnitOfWorkImpl::Commit() {
+    co_await lease_->ExecParams("COMMIT;"s);
+    metrics::Registry::Get().CountTransaction();
+}
+
+net::awaitable<std::unique_ptr<app::AsyncUnitOfWork>> AsyncUnitOfWorkFactoryImpl::CreateUnitOfWork() {
+    AsyncConnectionPool::Lease lease = co_await pool_.Acquire();
+    co_await lease->ExecParams("BEGIN;"s);
+    co_return std::make_unique<AsyncUnitOfWorkImpl>(std::move(lease));
+}
+
+}  // namespace postgres
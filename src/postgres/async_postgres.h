@@ -0,0 +1,136 @@
+#pragma once
+
+#include <memory>
+
+#include "../app/async_unit_of_work.h"
+#include "async_connection.h"
+
+namespace postgres {
+
+using namespace domain;
+
+class AsyncAuthorRepositoryImpl : public AsyncAuthorRepository {
+public:
+    explicit AsyncAuthorRepositoryImpl(AsyncConnection& connection)
+    : connection_{connection}
+    {
+
+    }
+
+    net::awaitable<void> Save(Author author) override;
+    net::awaitable<void> Edit(AuthorId id, std::string new_name) override;
+    net::awaitable<void> Delete(AuthorId id) override;
+    net::awaitable<void> MarkDeleted(AuthorId id) override;
+
+    net::awaitable<std::vector<Author>> GetAllAuthors() override;
+    net::awaitable<std::optional<Author>> GetAuthorByName(std::string name) override;
+    net::awaitable<std::optional<Author>> GetAuthorById(AuthorId id) override;
+
+private:
+    AsyncConnection& connection_;
+};
+
+class AsyncBookRepositoryImpl : public AsyncBookRepository {
+public:
+    explicit AsyncBookRepositoryImpl(AsyncConnection& connection)
+    : connection_{connection}
+    {
+
+    }
+
+    net::awaitable<void> Save(Book book) override;
+    net::awaitable<void> Edit(BookId id, std::string title, int publication_year) override;
+    net::awaitable<void> Delete(BookId id) override;
+
+    net::awaitable<std::optional<Book>> GetBookById(BookId id) override;
+    net::awaitable<std::vector<Book>> GetBooksByTitle(std::string title) override;
+    net::awaitable<std::vector<Book>> GetAllBooks() override;
+    net::awaitable<std::vector<Book>> GetBooksByAuthorId(AuthorId author_id) override;
+
+    net::awaitable<void> DeleteBooksByAuthorId(AuthorId author_id) override;
+
+private:
+    AsyncConnection& connection_;
+};
+
+class AsyncBookTagRepositoryImpl : public AsyncBookTagRepository {
+public:
+    explicit AsyncBookTagRepositoryImpl(AsyncConnection& connection)
+    : connection_{connection}
+    {
+
+    }
+
+    net::awaitable<void> Save(BookTag book_tag) override;
+    net::awaitable<void> DeleteByBookId(BookId book_id) override;
+    net::awaitable<void> DeleteByAuthorId(AuthorId author_id) override;
+
+    net::awaitable<std::vector<BookTag>> GetBookTags(BookId book_id) override;
+
+private:
+    AsyncConnection& connection_;
+};
+
+class AsyncUnitOfWorkImpl : public app::AsyncUnitOfWork {
+public:
+    explicit AsyncUnitOfWorkImpl(AsyncConnectionPool::Lease lease)
+    : lease_{std::move(lease)}
+    {
+
+    }
+
+    net::awaitable<void> Commit() override;
+
+    domain::AsyncAuthorRepository& GetAuthorRepository() override {
+        return authors_;
+    }
+
+    domain::AsyncBookRepository& GetBookRepository() override {
+        return books_;
+    }
+
+    domain::AsyncBookTagRepository& GetBookTagRepository() override {
+        return book_tags_;
+    }
+
+private:
+    AsyncConnectionPool::Lease lease_;
+    AsyncAuthorRepositoryImpl authors_{*lease_};
+    AsyncBookRepositoryImpl books_{*lease_};
+    AsyncBookTagRepositoryImpl book_tags_{*lease_};
+};
+
+class AsyncUnitOfWorkFactoryImpl : public app::AsyncUnitOfWorkFactory {
+public:
+    explicit AsyncUnitOfWorkFactoryImpl(AsyncConnectionPool& pool)
+    : pool_{pool}
+    {
+
+    }
+
+    // Берёт соединение из пула и открывает на нём транзакцию
+    net::awaitable<std::unique_ptr<app::AsyncUnitOfWork>> CreateUnitOfWork() override;
+
+private:
+    AsyncConnectionPool& pool_;
+};
+
+// Асинхронный доступ к базе. Схема создаётся синхронным postgres::Database.
+class AsyncDatabase {
+public:
+    AsyncDatabase(net::any_io_executor executor, const std::string& url, std::size_t pool_size)
+    : pool_{std::move(executor), url, pool_size}
+    {
+
+    }
+
+    AsyncUnitOfWorkFactoryImpl& GetUnitOfWorkFactory() {
+        return uow_factory_;
+    }
+
+private:
+    AsyncConnectionPool pool_;
+    AsyncUnitOfWorkFactoryImpl uow_factory_{pool_};
+};
+
+}  // namespace postgres
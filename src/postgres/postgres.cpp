@@ -1,56 +1,95 @@
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "postgres.h"
+#include "result_rows.h"
+
+#include "../metrics/metrics.h"
 
 namespace postgres {
 
 using namespace std::literals;
 using pqxx::operator"" _zv;
 
+namespace {
+
+// LIMIT принимает bigint
+std::int64_t ToSqlLimit(std::size_t limit) {
+    return static_cast<std::int64_t>(std::min<std::size_t>(limit, std::numeric_limits<std::int64_t>::max()));
+}
+
+// Шаблон LIKE для строк, начинающихся с prefix: служебные символы экранируются
+std::string ToLikePrefix(std::string_view prefix) {
+    std::string pattern;
+    pattern.reserve(prefix.size() + 1);
+    for (const char c : prefix) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern.push_back('\\');
+        }
+        pattern.push_back(c);
+    }
+    pattern.push_back('%');
+    return pattern;
+}
+
+}  // namespace
+
 // // // --- AUTHOR --- // // // --- AUTHOR --- // // // --- AUTHOR --- // // //
 
 Author AuthorRepositoryImpl::GetAuthorFromRow(const pqxx::row &row) const {
-    return Author{AuthorId::FromString(row.at("id"s).as<std::string>()), row.at("name"s).as<std::string>()};
+    return Author{AuthorId::FromString(row.at("id"s).view()), row.at("name"s).as<std::string>()};
 }
 
 void AuthorRepositoryImpl::Save(const domain::Author& author) {
-    work_.exec_params(
-        R"(
-            INSERT INTO authors (id, name) VALUES ($1, $2)
-            ON CONFLICT (id) DO UPDATE SET name=$2;
-        )"_zv,
-        author.GetId().ToString(), 
-        author.GetName()
-    );
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::Save"sv);
+    metrics::ScopedCall call{stats};
+    batch_.SaveAuthor(author);
 }
 
-void AuthorRepositoryImpl::Edit(const AuthorId& id, const std::string& new_name) {
-    work_.exec_params(R"(UPDATE authors SET name=$2 WHERE id=$1;)", id.ToString(), new_name);
+void AuthorRepositoryImpl::Edit(const AuthorId& id, std::string_view new_name) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::Edit"sv);
+    metrics::ScopedCall call{stats};
+    batch_.EditAuthor(id, new_name);
 }
 
 void AuthorRepositoryImpl::Delete(const AuthorId& id) {
-    work_.exec_params(R"(DELETE FROM authors WHERE id=$1;)"_zv, id.ToString());
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::Delete"sv);
+    metrics::ScopedCall call{stats};
+    batch_.DeleteAuthor(id);
 }
 
-std::vector<Author> AuthorRepositoryImpl::GetAllAuthors() const {
-    pqxx::result result = work_.exec(R"(SELECT * FROM authors ORDER BY name;)"_zv);
+void AuthorRepositoryImpl::MarkDeleted(const AuthorId& id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::MarkDeleted"sv);
+    metrics::ScopedCall call{stats};
+    batch_.MarkAuthorDeleted(id);
+}
 
-    std::vector<Author> authors;
-    authors.reserve(result.size());
-    for (const pqxx::row& row : result) {
-        authors.emplace_back(GetAuthorFromRow(row));
-    }
-    return authors;
+AuthorRows AuthorRepositoryImpl::GetAllAuthors() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::GetAllAuthors"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    pqxx::result result = work_.Exec("AuthorRepository::GetAllAuthors"sv, R"(SELECT id, name FROM authors WHERE deleted_at IS NULL ORDER BY name USING ~<~;)"_zv);
+    call.SetRows(result.size());
+    return AuthorRows{std::make_unique<ResultAuthorRows>(std::move(result))};
 }
 
-std::optional<Author> AuthorRepositoryImpl::GetAuthorByName(const std::string& name) const {
+std::optional<Author> AuthorRepositoryImpl::GetAuthorByName(std::string_view name) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::GetAuthorByName"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
     try {
-        const pqxx::row& row = work_.exec_params1(R"(SELECT * FROM authors WHERE name=$1;)"_zv, name);
+        const pqxx::row& row = work_.ExecParams1("AuthorRepository::GetAuthorByName"sv, R"(SELECT id, name FROM authors WHERE name=$1 AND deleted_at IS NULL;)"_zv, name);
+        call.SetRows(1);
         return GetAuthorFromRow(row);
     } catch (pqxx::unexpected_rows &) {
         return std::nullopt;
@@ -58,71 +97,96 @@ std::optional<Author> AuthorRepositoryImpl::GetAuthorByName(const std::string& n
 }
 
 std::optional<Author> AuthorRepositoryImpl::GetAuthorById(const AuthorId& id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::GetAuthorById"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
     try {
-        const pqxx::row& row = work_.exec_params1(R"(SELECT * FROM authors WHERE id=$1;)"_zv, id.ToString());
+        const pqxx::row& row = work_.ExecParams1("AuthorRepository::GetAuthorById"sv, R"(SELECT id, name FROM authors WHERE id=$1 AND deleted_at IS NULL;)"_zv, id.ToChars().View());
+        call.SetRows(1);
         return GetAuthorFromRow(row);
     } catch (pqxx::unexpected_rows &) {
         return std::nullopt;
     }
 }
 
+AuthorRows AuthorRepositoryImpl::GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::GetAuthorsByNamePrefix"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Побайтовый порядок ~<~ совпадает с порядком authors_name_pattern_idx: читаются
+    // только первые limit имён диапазона, без сортировки всех совпадений
+    pqxx::result result = work_.ExecParams(
+        "AuthorRepository::GetAuthorsByNamePrefix"sv,
+        R"(
+            SELECT id, name FROM authors
+            WHERE name LIKE $1 AND deleted_at IS NULL
+            ORDER BY name USING ~<~
+            LIMIT $2;
+        )"_zv,
+        ToLikePrefix(prefix), ToSqlLimit(limit)
+    );
+    call.SetRows(result.size());
+    return AuthorRows{std::make_unique<ResultAuthorRows>(std::move(result))};
+}
+
+std::vector<AuthorId> AuthorRepositoryImpl::GetDeletedAuthorIds() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "AuthorRepository::GetDeletedAuthorIds"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    const pqxx::result result = work_.Exec(
+        "AuthorRepository::GetDeletedAuthorIds"sv,
+        R"(SELECT id FROM authors WHERE deleted_at IS NOT NULL ORDER BY deleted_at, id;)"_zv
+    );
+    std::vector<AuthorId> ids;
+    ids.reserve(result.size());
+    for (const pqxx::row& row : result) {
+        ids.push_back(AuthorId::FromString(row[0].view()));
+    }
+    call.SetRows(ids.size());
+    return ids;
+}
+
 // // // --- AUTHOR --- // // // --- AUTHOR --- // // // --- AUTHOR --- // // //
 //
 //
 //
 // // // --- BOOK --- // // // --- BOOK --- // // // --- BOOK --- // // //
 
-Book BookRepositoryImpl::GetBookFromRow(const pqxx::row& row, bool with_author_name) const {
-    
-    if (with_author_name) {
-        return Book{
-            BookId::FromString(row.at("book_id"s).as<std::string>()),
-            AuthorId::FromString(row.at("author_id"s).as<std::string>()),
-            row.at("title"s).as<std::string>(), 
-            row.at("publication_year"s).as<int>(),
-            row.at("name").as<std::string>()
-        };
-    }
+Book BookRepositoryImpl::GetBookFromRow(const pqxx::row& row) const {
     return Book{
-        BookId::FromString(row.at("book_id"s).as<std::string>()),
-        AuthorId::FromString(row.at("author_id"s).as<std::string>()),
-        row.at("title"s).as<std::string>(), 
-        row.at("publication_year"s).as<int>()
+        BookId::FromString(row.at("book_id"s).view()),
+        AuthorId::FromString(row.at("author_id"s).view()),
+        row.at("title"s).as<std::string>(),
+        row.at("publication_year"s).as<int>(),
+        row.at("name"s).as<std::string>()
     };
 }
 
 void BookRepositoryImpl::Save(const Book& book) {
-    work_.exec_params(
-        R"(
-            INSERT INTO books (id, author_id, title, publication_year) VALUES ($1, $2, $3, $4)
-            ON CONFLICT (id) DO UPDATE SET author_id=$2, title=$3, publication_year=$4;
-        )"_zv,
-        book.GetId().ToString(),
-        book.GetAuthorId().ToString(),
-        book.GetTitle(),
-        book.GetPublicationYear()
-    );
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::Save"sv);
+    metrics::ScopedCall call{stats};
+    batch_.SaveBook(book);
 }
 
-void BookRepositoryImpl::Edit(const BookId& id, const std::string& title, int publication_year) {
-    work_.exec_params(
-        R"(
-            UPDATE books
-            SET title=$2, publication_year=$3
-            WHERE id=$1;
-        )"_zv,
-        id.ToString(),
-        title, publication_year
-    );
+void BookRepositoryImpl::Edit(const BookId& id, std::string_view title, int publication_year) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::Edit"sv);
+    metrics::ScopedCall call{stats};
+    batch_.EditBook(id, title, publication_year);
 }
 
 void BookRepositoryImpl::Delete(const BookId& id) {
-    work_.exec_params(R"(DELETE FROM books WHERE id=$1;)"_zv, id.ToString());
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::Delete"sv);
+    metrics::ScopedCall call{stats};
+    batch_.DeleteBook(id);
 }
 
 std::optional<Book> BookRepositoryImpl::GetBookById(const BookId& id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBookById"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
     try {
-        const pqxx::row& row = work_.exec_params1(
+        const pqxx::row& row = work_.ExecParams1(
+            "BookRepository::GetBookById"sv,
             R"(
                 SELECT 
                     books.id AS book_id,
@@ -132,40 +196,83 @@ std::optional<Book> BookRepositoryImpl::GetBookById(const BookId& id) {
                     publication_year
                 FROM books
                 INNER JOIN authors ON authors.id = author_id
-                WHERE books.id=$1;
+                WHERE books.id=$1 AND authors.deleted_at IS NULL;
 			)"_zv,
-            id.ToString()
+            id.ToChars().View()
         );
-        return GetBookFromRow(row, true);
+        call.SetRows(1);
+        return GetBookFromRow(row);
     } catch (pqxx::unexpected_rows &) {
         return std::nullopt;
     }
 }
 
-std::vector<Book> BookRepositoryImpl::GetBooksByTitle(const std::string& title) {
-    pqxx::result result = work_.exec_params(
+std::optional<Book> BookRepositoryImpl::GetBookByIdForUpdate(const BookId& id) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBookByIdForUpdate"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    try {
+        // Под READ COMMITTED вторая запись той же книги ждёт здесь фиксации первой
+        // и читает уже её результат
+        const pqxx::row& row = work_.ExecParams1(
+            "BookRepository::GetBookByIdForUpdate"sv,
+            R"(
+                SELECT 
+                    books.id AS book_id,
+                    author_id,
+                    authors.name AS name,
+                    title,
+                    publication_year
+                FROM books
+                INNER JOIN authors ON authors.id = author_id
+                WHERE books.id=$1 AND authors.deleted_at IS NULL
+                FOR UPDATE OF books;
+			)"_zv,
+            id.ToChars().View()
+        );
+        call.SetRows(1);
+        return GetBookFromRow(row);
+    } catch (pqxx::unexpected_rows &) {
+        return std::nullopt;
+    }
+}
+
+std::vector<Book> BookRepositoryImpl::GetBooksByTitle(std::string_view title) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBooksByTitle"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    pqxx::result result = work_.ExecParams(
+        "BookRepository::GetBooksByTitle"sv,
         R"(
-            SELECT 
-                id AS book_id,
+            SELECT
+                books.id AS book_id,
                 author_id,
+                authors.name AS name,
                 title,
                 publication_year
             FROM books
-            WHERE title=$1;
+            INNER JOIN authors ON authors.id = author_id
+            WHERE title=$1 AND authors.deleted_at IS NULL
+            ORDER BY name USING ~<~, publication_year;
 		)"_zv,
         title
     );
-    
+
     std::vector<domain::Book> books;
     books.reserve(result.size());
     for (const pqxx::row& row : result) {
-        books.emplace_back(GetBookFromRow(row, false));
+        books.emplace_back(GetBookFromRow(row));
     }
+    call.SetRows(books.size());
     return books;
 }
 
-std::vector<Book> BookRepositoryImpl::GetAllBooks() {
-    pqxx::result result = work_.exec_params(
+BookRows BookRepositoryImpl::GetAllBooks() {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetAllBooks"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    pqxx::result result = work_.ExecParams(
+        "BookRepository::GetAllBooks"sv,
         R"(
             SELECT
                 books.id AS book_id,
@@ -175,41 +282,115 @@ std::vector<Book> BookRepositoryImpl::GetAllBooks() {
                 publication_year
             FROM books
             INNER JOIN authors ON authors.id = author_id
-            ORDER BY title, name, publication_year;
+            WHERE authors.deleted_at IS NULL
+            ORDER BY title USING ~<~, name USING ~<~, publication_year;
 		)"_zv
     );
-    std::vector<domain::Book> books;
-    books.reserve(result.size());
-    for (const pqxx::row& row : result) {
-        books.emplace_back(GetBookFromRow(row, true));
-    }
-    return books;
+    call.SetRows(result.size());
+    return BookRows{std::make_unique<ResultBookRows>(std::move(result))};
 }
 
-std::vector<Book> BookRepositoryImpl::GetBooksByAuthorId(const AuthorId& author_id) const {
-    pqxx::result result = work_.exec_params(
+BookRows BookRepositoryImpl::GetBooksByAuthorId(const AuthorId& author_id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBooksByAuthorId"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    pqxx::result result = work_.ExecParams(
+        "BookRepository::GetBooksByAuthorId"sv,
         R"(
             SELECT
-                id AS book_id,
+                books.id AS book_id,
                 author_id,
+                authors.name AS name,
                 title,
                 publication_year
             FROM books
-            WHERE author_id=$1
+            INNER JOIN authors ON authors.id = author_id
+            WHERE author_id=$1 AND authors.deleted_at IS NULL
             ORDER BY publication_year, title;
 		)"_zv,
-        author_id.ToString()
+        author_id.ToChars().View()
     );
-    std::vector<domain::Book> books;
-    books.reserve(result.size());
+    call.SetRows(result.size());
+    return BookRows{std::make_unique<ResultBookRows>(std::move(result))};
+}
+
+BookRows BookRepositoryImpl::GetBooksByYearRange(int from, int to) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBooksByYearRange"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Условие на ключ секционирования отсекает лишние секции, внутри секции
+    // строки идут из индекса books_year_title_pattern_idx уже в нужном порядке
+    pqxx::result result = work_.ExecParams(
+        "BookRepository::GetBooksByYearRange"sv,
+        R"(
+            SELECT
+                books.id AS book_id,
+                author_id,
+                authors.name AS name,
+                title,
+                publication_year
+            FROM books
+            INNER JOIN authors ON authors.id = author_id
+            WHERE publication_year BETWEEN $1 AND $2 AND authors.deleted_at IS NULL
+            ORDER BY publication_year, title USING ~<~, name USING ~<~;
+		)"_zv,
+        from,
+        to
+    );
+    call.SetRows(result.size());
+    return BookRows{std::make_unique<ResultBookRows>(std::move(result))};
+}
+
+BookRows BookRepositoryImpl::GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBooksByTitlePrefix"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Секции читаются по books_title_pattern_idx и сливаются в порядке названий
+    pqxx::result result = work_.ExecParams(
+        "BookRepository::GetBooksByTitlePrefix"sv,
+        R"(
+            SELECT
+                books.id AS book_id,
+                author_id,
+                authors.name AS name,
+                title,
+                publication_year
+            FROM books
+            INNER JOIN authors ON authors.id = author_id
+            WHERE title LIKE $1 AND authors.deleted_at IS NULL
+            ORDER BY title USING ~<~, name USING ~<~, publication_year
+            LIMIT $2;
+		)"_zv,
+        ToLikePrefix(prefix), ToSqlLimit(limit)
+    );
+    call.SetRows(result.size());
+    return BookRows{std::make_unique<ResultBookRows>(std::move(result))};
+}
+
+std::vector<BookId> BookRepositoryImpl::GetBookIdsByAuthorId(const AuthorId& author_id, std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBookIdsByAuthorId"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Без соединения с authors: книги автора, помеченного удалённым, тоже возвращаются
+    const pqxx::result result = work_.ExecParams(
+        "BookRepository::GetBookIdsByAuthorId"sv,
+        R"(SELECT id FROM books WHERE author_id=$1 LIMIT $2;)"_zv,
+        author_id.ToChars().View(),
+        ToSqlLimit(limit)
+    );
+    std::vector<BookId> ids;
+    ids.reserve(result.size());
     for (const pqxx::row& row : result) {
-        books.emplace_back(GetBookFromRow(row, false));
+        ids.push_back(BookId::FromString(row[0].view()));
     }
-    return books;
+    call.SetRows(ids.size());
+    return ids;
 }
 
 void BookRepositoryImpl::DeleteBooksByAuthorId(const AuthorId& author_id) {
-    work_.exec_params(R"(DELETE FROM books WHERE author_id=$1;)"_zv, author_id.ToString());
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::DeleteBooksByAuthorId"sv);
+    metrics::ScopedCall call{stats};
+    batch_.DeleteBooksByAuthorId(author_id);
 }
 
 // // // --- BOOK --- // // // --- BOOK --- // // // --- BOOK --- // // //
@@ -218,74 +399,730 @@ void BookRepositoryImpl::DeleteBooksByAuthorId(const AuthorId& author_id) {
 //
 // // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // //
 
-void BookTagRepositoryImpl::Save(const BookTag& book_tag) {
-    work_.exec_params(
-        R"(
-            INSERT INTO book_tags (book_id, tag) VALUES ($1, $2);
-        )"_zv,
-        book_tag.GetBookId().ToString(),
-        book_tag.GetTag()
-    );
+void BookTagRepositoryImpl::Save(const BookId& book_id, std::string_view tag) {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookTagRepository::Save"sv);
+    metrics::ScopedCall call{stats};
+    batch_.SaveTag(book_id, tag);
 }
 
 void BookTagRepositoryImpl::DeleteByBookId(const BookId& book_id) {
-    work_.exec_params(R"(DELETE FROM book_tags WHERE book_id=$1;)"_zv, book_id.ToString());
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookTagRepository::DeleteByBookId"sv);
+    metrics::ScopedCall call{stats};
+    batch_.DeleteTagsByBookId(book_id);
 }
 
-std::vector<BookTag> BookTagRepositoryImpl::GetBookTags(const BookId& book_id) const {
-    auto result = work_.exec_params(
+std::vector<std::string> BookTagRepositoryImpl::GetTags(const BookId& book_id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookTagRepository::GetTags"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    auto result = work_.ExecParams(
+        "BookTagRepository::GetTags"sv,
         R"(
-            SELECT * FROM book_tags
+            SELECT tag FROM book_tags
             WHERE book_id=$1
             ORDER BY tag;
 		)"_zv,
-        book_id.ToString()
+        book_id.ToChars().View()
     );
-    std::vector<BookTag> book_tags;
-    book_tags.reserve(result.size());
+    std::vector<std::string> tags;
+    tags.reserve(result.size());
     for (const pqxx::row& row : result) {
-        book_tags.emplace_back(BookTag{
-            domain::BookId::FromString(row.at("book_id"s).as<std::string>()),
-            row.at("tag"s).as<std::string>()
-        });
+        tags.emplace_back(row[0].view());
     }
-    return book_tags;
+    call.SetRows(tags.size());
+    return tags;
+}
+
+std::vector<TagBookCount> BookTagRepositoryImpl::GetTagCountsByAuthorId(const AuthorId& author_id) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookTagRepository::GetTagCountsByAuthorId"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    const pqxx::result result = work_.ExecParams(
+        "BookTagRepository::GetTagCountsByAuthorId"sv,
+        R"(
+            SELECT tag, COUNT(*) FROM book_tags
+            JOIN books ON books.id = book_tags.book_id
+            WHERE books.author_id=$1
+            GROUP BY tag
+            ORDER BY tag;
+		)"_zv,
+        author_id.ToChars().View()
+    );
+    std::vector<TagBookCount> tags;
+    tags.reserve(result.size());
+    for (const pqxx::row& row : result) {
+        tags.push_back({row[0].as<std::string>(), row[1].as<std::int64_t>()});
+    }
+    call.SetRows(tags.size());
+    return tags;
 }
 
 // // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // // --- BOOK_TAG --- // // //
+//
+//
+//
+// // // --- STATISTICS --- // // // --- STATISTICS --- // // // --- STATISTICS --- // // //
+
+namespace {
+
+// Пересчёт сводных таблиц по исходным. SHARE-блокировка не пускает запись в исходные таблицы
+// до конца транзакции, поэтому триггеры не изменят счётчики посреди пересчёта.
+// Как и триггеры, учитывает только книги и теги авторов, не помеченных удалёнными
+constexpr const char kRebuildStatistics[] = R"(
+    LOCK TABLE authors, books, book_tags IN SHARE MODE;
+    TRUNCATE author_book_counts, tag_book_counts, year_book_counts, author_counts;
+    INSERT INTO author_book_counts (author_id, books)
+    SELECT author_id, count(*) FROM books
+    INNER JOIN authors ON authors.id = books.author_id AND authors.deleted_at IS NULL
+    GROUP BY author_id;
+    INSERT INTO tag_book_counts (tag, books)
+    SELECT tag, count(*) FROM book_tags
+    INNER JOIN books ON books.id = book_tags.book_id
+    INNER JOIN authors ON authors.id = books.author_id AND authors.deleted_at IS NULL
+    GROUP BY tag;
+    INSERT INTO year_book_counts (publication_year, books)
+    SELECT publication_year, count(*) FROM books
+    INNER JOIN authors ON authors.id = books.author_id AND authors.deleted_at IS NULL
+    GROUP BY publication_year;
+    INSERT INTO author_counts (slot, authors)
+    SELECT 0, count(*) FROM authors WHERE deleted_at IS NULL;
+)";
+
+}  // namespace
+
+CatalogTotals StatisticsRepositoryImpl::GetTotals() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::GetTotals"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    const pqxx::row row = work_.ExecParams1(
+        "StatisticsRepository::GetTotals"sv,
+        R"(
+            SELECT
+                (SELECT coalesce(sum(authors), 0) FROM author_counts)::bigint,
+                (SELECT coalesce(sum(books), 0) FROM year_book_counts)::bigint,
+                (SELECT count(*) FROM tag_book_counts);
+        )"_zv
+    );
+    call.SetRows(1);
+    return {row[0].as<std::int64_t>(), row[1].as<std::int64_t>(), row[2].as<std::int64_t>()};
+}
+
+std::vector<AuthorBookCount> StatisticsRepositoryImpl::GetTopAuthors(std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::GetTopAuthors"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Индекс (books DESC, author_id) отдаёт строки в нужном порядке: читается не больше
+    // limit строк счётчиков плюс пропущенные удалённые авторы
+    const pqxx::result result = work_.ExecParams(
+        "StatisticsRepository::GetTopAuthors"sv,
+        R"(
+            SELECT authors.id, authors.name, author_book_counts.books
+            FROM author_book_counts
+            INNER JOIN authors ON authors.id = author_book_counts.author_id
+            WHERE authors.deleted_at IS NULL
+            ORDER BY author_book_counts.books DESC, author_book_counts.author_id
+            LIMIT $1;
+        )"_zv,
+        ToSqlLimit(limit)
+    );
+    std::vector<AuthorBookCount> authors;
+    authors.reserve(result.size());
+    for (const pqxx::row& row : result) {
+        authors.push_back({AuthorId::FromString(row[0].view()), row[1].as<std::string>(), row[2].as<std::int64_t>()});
+    }
+    call.SetRows(authors.size());
+    return authors;
+}
+
+std::vector<TagBookCount> StatisticsRepositoryImpl::GetTopTags(std::size_t limit) const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::GetTopTags"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    const pqxx::result result = work_.ExecParams(
+        "StatisticsRepository::GetTopTags"sv,
+        R"(SELECT tag, books FROM tag_book_counts ORDER BY books DESC, tag LIMIT $1;)"_zv,
+        ToSqlLimit(limit)
+    );
+    std::vector<TagBookCount> tags;
+    tags.reserve(result.size());
+    for (const pqxx::row& row : result) {
+        tags.push_back({row[0].as<std::string>(), row[1].as<std::int64_t>()});
+    }
+    call.SetRows(tags.size());
+    return tags;
+}
+
+std::vector<TagBookCount> StatisticsRepositoryImpl::GetTopTagsByPrefix(std::string_view prefix, std::size_t limit) const {
+    if (prefix.empty()) {
+        return GetTopTags(limit);
+    }
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::GetTopTagsByPrefix"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Диапазон тегов с префиксом читается по индексу tag_book_counts_tag_pattern_idx
+    const pqxx::result result = work_.ExecParams(
+        "StatisticsRepository::GetTopTagsByPrefix"sv,
+        R"(SELECT tag, books FROM tag_book_counts WHERE tag LIKE $1 ORDER BY books DESC, tag LIMIT $2;)"_zv,
+        ToLikePrefix(prefix), ToSqlLimit(limit)
+    );
+    std::vector<TagBookCount> tags;
+    tags.reserve(result.size());
+    for (const pqxx::row& row : result) {
+        tags.push_back({row[0].as<std::string>(), row[1].as<std::int64_t>()});
+    }
+    call.SetRows(tags.size());
+    return tags;
+}
+
+std::vector<YearBookCount> StatisticsRepositoryImpl::GetBooksPerYear() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::GetBooksPerYear"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    const pqxx::result result = work_.Exec(
+        "StatisticsRepository::GetBooksPerYear"sv,
+        R"(SELECT publication_year, books FROM year_book_counts ORDER BY publication_year;)"_zv
+    );
+    std::vector<YearBookCount> years;
+    years.reserve(result.size());
+    for (const pqxx::row& row : result) {
+        years.push_back({row[0].as<int>(), row[1].as<std::int64_t>()});
+    }
+    call.SetRows(years.size());
+    return years;
+}
+
+StatisticsDrift StatisticsRepositoryImpl::Verify() const {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::Verify"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    // Один оператор — один снимок данных: параллельная запись не даёт ложных расхождений.
+    // Книги и теги авторов, помеченных удалёнными, в счётчиках не учитываются
+    const pqxx::row row = work_.ExecParams1(
+        "StatisticsRepository::Verify"sv,
+        R"(
+            WITH live_books AS (
+                SELECT books.* FROM books
+                INNER JOIN authors ON authors.id = books.author_id
+                WHERE authors.deleted_at IS NULL
+            )
+            SELECT
+                (SELECT count(*)
+                 FROM (SELECT author_id, count(*) AS books FROM live_books GROUP BY author_id) AS actual
+                 FULL JOIN author_book_counts AS stored USING (author_id)
+                 WHERE actual.books IS DISTINCT FROM stored.books),
+                (SELECT count(*)
+                 FROM (SELECT tag, count(*) AS books FROM book_tags
+                       INNER JOIN live_books ON live_books.id = book_tags.book_id
+                       GROUP BY tag) AS actual
+                 FULL JOIN tag_book_counts AS stored USING (tag)
+                 WHERE actual.books IS DISTINCT FROM stored.books),
+                (SELECT count(*)
+                 FROM (SELECT publication_year, count(*) AS books FROM live_books GROUP BY publication_year) AS actual
+                 FULL JOIN year_book_counts AS stored USING (publication_year)
+                 WHERE actual.books IS DISTINCT FROM stored.books),
+                ((SELECT count(*) FROM authors WHERE deleted_at IS NULL)
+                 IS DISTINCT FROM (SELECT coalesce(sum(authors), 0) FROM author_counts))::integer,
+                (SELECT count(*) FROM book_tags
+                 WHERE NOT EXISTS (SELECT 1 FROM books WHERE books.id = book_tags.book_id)),
+                (SELECT count(*) FROM (SELECT id FROM books GROUP BY id HAVING count(*) > 1) AS duplicates);
+        )"_zv
+    );
+    call.SetRows(1);
+    return {row[0].as<std::size_t>(), row[1].as<std::size_t>(), row[2].as<std::size_t>(), row[3].as<std::size_t>(),
+            row[4].as<std::size_t>(), row[5].as<std::size_t>()};
+}
+
+void StatisticsRepositoryImpl::Rebuild() {
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "StatisticsRepository::Rebuild"sv);
+    metrics::ScopedCall call{stats};
+    batch_.Flush(work_);
+    work_.Exec("StatisticsRepository::Rebuild"sv, pqxx::zview{kRebuildStatistics});
+}
+
+// // // --- STATISTICS --- // // // --- STATISTICS --- // // // --- STATISTICS --- // // //
+//
+//
+//
+// // // --- UNIT_OF_WORK --- // // // --- UNIT_OF_WORK --- // // // --- UNIT_OF_WORK --- // // //
+
+void UnitOfWorkImpl::Commit() {
+    if (read_only_ && (batch_.HasFlushed() || !batch_.Empty())) {
+        throw std::logic_error("Read-only unit of work cannot commit changes"s);
+    }
+    batch_.Flush(traced_work_);
+    work_.commit();
+    metrics::Registry::Get().CountTransaction();
+    if (lsn_router_ && batch_.HasFlushed()) {
+        // Позиция вставки не меньше конца записи о фиксации, даже если журнал ещё не сброшен на диск
+        try {
+            pqxx::nontransaction query{*connection_};
+            const pqxx::row row = query.exec1("SELECT pg_current_wal_insert_lsn()::text;"_zv);
+            if (const std::optional<std::uint64_t> lsn = ParseLsn(row[0].view())) {
+                lsn_router_->NoteCommitLsn(*lsn);
+            }
+        } catch (const std::exception& e) {
+            // Транзакция уже зафиксирована, откатывать нечего; но чтение сразу после неё
+            // может уйти на отстающую реплику и не увидеть изменений
+            std::cerr << "Failed to read commit LSN, read-your-writes is not guaranteed for this commit: "sv
+                      << e.what() << std::endl;
+        }
+    }
+}
+
+std::optional<std::uint64_t> UnitOfWorkImpl::QueryReplayLsn() {
+    const pqxx::result result = traced_work_.Exec(
+        "UnitOfWork::QueryReplayLsn"sv, R"(SELECT pg_last_wal_replay_lsn()::text;)"_zv
+    );
+    if (result.empty() || result[0][0].is_null()) {
+        return std::nullopt;
+    }
+    return ParseLsn(result[0][0].view());
+}
+
+std::unique_ptr<app::UnitOfWork> UnitOfWorkFactoryImpl::CreateReadOnlyUnitOfWork() {
+    const std::size_t replica_count = replica_pools_.size();
+    if (replica_count == 0 || app::PrimaryReadScope::IsActive()) {
+        return std::make_unique<UnitOfWorkImpl>(connection_pool_.GetConnection(), tracer_, nullptr, true);
+    }
+
+    std::array<std::size_t, ReplicaRouter::kMaxReplicas> in_use{};
+    for (std::size_t i = 0; i < replica_count; ++i) {
+        in_use[i] = replica_pools_[i]->GetUsedConnections();
+    }
+    const std::size_t first = router_.Pick({in_use.data(), replica_count});
+    const std::uint64_t required_lsn = read_your_writes_ ? router_.GetCommitLsn() : 0;
+    const auto is_fresh = [&](std::size_t replica) {
+        return router_.GetReplayedLsn(replica) >= required_lsn;
+    };
+
+    // Реплики, про которые по запомненной позиции уже известно, что они догнали основную базу
+    for (std::size_t i = 0; i < replica_count; ++i) {
+        const std::size_t replica = (first + i) % replica_count;
+        if (!is_fresh(replica)) {
+            continue;
+        }
+        if (auto connection = replica_pools_[replica]->TryGetConnection()) {
+            return std::make_unique<UnitOfWorkImpl>(std::move(*connection), tracer_, nullptr, true);
+        }
+    }
+
+    // Остальные спрашиваются о текущей позиции, если у них есть свободное соединение
+    for (std::size_t i = 0; i < replica_count; ++i) {
+        const std::size_t replica = (first + i) % replica_count;
+        if (is_fresh(replica)) {
+            continue;
+        }
+        auto connection = replica_pools_[replica]->TryGetConnection();
+        if (!connection) {
+            continue;
+        }
+        auto uow = std::make_unique<UnitOfWorkImpl>(std::move(*connection), tracer_, nullptr, true);
+        const std::optional<std::uint64_t> replayed = uow->QueryReplayLsn();
+        // Сервер не в режиме восстановления: это не реплика, отставать ему не от кого
+        router_.NoteReplayedLsn(replica, replayed.value_or(std::numeric_limits<std::uint64_t>::max()));
+        if (is_fresh(replica)) {
+            return uow;
+        }
+    }
+
+    // Все подходящие реплики заняты: ждать стоит первую из них, а не нагружать основную базу
+    for (std::size_t i = 0; i < replica_count; ++i) {
+        const std::size_t replica = (first + i) % replica_count;
+        if (is_fresh(replica)) {
+            return std::make_unique<UnitOfWorkImpl>(replica_pools_[replica]->GetConnection(), tracer_, nullptr, true);
+        }
+    }
+
+    // Все реплики отстают от последней фиксации процесса
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "UnitOfWork::ReplicaLagFallback"sv);
+    metrics::ScopedCall call{stats};
+    return std::make_unique<UnitOfWorkImpl>(connection_pool_.GetConnection(), tracer_, nullptr, true);
+}
+
+// // // --- UNIT_OF_WORK --- // // // --- UNIT_OF_WORK --- // // // --- UNIT_OF_WORK --- // // //
+//
+//
+//
+// // // --- SCHEMA --- // // // --- SCHEMA --- // // // --- SCHEMA --- // // //
+
+namespace {
+
+// Книги лежат в секциях по десятилетиям, начиная с kFirstPartitionYear; более ранние
+// собраны в одну секцию. Секции создаются на kPartitionDecadesAhead десятилетий вперёд
+// от текущего года, книги с более поздним годом попадают в секцию по умолчанию
+constexpr int kFirstPartitionYear = 1900;
+constexpr int kPartitionYears = 10;
+constexpr int kPartitionDecadesAhead = 2;
+
+// Ключ рекомендательной блокировки на время обновления схемы
+constexpr std::int64_t kSchemaLockKey = 0x626F6F6B79;
+
+bool IsUnpartitionedBooksTable(pqxx::work& work) {
+    const pqxx::result result = work.exec(R"(SELECT relkind FROM pg_class WHERE oid = to_regclass('books');)"_zv);
+    return !result.empty() && result[0][0].view() == "r"sv;
+}
+
+// Досоздаёт недостающие секции books. Секция десятилетия не создаётся, если в секции
+// по умолчанию уже есть книги этих лет: они остаются там и читаются вместе с ней
+void CreateBookPartitions(pqxx::work& work) {
+    std::unordered_set<std::string> existing;
+    for (const pqxx::row& row : work.exec(R"(
+        SELECT partition.relname
+        FROM pg_inherits
+        INNER JOIN pg_class AS partition ON partition.oid = pg_inherits.inhrelid
+        WHERE pg_inherits.inhparent = 'books'::regclass;
+    )"_zv)) {
+        existing.emplace(row[0].view());
+    }
+
+    const std::string first = std::to_string(kFirstPartitionYear);
+    if (!existing.contains("books_before_"s + first)) {
+        work.exec("CREATE TABLE books_before_" + first + " PARTITION OF books FOR VALUES FROM (MINVALUE) TO (" + first + ");");
+    }
+
+    const int current_year = work.exec1(R"(SELECT EXTRACT(YEAR FROM CURRENT_DATE)::integer;)"_zv)[0].as<int>();
+    const int last_decade = current_year / kPartitionYears * kPartitionYears + kPartitionDecadesAhead * kPartitionYears;
+    const bool has_default = existing.contains("books_default"s);
+    for (int decade = kFirstPartitionYear; decade <= last_decade; decade += kPartitionYears) {
+        const std::string from = std::to_string(decade);
+        const std::string to = std::to_string(decade + kPartitionYears);
+        if (existing.contains("books_"s + from + "s"s)) {
+            continue;
+        }
+        if (has_default) {
+            const pqxx::row overlap = work.exec1(
+                "SELECT EXISTS (SELECT 1 FROM books_default WHERE publication_year >= " + from
+                + " AND publication_year < " + to + ");"
+            );
+            if (overlap[0].as<bool>()) {
+                continue;
+            }
+        }
+        work.exec("CREATE TABLE books_" + from + "s PARTITION OF books FOR VALUES FROM (" + from + ") TO (" + to + ");");
+    }
+
+    if (!has_default) {
+        work.exec(R"(CREATE TABLE books_default PARTITION OF books DEFAULT;)"_zv);
+    }
+}
+
+// Сводные таблицы статистики и триггеры, которые обновляют их в транзакции,
+// меняющей книги, теги или авторов. Триггеры уровня оператора получают все изменённые
+// строки разом (transition tables): пакет из WriteBatch стоит одного обновления счётчиков
+// на оператор, а не на строку. Счётчики обновляются в порядке ключей, поэтому параллельные
+// транзакции блокируют их строки в одном порядке.
+//
+// Книги и теги автора, помеченного удалённым, не учитываются: пометка вычитает их из счётчиков,
+// а триггеры книг и тегов пропускают строки таких авторов, так что очистка не вычтет их второй раз.
+//
+// Возвращает true, если таблицы созданы впервые или правила подсчёта сменились и счётчики
+// нужно заполнить заново
+bool InstallStatistics(pqxx::work& work) {
+    // Версия правил подсчёта хранится комментарием к author_book_counts
+    static constexpr std::string_view kVersion = "2"sv;
+    const pqxx::row installed = work.exec1(
+        R"(SELECT obj_description(to_regclass('author_book_counts'), 'pg_class');)"_zv
+    );
+    const bool outdated = installed[0].is_null() || installed[0].view() != kVersion;
+
+    // Число авторов разложено по нескольким строкам (slot): иначе все вставки авторов
+    // ждали бы друг друга на одной строке до конца транзакции
+    work.exec(R"(
+        CREATE TABLE IF NOT EXISTS author_book_counts (
+            author_id UUID PRIMARY KEY,
+            books bigint NOT NULL
+        );
+        CREATE INDEX IF NOT EXISTS author_book_counts_top_idx ON author_book_counts (books DESC, author_id);
+        CREATE TABLE IF NOT EXISTS tag_book_counts (
+            tag varchar(30) PRIMARY KEY,
+            books bigint NOT NULL
+        );
+        CREATE INDEX IF NOT EXISTS tag_book_counts_top_idx ON tag_book_counts (books DESC, tag);
+        CREATE INDEX IF NOT EXISTS tag_book_counts_tag_pattern_idx ON tag_book_counts (tag text_pattern_ops);
+        CREATE TABLE IF NOT EXISTS year_book_counts (
+            publication_year integer PRIMARY KEY,
+            books bigint NOT NULL
+        );
+        CREATE TABLE IF NOT EXISTS author_counts (
+            slot smallint PRIMARY KEY,
+            authors bigint NOT NULL
+        );
+    )"_zv);
+
+    work.exec(R"(
+        CREATE OR REPLACE FUNCTION add_book_counts(author_ids uuid[], years integer[], direction bigint)
+        RETURNS void LANGUAGE sql AS $$
+            INSERT INTO author_book_counts AS c (author_id, books)
+            SELECT author_id, direction * count(*) FROM unnest(author_ids) AS author_id
+            GROUP BY author_id ORDER BY author_id
+            ON CONFLICT (author_id) DO UPDATE SET books = c.books + EXCLUDED.books;
+            DELETE FROM author_book_counts WHERE books = 0 AND author_id = ANY (author_ids);
+            INSERT INTO year_book_counts AS c (publication_year, books)
+            SELECT publication_year, direction * count(*) FROM unnest(years) AS publication_year
+            GROUP BY publication_year ORDER BY publication_year
+            ON CONFLICT (publication_year) DO UPDATE SET books = c.books + EXCLUDED.books;
+            DELETE FROM year_book_counts WHERE books = 0 AND publication_year = ANY (years);
+        $$;
+
+        CREATE OR REPLACE FUNCTION add_tag_counts(tags text[], direction bigint)
+        RETURNS void LANGUAGE sql AS $$
+            INSERT INTO tag_book_counts AS c (tag, books)
+            SELECT tag, direction * count(*) FROM unnest(tags) AS tag
+            GROUP BY tag ORDER BY tag
+            ON CONFLICT (tag) DO UPDATE SET books = c.books + EXCLUDED.books;
+            DELETE FROM tag_book_counts WHERE books = 0 AND tag = ANY (tags);
+        $$;
+
+        CREATE OR REPLACE FUNCTION add_author_count(delta bigint)
+        RETURNS void LANGUAGE sql AS $$
+            INSERT INTO author_counts AS c (slot, authors)
+            SELECT pg_backend_pid() % 16, delta WHERE delta <> 0
+            ON CONFLICT (slot) DO UPDATE SET authors = c.authors + EXCLUDED.authors;
+        $$;
+    )"_zv);
+
+    // Правка книги меняет счётчики, только если сменились автор или год. Автор строки книги
+    // ещё существует: WriteBatch удаляет авторов после их книг, а книги после их тегов
+    work.exec(R"(
+        CREATE OR REPLACE FUNCTION books_counts_insert() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_book_counts(array_agg(n.author_id), array_agg(n.publication_year), 1)
+            FROM new_rows AS n
+            INNER JOIN authors AS a ON a.id = n.author_id AND a.deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION books_counts_update() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_book_counts(array_agg(o.author_id), array_agg(o.publication_year), -1)
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id
+            INNER JOIN authors AS a ON a.id = o.author_id AND a.deleted_at IS NULL
+            WHERE o.author_id <> n.author_id OR o.publication_year <> n.publication_year;
+            PERFORM add_book_counts(array_agg(n.author_id), array_agg(n.publication_year), 1)
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id
+            INNER JOIN authors AS a ON a.id = n.author_id AND a.deleted_at IS NULL
+            WHERE o.author_id <> n.author_id OR o.publication_year <> n.publication_year;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION books_counts_delete() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_book_counts(array_agg(o.author_id), array_agg(o.publication_year), -1)
+            FROM old_rows AS o
+            INNER JOIN authors AS a ON a.id = o.author_id AND a.deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION book_tags_counts_insert() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_tag_counts(array_agg(t.tag), 1)
+            FROM new_rows AS t
+            INNER JOIN books AS b ON b.id = t.book_id
+            INNER JOIN authors AS a ON a.id = b.author_id AND a.deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION book_tags_counts_update() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_tag_counts(array_agg(t.tag), -1)
+            FROM old_rows AS t
+            INNER JOIN books AS b ON b.id = t.book_id
+            INNER JOIN authors AS a ON a.id = b.author_id AND a.deleted_at IS NULL;
+            PERFORM add_tag_counts(array_agg(t.tag), 1)
+            FROM new_rows AS t
+            INNER JOIN books AS b ON b.id = t.book_id
+            INNER JOIN authors AS a ON a.id = b.author_id AND a.deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION book_tags_counts_delete() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_tag_counts(array_agg(t.tag), -1)
+            FROM old_rows AS t
+            INNER JOIN books AS b ON b.id = t.book_id
+            INNER JOIN authors AS a ON a.id = b.author_id AND a.deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION authors_counts_insert() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_author_count(count(*)) FROM new_rows WHERE deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+
+        -- Пометка об удалении вычитает книги и теги автора, снятие пометки возвращает их
+        CREATE OR REPLACE FUNCTION authors_counts_update() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_author_count(
+                count(*) FILTER (WHERE o.deleted_at IS NOT NULL AND n.deleted_at IS NULL)
+                - count(*) FILTER (WHERE o.deleted_at IS NULL AND n.deleted_at IS NOT NULL))
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id;
+            -- Пометка об удалении вычитает книги и теги автора, снятие пометки возвращает их
+            PERFORM add_book_counts(array_agg(b.author_id), array_agg(b.publication_year), -1)
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id AND o.deleted_at IS NULL AND n.deleted_at IS NOT NULL
+            INNER JOIN books AS b ON b.author_id = n.id;
+            PERFORM add_tag_counts(array_agg(t.tag), -1)
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id AND o.deleted_at IS NULL AND n.deleted_at IS NOT NULL
+            INNER JOIN books AS b ON b.author_id = n.id
+            INNER JOIN book_tags AS t ON t.book_id = b.id;
+            PERFORM add_book_counts(array_agg(b.author_id), array_agg(b.publication_year), 1)
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id AND o.deleted_at IS NOT NULL AND n.deleted_at IS NULL
+            INNER JOIN books AS b ON b.author_id = n.id;
+            PERFORM add_tag_counts(array_agg(t.tag), 1)
+            FROM old_rows AS o
+            INNER JOIN new_rows AS n ON n.id = o.id AND o.deleted_at IS NOT NULL AND n.deleted_at IS NULL
+            INNER JOIN books AS b ON b.author_id = n.id
+            INNER JOIN book_tags AS t ON t.book_id = b.id;
+            RETURN NULL;
+        END $$;
+
+        CREATE OR REPLACE FUNCTION authors_counts_delete() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+            PERFORM add_author_count(-count(*)) FROM old_rows WHERE deleted_at IS NULL;
+            RETURN NULL;
+        END $$;
+    )"_zv);
+
+    // Transition tables разрешены только у триггеров на одно событие
+    work.exec(R"(
+        CREATE OR REPLACE TRIGGER books_counts_insert AFTER INSERT ON books
+            REFERENCING NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION books_counts_insert();
+        CREATE OR REPLACE TRIGGER books_counts_update AFTER UPDATE ON books
+            REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION books_counts_update();
+        CREATE OR REPLACE TRIGGER books_counts_delete AFTER DELETE ON books
+            REFERENCING OLD TABLE AS old_rows FOR EACH STATEMENT EXECUTE FUNCTION books_counts_delete();
+        CREATE OR REPLACE TRIGGER book_tags_counts_insert AFTER INSERT ON book_tags
+            REFERENCING NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION book_tags_counts_insert();
+        CREATE OR REPLACE TRIGGER book_tags_counts_update AFTER UPDATE ON book_tags
+            REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION book_tags_counts_update();
+        CREATE OR REPLACE TRIGGER book_tags_counts_delete AFTER DELETE ON book_tags
+            REFERENCING OLD TABLE AS old_rows FOR EACH STATEMENT EXECUTE FUNCTION book_tags_counts_delete();
+        CREATE OR REPLACE TRIGGER authors_counts_insert AFTER INSERT ON authors
+            REFERENCING NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION authors_counts_insert();
+        CREATE OR REPLACE TRIGGER authors_counts_update AFTER UPDATE ON authors
+            REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows FOR EACH STATEMENT EXECUTE FUNCTION authors_counts_update();
+        CREATE OR REPLACE TRIGGER authors_counts_delete AFTER DELETE ON authors
+            REFERENCING OLD TABLE AS old_rows FOR EACH STATEMENT EXECUTE FUNCTION authors_counts_delete();
+    )"_zv);
+    work.exec("COMMENT ON TABLE author_book_counts IS '"s + std::string{kVersion} + "';"s);
+    return outdated;
+}
+
+}  // namespace
+
+Database::Database(const std::string& db_url, size_t pool_size, QueryTracingConfig tracing_config,
+                   ReplicaConfig replicas)
+    : connection_pool_{pool_size, [&db_url] { return std::make_shared<pqxx::connection>(db_url); }}
+    , router_{replicas.urls.size(), replicas.routing}
+    , tracer_{tracing_config, std::clog}
+    , uow_factory_{connection_pool_, tracer_, replica_pools_, router_,
+                   replicas.read_your_writes && !replicas.urls.empty()} {
+    replica_pools_.reserve(replicas.urls.size());
+    for (const std::string& url : replicas.urls) {
+        replica_pools_.push_back(std::make_unique<ConnectionPool>(pool_size, [&url] {
+            return std::make_shared<pqxx::connection>(url);
+        }));
+    }
+
+    ConnectionPool::ConnectionWrapper connection = connection_pool_.GetConnection();
+    pqxx::work work{*connection};
+
+    // Процессы, стартующие одновременно, обновляют схему по очереди
+    work.exec("SELECT pg_advisory_xact_lock(" + std::to_string(kSchemaLockKey) + ");");
 
-Database::Database(pqxx::connection connection)
-    : connection_{std::move(connection)} {
-    pqxx::work work{connection_};
-    
     // Создаем таблицу авторов
     work.exec(R"(
         CREATE TABLE IF NOT EXISTS authors (
             id UUID CONSTRAINT author_id_constraint PRIMARY KEY,
-            name varchar(100) UNIQUE NOT NULL
+            name varchar(100) NOT NULL,
+            deleted_at timestamptz
         );
     )"_zv);
 
-    // Создаем таблицу кнги
+    // Удалённый автор хранится до конца очистки, но его имя сразу можно занять снова.
+    // Удалённых немного: частичный индекс по ним мал и служит очереди очистки
+    work.exec(R"(
+        ALTER TABLE authors ADD COLUMN IF NOT EXISTS deleted_at timestamptz;
+        ALTER TABLE authors DROP CONSTRAINT IF EXISTS authors_name_key;
+        CREATE UNIQUE INDEX IF NOT EXISTS authors_name_idx ON authors (name) WHERE deleted_at IS NULL;
+        CREATE INDEX IF NOT EXISTS authors_deleted_at_idx ON authors (deleted_at) WHERE deleted_at IS NOT NULL;
+        CREATE INDEX IF NOT EXISTS authors_name_pattern_idx ON authors (name text_pattern_ops);
+    )"_zv);
+
+    // Таблица книг прежних версий не секционирована: её строки переносятся в новую в этой же транзакции.
+    // Уникальность в секционированной таблице проверяется только вместе с ключом секционирования,
+    // поэтому ссылку из book_tags на books(id) держать нечем: теги удаляются вместе с книгой в use case'ах,
+    // WriteBatch не даёт id книги оказаться в двух секциях, а нарушения находит bookypedia-stats
+    const bool migrate_books = IsUnpartitionedBooksTable(work);
+    if (migrate_books) {
+        work.exec(R"(
+            ALTER TABLE IF EXISTS book_tags DROP CONSTRAINT IF EXISTS book_tags_book_id_fkey;
+            ALTER TABLE books RENAME TO books_unpartitioned;
+            ALTER TABLE books_unpartitioned RENAME CONSTRAINT book_id_constraint TO books_unpartitioned_pkey;
+        )"_zv);
+    }
+
+    // Создаем таблицу книг, секционированную по году издания
     work.exec(R"(
         CREATE TABLE IF NOT EXISTS books (
-            id UUID CONSTRAINT book_id_constraint PRIMARY KEY,
+            id UUID NOT NULL,
             author_id UUID NOT NULL REFERENCES authors(id),
             title varchar(100) NOT NULL,
-            publication_year integer NOT NULL
-        );
+            publication_year integer NOT NULL,
+            CONSTRAINT book_id_constraint PRIMARY KEY (id, publication_year)
+        ) PARTITION BY RANGE (publication_year);
     )"_zv);
+    CreateBookPartitions(work);
+
+    if (migrate_books) {
+        work.exec(R"(
+            INSERT INTO books (id, author_id, title, publication_year)
+            SELECT id, author_id, title, publication_year FROM books_unpartitioned;
+            DROP TABLE books_unpartitioned;
+        )"_zv);
+    }
+
+    // Индексы создаются на каждой секции, в том числе на будущих.
+    // По автору книги выбирает фоновая очистка удалённых авторов, по началу названия — выбор книги.
+    // Списки упорядочены побайтово (~<~), чтобы k-way merge шардов сравнивал строки так же, как база
+    work.exec(R"(
+        DROP INDEX IF EXISTS books_year_title_idx;
+        CREATE INDEX IF NOT EXISTS books_year_title_pattern_idx ON books (publication_year, title text_pattern_ops);
+        CREATE INDEX IF NOT EXISTS books_title_pattern_idx ON books (title text_pattern_ops);
+        CREATE INDEX IF NOT EXISTS books_author_id_idx ON books (author_id);
+    )"_zv);
+    if (migrate_books) {
+        work.exec(R"(ANALYZE books;)"_zv);
+    }
 
     // Создаем таблицу книжных тегов
     work.exec(R"(
         CREATE TABLE IF NOT EXISTS book_tags (
-            book_id UUID REFERENCES books (id),
+            book_id UUID,
             tag varchar(30) NOT NULL
         );
     )"_zv);
+    // Очистка удаляет теги пакетами по id книг
+    work.exec(R"(
+        CREATE INDEX IF NOT EXISTS book_tags_book_id_idx ON book_tags (book_id);
+    )"_zv);
+
+    // Счётчики прежних данных заполняются один раз и после смены правил подсчёта; книги,
+    // перенесённые в секционированную таблицу, вставлялись до появления на ней триггеров
+    if (InstallStatistics(work) || migrate_books) {
+        work.exec(pqxx::zview{kRebuildStatistics});
+    }
 
     // коммитим изменения
     work.commit();
 }
 
+// // // --- SCHEMA --- // // // --- SCHEMA --- // // // --- SCHEMA --- // // //
+
 }  // namespace postgres
\ No newline at end of file
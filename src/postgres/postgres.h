@@ -1,13 +1,26 @@
 #pragma once
 
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <pqxx/pqxx>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "../domain/author.h"
 #include "../domain/book.h"
 #include "../domain/book_tag.h"
+#include "../domain/statistics.h"
 
 #include "../app/unit_of_work.h"
+#include "../metrics/metrics.h"
+#include "query_tracer.h"
+#include "replica_router.h"
+#include "write_batch.h"
 
 namespace postgres {
 
@@ -15,79 +28,212 @@ using namespace domain;
 
 class AuthorRepositoryImpl : public AuthorRepository {
 public:
-    explicit AuthorRepositoryImpl(pqxx::work& work)
-    : work_{work}
+    AuthorRepositoryImpl(TracedWork& work, WriteBatch& batch)
+    : work_{work}, batch_{batch}
     {
 
     }
 
     void Save(const Author& author) override;
-    void Edit(const AuthorId& id, const std::string& new_name) override;
+    void Edit(const AuthorId& id, std::string_view new_name) override;
     void Delete(const AuthorId& id) override;
+    void MarkDeleted(const AuthorId& id) override;
 
-    std::vector<Author> GetAllAuthors() const override;
-    std::optional<Author> GetAuthorByName(const std::string& name) const override;
+    AuthorRows GetAllAuthors() const override;
+    AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override;
+    std::optional<Author> GetAuthorByName(std::string_view name) const override;
     std::optional<Author> GetAuthorById(const AuthorId& id) const override;
+    std::vector<AuthorId> GetDeletedAuthorIds() const override;
 
 private:
-    pqxx::work& work_;
+    TracedWork& work_;
+    // Запись откладывается до Commit, чтение сначала отправляет отложенные изменения
+    WriteBatch& batch_;
 
     Author GetAuthorFromRow(const pqxx::row& row) const;
 };
 
 class BookRepositoryImpl : public domain::BookRepository {
 public:
-    explicit BookRepositoryImpl(pqxx::work& work)
-    : work_{work}
+    BookRepositoryImpl(TracedWork& work, WriteBatch& batch)
+    : work_{work}, batch_{batch}
     {
         
     }
 
     void Save(const Book& book) override;
-    void Edit(const BookId& id, const std::string& title, int publication_year) override;
+    void Edit(const BookId& id, std::string_view title, int publication_year) override;
     void Delete(const BookId& id) override;
 
     std::optional<Book> GetBookById(const BookId& id) override;
-    std::vector<Book> GetBooksByTitle(const std::string& title) override;
-    std::vector<Book> GetAllBooks() override;
-    std::vector<Book> GetBooksByAuthorId(const AuthorId& author_id) const override;
+    std::optional<Book> GetBookByIdForUpdate(const BookId& id) override;
+    std::vector<Book> GetBooksByTitle(std::string_view title) override;
+    BookRows GetAllBooks() override;
+    BookRows GetBooksByAuthorId(const AuthorId& author_id) const override;
+    BookRows GetBooksByYearRange(int from, int to) const override;
+    BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override;
+    std::vector<BookId> GetBookIdsByAuthorId(const AuthorId& author_id, std::size_t limit) const override;
 
     void DeleteBooksByAuthorId(const AuthorId& author_id) override;
 
 private:
-    pqxx::work& work_;
+    TracedWork& work_;
+    // Запись откладывается до Commit, чтение сначала отправляет отложенные изменения
+    WriteBatch& batch_;
 
-    Book GetBookFromRow(const pqxx::row& row, bool with_author_name) const;
+    Book GetBookFromRow(const pqxx::row& row) const;
 };
 
 class BookTagRepositoryImpl : public BookTagRepository {
 public:
-    explicit BookTagRepositoryImpl(pqxx::work &work) 
-    : work_{work}
+    BookTagRepositoryImpl(TracedWork& work, WriteBatch& batch)
+    : work_{work}, batch_{batch}
     {
 
     }
     
-    void Save(const BookTag& book_tag) override;
+    void Save(const BookId& book_id, std::string_view tag) override;
     void DeleteByBookId(const BookId& book_id) override;
 
-    std::vector<BookTag> GetBookTags(const BookId& book_id) const override;
+    std::vector<std::string> GetTags(const BookId& book_id) const override;
+    std::vector<TagBookCount> GetTagCountsByAuthorId(const AuthorId& author_id) const override;
 
 private:
-    pqxx::work& work_;
+    TracedWork& work_;
+    // Запись откладывается до Commit, чтение сначала отправляет отложенные изменения
+    WriteBatch& batch_;
+};
+
+class ConnectionPool {
+    using PoolType = ConnectionPool;
+    using ConnectionPtr = std::shared_ptr<pqxx::connection>;
+
+public:
+    class ConnectionWrapper {
+    public:
+        ConnectionWrapper(std::shared_ptr<pqxx::connection>&& conn, PoolType& pool) noexcept
+        : conn_{std::move(conn)}, pool_{&pool}
+        {
+
+        }
+
+        ConnectionWrapper(const ConnectionWrapper&) = delete;
+        ConnectionWrapper& operator=(const ConnectionWrapper&) = delete;
+
+        ConnectionWrapper(ConnectionWrapper&&) = default;
+        ConnectionWrapper& operator=(ConnectionWrapper&&) = default;
+
+        pqxx::connection& operator*() const& noexcept {
+            return *conn_;
+        }
+        pqxx::connection& operator*() const&& = delete;
+
+        pqxx::connection* operator->() const& noexcept {
+            return conn_.get();
+        }
+
+        ~ConnectionWrapper() {
+            if (conn_) {
+                pool_->ReturnConnection(std::move(conn_));
+            }
+        }
+
+    private:
+        std::shared_ptr<pqxx::connection> conn_;
+        PoolType* pool_;
+    };
+
+    // ConnectionFactory is a functional object returning std::shared_ptr<pqxx::connection>
+    template <typename ConnectionFactory>
+    ConnectionPool(size_t capacity, ConnectionFactory&& connection_factory) {
+        pool_.reserve(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            pool_.emplace_back(connection_factory());
+        }
+    }
+
+    // Блокирует поток, пока в пуле не появится свободное соединение
+    ConnectionWrapper GetConnection() {
+        std::unique_lock lock{mutex_};
+        cond_var_.wait(lock, [this] {
+            return used_connections_ < pool_.size();
+        });
+        return {std::move(pool_[used_connections_++]), *this};
+    }
+
+    // Свободное соединение или std::nullopt, если все заняты; не ждёт
+    std::optional<ConnectionWrapper> TryGetConnection() {
+        std::lock_guard lock{mutex_};
+        if (used_connections_ == pool_.size()) {
+            return std::nullopt;
+        }
+        return std::optional<ConnectionWrapper>{std::in_place, std::move(pool_[used_connections_++]), *this};
+    }
+
+    size_t GetCapacity() const noexcept {
+        return pool_.size();
+    }
+
+    size_t GetUsedConnections() {
+        std::lock_guard lock{mutex_};
+        return used_connections_;
+    }
+
+private:
+    void ReturnConnection(ConnectionPtr&& conn) {
+        {
+            std::lock_guard lock{mutex_};
+            assert(used_connections_ != 0);
+            pool_[--used_connections_] = std::move(conn);
+        }
+        cond_var_.notify_one();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_var_;
+    std::vector<ConnectionPtr> pool_;
+    size_t used_connections_ = 0;
+};
+
+class StatisticsRepositoryImpl : public StatisticsRepository {
+public:
+    StatisticsRepositoryImpl(TracedWork& work, WriteBatch& batch)
+    : work_{work}, batch_{batch}
+    {
+
+    }
+
+    CatalogTotals GetTotals() const override;
+    std::vector<AuthorBookCount> GetTopAuthors(std::size_t limit) const override;
+    std::vector<TagBookCount> GetTopTags(std::size_t limit) const override;
+    std::vector<TagBookCount> GetTopTagsByPrefix(std::string_view prefix, std::size_t limit) const override;
+    std::vector<YearBookCount> GetBooksPerYear() const override;
+
+    StatisticsDrift Verify() const override;
+    void Rebuild() override;
+
+private:
+    TracedWork& work_;
+    // Счётчики обновляют триггеры при отправке изменений, поэтому чтение сначала отправляет их
+    WriteBatch& batch_;
 };
 
 class UnitOfWorkImpl : public app::UnitOfWork {
 public:
-    explicit UnitOfWorkImpl(pqxx::connection& connection) 
-    : work_(connection)
+    // Если задан lsn_router, после фиксации транзакции с изменениями в нём запоминается
+    // позиция журнала основной базы. read_only запрещает фиксировать изменения
+    UnitOfWorkImpl(ConnectionPool::ConnectionWrapper connection, QueryTracer& tracer,
+                   ReplicaRouter* lsn_router = nullptr, bool read_only = false)
+    : connection_{std::move(connection)}, work_{*connection_}, traced_work_{work_, tracer}
+    , lsn_router_{lsn_router}, read_only_{read_only}
     {
 
     }
     
-    void Commit() override {
-        work_.commit();
-    }
+    void Commit() override;
+
+    // Позиция журнала, применённая сервером-репликой; nullopt, если сервер не реплика
+    std::optional<std::uint64_t> QueryReplayLsn();
 
     domain::AuthorRepository& GetAuthorRepository() override {
         return authors_;
@@ -101,40 +247,78 @@ public:
         return book_tags_;
     }
 
+    domain::StatisticsRepository& GetStatisticsRepository() override {
+        return statistics_;
+    }
+
 private:
+    // Соединение возвращается в пул только после завершения транзакции
+    ConnectionPool::ConnectionWrapper connection_;
     pqxx::work work_;
-    AuthorRepositoryImpl authors_{work_};
-    BookRepositoryImpl books_{work_};
-    BookTagRepositoryImpl book_tags_{work_};
+    TracedWork traced_work_;
+    // Изменения, не отправленные на сервер; без Commit они отбрасываются вместе с транзакцией
+    WriteBatch batch_;
+    ReplicaRouter* lsn_router_;
+    bool read_only_;
+    AuthorRepositoryImpl authors_{traced_work_, batch_};
+    BookRepositoryImpl books_{traced_work_, batch_};
+    BookTagRepositoryImpl book_tags_{traced_work_, batch_};
+    StatisticsRepositoryImpl statistics_{traced_work_, batch_};
 };
 
+using ReplicaPools = std::vector<std::unique_ptr<ConnectionPool>>;
+
+/**
+ * Записывающие единицы работы открываются в основной базе, единицы работы только
+ * для чтения — на репликах (см. ReplicaRouter). С read_your_writes реплика, ещё не
+ * применившая последнюю фиксацию процесса, пропускается; если отстают все,
+ * чтение выполняется в основной базе. Там же выполняется чтение внутри app::PrimaryReadScope.
+ * Соединение реплики сначала берётся без ожидания: ждать имеет смысл только ту реплику,
+ * про которую уже известно, что она догнала основную базу.
+ */
 class UnitOfWorkFactoryImpl : public app::UnitOfWorkFactory {
 public:
-    explicit UnitOfWorkFactoryImpl(pqxx::connection &connection)
-    : connection_(connection)
+    UnitOfWorkFactoryImpl(ConnectionPool& connection_pool, QueryTracer& tracer,
+                          const ReplicaPools& replica_pools, ReplicaRouter& router, bool read_your_writes)
+    : connection_pool_(connection_pool), tracer_{tracer}
+    , replica_pools_{replica_pools}, router_{router}
+    , read_your_writes_{read_your_writes}
     {
 
     }
     
     std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
-        return std::make_unique<UnitOfWorkImpl>(connection_);
+        return std::make_unique<UnitOfWorkImpl>(connection_pool_.GetConnection(), tracer_,
+                                                read_your_writes_ ? &router_ : nullptr);
     }
 
+    std::unique_ptr<app::UnitOfWork> CreateReadOnlyUnitOfWork() override;
+
 private:
-    pqxx::connection &connection_;
+    ConnectionPool& connection_pool_;
+    QueryTracer& tracer_;
+    const ReplicaPools& replica_pools_;
+    ReplicaRouter& router_;
+    bool read_your_writes_;
 };
 
 class Database {
 public:
-    explicit Database(pqxx::connection connection);
+    // pool_size соединений открываются сразу в основной базе и в каждой реплике;
+    // каждая транзакция занимает одно из них. Схема создаётся только в основной базе
+    explicit Database(const std::string& db_url, size_t pool_size = 1, QueryTracingConfig tracing_config = {},
+                      ReplicaConfig replicas = {});
 
     UnitOfWorkFactoryImpl& GetUnitOfWorkFactoryFactory() {
         return uow_factory_;
     }
 
 private:
-    pqxx::connection connection_;
-    UnitOfWorkFactoryImpl uow_factory_{connection_};
+    ConnectionPool connection_pool_;
+    ReplicaPools replica_pools_;
+    ReplicaRouter router_;
+    QueryTracer tracer_;
+    UnitOfWorkFactoryImpl uow_factory_;
 };
 
 }  // namespace postgres
\ No newline at end of file
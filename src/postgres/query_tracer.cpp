@@ -0,0 +1,67 @@
+#include "query_tracer.h"
+
+#include <algorithm>
+#include <ostream>
+#include <thread>
+
+#include "../metrics/metrics.h"
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr double kTwoPow64 = 18446744073709551616.0;
+
+std::uint64_t NextRandom() noexcept {
+    // xorshift64*, состояние своё у каждого потока
+    thread_local std::uint64_t state =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+}  // namespace
+
+QueryTracer::QueryTracer(QueryTracingConfig config, std::ostream& log)
+    : config_{config}
+    , sample_threshold_{
+        config.sample_rate >= 1.0 ? UINT64_MAX
+        : config.sample_rate <= 0.0 ? 0
+        : static_cast<std::uint64_t>(config.sample_rate * kTwoPow64)
+    }
+    , log_{log} {
+}
+
+bool QueryTracer::ShouldSample() const noexcept {
+    if (sample_threshold_ == UINT64_MAX) {
+        return true;
+    }
+    if (sample_threshold_ == 0) {
+        return false;
+    }
+    return NextRandom() < sample_threshold_;
+}
+
+void QueryTracer::Record(const QueryTrace& trace) {
+    const bool is_slow = trace.duration >= config_.slow_threshold;
+    if (!is_slow && !config_.log_all && !trace.failed) {
+        return;
+    }
+    const std::string_view use_case = trace.use_case.empty() ? metrics::CurrentUseCase() : trace.use_case;
+
+    std::lock_guard lock{log_mutex_};
+    log_ << (is_slow ? "slow_query"sv : "query"sv)
+         << " statement="sv << trace.statement
+         << " params="sv << trace.param_count
+         << " rows="sv << trace.rows
+         << " duration_us="sv << std::chrono::duration_cast<std::chrono::microseconds>(trace.duration).count()
+         << " use_case="sv << (use_case.empty() ? "-"sv : use_case)
+         << " status="sv << (trace.failed ? "error"sv : "ok"sv)
+         << '\n';
+}
+
+}  // namespace postgres
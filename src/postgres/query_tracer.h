@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace postgres {
+
+struct QueryTracingConfig {
+    // Запросы дольше порога попадают в журнал медленных запросов
+    std::chrono::microseconds slow_threshold{std::chrono::milliseconds{200}};
+    // Доля запросов (0..1), для которых выполняется трассировка
+    double sample_rate = 1.0;
+    // Писать в журнал каждый трассируемый запрос, а не только медленные
+    bool log_all = false;
+};
+
+struct QueryTrace {
+    std::string_view statement{};
+    std::size_t param_count = 0;
+    std::chrono::nanoseconds duration{0};
+    std::uint64_t rows = 0;
+    std::string_view use_case{};
+    bool failed = false;
+};
+
+/**
+ * Принимает решение о трассировке запроса и пишет структурированные строки журнала
+ * в формате key=value. Потокобезопасен: один экземпляр обслуживает все соединения.
+ */
+class QueryTracer {
+public:
+    explicit QueryTracer(QueryTracingConfig config, std::ostream& log);
+
+    QueryTracer(const QueryTracer&) = delete;
+    QueryTracer& operator=(const QueryTracer&) = delete;
+
+    bool ShouldSample() const noexcept;
+    void Record(const QueryTrace& trace);
+
+    const QueryTracingConfig& GetConfig() const noexcept {
+        return config_;
+    }
+
+private:
+    QueryTracingConfig config_;
+    std::uint64_t sample_threshold_;
+    std::ostream& log_;
+    std::mutex log_mutex_;
+};
+
+/**
+ * Обёртка над pqxx::work, через которую репозитории выполняют SQL.
+ * Для сэмплированных запросов замеряет длительность и число строк и передаёт их в QueryTracer.
+ */
+class TracedWork {
+public:
+    TracedWork(pqxx::work& work, QueryTracer& tracer)
+    : work_{work}, tracer_{tracer}
+    {
+
+    }
+
+    template <typename... Args>
+    pqxx::result ExecParams(std::string_view statement, pqxx::zview query, Args&&... args) {
+        return Trace(statement, sizeof...(Args), [&] {
+            return work_.exec_params(query, std::forward<Args>(args)...);
+        });
+    }
+
+    // Как pqxx::work::exec_params1: бросает pqxx::unexpected_rows, если строк не ровно одна
+    template <typename... Args>
+    pqxx::row ExecParams1(std::string_view statement, pqxx::zview query, Args&&... args) {
+        pqxx::result result = ExecParams(statement, query, std::forward<Args>(args)...);
+        if (result.size() != 1) {
+            throw pqxx::unexpected_rows("Expected 1 row from " + std::string{statement});
+        }
+        return result[0];
+    }
+
+    pqxx::result Exec(std::string_view statement, pqxx::zview query) {
+        return Trace(statement, 0, [&] {
+            return work_.exec(query);
+        });
+    }
+
+    pqxx::work& GetWork() noexcept {
+        return work_;
+    }
+
+private:
+    template <typename Fn>
+    pqxx::result Trace(std::string_view statement, std::size_t param_count, Fn&& fn) {
+        if (!tracer_.ShouldSample()) {
+            return fn();
+        }
+        QueryTrace trace{.statement = statement, .param_count = param_count};
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            pqxx::result result = fn();
+            trace.duration = std::chrono::steady_clock::now() - start;
+            trace.rows = static_cast<std::uint64_t>(result.affected_rows());
+            tracer_.Record(trace);
+            return result;
+        } catch (...) {
+            trace.duration = std::chrono::steady_clock::now() - start;
+            trace.failed = true;
+            tracer_.Record(trace);
+            throw;
+        }
+    }
+
+    pqxx::work& work_;
+    QueryTracer& tracer_;
+};
+
+}  // namespace postgres
@@ -0,0 +1,119 @@
+#include "replica_router.h"
+
+#include <algorithm>
+#include <boost/algorithm/string/trim.hpp>
+#include <charconv>
+#include <iterator>
+#include <stdexcept>
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+std::optional<std::uint32_t> ParseHex(std::string_view text) noexcept {
+    std::uint32_t value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    if (text.empty() || ec != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+}  // namespace
+
+std::optional<std::uint64_t> ParseLsn(std::string_view text) noexcept {
+    const std::size_t slash = text.find('/');
+    if (slash == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const std::optional<std::uint32_t> high = ParseHex(text.substr(0, slash));
+    const std::optional<std::uint32_t> low = ParseHex(text.substr(slash + 1));
+    if (!high || !low) {
+        return std::nullopt;
+    }
+    return (std::uint64_t{*high} << 32) | *low;
+}
+
+std::string FormatLsn(std::uint64_t lsn) {
+    char buffer[20];
+    char* end = std::to_chars(std::begin(buffer), std::end(buffer), static_cast<std::uint32_t>(lsn >> 32), 16).ptr;
+    *end++ = '/';
+    end = std::to_chars(end, std::end(buffer), static_cast<std::uint32_t>(lsn), 16).ptr;
+    std::string result{buffer, end};
+    for (char& c : result) {
+        if (c >= 'a' && c <= 'f') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> ParseUrlList(std::string_view text) {
+    std::vector<std::string> urls;
+    while (!text.empty()) {
+        const std::size_t separator = std::min(text.find(';'), text.size());
+        std::string url = boost::algorithm::trim_copy(std::string{text.substr(0, separator)});
+        if (!url.empty()) {
+            urls.push_back(std::move(url));
+        }
+        text.remove_prefix(std::min(separator + 1, text.size()));
+    }
+    return urls;
+}
+
+ReplicaRouting ParseReplicaRouting(std::string_view text) {
+    if (text == "round-robin"sv) {
+        return ReplicaRouting::kRoundRobin;
+    }
+    if (text == "least-loaded"sv) {
+        return ReplicaRouting::kLeastLoaded;
+    }
+    throw std::invalid_argument("Unknown replica routing: "s + std::string{text});
+}
+
+ReplicaRouter::ReplicaRouter(std::size_t replica_count, ReplicaRouting routing)
+    : replica_count_{replica_count}
+    , routing_{routing}
+    , replayed_lsn_{std::make_unique<std::atomic<std::uint64_t>[]>(replica_count)} {
+    if (replica_count > kMaxReplicas) {
+        throw std::invalid_argument("Too many replicas: "s + std::to_string(replica_count));
+    }
+}
+
+std::size_t ReplicaRouter::Pick(std::span<const std::size_t> in_use) noexcept {
+    if (replica_count_ == 0) {
+        return 0;
+    }
+    const std::size_t start = next_.fetch_add(1, std::memory_order_relaxed) % replica_count_;
+    if (routing_ == ReplicaRouting::kRoundRobin || in_use.size() != replica_count_) {
+        return start;
+    }
+    // Обход начинается с очередной реплики, поэтому равная загрузка распределяется по кругу
+    std::size_t best = start;
+    for (std::size_t i = 1; i < replica_count_; ++i) {
+        const std::size_t candidate = (start + i) % replica_count_;
+        if (in_use[candidate] < in_use[best]) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+void ReplicaRouter::NoteCommitLsn(std::uint64_t lsn) noexcept {
+    StoreMax(commit_lsn_, lsn);
+}
+
+void ReplicaRouter::NoteReplayedLsn(std::size_t replica, std::uint64_t lsn) noexcept {
+    StoreMax(replayed_lsn_[replica], lsn);
+}
+
+void ReplicaRouter::StoreMax(std::atomic<std::uint64_t>& target, std::uint64_t value) noexcept {
+    std::uint64_t current = target.load(std::memory_order_relaxed);
+    while (current < value
+           && !target.compare_exchange_weak(current, value, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace postgres
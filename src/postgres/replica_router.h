@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace postgres {
+
+enum class ReplicaRouting {
+    // Реплики по очереди
+    kRoundRobin,
+    // Реплика с наименьшим числом занятых соединений, при равенстве — по очереди
+    kLeastLoaded
+};
+
+struct ReplicaConfig {
+    // Строки подключения к репликам; пустой список — все запросы идут в основную базу
+    std::vector<std::string> urls;
+    ReplicaRouting routing = ReplicaRouting::kRoundRobin;
+    // Чтение после записи видит записанное: реплика, не применившая последнюю
+    // зафиксированную этим процессом транзакцию, не используется
+    bool read_your_writes = true;
+};
+
+// Позиция в журнале предзаписи в текстовом виде pg_lsn: "16/B374D848"
+std::optional<std::uint64_t> ParseLsn(std::string_view text) noexcept;
+std::string FormatLsn(std::uint64_t lsn);
+
+// Список строк подключения, разделённых ';' (в URL может встретиться ',', в key=value — пробел)
+std::vector<std::string> ParseUrlList(std::string_view text);
+// "round-robin" или "least-loaded"; для остальных значений бросает std::invalid_argument
+ReplicaRouting ParseReplicaRouting(std::string_view text);
+
+/**
+ * Выбор реплики для единицы работы только для чтения и учёт позиций журнала
+ * для гарантии read-your-writes. Сами соединения не хранит. Потокобезопасен.
+ */
+class ReplicaRouter {
+public:
+    // Загрузка реплик передаётся в Pick массивом на стеке
+    static constexpr std::size_t kMaxReplicas = 16;
+
+    ReplicaRouter(std::size_t replica_count, ReplicaRouting routing);
+
+    std::size_t GetReplicaCount() const noexcept {
+        return replica_count_;
+    }
+
+    // Индекс реплики, с которой начинать поиск; in_use[i] — занятые соединения i-й реплики
+    std::size_t Pick(std::span<const std::size_t> in_use) noexcept;
+
+    // Позиция журнала, до которой должна дойти реплика, чтобы увидеть все фиксации процесса
+    std::uint64_t GetCommitLsn() const noexcept {
+        return commit_lsn_.load(std::memory_order_acquire);
+    }
+    void NoteCommitLsn(std::uint64_t lsn) noexcept;
+
+    // Наибольшая замеченная позиция, применённая репликой; позиции только растут,
+    // поэтому достаточно однажды увидеть нужную, чтобы больше её не проверять
+    std::uint64_t GetReplayedLsn(std::size_t replica) const noexcept {
+        return replayed_lsn_[replica].load(std::memory_order_acquire);
+    }
+    void NoteReplayedLsn(std::size_t replica, std::uint64_t lsn) noexcept;
+
+private:
+    static void StoreMax(std::atomic<std::uint64_t>& target, std::uint64_t value) noexcept;
+
+    std::size_t replica_count_;
+    ReplicaRouting routing_;
+    std::atomic<std::size_t> next_{0};
+    std::atomic<std::uint64_t> commit_lsn_{0};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> replayed_lsn_;
+};
+
+}  // namespace postgres
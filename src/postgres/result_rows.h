@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <pqxx/pqxx>
+#include <string_view>
+#include <utility>
+
+#include "../domain/author_rows.h"
+#include "../domain/book_rows.h"
+
+namespace postgres {
+
+/**
+ * Источники строк поверх pqxx::result: результат живёт столько же, сколько список,
+ * а поля читаются из его буфера по номеру столбца только при обращении.
+ * Текстовые поля отдаются как string_view без копирования, идентификаторы
+ * и годы разбираются на лету.
+ */
+class ResultAuthorRows : public domain::AuthorRowSource {
+public:
+    // Ожидаемый порядок столбцов: id, name
+    explicit ResultAuthorRows(pqxx::result result) noexcept
+    : result_{std::move(result)}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return static_cast<std::size_t>(result_.size());
+    }
+
+    domain::AuthorId GetId(std::size_t row) const override {
+        return domain::AuthorId::FromString(Field(row, 0).view());
+    }
+
+    std::string_view GetName(std::size_t row) const noexcept override {
+        return Field(row, 1).view();
+    }
+
+private:
+    pqxx::field Field(std::size_t row, int column) const noexcept {
+        return result_[static_cast<pqxx::result::size_type>(row)][column];
+    }
+
+    pqxx::result result_;
+};
+
+class ResultBookRows : public domain::BookRowSource {
+public:
+    // Ожидаемый порядок столбцов: book_id, author_id, name, title, publication_year
+    explicit ResultBookRows(pqxx::result result) noexcept
+    : result_{std::move(result)}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return static_cast<std::size_t>(result_.size());
+    }
+
+    domain::BookId GetId(std::size_t row) const override {
+        return domain::BookId::FromString(Field(row, 0).view());
+    }
+
+    domain::AuthorId GetAuthorId(std::size_t row) const override {
+        return domain::AuthorId::FromString(Field(row, 1).view());
+    }
+
+    std::string_view GetAuthorName(std::size_t row) const noexcept override {
+        return Field(row, 2).view();
+    }
+
+    std::string_view GetTitle(std::size_t row) const noexcept override {
+        return Field(row, 3).view();
+    }
+
+    int GetPublicationYear(std::size_t row) const override {
+        return Field(row, 4).as<int>();
+    }
+
+private:
+    pqxx::field Field(std::size_t row, int column) const noexcept {
+        return result_[static_cast<pqxx::result::size_type>(row)][column];
+    }
+
+    pqxx::result result_;
+};
+
+}  // namespace postgres
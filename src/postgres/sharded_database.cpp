@@ -0,0 +1,33 @@
+#include "sharded_database.h"
+
+#include <stdexcept>
+
+namespace postgres {
+
+using namespace std::literals;
+
+ShardedDatabase::ShardedDatabase(const std::string& db_url, const std::vector<std::string>& shard_urls,
+                                 size_t pool_size, QueryTracingConfig tracing_config, ReplicaConfig replicas) {
+    if (!shard_urls.empty() && !replicas.urls.empty()) {
+        throw std::invalid_argument("Read replicas are not supported together with shards"s);
+    }
+    shards_.reserve(shard_urls.size() + 1);
+    shards_.push_back(std::make_unique<Database>(db_url, pool_size, tracing_config, std::move(replicas)));
+    for (const std::string& url : shard_urls) {
+        shards_.push_back(std::make_unique<Database>(url, pool_size, tracing_config));
+    }
+    if (!shard_urls.empty()) {
+        sharded_ = std::make_unique<app::ShardedUnitOfWorkFactory>(GetShardFactories());
+    }
+}
+
+std::vector<app::UnitOfWorkFactory*> ShardedDatabase::GetShardFactories() {
+    std::vector<app::UnitOfWorkFactory*> factories;
+    factories.reserve(shards_.size());
+    for (const std::unique_ptr<Database>& shard : shards_) {
+        factories.push_back(&shard->GetUnitOfWorkFactoryFactory());
+    }
+    return factories;
+}
+
+}  // namespace postgres
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../app/sharded_unit_of_work.h"
+#include "postgres.h"
+
+namespace postgres {
+
+/**
+ * Основная база и дополнительные шарды (см. app::ShardedUnitOfWorkFactory): основная база —
+ * шард 0, shard_urls — шарды 1, 2, ... Без дополнительных шардов GetUnitOfWorkFactory
+ * возвращает фабрику основной базы, и запросы выполняются как без шардирования.
+ * Реплики поддерживаются только без шардов.
+ */
+class ShardedDatabase {
+public:
+    ShardedDatabase(const std::string& db_url, const std::vector<std::string>& shard_urls, size_t pool_size = 1,
+                    QueryTracingConfig tracing_config = {}, ReplicaConfig replicas = {});
+
+    app::UnitOfWorkFactory& GetUnitOfWorkFactory() noexcept {
+        if (sharded_) {
+            return *sharded_;
+        }
+        return shards_.front()->GetUnitOfWorkFactoryFactory();
+    }
+
+    // Фабрики отдельных шардов в порядке размещения данных
+    std::vector<app::UnitOfWorkFactory*> GetShardFactories();
+
+private:
+    std::vector<std::unique_ptr<Database>> shards_;
+    std::unique_ptr<app::ShardedUnitOfWorkFactory> sharded_;
+};
+
+}  // namespace postgres
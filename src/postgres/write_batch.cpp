@@ -0,0 +1,306 @@
+#include "write_batch.h"
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+
+#include "../metrics/metrics.h"
+#include "query_tracer.h"
+
+namespace postgres {
+
+using namespace std::literals;
+
+namespace {
+
+void AppendUUID(std::string& out, const util::detail::UUIDType& uuid) {
+    out += '\'';
+    out += util::UUIDChars{uuid}.View();
+    out += '\'';
+}
+
+void AppendString(std::string& out, const WriteBatch::Escape& escape, std::string_view value) {
+    out += '\'';
+    out += escape(value);
+    out += '\'';
+}
+
+void AppendInt(std::string& out, int value) {
+    char buffer[16];
+    const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.append(buffer, end);
+}
+
+// ('id1', 'id2', ...) без повторов, по возрастанию id
+void AppendIdList(std::string& out, std::vector<util::detail::UUIDType> ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    out += '(';
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (i != 0) {
+            out += ", "sv;
+        }
+        AppendUUID(out, ids[i]);
+    }
+    out += ')';
+}
+
+// DELETE FROM <table> WHERE <column> IN ('id1', 'id2', ...);
+void AppendDelete(std::string& out, std::string_view table, std::string_view column,
+                  std::vector<util::detail::UUIDType> ids) {
+    if (ids.empty()) {
+        return;
+    }
+    out.append("DELETE FROM "sv).append(table).append(" WHERE "sv).append(column).append(" IN "sv);
+    AppendIdList(out, std::move(ids));
+    out += ";\n"sv;
+}
+
+}  // namespace
+
+// // // --- AUTHOR --- // // //
+
+void WriteBatch::SaveAuthor(const domain::Author& author) {
+    author_edits_.erase(*author.GetId());
+    author_saves_.insert_or_assign(*author.GetId(), author.GetName());
+}
+
+void WriteBatch::EditAuthor(const domain::AuthorId& id, std::string_view new_name) {
+    if (const auto it = author_saves_.find(*id); it != author_saves_.end()) {
+        it->second = new_name;
+    } else {
+        author_edits_.insert_or_assign(*id, std::string{new_name});
+    }
+}
+
+void WriteBatch::DeleteAuthor(const domain::AuthorId& id) {
+    author_saves_.erase(*id);
+    author_edits_.erase(*id);
+    author_deletes_.push_back(*id);
+}
+
+void WriteBatch::MarkAuthorDeleted(const domain::AuthorId& id) {
+    author_tombstones_.push_back(*id);
+}
+
+// // // --- AUTHOR --- // // //
+//
+//
+//
+// // // --- BOOK --- // // //
+
+void WriteBatch::SaveBook(const domain::Book& book) {
+    book_edits_.erase(*book.GetId());
+    book_saves_.insert_or_assign(*book.GetId(), BookValues{*book.GetAuthorId(), book.GetTitle(), book.GetPublicationYear()});
+}
+
+void WriteBatch::EditBook(const domain::BookId& id, std::string_view title, int publication_year) {
+    if (const auto it = book_saves_.find(*id); it != book_saves_.end()) {
+        it->second.title = title;
+        it->second.publication_year = publication_year;
+    } else {
+        book_edits_.insert_or_assign(*id, std::pair{std::string{title}, publication_year});
+    }
+}
+
+void WriteBatch::DeleteBook(const domain::BookId& id) {
+    book_saves_.erase(*id);
+    book_edits_.erase(*id);
+    book_deletes_.push_back(*id);
+}
+
+void WriteBatch::DeleteBooksByAuthorId(const domain::AuthorId& author_id) {
+    // Вместе с ещё не вставленными книгами автора отбрасываются и их теги:
+    // иначе Flush вставил бы теги книг, которых нет
+    std::vector<UUIDType> dropped_books;
+    for (auto it = book_saves_.begin(); it != book_saves_.end();) {
+        if (it->second.author_id == *author_id) {
+            dropped_books.push_back(it->first);
+            it = book_saves_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!dropped_books.empty()) {
+        // book_saves_ упорядочен по id, поэтому dropped_books уже отсортирован
+        std::erase_if(tag_saves_, [&dropped_books](const auto& entry) {
+            return std::binary_search(dropped_books.begin(), dropped_books.end(), entry.first);
+        });
+    }
+    book_deletes_by_author_.push_back(*author_id);
+}
+
+// // // --- BOOK --- // // //
+//
+//
+//
+// // // --- BOOK_TAG --- // // //
+
+void WriteBatch::SaveTag(const domain::BookId& book_id, std::string_view tag) {
+    tag_saves_.emplace_back(*book_id, std::string{tag});
+}
+
+void WriteBatch::DeleteTagsByBookId(const domain::BookId& book_id) {
+    std::erase_if(tag_saves_, [&book_id](const auto& entry) {
+        return entry.first == *book_id;
+    });
+    tag_deletes_by_book_.push_back(*book_id);
+}
+
+// // // --- BOOK_TAG --- // // //
+
+std::size_t WriteBatch::Size() const noexcept {
+    return author_saves_.size() + author_edits_.size() + author_deletes_.size() + author_tombstones_.size()
+         + book_saves_.size() + book_edits_.size() + book_deletes_.size() + book_deletes_by_author_.size()
+         + tag_saves_.size() + tag_deletes_by_book_.size();
+}
+
+std::string WriteBatch::BuildStatement(const Escape& escape) const {
+    std::string sql;
+    if (Empty()) {
+        return sql;
+    }
+
+    // Удаления идут от дочерних таблиц к родительским
+    AppendDelete(sql, "book_tags"sv, "book_id"sv, tag_deletes_by_book_);
+    AppendDelete(sql, "books"sv, "id"sv, book_deletes_);
+    AppendDelete(sql, "books"sv, "author_id"sv, book_deletes_by_author_);
+    AppendDelete(sql, "authors"sv, "id"sv, author_deletes_);
+
+    // Правки авторов раньше вставок: имя, освобождённое переименованием, можно занять новым автором
+    if (!author_edits_.empty()) {
+        sql += "UPDATE authors SET name = v.name FROM (VALUES "sv;
+        bool first = true;
+        for (const auto& [id, name] : author_edits_) {
+            sql += first ? "("sv : ", ("sv;
+            first = false;
+            AppendUUID(sql, id);
+            sql += "::uuid, "sv;
+            AppendString(sql, escape, name);
+            sql += ')';
+        }
+        sql += ") AS v(id, name) WHERE authors.id = v.id;\n"sv;
+    }
+    if (!author_saves_.empty()) {
+        sql += "INSERT INTO authors (id, name) VALUES "sv;
+        bool first = true;
+        for (const auto& [id, name] : author_saves_) {
+            sql += first ? "("sv : ", ("sv;
+            first = false;
+            AppendUUID(sql, id);
+            sql += ", "sv;
+            AppendString(sql, escape, name);
+            sql += ')';
+        }
+        sql += " ON CONFLICT (id) DO UPDATE SET name = EXCLUDED.name;\n"sv;
+    }
+
+    if (!book_edits_.empty()) {
+        sql += "UPDATE books SET title = v.title, publication_year = v.publication_year FROM (VALUES "sv;
+        bool first = true;
+        for (const auto& [id, values] : book_edits_) {
+            sql += first ? "("sv : ", ("sv;
+            first = false;
+            AppendUUID(sql, id);
+            sql += "::uuid, "sv;
+            AppendString(sql, escape, values.first);
+            sql += ", "sv;
+            AppendInt(sql, values.second);
+            sql += ')';
+        }
+        sql += ") AS v(id, title, publication_year) WHERE books.id = v.id;\n"sv;
+    }
+    if (!book_saves_.empty()) {
+        // Ключ таблицы, секционированной по году, включает год, и ON CONFLICT не находит ту же книгу
+        // с другим годом: её строка в прежней секции удаляется, иначе id повторился бы в двух секциях
+        sql += "DELETE FROM books USING (VALUES "sv;
+        bool first = true;
+        for (const auto& [id, values] : book_saves_) {
+            sql += first ? "("sv : ", ("sv;
+            first = false;
+            AppendUUID(sql, id);
+            sql += "::uuid, "sv;
+            AppendInt(sql, values.publication_year);
+            sql += ')';
+        }
+        sql += ") AS v(id, publication_year) WHERE books.id = v.id AND books.publication_year <> v.publication_year;\n"sv;
+
+        sql += "INSERT INTO books (id, author_id, title, publication_year) VALUES "sv;
+        first = true;
+        for (const auto& [id, values] : book_saves_) {
+            sql += first ? "("sv : ", ("sv;
+            first = false;
+            AppendUUID(sql, id);
+            sql += ", "sv;
+            AppendUUID(sql, values.author_id);
+            sql += ", "sv;
+            AppendString(sql, escape, values.title);
+            sql += ", "sv;
+            AppendInt(sql, values.publication_year);
+            sql += ')';
+        }
+        sql += " ON CONFLICT (id, publication_year) DO UPDATE SET author_id = EXCLUDED.author_id,"
+               " title = EXCLUDED.title;\n"sv;
+    }
+
+    if (!tag_saves_.empty()) {
+        std::vector<const std::pair<UUIDType, std::string>*> tags;
+        tags.reserve(tag_saves_.size());
+        for (const auto& tag : tag_saves_) {
+            tags.push_back(&tag);
+        }
+        std::sort(tags.begin(), tags.end(), [](const auto* lhs, const auto* rhs) {
+            return *lhs < *rhs;
+        });
+        sql += "INSERT INTO book_tags (book_id, tag) VALUES "sv;
+        for (std::size_t i = 0; i < tags.size(); ++i) {
+            sql += i == 0 ? "("sv : ", ("sv;
+            AppendUUID(sql, tags[i]->first);
+            sql += ", "sv;
+            AppendString(sql, escape, tags[i]->second);
+            sql += ')';
+        }
+        sql += ";\n"sv;
+    }
+
+    // Пометка после вставок: автора можно добавить и удалить в одной транзакции
+    if (!author_tombstones_.empty()) {
+        sql += "UPDATE authors SET deleted_at = now() WHERE deleted_at IS NULL AND id IN "sv;
+        AppendIdList(sql, author_tombstones_);
+        sql += ";\n"sv;
+    }
+    return sql;
+}
+
+void WriteBatch::Flush(TracedWork& work) {
+    if (Empty()) {
+        return;
+    }
+    static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "UnitOfWork::Flush"sv);
+    metrics::ScopedCall call{stats};
+    call.SetRows(Size());
+
+    pqxx::work& transaction = work.GetWork();
+    const std::string sql = BuildStatement([&transaction](std::string_view value) {
+        return transaction.esc(value);
+    });
+    Clear();
+    flushed_ = true;
+    // Несколько операторов без параметров уходят на сервер одним сообщением простого протокола
+    work.Exec("UnitOfWork::Flush"sv, sql);
+}
+
+void WriteBatch::Clear() noexcept {
+    author_saves_.clear();
+    author_edits_.clear();
+    author_deletes_.clear();
+    author_tombstones_.clear();
+    book_saves_.clear();
+    book_edits_.clear();
+    book_deletes_.clear();
+    book_deletes_by_author_.clear();
+    tag_saves_.clear();
+    tag_deletes_by_book_.clear();
+}
+
+}  // namespace postgres
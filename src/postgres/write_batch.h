@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+
+namespace postgres {
+
+class TracedWork;
+
+/**
+ * Отложенные изменения единицы работы. Репозитории не отправляют запись на сервер сразу,
+ * а регистрируют здесь новые, изменённые и удалённые сущности. Повторные изменения одной
+ * сущности схлопываются: правка ещё не записанного автора меняет строку его вставки,
+ * удаление отменяет ожидающие вставку и правку.
+ *
+ * Flush отправляет всё одним запросом из нескольких многострочных операторов в порядке
+ * внешних ключей: сначала удаления (теги, книги, авторы), затем правки и вставки
+ * (авторы, книги, теги), последними — пометки об удалении авторов. Строки внутри оператора упорядочены по id, поэтому
+ * параллельные транзакции берут блокировки строк в одном порядке.
+ * Чтения в той же единице работы должны вызывать Flush перед запросом,
+ * чтобы видеть ещё не отправленные изменения.
+ */
+class WriteBatch {
+public:
+    // Экранирует строку для вставки внутрь литерала '...'
+    using Escape = std::function<std::string(std::string_view)>;
+
+    void SaveAuthor(const domain::Author& author);
+    void EditAuthor(const domain::AuthorId& id, std::string_view new_name);
+    void DeleteAuthor(const domain::AuthorId& id);
+    void MarkAuthorDeleted(const domain::AuthorId& id);
+
+    void SaveBook(const domain::Book& book);
+    void EditBook(const domain::BookId& id, std::string_view title, int publication_year);
+    void DeleteBook(const domain::BookId& id);
+    void DeleteBooksByAuthorId(const domain::AuthorId& author_id);
+
+    void SaveTag(const domain::BookId& book_id, std::string_view tag);
+    void DeleteTagsByBookId(const domain::BookId& book_id);
+
+    // Число ожидающих изменений (строк во всех операторах)
+    std::size_t Size() const noexcept;
+
+    bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    // Отправлял ли Flush хоть одно изменение; Clear не сбрасывает
+    bool HasFlushed() const noexcept {
+        return flushed_;
+    }
+
+    // Текст запроса, применяющего все изменения; пустая строка, если изменений нет
+    std::string BuildStatement(const Escape& escape) const;
+
+    // Отправляет изменения одним запросом и очищает буфер. Если запрос завершился ошибкой,
+    // буфер тоже очищается: транзакция всё равно откатится
+    void Flush(TracedWork& work);
+
+    void Clear() noexcept;
+
+private:
+    using UUIDType = util::detail::UUIDType;
+
+    struct BookValues {
+        UUIDType author_id;
+        std::string title;
+        int publication_year;
+    };
+
+    std::map<UUIDType, std::string> author_saves_;
+    std::map<UUIDType, std::string> author_edits_;
+    std::vector<UUIDType> author_deletes_;
+    std::vector<UUIDType> author_tombstones_;
+
+    std::map<UUIDType, BookValues> book_saves_;
+    std::map<UUIDType, std::pair<std::string, int>> book_edits_;
+    std::vector<UUIDType> book_deletes_;
+    std::vector<UUIDType> book_deletes_by_author_;
+
+    std::vector<std::pair<UUIDType, std::string>> tag_saves_;
+    std::vector<UUIDType> tag_deletes_by_book_;
+
+    bool flushed_ = false;
+};
+
+}  // namespace postgres
@@ -0,0 +1,53 @@
+// Переносит авторов на шарды, которые им назначает app::ShardOfAuthor, после добавления
+// шардов в конец BOOKYPEDIA_DB_SHARD_URLS.
+//
+// Использование: BOOKYPEDIA_DB_URL=... BOOKYPEDIA_DB_SHARD_URLS="url1;url2" bookypedia-rebalance [--dry-run]
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "app/shard_rebalance.h"
+#include "postgres/sharded_database.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr const char DB_URL_ENV_NAME[]{"BOOKYPEDIA_DB_URL"};
+constexpr const char DB_SHARD_URLS_ENV_NAME[]{"BOOKYPEDIA_DB_SHARD_URLS"};
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        const char* url = std::getenv(DB_URL_ENV_NAME);
+        if (url == nullptr) {
+            throw std::runtime_error(DB_URL_ENV_NAME + " environment variable not found"s);
+        }
+        std::vector<std::string> shard_urls;
+        if (const char* urls = std::getenv(DB_SHARD_URLS_ENV_NAME)) {
+            shard_urls = postgres::ParseUrlList(urls);
+        }
+        bool dry_run = false;
+        for (int i = 1; i < argc; ++i) {
+            if (argv[i] == "--dry-run"sv) {
+                dry_run = true;
+            } else {
+                throw std::invalid_argument("Unknown argument: "s + argv[i]);
+            }
+        }
+
+        postgres::ShardedDatabase db{url, shard_urls};
+        const app::RebalanceStats stats = app::RebalanceShards(db.GetShardFactories(), dry_run, &std::cout);
+        std::cout << (dry_run ? "Would move "sv : "Moved "sv) << stats.authors_moved << " of "sv
+                  << stats.authors_checked << " authors, "sv << stats.books_moved << " books, "sv
+                  << stats.tags_moved << " tags across "sv << shard_urls.size() + 1 << " shards"sv << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
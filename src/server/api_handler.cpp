@@ -0,0 +1,380 @@
+#include "api_handler.h"
+
+#include <boost/json.hpp>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "../app/use_cases.h"
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/book_tag.h"
+#include "../util/string_util.h"
+#include "json_writer.h"
+
+namespace server {
+
+using namespace std::literals;
+namespace json = boost::json;
+
+namespace {
+
+// Ошибка, которая превращается в HTTP-ответ с заданным статусом
+class ApiError : public std::runtime_error {
+public:
+    ApiError(http::status status, std::string code, const std::string& message)
+    : std::runtime_error{message}, status_{status}, code_{std::move(code)}
+    {
+
+    }
+
+    http::status GetStatus() const noexcept {
+        return status_;
+    }
+
+    const std::string& GetCode() const noexcept {
+        return code_;
+    }
+
+private:
+    http::status status_;
+    std::string code_;
+};
+
+StringResponse MakeResponse(const StringRequest& req, http::status status, std::string body) {
+    StringResponse response{status, req.version()};
+    response.set(http::field::content_type, "application/json");
+    response.set(http::field::cache_control, "no-cache");
+    response.body() = std::move(body);
+    response.keep_alive(req.keep_alive());
+    response.prepare_payload();
+    return response;
+}
+
+StringResponse MakeError(const StringRequest& req, http::status status, std::string_view code, std::string_view message) {
+    std::string body;
+    JsonWriter{body}.WriteError(code, message);
+    return MakeResponse(req, status, std::move(body));
+}
+
+StringResponse MakeNoContent(const StringRequest& req) {
+    StringResponse response{http::status::no_content, req.version()};
+    response.keep_alive(req.keep_alive());
+    return response;
+}
+
+ApiError MethodNotAllowed() {
+    return ApiError{http::status::method_not_allowed, "invalidMethod"s, "Invalid method"s};
+}
+
+ApiError NotFound(std::string_view what) {
+    return ApiError{http::status::not_found, "notFound"s, std::string{what} + " not found"s};
+}
+
+ApiError BadRequest(const std::string& message) {
+    return ApiError{http::status::bad_request, "invalidArgument"s, message};
+}
+
+template <typename Id>
+Id ParseId(std::string_view text) {
+    if (std::optional<Id> id = Id::TryFromString(text)) {
+        return *id;
+    }
+    throw BadRequest("Invalid id"s);
+}
+
+json::object ParseBody(const StringRequest& req) {
+    boost::system::error_code ec;
+    json::value value = json::parse(req.body(), ec);
+    if (ec || !value.is_object()) {
+        throw BadRequest("Request body must be a JSON object"s);
+    }
+    return std::move(value.as_object());
+}
+
+std::optional<std::string> GetString(const json::object& object, std::string_view key) {
+    const json::value* value = object.if_contains(key);
+    if (value == nullptr) {
+        return std::nullopt;
+    }
+    if (!value->is_string()) {
+        throw BadRequest("Field '"s + std::string{key} + "' must be a string"s);
+    }
+    const json::string& str = value->get_string();
+    return std::string{str.data(), str.size()};
+}
+
+std::string GetRequiredString(const json::object& object, std::string_view key) {
+    std::optional<std::string> value = GetString(object, key);
+    if (!value || value->empty()) {
+        throw BadRequest("Field '"s + std::string{key} + "' is required"s);
+    }
+    return std::move(*value);
+}
+
+int GetRequiredInt(const json::object& object, std::string_view key) {
+    const json::value* value = object.if_contains(key);
+    if (value == nullptr || !value->is_int64()) {
+        throw BadRequest("Field '"s + std::string{key} + "' must be an integer"s);
+    }
+    const std::int64_t number = value->get_int64();
+    if (number < std::numeric_limits<int>::min() || number > std::numeric_limits<int>::max()) {
+        throw BadRequest("Field '"s + std::string{key} + "' is out of range"s);
+    }
+    return static_cast<int>(number);
+}
+
+// Теги нормализуются так же, как в интерактивном режиме: пробелы схлопываются,
+// пустые и повторяющиеся теги отбрасываются
+std::vector<std::string> GetTags(const json::object& object) {
+    std::vector<std::string> tags;
+    const json::value* value = object.if_contains("tags"sv);
+    if (value == nullptr) {
+        return tags;
+    }
+    if (!value->is_array()) {
+        throw BadRequest("Field 'tags' must be an array of strings"s);
+    }
+    tags.reserve(value->get_array().size());
+    for (const json::value& tag : value->get_array()) {
+        if (!tag.is_string()) {
+            throw BadRequest("Field 'tags' must be an array of strings"s);
+        }
+        const json::string& raw = tag.get_string();
+        std::string normalized = util::NormalizeTag(std::string_view{raw.data(), raw.size()});
+        if (util::Utf8Length(normalized) > domain::kMaxTagLength) {
+            throw BadRequest("Tags must be at most "s + std::to_string(domain::kMaxTagLength) + " characters long"s);
+        }
+        if (!normalized.empty()) {
+            tags.push_back(std::move(normalized));
+        }
+    }
+    util::SortUniqueTags(tags);
+    return tags;
+}
+
+std::string DecodeUrl(std::string_view encoded) {
+    auto hex_value = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    std::string decoded;
+    decoded.reserve(encoded.size());
+    for (std::size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size() && hex_value(encoded[i + 1]) >= 0 && hex_value(encoded[i + 2]) >= 0) {
+            decoded.push_back(static_cast<char>(hex_value(encoded[i + 1]) * 16 + hex_value(encoded[i + 2])));
+            i += 2;
+        } else if (encoded[i] == '+') {
+            decoded.push_back(' ');
+        } else {
+            decoded.push_back(encoded[i]);
+        }
+    }
+    return decoded;
+}
+
+}  // namespace
+
+std::optional<std::string_view> ApiHandler::Target::GetQueryParam(std::string_view name) const {
+    for (const auto& [key, value] : query) {
+        if (key == name) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+ApiHandler::Target ApiHandler::ParseTarget(std::string_view target) {
+    Target result;
+    std::string_view path = target;
+    if (const std::size_t pos = target.find('?'); pos != std::string_view::npos) {
+        path = target.substr(0, pos);
+        std::string_view query = target.substr(pos + 1);
+        while (!query.empty()) {
+            const std::size_t amp = query.find('&');
+            const std::string_view pair = query.substr(0, amp);
+            const std::size_t eq = pair.find('=');
+            result.query.emplace_back(
+                DecodeUrl(pair.substr(0, eq)),
+                eq == std::string_view::npos ? std::string{} : DecodeUrl(pair.substr(eq + 1))
+            );
+            query = amp == std::string_view::npos ? std::string_view{} : query.substr(amp + 1);
+        }
+    }
+    while (!path.empty()) {
+        const std::size_t slash = path.find('/');
+        if (slash != 0) {
+            result.segments.emplace_back(DecodeUrl(path.substr(0, slash)));
+        }
+        path = slash == std::string_view::npos ? std::string_view{} : path.substr(slash + 1);
+    }
+    return result;
+}
+
+StringResponse ApiHandler::operator()(StringRequest&& req) const {
+    try {
+        const Target target = ParseTarget({req.target().data(), req.target().size()});
+        if (target.segments.size() < 3 || target.segments[0] != "api"sv || target.segments[1] != "v1"sv) {
+            throw ApiError{http::status::not_found, "badRequest"s, "Unknown API endpoint"s};
+        }
+        if (target.segments[2] == "authors"sv) {
+            return HandleAuthors(req, target);
+        }
+        if (target.segments[2] == "books"sv) {
+            return HandleBooks(req, target);
+        }
+        throw ApiError{http::status::not_found, "badRequest"s, "Unknown API endpoint"s};
+    } catch (const ApiError& e) {
+        return MakeError(req, e.GetStatus(), e.GetCode(), e.what());
+    } catch (const std::exception& e) {
+        // Текст исключения может содержать SQL и имена ограничений: клиенту он не отдаётся
+        std::cerr << "API request "sv << req.method_string() << ' ' << req.target() << " failed: "sv << e.what() << std::endl;
+        return MakeError(req, http::status::internal_server_error, "internalError"sv, "Internal server error"sv);
+    }
+}
+
+StringResponse ApiHandler::HandleAuthors(const StringRequest& req, const Target& target) const {
+    const std::vector<std::string>& segments = target.segments;
+    std::string body;
+    JsonWriter writer{body};
+
+    if (segments.size() == 3) {
+        if (req.method() == http::verb::get) {
+            if (const std::optional<std::string_view> name = target.GetQueryParam("name"sv)) {
+                const std::optional<domain::Author> author = use_cases_.GetAuthorByName(*name);
+                if (!author) {
+                    throw NotFound("Author"sv);
+                }
+                writer.WriteAuthor(*author);
+            } else {
+                writer.WriteAuthors(use_cases_.GetAllAuthors());
+            }
+            return MakeResponse(req, http::status::ok, std::move(body));
+        }
+        if (req.method() == http::verb::post) {
+            const std::string name = GetRequiredString(ParseBody(req), "name"sv);
+            if (use_cases_.GetAuthorByName(name)) {
+                throw ApiError{http::status::conflict, "conflict"s, "Author already exists"s};
+            }
+            // Автор не перечитывается: к этому моменту его могли изменить, а реплика — ещё не увидеть
+            const domain::AuthorId id = use_cases_.AddAuthor(name);
+            writer.WriteAuthor(domain::Author{id, name});
+            return MakeResponse(req, http::status::created, std::move(body));
+        }
+        throw MethodNotAllowed();
+    }
+
+    const domain::AuthorId id = ParseId<domain::AuthorId>(segments[3]);
+    if (segments.size() == 4) {
+        switch (req.method()) {
+            case http::verb::get: {
+                const std::optional<domain::Author> author = use_cases_.GetAuthorById(id);
+                if (!author) {
+                    throw NotFound("Author"sv);
+                }
+                writer.WriteAuthor(*author);
+                return MakeResponse(req, http::status::ok, std::move(body));
+            }
+            case http::verb::put:
+                if (!use_cases_.EditAuthor(id, GetRequiredString(ParseBody(req), "name"sv))) {
+                    throw NotFound("Author"sv);
+                }
+                return MakeNoContent(req);
+            case http::verb::delete_:
+                if (!use_cases_.DeleteAuthor(id)) {
+                    throw NotFound("Author"sv);
+                }
+                return MakeNoContent(req);
+            default:
+                throw MethodNotAllowed();
+        }
+    }
+    if (segments.size() == 5 && segments[4] == "books"sv) {
+        if (req.method() != http::verb::get) {
+            throw MethodNotAllowed();
+        }
+        writer.WriteBooks(use_cases_.GetBooksByAuthorId(id));
+        return MakeResponse(req, http::status::ok, std::move(body));
+    }
+    throw NotFound("Endpoint"sv);
+}
+
+StringResponse ApiHandler::HandleBooks(const StringRequest& req, const Target& target) const {
+    const std::vector<std::string>& segments = target.segments;
+    std::string body;
+    JsonWriter writer{body};
+
+    if (segments.size() == 3) {
+        if (req.method() == http::verb::get) {
+            if (const std::optional<std::string_view> title = target.GetQueryParam("title"sv)) {
+                writer.WriteBooks(use_cases_.GetBooksByTitle(*title));
+            } else {
+                writer.WriteBooks(use_cases_.GetAllBooks());
+            }
+            return MakeResponse(req, http::status::ok, std::move(body));
+        }
+        if (req.method() == http::verb::post) {
+            const json::object params = ParseBody(req);
+            std::string title = GetRequiredString(params, "title"sv);
+            const int publication_year = GetRequiredInt(params, "publicationYear"sv);
+            std::vector<std::string> tags = GetTags(params);
+            domain::BookId id;
+            if (const std::optional<std::string> author_id = GetString(params, "authorId"sv)) {
+                id = use_cases_.AddBookByAuthorId(ParseId<domain::AuthorId>(*author_id), std::move(title), publication_year, tags);
+            } else if (std::optional<std::string> author_name = GetString(params, "authorName"sv)) {
+                if (const std::optional<domain::Author> author = use_cases_.GetAuthorByName(*author_name)) {
+                    id = use_cases_.AddBookByAuthorId(author->GetId(), std::move(title), publication_year, tags);
+                } else {
+                    id = use_cases_.AddBookByAuthorName(std::move(*author_name), std::move(title), publication_year, tags);
+                }
+            } else {
+                throw BadRequest("Either 'authorId' or 'authorName' is required"s);
+            }
+            writer.WriteBookId(id);
+            return MakeResponse(req, http::status::created, std::move(body));
+        }
+        throw MethodNotAllowed();
+    }
+
+    if (segments.size() != 4) {
+        throw NotFound("Endpoint"sv);
+    }
+    const domain::BookId id = ParseId<domain::BookId>(segments[3]);
+    switch (req.method()) {
+        case http::verb::get: {
+            const std::optional<domain::Book> book = use_cases_.GetBook(id);
+            if (!book) {
+                throw NotFound("Book"sv);
+            }
+            writer.WriteBook(*book);
+            return MakeResponse(req, http::status::ok, std::move(body));
+        }
+        case http::verb::put: {
+            const json::object params = ParseBody(req);
+            if (!use_cases_.EditBook(
+                id,
+                GetRequiredString(params, "title"sv),
+                GetRequiredInt(params, "publicationYear"sv),
+                GetTags(params)
+            )) {
+                throw NotFound("Book"sv);
+            }
+            return MakeNoContent(req);
+        }
+        case http::verb::delete_:
+            if (!use_cases_.DeleteBook(id)) {
+                throw NotFound("Book"sv);
+            }
+            return MakeNoContent(req);
+        default:
+            throw MethodNotAllowed();
+    }
+}
+
+}  // namespace server
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <boost/beast/http.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace app {
+class UseCases;
+}
+
+namespace server {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+using StringRequest = http::request<http::string_body>;
+using StringResponse = http::response<http::string_body>;
+
+/**
+ * REST API поверх app::UseCases:
+ *
+ *  GET    /api/v1/authors[?name=<name>]
+ *  POST   /api/v1/authors                 {"name": "..."}, в ответе созданный автор
+ *  GET    /api/v1/authors/<id>
+ *  PUT    /api/v1/authors/<id>            {"name": "..."}
+ *  DELETE /api/v1/authors/<id>
+ *  GET    /api/v1/authors/<id>/books
+ *  GET    /api/v1/books[?title=<title>]
+ *  POST   /api/v1/books                   {"title", "publicationYear", "authorId" | "authorName", "tags"},
+ *                                         в ответе {"id": ...} созданной книги
+ *  GET    /api/v1/books/<id>              книга вместе с тегами
+ *  PUT    /api/v1/books/<id>              {"title", "publicationYear", "tags"}
+ *  DELETE /api/v1/books/<id>
+ *
+ * Подробности внутренних ошибок (500) пишутся в std::cerr, клиент получает только общее сообщение.
+ * Обработчик не хранит состояния и может вызываться из нескольких потоков одновременно.
+ */
+class ApiHandler {
+public:
+    explicit ApiHandler(app::UseCases& use_cases)
+    : use_cases_{use_cases}
+    {
+
+    }
+
+    StringResponse operator()(StringRequest&& req) const;
+
+private:
+    struct Target {
+        std::vector<std::string> segments;
+        std::vector<std::pair<std::string, std::string>> query;
+
+        std::optional<std::string_view> GetQueryParam(std::string_view name) const;
+    };
+
+    static Target ParseTarget(std::string_view target);
+
+    StringResponse HandleAuthors(const StringRequest& req, const Target& target) const;
+    StringResponse HandleBooks(const StringRequest& req, const Target& target) const;
+
+    app::UseCases& use_cases_;
+};
+
+}  // namespace server
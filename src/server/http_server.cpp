@@ -0,0 +1,109 @@
+#include "http_server.h"
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/strand.hpp>
+#include <iostream>
+
+namespace server {
+
+using namespace std::literals;
+
+namespace {
+
+void ReportError(beast::error_code ec, std::string_view where) {
+    std::cerr << where << ": "sv << ec.message() << std::endl;
+}
+
+}  // namespace
+
+// // // --- SESSION --- // // //
+
+Session::Session(tcp::socket&& socket, const RequestHandler& handler)
+    : stream_{std::move(socket)}
+    , handler_{handler} {
+}
+
+void Session::Run() {
+    net::dispatch(stream_.get_executor(), beast::bind_front_handler(&Session::Read, shared_from_this()));
+}
+
+void Session::Read() {
+    request_ = {};
+    stream_.expires_after(kIdleTimeout);
+    http::async_read(stream_, buffer_, request_, beast::bind_front_handler(&Session::OnRead, shared_from_this()));
+}
+
+void Session::OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
+    if (ec == http::error::end_of_stream) {
+        return Close();
+    }
+    if (ec) {
+        if (ec != beast::error::timeout) {
+            ReportError(ec, "read"sv);
+        }
+        return;
+    }
+
+    response_ = std::make_shared<http::response<http::string_body>>(handler_(std::move(request_)));
+    const bool close = response_->need_eof();
+    http::async_write(stream_, *response_,
+                      beast::bind_front_handler(&Session::OnWrite, shared_from_this(), close));
+}
+
+void Session::OnWrite(bool close, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written) {
+    if (ec) {
+        return ReportError(ec, "write"sv);
+    }
+    if (close) {
+        return Close();
+    }
+    response_.reset();
+    Read();
+}
+
+void Session::Close() {
+    beast::error_code ec;
+    stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+}
+
+// // // --- SESSION --- // // //
+//
+//
+//
+// // // --- LISTENER --- // // //
+
+Listener::Listener(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler handler)
+    : ioc_{ioc}
+    , acceptor_{net::make_strand(ioc)}
+    , handler_{std::move(handler)} {
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(net::socket_base::reuse_address(true));
+    acceptor_.bind(endpoint);
+    acceptor_.listen(net::socket_base::max_listen_connections);
+}
+
+void Listener::Run() {
+    Accept();
+}
+
+void Listener::Accept() {
+    // Каждое соединение обслуживается в собственном strand
+    acceptor_.async_accept(net::make_strand(ioc_), beast::bind_front_handler(&Listener::OnAccept, shared_from_this()));
+}
+
+void Listener::OnAccept(beast::error_code ec, tcp::socket socket) {
+    if (ec) {
+        ReportError(ec, "accept"sv);
+    } else {
+        std::make_shared<Session>(std::move(socket), handler_)->Run();
+    }
+    Accept();
+}
+
+// // // --- LISTENER --- // // //
+
+void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler handler) {
+    std::make_shared<Listener>(ioc, endpoint, std::move(handler))->Run();
+}
+
+}  // namespace server
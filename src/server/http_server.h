@@ -0,0 +1,63 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace server {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+using RequestHandler = std::function<http::response<http::string_body>(http::request<http::string_body>&&)>;
+
+/**
+ * HTTP-сессия с поддержкой keep-alive: после отправки ответа ждёт следующий запрос
+ * на том же соединении, пока клиент не закроет его или не истечёт таймаут.
+ */
+class Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(tcp::socket&& socket, const RequestHandler& handler);
+
+    void Run();
+
+private:
+    void Read();
+    void OnRead(beast::error_code ec, std::size_t bytes_read);
+    void OnWrite(bool close, beast::error_code ec, std::size_t bytes_written);
+    void Close();
+
+    static constexpr std::chrono::seconds kIdleTimeout{30};
+
+    beast::tcp_stream stream_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    std::shared_ptr<http::response<http::string_body>> response_;
+    const RequestHandler& handler_;
+};
+
+class Listener : public std::enable_shared_from_this<Listener> {
+public:
+    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler handler);
+
+    void Run();
+
+private:
+    void Accept();
+    void OnAccept(beast::error_code ec, tcp::socket socket);
+
+    net::io_context& ioc_;
+    tcp::acceptor acceptor_;
+    RequestHandler handler_;
+};
+
+// Принимает соединения на endpoint; обработка идёт в потоках, вызывающих ioc.run()
+void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler handler);
+
+}  // namespace server
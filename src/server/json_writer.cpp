@@ -0,0 +1,138 @@
+#include "json_writer.h"
+
+#include <charconv>
+
+namespace server {
+
+using namespace std::literals;
+
+void JsonWriter::WriteString(std::string_view value) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    out_.push_back('"');
+    for (const char c : value) {
+        switch (c) {
+            case '"': out_.append(R"(\")"sv); break;
+            case '\\': out_.append(R"(\\)"sv); break;
+            case '\n': out_.append(R"(\n)"sv); break;
+            case '\r': out_.append(R"(\r)"sv); break;
+            case '\t': out_.append(R"(\t)"sv); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out_.append(R"(\u00)"sv);
+                    out_.push_back(kHex[(c >> 4) & 0xF]);
+                    out_.push_back(kHex[c & 0xF]);
+                } else {
+                    out_.push_back(c);
+                }
+        }
+    }
+    out_.push_back('"');
+}
+
+void JsonWriter::WriteYear(int publication_year) {
+    char year[16];
+    const auto [end, ec] = std::to_chars(std::begin(year), std::end(year), publication_year);
+    out_.append(R"(,"publicationYear":)"sv);
+    out_.append(year, end);
+}
+
+void JsonWriter::WriteAuthor(const domain::Author& author) {
+    out_.append(R"({"id":)"sv);
+    WriteId(author.GetId());
+    out_.append(R"(,"name":)"sv);
+    WriteString(author.GetName());
+    out_.push_back('}');
+}
+
+void JsonWriter::WriteAuthors(const domain::AuthorRows& authors) {
+    out_.push_back('[');
+    bool first = true;
+    for (const domain::AuthorRow author : authors) {
+        if (!first) {
+            out_.push_back(',');
+        }
+        first = false;
+        out_.append(R"({"id":)"sv);
+        WriteId(author.GetId());
+        out_.append(R"(,"name":)"sv);
+        WriteString(author.GetName());
+        out_.push_back('}');
+    }
+    out_.push_back(']');
+}
+
+void JsonWriter::WriteBookId(const domain::BookId& id) {
+    out_.append(R"({"id":)"sv);
+    WriteId(id);
+    out_.push_back('}');
+}
+
+void JsonWriter::WriteBook(const domain::Book& book) {
+    out_.append(R"({"id":)"sv);
+    WriteId(book.GetId());
+    out_.append(R"(,"authorId":)"sv);
+    WriteId(book.GetAuthorId());
+    if (const std::optional<std::string>& author_name = book.GetAuthorName()) {
+        out_.append(R"(,"authorName":)"sv);
+        WriteString(*author_name);
+    }
+    out_.append(R"(,"title":)"sv);
+    WriteString(book.GetTitle());
+
+    WriteYear(book.GetPublicationYear());
+
+    if (!book.GetTags().empty()) {
+        out_.append(R"(,"tags":[)"sv);
+        for (std::size_t i = 0; i < book.GetTags().size(); ++i) {
+            if (i != 0) {
+                out_.push_back(',');
+            }
+            WriteString(book.GetTags()[i]);
+        }
+        out_.push_back(']');
+    }
+    out_.push_back('}');
+}
+
+void JsonWriter::WriteBooks(const std::vector<domain::Book>& books) {
+    out_.push_back('[');
+    for (std::size_t i = 0; i < books.size(); ++i) {
+        if (i != 0) {
+            out_.push_back(',');
+        }
+        WriteBook(books[i]);
+    }
+    out_.push_back(']');
+}
+
+void JsonWriter::WriteBooks(const domain::BookRows& books) {
+    out_.push_back('[');
+    bool first = true;
+    for (const domain::BookRow book : books) {
+        if (!first) {
+            out_.push_back(',');
+        }
+        first = false;
+        out_.append(R"({"id":)"sv);
+        WriteId(book.GetId());
+        out_.append(R"(,"authorId":)"sv);
+        WriteId(book.GetAuthorId());
+        out_.append(R"(,"authorName":)"sv);
+        WriteString(book.GetAuthorName());
+        out_.append(R"(,"title":)"sv);
+        WriteString(book.GetTitle());
+        WriteYear(book.GetPublicationYear());
+        out_.push_back('}');
+    }
+    out_.push_back(']');
+}
+
+void JsonWriter::WriteError(std::string_view code, std::string_view message) {
+    out_.append(R"({"code":)"sv);
+    WriteString(code);
+    out_.append(R"(,"message":)"sv);
+    WriteString(message);
+    out_.push_back('}');
+}
+
+}  // namespace server
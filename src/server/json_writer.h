@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../domain/author.h"
+#include "../domain/book.h"
+#include "../domain/author_rows.h"
+#include "../domain/book_rows.h"
+
+namespace server {
+
+/**
+ * Сериализует доменные объекты в JSON прямо в выходной буфер,
+ * без промежуточных DTO и DOM-дерева.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) noexcept
+    : out_{out}
+    {
+
+    }
+
+    void WriteString(std::string_view value);
+
+    void WriteAuthor(const domain::Author& author);
+    void WriteAuthors(const domain::AuthorRows& authors);
+
+    void WriteBook(const domain::Book& book);
+    // {"id": ...} — ответ на создание книги
+    void WriteBookId(const domain::BookId& id);
+    void WriteBooks(const std::vector<domain::Book>& books);
+    void WriteBooks(const domain::BookRows& books);
+
+    void WriteError(std::string_view code, std::string_view message);
+
+private:
+    void WriteYear(int publication_year);
+
+    // Идентификатор пишется прямо в буфер: цифры и дефисы не требуют экранирования
+    template <typename Tag>
+    void WriteId(const util::TaggedUUID<Tag>& id) {
+        const std::size_t pos = out_.size();
+        out_.resize(pos + util::kUUIDStringSize + 2);
+        out_[pos] = '"';
+        id.ToChars(out_.data() + pos + 1);
+        out_.back() = '"';
+    }
+
+    std::string& out_;
+};
+
+}  // namespace server
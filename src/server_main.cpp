@@ -0,0 +1,134 @@
+#include <boost/asio/signal_set.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "app/catalog_use_cases.h"
+#include "app/identity_map_unit_of_work.h"
+#include "app/purge_worker.h"
+#include "app/use_cases_impl.h"
+#include "postgres/sharded_database.h"
+#include "server/api_handler.h"
+#include "server/http_server.h"
+
+using namespace std::literals;
+namespace net = boost::asio;
+
+namespace {
+
+constexpr const char DB_URL_ENV_NAME[]{"BOOKYPEDIA_DB_URL"};
+constexpr const char DB_SHARD_URLS_ENV_NAME[]{"BOOKYPEDIA_DB_SHARD_URLS"};
+constexpr const char DB_REPLICA_URLS_ENV_NAME[]{"BOOKYPEDIA_DB_REPLICA_URLS"};
+constexpr const char DB_REPLICA_ROUTING_ENV_NAME[]{"BOOKYPEDIA_DB_REPLICA_ROUTING"};
+constexpr const char DB_READ_YOUR_WRITES_ENV_NAME[]{"BOOKYPEDIA_DB_READ_YOUR_WRITES"};
+constexpr const char HTTP_PORT_ENV_NAME[]{"BOOKYPEDIA_HTTP_PORT"};
+constexpr const char HTTP_THREADS_ENV_NAME[]{"BOOKYPEDIA_HTTP_THREADS"};
+constexpr const char DB_POOL_SIZE_ENV_NAME[]{"BOOKYPEDIA_DB_POOL_SIZE"};
+constexpr const char CATALOG_CACHE_ENV_NAME[]{"BOOKYPEDIA_CATALOG_CACHE"};
+constexpr const char PURGE_BATCH_SIZE_ENV_NAME[]{"BOOKYPEDIA_PURGE_BATCH_SIZE"};
+constexpr const char PURGE_PAUSE_ENV_NAME[]{"BOOKYPEDIA_PURGE_PAUSE_MS"};
+
+struct ServerConfig {
+    std::string db_url;
+    postgres::ReplicaConfig db_replicas;
+    std::vector<std::string> db_shard_urls;
+    unsigned short port = 8080;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    // Обработчики выполняют запросы к базе синхронно, поэтому по умолчанию
+    // соединений столько же, сколько рабочих потоков
+    std::size_t db_pool_size = 0;
+    // Читать списки авторов и книг из снимка каталога в памяти (см. app::CatalogUseCases)
+    bool catalog_cache = false;
+    app::PurgeSettings purge;
+};
+
+ServerConfig GetConfigFromEnv() {
+    ServerConfig config;
+    if (const auto* url = std::getenv(DB_URL_ENV_NAME)) {
+        config.db_url = url;
+    } else {
+        throw std::runtime_error(DB_URL_ENV_NAME + " environment variable not found"s);
+    }
+    if (const auto* urls = std::getenv(DB_SHARD_URLS_ENV_NAME)) {
+        config.db_shard_urls = postgres::ParseUrlList(urls);
+    }
+    if (const auto* urls = std::getenv(DB_REPLICA_URLS_ENV_NAME)) {
+        config.db_replicas.urls = postgres::ParseUrlList(urls);
+    }
+    if (const auto* routing = std::getenv(DB_REPLICA_ROUTING_ENV_NAME)) {
+        config.db_replicas.routing = postgres::ParseReplicaRouting(routing);
+    }
+    if (const auto* read_your_writes = std::getenv(DB_READ_YOUR_WRITES_ENV_NAME)) {
+        config.db_replicas.read_your_writes = read_your_writes != "0"sv;
+    }
+    if (const auto* port = std::getenv(HTTP_PORT_ENV_NAME)) {
+        config.port = static_cast<unsigned short>(std::stoul(port));
+    }
+    if (const auto* threads = std::getenv(HTTP_THREADS_ENV_NAME)) {
+        config.threads = std::max(1ul, std::stoul(threads));
+    }
+    if (const auto* pool_size = std::getenv(DB_POOL_SIZE_ENV_NAME)) {
+        config.db_pool_size = std::stoul(pool_size);
+    }
+    if (const auto* catalog_cache = std::getenv(CATALOG_CACHE_ENV_NAME)) {
+        config.catalog_cache = catalog_cache == "1"sv;
+    }
+    if (const auto* batch_size = std::getenv(PURGE_BATCH_SIZE_ENV_NAME)) {
+        config.purge.batch_size = std::max<std::size_t>(1, std::stoul(batch_size));
+    }
+    if (const auto* pause = std::getenv(PURGE_PAUSE_ENV_NAME)) {
+        config.purge.batch_pause = std::chrono::milliseconds{std::stoll(pause)};
+    }
+    if (config.db_pool_size == 0) {
+        config.db_pool_size = config.threads;
+    }
+    return config;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        const ServerConfig config = GetConfigFromEnv();
+
+        postgres::ShardedDatabase db{config.db_url, config.db_shard_urls, config.db_pool_size, {}, config.db_replicas};
+        app::IdentityMapUnitOfWorkFactory identity_map{db.GetUnitOfWorkFactory()};
+        app::UseCasesImpl use_cases_impl{identity_map};
+        std::optional<app::CatalogUseCases> catalog;
+        if (config.catalog_cache) {
+            catalog.emplace(use_cases_impl);
+        }
+        app::UseCases& use_cases = catalog ? static_cast<app::UseCases&>(*catalog) : use_cases_impl;
+        app::PurgeWorker purge_worker{db.GetUnitOfWorkFactory(), config.purge};
+
+        net::io_context ioc(static_cast<int>(config.threads));
+        net::signal_set signals(ioc, SIGINT, SIGTERM);
+        signals.async_wait([&ioc](const boost::system::error_code& ec, [[maybe_unused]] int signal_number) {
+            if (!ec) {
+                ioc.stop();
+            }
+        });
+
+        server::ServeHttp(ioc, {net::ip::make_address("0.0.0.0"), config.port}, server::ApiHandler{use_cases});
+        std::cout << "Server has started on port "sv << config.port << " with "sv << config.threads
+                  << " threads and "sv << config.db_pool_size << " database connections"sv << std::endl;
+
+        std::vector<std::thread> workers;
+        workers.reserve(config.threads - 1);
+        for (unsigned i = 1; i < config.threads; ++i) {
+            workers.emplace_back([&ioc] { ioc.run(); });
+        }
+        ioc.run();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+// Сверяет сводные счётчики статистики с полным пересчётом по книгам и тегам, ищет теги без книг
+// и книги, записанные в несколько секций, и, с --rebuild, пересчитывает счётчики заново.
+// Код возврата ненулевой, если расхождения остались.
+//
+// Использование: BOOKYPEDIA_DB_URL=... [BOOKYPEDIA_DB_SHARD_URLS="url1;url2"] bookypedia-stats [--rebuild]
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "app/unit_of_work.h"
+#include "domain/statistics.h"
+#include "postgres/sharded_database.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr const char DB_URL_ENV_NAME[]{"BOOKYPEDIA_DB_URL"};
+constexpr const char DB_SHARD_URLS_ENV_NAME[]{"BOOKYPEDIA_DB_SHARD_URLS"};
+
+domain::StatisticsDrift Verify(app::UnitOfWorkFactory& factory) {
+    std::unique_ptr<app::UnitOfWork> uow = factory.CreateUnitOfWork();
+    const domain::StatisticsDrift drift = uow->GetStatisticsRepository().Verify();
+    uow->Commit();
+    std::cout << "Mismatched counters: authors="sv << drift.authors << " tags="sv << drift.tags << " years="sv
+              << drift.years << " totals="sv << drift.totals << std::endl;
+    std::cout << "Broken links: orphan tags="sv << drift.orphan_tags << " duplicate books="sv << drift.duplicate_books
+              << std::endl;
+    return drift;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        const char* url = std::getenv(DB_URL_ENV_NAME);
+        if (url == nullptr) {
+            throw std::runtime_error(DB_URL_ENV_NAME + " environment variable not found"s);
+        }
+        std::vector<std::string> shard_urls;
+        if (const char* urls = std::getenv(DB_SHARD_URLS_ENV_NAME)) {
+            shard_urls = postgres::ParseUrlList(urls);
+        }
+        bool rebuild = false;
+        for (int i = 1; i < argc; ++i) {
+            if (argv[i] == "--rebuild"sv) {
+                rebuild = true;
+            } else {
+                throw std::invalid_argument("Unknown argument: "s + argv[i]);
+            }
+        }
+
+        postgres::ShardedDatabase db{url, shard_urls};
+        app::UnitOfWorkFactory& factory = db.GetUnitOfWorkFactory();
+        domain::StatisticsDrift drift = Verify(factory);
+        if (rebuild) {
+            std::unique_ptr<app::UnitOfWork> uow = factory.CreateUnitOfWork();
+            uow->GetStatisticsRepository().Rebuild();
+            uow->Commit();
+            std::cout << "Rebuilt"sv << std::endl;
+            drift = Verify(factory);
+        }
+        if (!drift.Empty()) {
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
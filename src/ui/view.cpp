@@ -1,132 +1,235 @@
 #include "view.h"
 
 #include <algorithm>
-#include <boost/algorithm/string/join.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <cassert>
 #include <cstddef>
-#include <functional>
 #include <iostream>
-#include <iterator>
+#include <limits>
 #include <optional>
 #include <ostream>
-#include <sstream>
 #include <stdexcept>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <variant>
 #include <vector>
 
 #include "../app/use_cases.h"
 #include "../domain/author.h"
 #include "../domain/book.h"
+#include "../domain/author_rows.h"
+#include "../domain/book_rows.h"
+#include "../domain/search.h"
+#include "../domain/statistics.h"
 #include "../menu/menu.h"
+#include "../util/string_util.h"
 #include "../util/visit_util.h"
 
 using namespace std::literals;
-namespace ph = std::placeholders;
 
 namespace ui {
-namespace detail {
+namespace {
 
-std::ostream& operator<<(std::ostream& out, const AuthorInfo& author) {
-    out << author.name;
-    return out;
+template <typename Tags>
+void PrintTags(std::ostream& out, const Tags& tags) {
+    for (std::size_t i = 0; i < tags.size(); ++i) {
+        out << tags[i] << (tags.size() == i + 1 ? ""sv : ", "sv);
+    }
 }
 
-std::ostream& operator<<(std::ostream& out, const BookInfoByAuthor& book) {
-    out << book.title << ", " << book.publication_year;
-    return out;
+// UseCases принимает теги как std::string: строки копируются из арены только здесь,
+// на границе с use case, а буфер самого вектора по-прежнему берётся из арены
+std::pmr::vector<std::string> ToUseCaseTags(const detail::Tags& tags) {
+    std::pmr::vector<std::string> result{tags.get_allocator()};
+    result.reserve(tags.size());
+    for (const std::pmr::string& tag : tags) {
+        result.emplace_back(tag);
+    }
+    return result;
 }
 
-std::ostream& operator<<(std::ostream& out, const BookInfoWithAuthor& book) {
-    out << book.title << " by " << book.author_name << ", " << book.publication_year;
-    return out;
+void PrintBook(std::ostream& out, const domain::Book& book) {
+    out << "Title: "sv << book.GetTitle() << '\n';
+    out << "Author: "sv << book.GetAuthorName().value_or(""s) << '\n';
+    out << "Publication year: "sv << book.GetPublicationYear();
+    if (!book.GetTags().empty()) {
+        out << "\nTags: "sv;
+        PrintTags(out, book.GetTags());
+    }
+    out << std::endl;
 }
 
-std::string GetTagsPrintable(const std::vector<std::string>& tags) {
-    std::ostringstream ss;
-    for (std::size_t i = 0; i < tags.size(); ++i) {
-        ss << tags[i] << (tags.size() == i + 1 ? "" : ", ");
-    }
-    return ss.str();
+void PrintBookLine(std::ostream& out, int index, const domain::BookRow book) {
+    out << index << ' ' << book.GetTitle() << " by "sv << book.GetAuthorName() << ", "sv
+        << book.GetPublicationYear() << '\n';
 }
 
-std::ostream& operator<<(std::ostream& out, const BookInfoCompletely& book) {
-    out << "Title: " << book.title << std::endl;
-    out << "Author: " << book.author_name << std::endl;
-    out << "Publication year: " << book.publication_year;
-    if (!book.tags.empty()) {
-        out << "\nTags: ";
-        out << GetTagsPrintable(book.tags);
+void PrintBookLine(std::ostream& out, int index, const domain::Book& book) {
+    out << index << ' ' << book.GetTitle() << " by "sv;
+    if (const std::optional<std::string>& author_name = book.GetAuthorName()) {
+        out << *author_name;
     }
-    return out;
+    out << ", "sv << book.GetPublicationYear() << '\n';
 }
 
-}  // namespace detail
+template <typename Books>
+void PrintBookList(std::ostream& out, const Books& books, std::size_t limit = std::numeric_limits<std::size_t>::max()) {
+    int i = 1;
+    for (const auto& book : books) {
+        if (static_cast<std::size_t>(i) > limit) {
+            break;
+        }
+        PrintBookLine(out, i++, book);
+    }
+    out.flush();
+}
 
-template <typename T>
-void PrintVector(std::ostream& out, const std::vector<T>& vector) {
+void PrintAuthorList(std::ostream& out, const domain::AuthorRows& authors,
+                     std::size_t limit = std::numeric_limits<std::size_t>::max()) {
     int i = 1;
-    for (const T& value : vector) {
-        out << i++ << " " << value << std::endl;
+    for (const domain::AuthorRow author : authors) {
+        if (static_cast<std::size_t>(i) > limit) {
+            break;
+        }
+        out << i++ << ' ' << author.GetName() << '\n';
     }
+    out.flush();
 }
 
-View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output)
-    : menu_{menu}, use_cases_{use_cases}, input_{input}, output_{output} {
-    menu_.AddAction("AddAuthor"s, "<name>"s, "Adds author"s, std::bind(&View::AddAuthor, this, ph::_1));
-    menu_.AddAction("AddBook"s, "<pub year> <title>"s, "Adds book"s, std::bind(&View::AddBook, this, ph::_1));
-    menu_.AddAction("ShowAuthors"s, {}, "Show authors"s, std::bind(&View::ShowAuthors, this));
-    menu_.AddAction("ShowBooks"s, {}, "Show books"s, std::bind(&View::ShowBooks, this));
-    menu_.AddAction("ShowAuthorBooks"s, {}, "Show author books"s, std::bind(&View::ShowAuthorBooks, this));
-    menu_.AddAction("DeleteAuthor"s, "<name>"s, "Delete author"s, std::bind(&View::DeleteAuthorWithName, this, ph::_1));
-    menu_.AddAction("EditAuthor"s, "<name>"s, "Edit author"s, std::bind(&View::EditAuthorWithName, this, ph::_1));
-    menu_.AddAction("ShowBook"s, "<title>"s, "Show book"s, std::bind(&View::ShowBookWithTitle, this, ph::_1));
-    menu_.AddAction("DeleteBook"s, "<title>"s, "Delete book"s, std::bind(&View::DeleteBookWithTitle, this, ph::_1));
-    menu_.AddAction("EditBook"s, "<title>"s, "Edit book"s,std::bind(&View::EditBookWithTitle, this, ph::_1));
+// Авторов и тегов в статистике, если число не задано командой
+constexpr int kDefaultStatisticsTop = 10;
+
+void PrintStatistics(std::ostream& out, const domain::CatalogStatistics& statistics) {
+    out << "Authors: "sv << statistics.totals.authors << ", books: "sv << statistics.totals.books
+        << ", tags: "sv << statistics.totals.tags << '\n';
+    out << "Top authors:\n"sv;
+    int i = 1;
+    for (const domain::AuthorBookCount& author : statistics.top_authors) {
+        out << i++ << ' ' << author.name << ", "sv << author.books << " books\n"sv;
+    }
+    out << "Top tags:\n"sv;
+    i = 1;
+    for (const domain::TagBookCount& tag : statistics.top_tags) {
+        out << i++ << ' ' << tag.tag << ", "sv << tag.books << " books\n"sv;
+    }
+    out << "Books by year:\n"sv;
+    for (const domain::YearBookCount& year : statistics.books_per_year) {
+        out << year.publication_year << ": "sv << year.books << '\n';
+    }
+    out.flush();
+}
+
+// Подсказок в CompleteTag
+constexpr std::size_t kCompleteTagLimit = 10;
+
+// Совпадений в FuzzyFind
+constexpr std::size_t kFuzzyFindLimit = 10;
+
+// Строк в списке выбора автора или книги. Запрашивается на одну больше:
+// лишняя строка означает, что совпадений больше, чем показано
+constexpr std::size_t kPickerLimit = 20;
+
+}  // namespace
+
+View::View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output,
+           bool use_arena)
+    : menu_{menu}
+    , use_cases_{use_cases}
+    , input_{input}
+    , output_{output}
+    , memory_{use_arena ? static_cast<std::pmr::memory_resource*>(&arena_) : std::pmr::new_delete_resource()} {
+    AddAction("AddAuthor"s, "<name>"s, "Adds author"s, [this](std::string_view name) {
+        return AddAuthor(name);
+    });
+    AddAction("AddBook"s, "<pub year> <title>"s, "Adds book"s, [this](std::string_view args) {
+        return AddBook(args);
+    });
+    AddAction("ShowAuthors"s, {}, "Show authors"s, [this](std::string_view) {
+        return ShowAuthors();
+    });
+    AddAction("ShowBooks"s, {}, "Show books"s, [this](std::string_view) {
+        return ShowBooks();
+    });
+    AddAction("ShowBooksByYears"s, "<from> <to>"s, "Show books published in years from..to"s, [this](std::string_view args) {
+        return ShowBooksByYears(args);
+    });
+    AddAction("ShowStatistics"s, "[top]"s, "Show catalog totals, top authors and tags, books by year"s, [this](std::string_view args) {
+        return ShowStatistics(args);
+    });
+    AddAction("CompleteTag"s, "<prefix>"s, "Show most used tags starting with prefix"s, [this](std::string_view prefix) {
+        return CompleteTag(prefix);
+    });
+    AddAction("FuzzyFind"s, "<text>"s, "Find authors and books with similar names"s, [this](std::string_view text) {
+        return FuzzyFind(text);
+    });
+    AddAction("ShowAuthorBooks"s, {}, "Show author books"s, [this](std::string_view) {
+        return ShowAuthorBooks();
+    });
+    AddAction("DeleteAuthor"s, "<name>"s, "Delete author"s, [this](std::string_view name) {
+        return DeleteAuthorWithName(name);
+    });
+    AddAction("EditAuthor"s, "<name>"s, "Edit author"s, [this](std::string_view name) {
+        return EditAuthorWithName(name);
+    });
+    AddAction("ShowBook"s, "<title>"s, "Show book"s, [this](std::string_view title) {
+        return ShowBookWithTitle(title);
+    });
+    AddAction("DeleteBook"s, "<title>"s, "Delete book"s, [this](std::string_view title) {
+        return DeleteBookWithTitle(title);
+    });
+    AddAction("EditBook"s, "<title>"s, "Edit book"s, [this](std::string_view title) {
+        return EditBookWithTitle(title);
+    });
+}
+
+template <typename Fn>
+void View::AddAction(std::string name, std::string args, std::string description, Fn fn) {
+    menu_.AddAction(std::move(name), std::move(args), std::move(description), [this, fn](std::string_view command_args) {
+        // Освобождение выполняется и при выходе по исключению: память команды не переживает её
+        struct ArenaRelease {
+            std::pmr::monotonic_buffer_resource& arena;
+
+            ~ArenaRelease() {
+                arena.release();
+            }
+        } release{arena_};
+        return fn(command_args);
+    });
 }
 
-bool View::AddAuthor(std::istream& cmd_input) const {
+bool View::AddAuthor(std::string_view name) const {
     try {
-        std::string name;
-        std::getline(cmd_input, name);
-        boost::algorithm::trim(name);
-
         if (name.empty()) {
             throw std::logic_error("Empty name is not allowed"s);
         }
 
-        if (std::optional<ui::detail::AuthorInfo> author = GetAuthorByName(name)) {
+        if (use_cases_.GetAuthorByName(name)) {
             throw std::runtime_error("This author has been added before"s);
         }
 
-        use_cases_.AddAuthor(std::move(name));
+        use_cases_.AddAuthor(std::string{name});
     } catch (const std::exception& ) {
         output_ << "Failed to add author"sv << std::endl;
     }
     return true;
 }
 
-bool View::AddBook(std::istream& cmd_input) const {
+bool View::AddBook(std::string_view args) const {
     try {
-        if (std::optional<ui::detail::AddBookParams> params = GetBookParams(cmd_input)) {
+        if (std::optional<ui::detail::AddBookParams> params = GetBookParams(args)) {
             std::visit(util::overload{
                 [this](detail::AddBookParamsWithAuthorId& p) {
                     use_cases_.AddBookByAuthorId(
-                        domain::AuthorId::FromString(p.author_id),
-                        p.title,
+                        p.author_id,
+                        std::move(p.title),
                         p.publication_year,
-                        p.tags
-                );
+                        ToUseCaseTags(p.tags)
+                    );
                 },
                 [this](detail::AddBookParamsWithAuthorName& p) {
                     use_cases_.AddBookByAuthorName(
-                        p.author_name,
-                        p.title,
+                        std::move(p.author_name),
+                        std::move(p.title),
                         p.publication_year,
-                        p.tags
+                        ToUseCaseTags(p.tags)
                     );
                 },
             },
@@ -139,20 +242,87 @@ bool View::AddBook(std::istream& cmd_input) const {
 }
 
 bool View::ShowAuthors() const {
-    PrintVector(output_, GetAuthors());
+    PrintAuthorList(output_, use_cases_.GetAllAuthors());
     return true;
 }
 
 bool View::ShowBooks() const {
-    PrintVector(output_, GetBooks());
+    // Строки печатаются прямо из буфера результата запроса
+    PrintBookList(output_, use_cases_.GetAllBooks());
+    return true;
+}
+
+bool View::ShowBooksByYears(std::string_view args) const {
+    const auto [from_str, to_str] = util::SplitFirstWord(args);
+    const std::optional<int> from = util::ParseInt(from_str);
+    const std::optional<int> to = util::ParseInt(to_str);
+    if (!from || !to || *from > *to) {
+        output_ << "Invalid year range"sv << std::endl;
+        return true;
+    }
+    PrintBookList(output_, use_cases_.GetBooksByYearRange(*from, *to));
+    return true;
+}
+
+bool View::ShowStatistics(std::string_view args) const {
+    const std::optional<int> top = util::Trim(args).empty() ? kDefaultStatisticsTop : util::ParseInt(args);
+    if (!top || *top <= 0) {
+        output_ << "Invalid number of top entries"sv << std::endl;
+        return true;
+    }
+    PrintStatistics(output_, use_cases_.GetStatistics(static_cast<std::size_t>(*top)));
+    return true;
+}
+
+bool View::CompleteTag(std::string_view prefix) const {
+    // Префикс приводится к виду, в котором теги хранятся
+    const std::vector<domain::TagBookCount> tags = use_cases_.CompleteTag(
+        util::NormalizeTag<std::pmr::string>(prefix, memory_), kCompleteTagLimit
+    );
+    if (tags.empty()) {
+        output_ << "No tags found"sv << std::endl;
+        return true;
+    }
+    int i = 1;
+    for (const domain::TagBookCount& tag : tags) {
+        output_ << i++ << ' ' << tag.tag << ", "sv << tag.books << " books\n"sv;
+    }
+    output_.flush();
+    return true;
+}
+
+bool View::FuzzyFind(std::string_view text) const {
+    const std::vector<domain::FuzzyMatch> matches = use_cases_.FuzzyFind(text, kFuzzyFindLimit);
+    int i = 1;
+    for (const domain::FuzzyMatch& match : matches) {
+        std::visit(util::overload{
+            [this, &i, &match](const domain::AuthorId&) {
+                output_ << i++ << ' ' << match.text << " (author)\n"sv;
+            },
+            [this, &i, &match](const domain::BookId&) {
+                // Автор и год приходят вместе с совпадением: книги не перечитываются из хранилища
+                output_ << i++ << ' ' << match.text << " by "sv << match.author_name << ", "sv
+                        << match.publication_year << '\n';
+            },
+        }, match.id);
+    }
+    if (i == 1) {
+        output_ << "Nothing found"sv << std::endl;
+        return true;
+    }
+    output_.flush();
     return true;
 }
 
 bool View::ShowAuthorBooks() const {
     // TODO: handle error
     try {
-        if (std::optional<std::string> author_id = SelectAuthor()) {
-            PrintVector(output_, GetAuthorBooks(*author_id));
+        if (std::optional<domain::AuthorId> author_id = SelectAuthor()) {
+            int i = 1;
+            for (const domain::BookRow book : use_cases_.GetBooksByAuthorId(*author_id)) {
+                output_ << i++ << ' ' << book.GetTitle() << ", "sv << book.GetPublicationYear() << '\n';
+            }
+            output_.flush();
         }
     } catch (const std::exception& ) {
         throw std::runtime_error("Failed to Show Books");
@@ -162,29 +332,25 @@ bool View::ShowAuthorBooks() const {
 
 bool View::DeleteAuthor() const {
     try {
-        if (std::optional<std::string> author_id = SelectAuthor()) {
-            if (!use_cases_.DeleteAuthor(domain::AuthorId::FromString(*author_id))) {
+        if (std::optional<domain::AuthorId> author_id = SelectAuthor()) {
+            if (!use_cases_.DeleteAuthor(*author_id)) {
                 throw std::logic_error("This author doesn't exist in the database"s);
             }
         }
     } catch (const std::exception& err) {
-        output_ << "Failed to delete author"s << std::endl;
+        output_ << "Failed to delete author"sv << std::endl;
     }
     return true;
 }
 
-bool View::DeleteAuthorWithName(std::istream& cmd_input) const {
-    std::string name;
-    std::getline(cmd_input, name);
-    boost::algorithm::trim(name);
-
+bool View::DeleteAuthorWithName(std::string_view name) const {
     if (name.empty()) {
         return DeleteAuthor();
     }
 
     try {
-        if (std::optional<ui::detail::AuthorInfo> author = GetAuthorByName(name)) {
-            if (!use_cases_.DeleteAuthor(domain::AuthorId::FromString(author->id))) {
+        if (std::optional<domain::Author> author = use_cases_.GetAuthorByName(name)) {
+            if (!use_cases_.DeleteAuthor(author->GetId())) {
                 throw std::logic_error("This author doesn't exist in the database"s);
             }
         } else {
@@ -192,16 +358,16 @@ bool View::DeleteAuthorWithName(std::istream& cmd_input) const {
         }
 
     } catch (const std::exception& err) {
-        output_ << "Failed to delete author"s << std::endl;
+        output_ << "Failed to delete author"sv << std::endl;
     }
     return true;
 }
 
 bool View::EditAuthor() const {
     try {
-        if (std::optional<std::string> author_id = SelectAuthor()) {
-            if (std::optional<std::string> new_name = EnterAuthorName("Enter new name:"s)) {
-                if (!use_cases_.EditAuthor(domain::AuthorId::FromString(*author_id), *new_name)) {
+        if (std::optional<domain::AuthorId> author_id = SelectAuthor()) {
+            if (std::optional<std::string> new_name = EnterAuthorName("Enter new name:"sv)) {
+                if (!use_cases_.EditAuthor(*author_id, *new_name)) {
                     throw std::runtime_error(""s);
                 }
             } else {
@@ -214,18 +380,14 @@ bool View::EditAuthor() const {
     return true;
 }
 
-bool View::EditAuthorWithName(std::istream& cmd_input) const {
-    std::string name;
-    std::getline(cmd_input, name);
-    boost::algorithm::trim(name);
-
+bool View::EditAuthorWithName(std::string_view name) const {
     if (name.empty()) {
         return EditAuthor();
     }
 
     try {
         if (std::optional<domain::Author> author = use_cases_.GetAuthorByName(name)) {
-            if (std::optional<std::string> new_name = EnterAuthorName("Enter new name:")) {
+            if (std::optional<std::string> new_name = EnterAuthorName("Enter new name:"sv)) {
                 if (!use_cases_.EditAuthor(author->GetId(), *new_name)) {
                     throw std::runtime_error(""s);
                 }
@@ -244,8 +406,8 @@ bool View::EditAuthorWithName(std::istream& cmd_input) const {
 
 bool View::ShowBook() const {
     try {
-        if (const std::optional<std::string> book_id = SelectBook(GetBooks())) {
-            output_ << *GetBookById(*book_id) << std::endl;
+        if (const std::optional<domain::BookId> book_id = SelectBook()) {
+            PrintBook(output_, use_cases_.GetBook(*book_id).value());
         }
     } catch (const std::exception& ) {
         throw std::runtime_error("Failed to Show Book");
@@ -253,25 +415,15 @@ bool View::ShowBook() const {
     return true;
 }
 
-bool View::ShowBookWithTitle(std::istream& cmd_input) const {
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
-
+bool View::ShowBookWithTitle(std::string_view title) const {
     if (title.empty()) {
         return ShowBook();
     }
 
     try {
-        const std::vector<ui::detail::BookInfoWithAuthor> books = GetBooksByTitle(title);
-        if (books.size() == 1) {
-            output_ << *GetBookById(books.front().id) << std::endl;
-        } else if (books.size() > 1) {
-            if (const std::optional<std::string> book_id = SelectBook(books)) {
-                output_ << *GetBookById(*book_id) << std::endl;
-            }
+        if (const std::optional<domain::BookId> book_id = SelectBookByTitle(title)) {
+            PrintBook(output_, use_cases_.GetBook(*book_id).value());
         }
-
     } catch (const std::exception& ) {
         throw std::runtime_error("Failed to Show Book");
     }
@@ -280,70 +432,45 @@ bool View::ShowBookWithTitle(std::istream& cmd_input) const {
 
 bool View::DeleteBook() const {
     try {
-        if (const std::optional<std::string> book_id = SelectBook(GetBooks())) {
-            if (!use_cases_.DeleteBook(domain::BookId::FromString(*book_id))) {
+        if (const std::optional<domain::BookId> book_id = SelectBook()) {
+            if (!use_cases_.DeleteBook(*book_id)) {
                 throw std::logic_error("This book doesn't exist in the database"s);
             }
         }
     } catch (const std::exception& err) {
-        output_ << "Book not found"s << std::endl;
+        output_ << "Book not found"sv << std::endl;
     }
     return true;
 }
 
-bool View::DeleteBookWithTitle(std::istream& cmd_input) const {
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
-
+bool View::DeleteBookWithTitle(std::string_view title) const {
     if (title.empty()) {
         return DeleteBook();
     }
 
     try {
-        const std::vector<ui::detail::BookInfoWithAuthor>& books = GetBooksByTitle(title);
+        const std::vector<domain::Book> books = use_cases_.GetBooksByTitle(title);
         if (books.empty()) {
             throw std::logic_error("This book doesn't exist in the database"s);
-        } else if (books.size() == 1) {
-            if (!use_cases_.DeleteBook(domain::BookId::FromString(books.front().id))) {
+        }
+        if (const std::optional<domain::BookId> book_id
+                = books.size() == 1 ? books.front().GetId() : SelectBook(books)) {
+            if (!use_cases_.DeleteBook(*book_id)) {
                 throw std::logic_error("This book doesn't exist in the database"s);
             }
-        } else {
-            if (const std::optional<std::string> book_id = SelectBook(books)) {
-                if (!use_cases_.DeleteBook(domain::BookId::FromString(*book_id))) {
-                    throw std::logic_error("This book doesn't exist in the database"s);
-                }
-            }
         }
 
     } catch (const std::exception& err) {
-        output_ << "Book not found"s << std::endl;
+        output_ << "Book not found"sv << std::endl;
     }
     return true;
 }
 
 bool View::EditBook() const {
     try {
-        if (const std::optional<std::string> book_id = SelectBook(GetBooks())) {
-            if (const std::optional<ui::detail::BookInfoCompletely> book = GetBookById(*book_id)) {
-                ui::detail::EditBookParams params = GetBookParamsForEdit(*book);
-
-                if (!params.title.has_value()) {
-                    params.title = book->title;
-                }
-
-                if (!params.publication_year.has_value()) {
-                    params.publication_year = book->publication_year;
-                }
-
-                if (!use_cases_.EditBook(
-                    domain::BookId::FromString(book->id),
-                    *params.title,
-                    *params.publication_year,
-                    params.tags
-                )) {
-                    throw std::runtime_error(""s);
-                }
+        if (const std::optional<domain::BookId> book_id = SelectBook()) {
+            if (!EditSelectedBook(*book_id)) {
+                throw std::runtime_error(""s);
             }
         } else {
             throw std::runtime_error(""s);
@@ -354,346 +481,242 @@ bool View::EditBook() const {
     return true;
 }
 
-bool View::EditBookWithTitle(std::istream& cmd_input) const {
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
-
+bool View::EditBookWithTitle(std::string_view title) const {
     if (title.empty()) {
         return EditBook();
     }
 
     try {
-        const std::vector<ui::detail::BookInfoWithAuthor>& books = GetBooksByTitle(title);
-        detail::BookInfoCompletely edit_book;
-        if (books.empty()) {
-            throw std::logic_error("This book doesn't exist in the database"s);
-        } else if (books.size() == 1) {
-            edit_book = *GetBookById(books.front().id);
-        } else {
-            if (const std::optional<std::string>& book_id = SelectBook(books)) {
-                edit_book = *GetBookById(*book_id);
-            } else {
+        if (const std::optional<domain::BookId> book_id = SelectBookByTitle(title)) {
+            if (!EditSelectedBook(*book_id)) {
                 throw std::runtime_error(""s);
             }
+        } else {
+            throw std::logic_error("This book doesn't exist in the database"s);
         }
-
-        ui::detail::EditBookParams params = GetBookParamsForEdit(edit_book);
-
-        if (!params.title.has_value()) {
-            params.title = edit_book.title;
-        }
-
-        if (!params.publication_year.has_value()) {
-            params.publication_year = edit_book.publication_year;
-        }
-
-        if (!use_cases_.EditBook(
-            domain::BookId::FromString(edit_book.id),
-            *params.title,
-            *params.publication_year,
-            params.tags
-        )) {
-            throw std::runtime_error(""s);
-        }
-
     } catch (const std::exception& ) {
         output_ << "Book not found"sv << std::endl;
     }
     return true;
 }
 
-std::optional<detail::AddBookParams> View::GetBookParams(std::istream& cmd_input) const {
-    int pub_year = 0;
-    cmd_input >> pub_year;
+bool View::EditSelectedBook(const domain::BookId& book_id) const {
+    const std::optional<domain::Book> book = use_cases_.GetBook(book_id);
+    if (!book) {
+        return false;
+    }
 
-    std::string title;
-    std::getline(cmd_input, title);
-    boost::algorithm::trim(title);
+    const detail::EditBookParams params = GetBookParamsForEdit(*book);
+    return use_cases_.EditBook(
+        book->GetId(),
+        params.title ? std::string_view{*params.title} : std::string_view{book->GetTitle()},
+        params.publication_year.value_or(book->GetPublicationYear()),
+        ToUseCaseTags(params.tags)
+    ).has_value();
+}
 
-    if (title.empty()) {
+std::optional<detail::AddBookParams> View::GetBookParams(std::string_view args) const {
+    const auto [pub_year_str, title_view] = util::SplitFirstWord(args);
+    const std::optional<int> pub_year = util::ParseInt(pub_year_str);
+    if (!pub_year) {
+        throw std::logic_error("Invalid publication year"s);
+    }
+    if (title_view.empty()) {
         throw std::logic_error("Empty title is not allowed"s);
     }
 
-    std::string author_id_par, author_name_par;
-    if (const std::optional<std::string>& author_name = EnterAuthorName(
-            "Enter author name or empty line to select from list:"s)) {
-        if (std::optional<ui::detail::AuthorInfo> author = GetAuthorByName(*author_name)) {
-            author_id_par = author->id;
-        } else {
-            if (OfferToAddAuthor(*author_name)) {
-                author_name_par = *author_name;
-            } else {
-                throw std::runtime_error(""s);
-            }
+    std::optional<domain::AuthorId> author_id;
+    std::optional<std::string> author_name = EnterAuthorName("Enter author name or empty line to select from list:"sv);
+    if (author_name) {
+        if (std::optional<domain::Author> author = use_cases_.GetAuthorByName(*author_name)) {
+            author_id = author->GetId();
+        } else if (!OfferToAddAuthor(*author_name)) {
+            throw std::runtime_error(""s);
         }
     } else {
-        std::optional<std::string> author_id = SelectAuthor();
-        if (not author_id.has_value())
+        author_id = SelectAuthor();
+        if (!author_id) {
             return std::nullopt;
-        else {
-            author_id_par = *author_id;
         }
     }
 
-    std::vector<std::string> tags = EnterBookTags("Enter tags (comma separated):");
+    detail::Tags tags = EnterBookTags("Enter tags (comma separated):"sv);
 
-    if (author_name_par.empty() && !author_id_par.empty()) {
-        return detail::AddBookParamsWithAuthorId{title, author_id_par, tags, pub_year};
-    } else if (!author_name_par.empty() && author_id_par.empty()) {
-        return detail::AddBookParamsWithAuthorName{title, author_name_par, tags, pub_year};
+    if (author_id) {
+        return detail::AddBookParamsWithAuthorId{std::string{title_view}, *author_id, std::move(tags), *pub_year};
     }
-    return std::nullopt;
+    return detail::AddBookParamsWithAuthorName{std::string{title_view}, std::move(*author_name), std::move(tags), *pub_year};
 }
 
-detail::EditBookParams View::GetBookParamsForEdit(const detail::BookInfoCompletely& book) const {
-    detail::EditBookParams params;
+detail::EditBookParams View::GetBookParamsForEdit(const domain::Book& book) const {
+    detail::EditBookParams params{memory_};
 
-    if (std::optional<std::string> new_title = EnterTitle(
-        "Enter new title or empty line to use the current one ("s + book.title + "):"s
-    )) {
-        params.title = *new_title;
-    }
+    output_ << "Enter new title or empty line to use the current one ("sv << book.GetTitle() << "):"sv << std::endl;
+    params.title = ReadTitle();
 
-    if (std::optional<int> new_pub_year = EnterPubYear(
-        "Enter publication year or empty line to use the current one ("s + 
-        std::to_string(book.publication_year) + "):"s
-    )) {
-        params.publication_year = *new_pub_year;
-    }
+    output_ << "Enter publication year or empty line to use the current one ("sv
+            << book.GetPublicationYear() << "):"sv << std::endl;
+    params.publication_year = ReadPubYear();
 
-    params.tags = EnterBookTags(
-        "Enter tags (current tags: "s + detail::GetTagsPrintable(book.tags) + "):"s
-    );
+    output_ << "Enter tags (current tags: "sv;
+    PrintTags(output_, book.GetTags());
+    output_ << "):"sv << std::endl;
+    params.tags = ReadBookTags();
 
     return params;
 }
 
-std::optional<std::string> View::EnterAuthorName(const std::string& introductory_phrase) const {
+std::optional<std::string> View::EnterAuthorName(std::string_view introductory_phrase) const {
     output_ << introductory_phrase << std::endl;
 
-    std::string name;
-    if (!std::getline(input_, name) || name.empty()) {
+    if (!ReadLine() || line_.empty()) {
         return std::nullopt;
     }
-
-    return name;
+    return line_;
 }
 
-bool View::OfferToAddAuthor(const std::string& author_name) const {
-    output_ << "No author found. Do you want to add " << author_name << " (y/n)?"
+bool View::OfferToAddAuthor(std::string_view author_name) const {
+    output_ << "No author found. Do you want to add "sv << author_name << " (y/n)?"sv
             << std::endl;
 
-    std::string answer;
-    if (!std::getline(input_, answer) || (answer != "y" && answer != "Y")) {
-        return false;
-    }
-    return true;
+    return ReadLine() && (line_ == "y"sv || line_ == "Y"sv);
 }
 
-std::optional<std::string> View::SelectAuthor() const {
-    output_ << "Select author:" << std::endl;
-    const std::vector<ui::detail::AuthorInfo>& authors = GetAuthors();
-    PrintVector(output_, authors);
-    output_ << "Enter author # or empty line to cancel" << std::endl;
-
-    std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
+std::optional<domain::AuthorId> View::SelectAuthor() const {
+    output_ << "Select author:"sv << std::endl;
+    const std::string prefix = EnterPrefix("Enter the beginning of the name or empty line to list the first authors:"sv);
+    const domain::AuthorRows authors = use_cases_.GetAuthorsByNamePrefix(prefix, kPickerLimit + 1);
+    if (authors.Size() == 0) {
+        output_ << "No authors found"sv << std::endl;
         return std::nullopt;
     }
+    const std::size_t shown = std::min(authors.Size(), kPickerLimit);
+    PrintAuthorList(output_, authors, shown);
+    PrintMoreMatches(authors.Size() > shown);
+    output_ << "Enter author # or empty line to cancel"sv << std::endl;
 
-    int author_idx;
-    try {
-        author_idx = std::stoi(str);
-    } catch (std::exception const& ) {
-        throw std::runtime_error("Invalid author num");
-    }
-
-    --author_idx;
-    if (author_idx < 0 or author_idx >= authors.size()) {
-        throw std::runtime_error("Invalid author num");
+    if (const std::optional<std::size_t> index = ReadIndex(shown, "Invalid author num"sv)) {
+        return authors[*index].GetId();
     }
-
-    return authors[author_idx].id;
+    return std::nullopt;
 }
 
-std::vector<std::string> View::EnterBookTags(const std::string& introductory_phrase) const {
+detail::Tags View::EnterBookTags(std::string_view introductory_phrase) const {
     output_ << introductory_phrase << std::endl;
+    return ReadBookTags();
+}
 
-    std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
-        return {};
+detail::Tags View::ReadBookTags() const {
+    detail::Tags tags{memory_};
+    if (!ReadLine() || line_.empty()) {
+        return tags;
     }
 
-    std::vector<std::string> tags;
-    boost::split(tags, str, boost::is_any_of(","));
-
-    auto is_empty = [](const std::string& s) {
-        return s.find_first_not_of(" ") == std::string::npos;
-    };
-    std::erase_if(tags, is_empty);
-
-    for (std::string& tag : tags) {
-        std::istringstream buffer(tag);
-        std::vector<std::string> words{std::istream_iterator<std::string>(buffer),
-                                     std::istream_iterator<std::string>()};
-        tag = boost::algorithm::join(words, " "s);
+    tags.reserve(std::count(line_.begin(), line_.end(), ',') + 1);
+    std::string_view rest = line_;
+    while (!rest.empty()) {
+        const std::size_t comma = rest.find(',');
+        std::pmr::string tag = util::NormalizeTag<std::pmr::string>(rest.substr(0, comma), memory_);
+        if (!tag.empty()) {
+            tags.emplace_back(std::move(tag));
+        }
+        rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
     }
 
-    std::sort(tags.begin(), tags.end());
-    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+    util::SortUniqueTags(tags);
 
     return tags;
 }
 
-std::vector<detail::AuthorInfo> View::GetAuthors() const {
-    const std::vector<domain::Author>& authors = use_cases_.GetAllAuthors();
-
-    std::vector<detail::AuthorInfo> dst_authors;
-    dst_authors.reserve(authors.size());
-
-    std::transform(authors.begin(), authors.end(),
-                 std::inserter(dst_authors, dst_authors.end()),
-                 [](const domain::Author& author) -> detail::AuthorInfo {
-                     return {author.GetId().ToString(), author.GetName()};
-                 });
-
-    return dst_authors;
-}
-
-std::vector<detail::BookInfoWithAuthor> View::GetBooks() const {
-    const std::vector<domain::Book>& books = use_cases_.GetAllBooks();
-
-    std::vector<detail::BookInfoWithAuthor> dst_books;
-    dst_books.reserve(books.size());
-
-    std::transform(
-        books.begin(), books.end(), std::inserter(dst_books, dst_books.end()),
-        [this](const domain::Book& book) -> detail::BookInfoWithAuthor {
-            return {
-                book.GetId().ToString(),
-                book.GetTitle(),
-                *book.GetAuthorName(),
-                book.GetPublicationYear()};
-            });
+std::optional<domain::BookId> View::SelectBook() const {
+    const std::string prefix = EnterPrefix("Enter the beginning of the title or empty line to list the first books:"sv);
+    const domain::BookRows books = use_cases_.GetBooksByTitlePrefix(prefix, kPickerLimit + 1);
+    if (books.Size() == 0) {
+        output_ << "No books found"sv << std::endl;
+        return std::nullopt;
+    }
+    const std::size_t shown = std::min(books.Size(), kPickerLimit);
+    PrintBookList(output_, books, shown);
+    PrintMoreMatches(books.Size() > shown);
+    output_ << "Enter book # or empty line to cancel"sv << std::endl;
 
-    return dst_books;
+    if (const std::optional<std::size_t> index = ReadIndex(shown, "Invalid book num"sv)) {
+        return books[*index].GetId();
+    }
+    return std::nullopt;
 }
 
-std::vector<detail::BookInfoByAuthor> View::GetAuthorBooks(const std::string& author_id) const {
-    const std::vector<domain::Book>& authors_books = use_cases_.GetBooksByAuthorId(domain::AuthorId::FromString(author_id));
-
-    std::vector<detail::BookInfoByAuthor> dst_books;
-    dst_books.reserve(authors_books.size());
-
-    std::transform(
-        authors_books.begin(),
-        authors_books.end(),
-        std::inserter(dst_books, dst_books.end()),
-        [](const domain::Book& book) -> detail::BookInfoByAuthor {
-            return {book.GetTitle(), book.GetPublicationYear()};
-        }
-    );
+std::optional<domain::BookId> View::SelectBook(const std::vector<domain::Book>& books) const {
+    PrintBookList(output_, books);
+    output_ << "Enter book # or empty line to cancel"sv << std::endl;
 
-    return dst_books;
-}
-
-std::optional<detail::AuthorInfo> View::GetAuthorByName(const std::string& name) const {
-    if (const std::optional<domain::Author>& author = use_cases_.GetAuthorByName(name)) {
-        return detail::AuthorInfo{author->GetId().ToString(), author->GetName()};
+    if (const std::optional<std::size_t> index = ReadIndex(books.size(), "Invalid book num"sv)) {
+        return books[*index].GetId();
     }
     return std::nullopt;
 }
 
-std::optional<std::string> View::SelectBook(const std::vector<detail::BookInfoWithAuthor>& books) const {
-    PrintVector(output_, books);
-    output_ << "Enter book # or empty line to cancel" << std::endl;
-
-    std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
+std::optional<domain::BookId> View::SelectBookByTitle(std::string_view title) const {
+    const std::vector<domain::Book> books = use_cases_.GetBooksByTitle(title);
+    if (books.empty()) {
         return std::nullopt;
     }
-
-    int book_idx;
-    try {
-        book_idx = std::stoi(str);
-    } catch (std::exception const& ) {
-        throw std::runtime_error("Invalid book num");
-    }
-
-    --book_idx;
-    if (book_idx < 0 or book_idx >= books.size()) {
-        throw std::runtime_error("Invalid book num");
+    if (books.size() == 1) {
+        return books.front().GetId();
     }
+    return SelectBook(books);
+}
 
-    return books[book_idx].id;
+std::string View::EnterPrefix(std::string_view introductory_phrase) const {
+    output_ << introductory_phrase << std::endl;
+    ReadLine();
+    return std::string{util::Trim(line_)};
 }
 
-std::optional<detail::BookInfoCompletely> View::GetBookById(const std::string& book_id) const {
-    if (const std::optional<domain::Book> book = use_cases_.GetBook(domain::BookId::FromString(book_id))) {
-        return detail::BookInfoCompletely{
-            book->GetId().ToString(),
-            book->GetTitle(),
-            *book->GetAuthorName(),
-            book->GetPublicationYear(),
-            book->GetTags()
-        };
+void View::PrintMoreMatches(bool more) const {
+    if (more) {
+        output_ << "Only the first "sv << kPickerLimit << " matches are shown"sv << std::endl;
     }
-    return std::nullopt;
 }
 
-std::vector<detail::BookInfoWithAuthor> View::GetBooksByTitle(const std::string& title) const {
-    const std::vector<domain::Book>& books = use_cases_.GetBooksByTitle(title);
-
-    std::vector<detail::BookInfoWithAuthor> dst_books;
-    dst_books.reserve(books.size());
-
-    std::transform(
-        books.begin(), books.end(), std::inserter(dst_books, dst_books.end()),
-        [this](const domain::Book& book) -> detail::BookInfoWithAuthor {
-            const std::optional<domain::Author>& author = use_cases_.GetAuthorById(book.GetAuthorId());
-            return {
-                book.GetId().ToString(),
-                book.GetTitle(),
-                author->GetName(),
-                book.GetPublicationYear()
-            };
-        }
-    );
-
-    return dst_books;
+std::optional<std::pmr::string> View::ReadTitle() const {
+    ReadLine();
+    const std::string_view title = util::Trim(line_);
+    if (title.empty()) {
+        return std::nullopt;
+    }
+    return std::pmr::string{title, memory_};
 }
 
-std::optional<std::string> View::EnterTitle(const std::string& introductory_phrase) const {
-    output_ << introductory_phrase << std::endl;
-
-    std::string title;
-    std::getline(input_, title);
-    boost::algorithm::trim(title);
-
-    if (title.empty()) {
+std::optional<int> View::ReadPubYear() const {
+    if (!ReadLine() || line_.empty()) {
         return std::nullopt;
     }
 
-    return title;
+    if (const std::optional<int> pub_year = util::ParseInt(line_)) {
+        return pub_year;
+    }
+    throw std::runtime_error("Invalid publication year");
 }
 
-std::optional<int> View::EnterPubYear(const std::string& introductory_phrase) const {
-    output_ << introductory_phrase << std::endl;
+bool View::ReadLine() const {
+    if (!std::getline(input_, line_)) {
+        line_.clear();
+        return false;
+    }
+    return true;
+}
 
-    std::string str;
-    if (!std::getline(input_, str) || str.empty()) {
+std::optional<std::size_t> View::ReadIndex(std::size_t size, std::string_view error) const {
+    if (!ReadLine() || line_.empty()) {
         return std::nullopt;
     }
 
-    int pub_year;
-    try {
-        pub_year = std::stoi(str);
-    } catch (std::exception const& ) {
-        throw std::runtime_error("Invalid publication year");
+    const std::optional<int> index = util::ParseInt(line_);
+    if (!index || *index < 1 || static_cast<std::size_t>(*index) > size) {
+        throw std::runtime_error(std::string{error});
     }
-
-    return pub_year;
+    return static_cast<std::size_t>(*index - 1);
 }
 
-}  // namespace ui
\ No newline at end of file
+}  // namespace ui
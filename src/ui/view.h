@@ -1,10 +1,17 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <iosfwd>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
+#include "../domain/author.h"
+#include "../domain/book.h"
+
 namespace menu {
 class Menu;
 }
@@ -16,98 +23,112 @@ class UseCases;
 namespace ui {
 namespace detail {
 
+// Название и имя автора передаются в use case и становятся частью доменных объектов,
+// а теги и параметры редактирования живут только до конца команды и лежат в её арене
+// вместе со строками тегов
+using Tags = std::pmr::vector<std::pmr::string>;
+
 struct AddBookParamsWithAuthorId {
     std::string title;
-    std::string author_id;
-    std::vector<std::string> tags;
+    domain::AuthorId author_id;
+    Tags tags;
     int publication_year = 0;
 };
 
 struct AddBookParamsWithAuthorName {
     std::string title;
     std::string author_name;
-    std::vector<std::string> tags;
+    Tags tags;
     int publication_year = 0;
 };
 
 using AddBookParams = std::variant<AddBookParamsWithAuthorId, AddBookParamsWithAuthorName>;
 
 struct EditBookParams {
-    std::optional<std::string> title;
-    std::vector<std::string> tags;
-    std::optional<int> publication_year;
-};
-
-struct AuthorInfo {
-    std::string id;
-    std::string name;
-};
-
-struct BookInfoByAuthor {
-    std::string title;
-    int publication_year;
-};
+    explicit EditBookParams(std::pmr::memory_resource* memory)
+    : tags{memory}
+    {
 
-struct BookInfoWithAuthor {
-    std::string id;
-    std::string title;
-    std::string author_name;
-    int publication_year;
-};
+    }
 
-struct BookInfoCompletely {
-    std::string id;
-    std::string title;
-    std::string author_name;
-    int publication_year;
-    std::vector<std::string> tags;
+    std::optional<std::pmr::string> title;
+    Tags tags;
+    std::optional<int> publication_year;
 };
 
-std::string GetTagsPrintable(const std::vector<std::string> &tags);
-
 }  // namespace detail
 
+/**
+ * Представление работает с доменными объектами напрямую: списки печатаются
+ * из результатов запросов (BookRows, AuthorRows), без промежуточных копий в DTO.
+ * Временные данные команды (теги, параметры редактирования) выделяются в арене,
+ * которая целиком освобождается по окончании команды. Представление принадлежит
+ * одной сессии, поэтому арена не синхронизируется.
+ */
 class View {
 public:
-    View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output);
+    // use_arena = false выделяет временные данные глобальным аллокатором (для сравнения в бенчмарке)
+    View(menu::Menu& menu, app::UseCases& use_cases, std::istream& input, std::ostream& output,
+         bool use_arena = true);
 
 private:
-    bool AddAuthor(std::istream &cmd_input) const;
-    bool AddBook(std::istream &cmd_input) const;
+    // Размер буфера арены внутри View: типичной команде его хватает без обращений к куче
+    static constexpr std::size_t kArenaBufferSize = 4096;
+
+    // Регистрирует команду меню, после которой арена освобождается
+    template <typename Fn>
+    void AddAction(std::string name, std::string args, std::string description, Fn fn);
+
+    bool AddAuthor(std::string_view name) const;
+    bool AddBook(std::string_view args) const;
     bool ShowAuthors() const;
     bool ShowBooks() const;
+    bool ShowBooksByYears(std::string_view args) const;
+    bool ShowStatistics(std::string_view args) const;
+    bool CompleteTag(std::string_view prefix) const;
+    bool FuzzyFind(std::string_view text) const;
     bool ShowAuthorBooks() const;
     bool DeleteAuthor() const;
-    bool DeleteAuthorWithName(std::istream &cmd_input) const;
+    bool DeleteAuthorWithName(std::string_view name) const;
     bool EditAuthor() const;
-    bool EditAuthorWithName(std::istream &cmd_input) const;
+    bool EditAuthorWithName(std::string_view name) const;
     bool ShowBook() const;
-    bool ShowBookWithTitle(std::istream &cmd_input) const;
+    bool ShowBookWithTitle(std::string_view title) const;
     bool DeleteBook() const;
-    bool DeleteBookWithTitle(std::istream &cmd_input) const;
+    bool DeleteBookWithTitle(std::string_view title) const;
     bool EditBook() const;
-    bool EditBookWithTitle(std::istream &cmd_input) const;
-    
-    std::optional<detail::AddBookParams> GetBookParams(std::istream &cmd_input) const;
-    detail::EditBookParams GetBookParamsForEdit(const detail::BookInfoCompletely &book) const;
-    std::optional<std::string> EnterAuthorName(const std::string &introductory_phrase) const;
-    bool OfferToAddAuthor(const std::string &author_name) const;
-    std::optional<std::string> SelectAuthor() const;
-    std::vector<std::string> EnterBookTags(const std::string &introductory_phrase) const;
-    std::vector<detail::AuthorInfo> GetAuthors() const;
-    std::vector<detail::BookInfoWithAuthor> GetBooks() const;
-    std::vector<detail::BookInfoByAuthor> GetAuthorBooks(const std::string &author_id) const;
-    std::optional<detail::AuthorInfo> GetAuthorByName(const std::string &name) const;
-    std::optional<std::string> SelectBook(const std::vector<detail::BookInfoWithAuthor> &books) const;
-    std::vector<detail::BookInfoWithAuthor> GetBooksByTitle(const std::string &title) const;
-    std::optional<detail::BookInfoCompletely> GetBookById(const std::string &book_id) const;
-    std::optional<std::string> EnterTitle(const std::string &introductory_phrase) const;
-    std::optional<int> EnterPubYear(const std::string &introductory_phrase) const;
+    bool EditBookWithTitle(std::string_view title) const;
+
+    std::optional<detail::AddBookParams> GetBookParams(std::string_view args) const;
+    detail::EditBookParams GetBookParamsForEdit(const domain::Book& book) const;
+    bool EditSelectedBook(const domain::BookId& book_id) const;
+    std::optional<std::string> EnterAuthorName(std::string_view introductory_phrase) const;
+    bool OfferToAddAuthor(std::string_view author_name) const;
+    // Выбор из первых совпадений по началу имени или названия, а не из всего каталога
+    std::optional<domain::AuthorId> SelectAuthor() const;
+    detail::Tags EnterBookTags(std::string_view introductory_phrase) const;
+    detail::Tags ReadBookTags() const;
+    std::optional<domain::BookId> SelectBook() const;
+    std::optional<domain::BookId> SelectBook(const std::vector<domain::Book>& books) const;
+    std::optional<domain::BookId> SelectBookByTitle(std::string_view title) const;
+    std::string EnterPrefix(std::string_view introductory_phrase) const;
+    void PrintMoreMatches(bool more) const;
+    std::optional<std::pmr::string> ReadTitle() const;
+    std::optional<int> ReadPubYear() const;
+
+    // Читает строку в общий буфер; результат действителен до следующего чтения
+    bool ReadLine() const;
+    // Номер элемента списка (с единицы), выбранного пользователем; nullopt при пустой строке
+    std::optional<std::size_t> ReadIndex(std::size_t size, std::string_view error) const;
 
     menu::Menu& menu_;
     app::UseCases& use_cases_;
     std::istream& input_;
     std::ostream& output_;
+    mutable std::string line_;
+    alignas(std::max_align_t) std::array<std::byte, kArenaBufferSize> arena_buffer_;
+    mutable std::pmr::monotonic_buffer_resource arena_{arena_buffer_.data(), arena_buffer_.size()};
+    std::pmr::memory_resource* memory_;
 };
 
-}  // namespace ui
\ No newline at end of file
+}  // namespace ui
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace util {
+
+inline constexpr std::string_view kWhitespace = " \t\r\n\v\f";
+
+// Аналог boost::algorithm::trim для string_view: не копирует строку
+constexpr std::string_view Trim(std::string_view str) noexcept {
+    const std::size_t begin = str.find_first_not_of(kWhitespace);
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const std::size_t end = str.find_last_not_of(kWhitespace);
+    return str.substr(begin, end - begin + 1);
+}
+
+// Отделяет первое слово строки; остаток возвращается без пробелов по краям
+constexpr std::pair<std::string_view, std::string_view> SplitFirstWord(std::string_view str) noexcept {
+    str = Trim(str);
+    const std::size_t space = str.find_first_of(kWhitespace);
+    if (space == std::string_view::npos) {
+        return {str, {}};
+    }
+    return {str.substr(0, space), Trim(str.substr(space))};
+}
+
+// Целое число, занимающее всю строку (без учёта пробелов по краям)
+inline std::optional<int> ParseInt(std::string_view str) noexcept {
+    str = Trim(str);
+    int value = 0;
+    const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec != std::errc{} || end != str.data() + str.size() || str.empty()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// Число символов в строке UTF-8: так длину считают ограничения varchar(n)
+constexpr std::size_t Utf8Length(std::string_view str) noexcept {
+    return static_cast<std::size_t>(std::count_if(str.begin(), str.end(), [](char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+    }));
+}
+
+// Схлопывает пробелы внутри тега до одного и убирает их по краям. Строка результата
+// берёт память у allocator: View собирает теги прямо в арене команды
+template <typename String = std::string>
+String NormalizeTag(std::string_view raw, const typename String::allocator_type& allocator = {}) {
+    String tag{allocator};
+    tag.reserve(raw.size());
+    for (auto [word, rest] = SplitFirstWord(raw); !word.empty(); std::tie(word, rest) = SplitFirstWord(rest)) {
+        if (!tag.empty()) {
+            tag += ' ';
+        }
+        tag += word;
+    }
+    return tag;
+}
+
+// Упорядочивает нормализованные теги и убирает повторы: у книги каждый тег один раз
+template <typename Tags>
+void SortUniqueTags(Tags& tags) {
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+}
+
+}  // namespace util
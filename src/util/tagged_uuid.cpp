@@ -1,23 +1,114 @@
 #include "tagged_uuid.h"
 
-#include <boost/uuid/random_generator.hpp>
-#include <boost/uuid/string_generator.hpp>
-#include <boost/uuid/uuid_io.hpp>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
 
 namespace util {
 namespace detail {
 
+namespace {
+
+// Генератор потока: сид берётся из системного источника энтропии один раз,
+// а не при каждом вызове, и обновляется после kReseedPeriod идентификаторов
+class ThreadRandom {
+public:
+    static constexpr std::uint64_t kReseedPeriod = std::uint64_t{1} << 20;
+
+    ThreadRandom() {
+        Reseed();
+    }
+
+    std::uint64_t Next() {
+        if (++generated_ == kReseedPeriod) {
+            Reseed();
+        }
+        return engine_();
+    }
+
+private:
+    void Reseed() {
+        std::random_device device;
+        std::seed_seq seed{device(), device(), device(), device(), device(), device(), device(), device()};
+        engine_.seed(seed);
+        generated_ = 0;
+    }
+
+    std::mt19937_64 engine_;
+    std::uint64_t generated_ = 0;
+};
+
+ThreadRandom& GetThreadRandom() {
+    thread_local ThreadRandom random;
+    return random;
+}
+
+void StoreBigEndian(std::uint8_t* dst, std::uint64_t value) noexcept {
+    for (int i = 7; i >= 0; --i) {
+        dst[i] = static_cast<std::uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+UUIDType MakeUUID(std::uint64_t high, std::uint64_t low, std::uint64_t version) noexcept {
+    high = (high & ~std::uint64_t{0xF000}) | (version << 12);
+    low = (low & ~(std::uint64_t{0xC} << 60)) | (std::uint64_t{0x8} << 60);  // вариант RFC 4122
+    UUIDType uuid;
+    StoreBigEndian(uuid.data, high);
+    StoreBigEndian(uuid.data + 8, low);
+    return uuid;
+}
+
+}  // namespace
+
 UUIDType NewUUID() {
-    return boost::uuids::random_generator()();
+    ThreadRandom& random = GetThreadRandom();
+    const std::uint64_t high = random.Next();
+    return MakeUUID(high, random.Next(), 4);
+}
+
+UUIDType NewTimeOrderedUUID() {
+    // RFC 9562, метод 1: 12 бит rand_a служат счётчиком внутри одной миллисекунды.
+    // При переполнении счётчика время сдвигается вперёд, чтобы сохранить порядок
+    thread_local std::uint64_t last_ms = 0;
+    thread_local std::uint64_t counter = 0;
+
+    ThreadRandom& random = GetThreadRandom();
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const auto now_ms = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    if (now_ms > last_ms) {
+        last_ms = now_ms;
+        // Старший бит счётчика сброшен, чтобы оставался запас на пачку идентификаторов
+        counter = random.Next() & 0x7FF;
+    } else if (++counter > 0xFFF) {
+        ++last_ms;
+        counter = 0;
+    }
+
+    const std::uint64_t high = (last_ms << 16) | counter;
+    return MakeUUID(high, random.Next(), 7);
 }
 
 std::string UUIDToString(const UUIDType& uuid) {
-    return to_string(uuid);
+    std::string result(kUUIDStringSize, '\0');
+    FormatUUID(uuid.data, result.data());
+    return result;
 }
 
 UUIDType UUIDFromString(std::string_view str) {
-    boost::uuids::string_generator gen;
-    return gen(str.begin(), str.end());
+    if (std::optional<UUIDType> uuid = TryUUIDFromString(str)) {
+        return *uuid;
+    }
+    throw std::invalid_argument("Invalid UUID string");
+}
+
+std::optional<UUIDType> TryUUIDFromString(std::string_view str) noexcept {
+    UUIDType uuid;
+    if (!ParseUUID(str, uuid.data)) {
+        return std::nullopt;
+    }
+    return uuid;
 }
 
 }  // namespace detail
@@ -1,24 +1,65 @@
 #pragma once
+#include <array>
 #include <boost/uuid/nil_generator.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "tagged.h"
+#include "uuid_hex.h"
 
 namespace util {
 
+enum class UUIDVersion {
+    // Случайный UUIDv4
+    kRandom,
+    // UUIDv7: старшие 48 бит — время в миллисекундах, поэтому новые ключи
+    // попадают в конец btree-индекса, а не в случайные страницы
+    kTimeOrdered,
+};
+
 namespace detail {
 
 using UUIDType = boost::uuids::uuid;
 
 UUIDType NewUUID();
+// Идентификаторы, созданные одним потоком, строго возрастают
+UUIDType NewTimeOrderedUUID();
+
+// Версия задаётся в теге константой kUUIDVersion, по умолчанию — случайные UUID
+template <typename Tag>
+constexpr UUIDVersion GetUUIDVersion() noexcept {
+    if constexpr (requires { Tag::kUUIDVersion; }) {
+        return Tag::kUUIDVersion;
+    } else {
+        return UUIDVersion::kRandom;
+    }
+}
 constexpr UUIDType ZeroUUID{{0}};
 
 std::string UUIDToString(const UUIDType& uuid);
+// Бросает std::invalid_argument, если строка не является канонической записью UUID
 UUIDType UUIDFromString(std::string_view str);
+std::optional<UUIDType> TryUUIDFromString(std::string_view str) noexcept;
 
 }  // namespace detail
 
+// Текстовая запись UUID в буфере на стеке: для передачи туда, где достаточно string_view
+class UUIDChars {
+public:
+    explicit UUIDChars(const detail::UUIDType& uuid) noexcept {
+        detail::FormatUUID(uuid.data, chars_.data());
+    }
+
+    std::string_view View() const noexcept {
+        return {chars_.data(), chars_.size()};
+    }
+
+private:
+    std::array<char, kUUIDStringSize> chars_;
+};
+
 template <typename Tag>
 class TaggedUUID : public Tagged<detail::UUIDType, Tag> {
 public:
@@ -30,17 +71,36 @@ public:
     }
 
     static TaggedUUID New() {
-        return TaggedUUID{detail::NewUUID()};
+        if constexpr (detail::GetUUIDVersion<Tag>() == UUIDVersion::kTimeOrdered) {
+            return TaggedUUID{detail::NewTimeOrderedUUID()};
+        } else {
+            return TaggedUUID{detail::NewUUID()};
+        }
     }
 
-    static TaggedUUID FromString(const std::string& uuid_as_text) {
+    static TaggedUUID FromString(std::string_view uuid_as_text) {
         return TaggedUUID{detail::UUIDFromString(uuid_as_text)};
     }
 
+    static std::optional<TaggedUUID> TryFromString(std::string_view uuid_as_text) noexcept {
+        if (std::optional<detail::UUIDType> uuid = detail::TryUUIDFromString(uuid_as_text)) {
+            return TaggedUUID{*uuid};
+        }
+        return std::nullopt;
+    }
 
     std::string ToString() const {
         return detail::UUIDToString(**this);
     }
+
+    UUIDChars ToChars() const noexcept {
+        return UUIDChars{**this};
+    }
+
+    // Пишет kUUIDStringSize символов в буфер вызывающего, возвращает указатель за последним
+    char* ToChars(char* out) const noexcept {
+        return detail::FormatUUID((**this).data, out);
+    }
 };
 
 }  // namespace util
\ No newline at end of file
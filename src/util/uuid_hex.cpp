@@ -0,0 +1,175 @@
+#include "uuid_hex.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace util {
+namespace detail {
+
+namespace {
+
+constexpr std::array<std::size_t, 4> kDashPositions{8, 13, 18, 23};
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// 0..15 для шестнадцатеричной цифры, 0xFF для остальных символов
+constexpr std::array<std::uint8_t, 256> kHexValues = [] {
+    std::array<std::uint8_t, 256> values{};
+    values.fill(0xFF);
+    for (int i = 0; i < 10; ++i) {
+        values['0' + i] = static_cast<std::uint8_t>(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        values['a' + i] = static_cast<std::uint8_t>(10 + i);
+        values['A' + i] = static_cast<std::uint8_t>(10 + i);
+    }
+    return values;
+}();
+
+bool HasDashes(std::string_view str) noexcept {
+    return str.size() == kUUIDStringSize
+        && str[kDashPositions[0]] == '-' && str[kDashPositions[1]] == '-'
+        && str[kDashPositions[2]] == '-' && str[kDashPositions[3]] == '-';
+}
+
+// Вставляет дефисы в 32 цифры подряд
+char* InsertDashes(const char* digits, char* out) noexcept {
+    std::memcpy(out, digits, 8);
+    out[8] = '-';
+    std::memcpy(out + 9, digits + 8, 4);
+    out[13] = '-';
+    std::memcpy(out + 14, digits + 12, 4);
+    out[18] = '-';
+    std::memcpy(out + 19, digits + 16, 4);
+    out[23] = '-';
+    std::memcpy(out + 24, digits + 20, 12);
+    return out + kUUIDStringSize;
+}
+
+// Обратное к InsertDashes: собирает 32 цифры без дефисов
+void RemoveDashes(const char* str, char* digits) noexcept {
+    std::memcpy(digits, str, 8);
+    std::memcpy(digits + 8, str + 9, 4);
+    std::memcpy(digits + 12, str + 14, 4);
+    std::memcpy(digits + 16, str + 19, 4);
+    std::memcpy(digits + 20, str + 24, 12);
+}
+
+#if defined(__SSE2__)
+
+// Каждый байт превращается в две ASCII-цифры: сначала старший полубайт, затем младший
+void EncodeHex16(const std::uint8_t* bytes, char* digits) noexcept {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(value, 4), low_mask);
+    const __m128i low = _mm_and_si128(value, low_mask);
+
+    auto to_ascii = [](__m128i nibbles) {
+        // '0' + n для n < 10, 'a' + n - 10 для остальных
+        const __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+        const __m128i offset = _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10));
+        return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), offset);
+    };
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(digits), to_ascii(_mm_unpacklo_epi8(high, low)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(digits + 16), to_ascii(_mm_unpackhi_epi8(high, low)));
+}
+
+// Значения 16 цифр; в valid выставляются биты корректных символов
+__m128i DecodeNibbles(__m128i chars, int& valid) noexcept {
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i zero = _mm_setzero_si128();
+    // Беззнаковое сравнение x <= n через насыщающее вычитание
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)), zero);
+    const __m128i is_letter = _mm_cmpeq_epi8(_mm_subs_epu8(letter, _mm_set1_epi8(5)), zero);
+    valid = _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter));
+    return _mm_or_si128(
+        _mm_and_si128(is_digit, digit),
+        _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10)))
+    );
+}
+
+// Склеивает пары полубайтов: в каждом 16-битном слове младший байт — старший полубайт результата
+__m128i PackNibblePairs(__m128i nibbles) noexcept {
+    const __m128i high = _mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00F0));
+    const __m128i low = _mm_srli_epi16(nibbles, 8);
+    return _mm_or_si128(high, low);
+}
+
+bool DecodeHex32(const char* digits, std::uint8_t* out) noexcept {
+    int valid_first = 0;
+    int valid_second = 0;
+    const __m128i first = DecodeNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)), valid_first);
+    const __m128i second = DecodeNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits + 16)), valid_second);
+    if ((valid_first & valid_second) != 0xFFFF) {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_packus_epi16(PackNibblePairs(first), PackNibblePairs(second)));
+    return true;
+}
+
+#endif
+
+}  // namespace
+
+char* FormatUUIDScalar(const std::uint8_t* bytes, char* out) noexcept {
+    char digits[32];
+    for (std::size_t i = 0; i < 16; ++i) {
+        digits[2 * i] = kHexDigits[bytes[i] >> 4];
+        digits[2 * i + 1] = kHexDigits[bytes[i] & 0x0F];
+    }
+    return InsertDashes(digits, out);
+}
+
+bool ParseUUIDScalar(std::string_view str, std::uint8_t* out) noexcept {
+    if (!HasDashes(str)) {
+        return false;
+    }
+    char digits[32];
+    RemoveDashes(str.data(), digits);
+    std::uint8_t invalid = 0;
+    for (std::size_t i = 0; i < 16; ++i) {
+        const std::uint8_t high = kHexValues[static_cast<unsigned char>(digits[2 * i])];
+        const std::uint8_t low = kHexValues[static_cast<unsigned char>(digits[2 * i + 1])];
+        invalid |= (high | low) & 0xF0;
+        out[i] = static_cast<std::uint8_t>((high << 4) | (low & 0x0F));
+    }
+    return invalid == 0;
+}
+
+#if defined(__SSE2__)
+
+char* FormatUUID(const std::uint8_t* bytes, char* out) noexcept {
+    char digits[32];
+    EncodeHex16(bytes, digits);
+    return InsertDashes(digits, out);
+}
+
+bool ParseUUID(std::string_view str, std::uint8_t* out) noexcept {
+    if (!HasDashes(str)) {
+        return false;
+    }
+    char digits[32];
+    RemoveDashes(str.data(), digits);
+    return DecodeHex32(digits, out);
+}
+
+#else
+
+char* FormatUUID(const std::uint8_t* bytes, char* out) noexcept {
+    return FormatUUIDScalar(bytes, out);
+}
+
+bool ParseUUID(std::string_view str, std::uint8_t* out) noexcept {
+    return ParseUUIDScalar(str, out);
+}
+
+#endif
+
+}  // namespace detail
+}  // namespace util
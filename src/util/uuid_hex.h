@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace util {
+
+// Каноническая запись UUID: 8-4-4-4-12 шестнадцатеричных цифр
+inline constexpr std::size_t kUUIDStringSize = 36;
+
+namespace detail {
+
+/**
+ * Записывает 16 байт UUID в out строчными шестнадцатеричными цифрами в канонической форме.
+ * В out должно быть не меньше kUUIDStringSize байт, завершающий ноль не пишется.
+ * Возвращает указатель за последним записанным символом.
+ */
+char* FormatUUID(const std::uint8_t* bytes, char* out) noexcept;
+
+/**
+ * Строгий разбор канонической записи: ровно 36 символов, дефисы на позициях 8, 13, 18 и 23,
+ * остальные символы — шестнадцатеричные цифры в любом регистре. Фигурные скобки и запись
+ * без дефисов не принимаются. При ошибке возвращает false, out может быть изменён.
+ */
+bool ParseUUID(std::string_view str, std::uint8_t* out) noexcept;
+
+// Переносимые реализации. FormatUUID и ParseUUID используют их, если SSE2 недоступен
+char* FormatUUIDScalar(const std::uint8_t* bytes, char* out) noexcept;
+bool ParseUUIDScalar(std::string_view str, std::uint8_t* out) noexcept;
+
+}  // namespace detail
+}  // namespace util
@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+// Счётчик аллокаций: глобальный operator new заменён на всё тестовое приложение,
+// но считает только во время замера и только в потоке, который его включил
+namespace {
+
+thread_local bool counting_allocations = false;
+thread_local std::size_t allocation_count = 0;
+
+void* Allocate(std::size_t size) {
+    if (counting_allocations) {
+        ++allocation_count;
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return Allocate(size);
+}
+
+// std::pmr::new_delete_resource выделяет память через варианты с выравниванием
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (counting_allocations) {
+        ++allocation_count;
+    }
+    const std::size_t alignment = std::max(static_cast<std::size_t>(align), sizeof(void*));
+    if (void* ptr = std::aligned_alloc(alignment, (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+// Поток вывода, выбрасывающий всё записанное: рост буфера ostringstream не должен попадать в замер
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int ch) override {
+        return ch;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+struct Fixture {
+    Fixture() {
+        storage.Reserve(64);
+        use_cases.AddAuthor("Herman Melville"s);
+        use_cases.AddAuthor("Jack London"s);
+        const std::vector<std::string> tags{"adventure"s, "classic"s};
+        use_cases.AddBookByAuthorName("Mark Twain"s, "Tom Sawyer"s, 1876, tags);
+        use_cases.AddBookByAuthorId(use_cases.GetAuthorByName("Jack London"sv)->GetId(), "White Fang"s, 1906, tags);
+    }
+
+    // Выполняет сценарий дважды и возвращает число аллокаций во втором прогоне:
+    // первый прогон прогревает статические счётчики метрик и буферы Menu и View
+    std::size_t CountAllocations(const std::string& script) {
+        input.str(script);
+        input.clear();
+        menu.Run();
+
+        input.str(script);
+        input.clear();
+        allocation_count = 0;
+        counting_allocations = true;
+        menu.Run();
+        counting_allocations = false;
+        return allocation_count;
+    }
+
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    std::istringstream input;
+    NullBuffer null_buffer;
+    std::ostream output{&null_buffer};
+    menu::Menu menu{input, output};
+    ui::View view{menu, use_cases, input, output};
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "ShowBook prints a book from the repository") {
+    std::ostringstream out;
+    menu::Menu show_menu{input, out};
+    ui::View show_view{show_menu, use_cases, input, out};
+    input.str("ShowBook White Fang\n"s);
+    show_menu.Run();
+    CHECK(out.str() == "Title: White Fang\nAuthor: Jack London\nPublication year: 1906\nTags: adventure, classic\n"s);
+}
+
+TEST_CASE_METHOD(Fixture, "ShowBooksByYears prints books of the range by year") {
+    use_cases.AddBookByAuthorName("Herman Melville"s, "Moby Dick"s, 1851, {});
+    use_cases.AddBookByAuthorName("Jack London"s, "The Call of the Wild"s, 1903, {});
+    std::ostringstream out;
+    menu::Menu show_menu{input, out};
+    ui::View show_view{show_menu, use_cases, input, out};
+    input.str("ShowBooksByYears 1850 1905\nShowBooksByYears 1907\nShowBooksByYears 1910 1900\n"s);
+    show_menu.Run();
+    CHECK(out.str() ==
+        "1 Moby Dick by Herman Melville, 1851\n"
+        "2 Tom Sawyer by Mark Twain, 1876\n"
+        "3 The Call of the Wild by Jack London, 1903\n"
+        "Invalid year range\n"
+        "Invalid year range\n"s);
+}
+
+// Бюджеты зафиксированы по текущей реализации. Если тест упал после изменения кода,
+// значит, на пути команды появились лишние копии строк или векторов
+TEST_CASE_METHOD(Fixture, "AddBook stays within allocation budget") {
+    // Автор уже есть в базе, два тега: две единицы работы, вектор тегов лежит в арене команды
+    const std::size_t allocations = CountAllocations("AddBook 1851 Moby Dick\nHerman Melville\nsea, classic\n"s);
+    INFO("allocations: " << allocations);
+    CHECK(allocations <= 2);
+}
+
+TEST_CASE_METHOD(Fixture, "ShowBook stays within allocation budget") {
+    // Две единицы работы, вектор найденных по названию книг и теги выбранной книги
+    const std::size_t allocations = CountAllocations("ShowBook White Fang\n"s);
+    INFO("allocations: " << allocations);
+    CHECK(allocations <= 5);
+}
+
+TEST_CASE_METHOD(Fixture, "EditBook keeps temporary parameters in the command arena") {
+    // Название и один из тегов длиннее буфера SSO, чтобы их копии не помещались в сам объект строки
+    const std::string script = "EditBook White Fang\nWhite Fang: A Novel of the North\n1906\n"
+                               "adventure,   stories of the  far north\n"
+                               "EditBook White Fang: A Novel of the North\nWhite Fang\n1906\n"
+                               "adventure,   stories of the  far north\n"s;
+    const std::size_t with_arena = CountAllocations(script);
+
+    menu::Menu global_menu{input, output};
+    ui::View global_view{global_menu, use_cases, input, output, false};
+    input.str(script);
+    input.clear();
+    global_menu.Run();
+    input.str(script);
+    input.clear();
+    allocation_count = 0;
+    counting_allocations = true;
+    global_menu.Run();
+    counting_allocations = false;
+    const std::size_t without_arena = allocation_count;
+
+    INFO("with arena: " << with_arena << ", without arena: " << without_arena);
+    // Без арены в каждой команде добавляются вектор тегов, нормализованный длинный тег и вектор,
+    // передаваемый в use case, и ещё копия длинного названия (короткое помещается в SSO).
+    // Копия длинного тега для use case идёт в глобальную кучу в обоих случаях
+    CHECK(without_arena - with_arena == 7);
+    CHECK(use_cases.GetBooksByTitle("White Fang"sv).size() == 1);
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <variant>
+
+#include "../src/batch/batch.h"
+
+using namespace std::literals;
+
+TEST_CASE("Batch file is parsed up front") {
+    std::istringstream input{
+        "# authors\n"
+        "AddAuthor Jack London\n"
+        "\n"
+        "AddBook 1906 White Fang | Jack London | tags=adventure,  novel ,adventure\n"
+        "AddBook 1851 Moby Dick | Herman Melville | create-author\n"
+        "EditBook id=5b3e4ab8-7f1c-4b9b-9a53-0c6cc6b9a2a1 | year=1907 | tags=\n"
+        "DeleteBook Moby Dick\n"s
+    };
+    const std::vector<batch::Command> commands = batch::ParseCommands(input);
+    REQUIRE(commands.size() == 5);
+    CHECK(commands[0].line == 2);
+    CHECK(std::get<batch::AddAuthor>(commands[0].action).name == "Jack London"s);
+
+    const auto& add_book = std::get<batch::AddBook>(commands[1].action);
+    CHECK(commands[1].line == 4);
+    CHECK(add_book.publication_year == 1906);
+    CHECK(add_book.title == "White Fang"s);
+    CHECK(add_book.author.value == "Jack London"s);
+    CHECK_FALSE(add_book.author.is_id);
+    CHECK(add_book.tags == std::vector{"adventure"s, "novel"s});
+    CHECK_FALSE(add_book.create_author);
+    CHECK(std::get<batch::AddBook>(commands[2].action).create_author);
+
+    const auto& edit_book = std::get<batch::EditBook>(commands[3].action);
+    CHECK(edit_book.book.is_id);
+    CHECK(edit_book.book.value == "5b3e4ab8-7f1c-4b9b-9a53-0c6cc6b9a2a1"s);
+    CHECK_FALSE(edit_book.title.has_value());
+    CHECK(edit_book.publication_year == 1907);
+    REQUIRE(edit_book.tags.has_value());
+    CHECK(edit_book.tags->empty());
+
+    CHECK(std::get<batch::DeleteBook>(commands[4].action).book.value == "Moby Dick"s);
+}
+
+TEST_CASE("Batch parse errors report the line number") {
+    std::istringstream unknown{"AddAuthor A\nShowAuthors\n"s};
+    CHECK_THROWS_AS(batch::ParseCommands(unknown), batch::ParseError);
+
+    std::istringstream bad_year{"AddAuthor A\nEditBook Title | year=19x\n"s};
+    try {
+        batch::ParseCommands(bad_year);
+        FAIL("ParseError expected");
+    } catch (const batch::ParseError& e) {
+        CHECK(std::string{e.what()}.starts_with("line 2: "sv));
+    }
+
+    // Год должен занимать всё поле, а не только его начало
+    for (const std::string& line : {"AddBook 1906abc White Fang | Jack London\n"s, "AddBook +1906 White Fang | Jack London\n"s,
+                                   "AddBook 1906 | Jack London\n"s, "EditBook Title | year=1907 x\n"s}) {
+        std::istringstream bad{line};
+        CHECK_THROWS_AS(batch::ParseCommands(bad), batch::ParseError);
+    }
+}
+
+TEST_CASE("Batch rejects tags longer than a book tag may be") {
+    // Длина считается после схлопывания пробелов, в символах, а не байтах
+    const std::string longest = "a  "s + std::string(26, 'b') + "   é"s;
+    std::istringstream fits{"EditBook Title | tags=" + longest + "\n"};
+    const std::vector<batch::Command> commands = batch::ParseCommands(fits);
+    REQUIRE(commands.size() == 1);
+    CHECK(*std::get<batch::EditBook>(commands[0].action).tags == std::vector{"a "s + std::string(26, 'b') + " é"s});
+
+    std::istringstream too_long{"AddAuthor A\n\nAddBook 1906 White Fang | A | tags=sea, " + std::string(31, 'x') + "\n"};
+    try {
+        batch::ParseCommands(too_long);
+        FAIL("ParseError expected");
+    } catch (const batch::ParseError& e) {
+        CHECK(std::string{e.what()} == "line 3: Tags must be at most 30 characters long"s);
+    }
+}
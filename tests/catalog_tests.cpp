@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/app/catalog_use_cases.h"
+#include "../src/app/unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::vector<std::string> GetTitles(const domain::BookRows& rows) {
+    std::vector<std::string> titles;
+    for (const domain::BookRow row : rows) {
+        titles.emplace_back(row.GetTitle());
+    }
+    return titles;
+}
+
+struct Fixture {
+    Fixture() {
+        storage.Reserve(1024);
+        use_cases.AddAuthor("Jack London"s);
+        const domain::AuthorId london = use_cases.GetAuthorByName("Jack London"sv)->GetId();
+        use_cases.AddBookByAuthorId(london, "White Fang"s, 1906, {});
+        use_cases.AddBookByAuthorId(london, "Martin Eden"s, 1909, {});
+        use_cases.AddBookByAuthorName("Herman Melville"s, "Moby Dick"s, 1851, {});
+    }
+
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "Catalog snapshot serves reads loaded from storage") {
+    app::CatalogUseCases catalog{use_cases};
+
+    const domain::AuthorRows authors = catalog.GetAllAuthors();
+    REQUIRE(authors.Size() == 2);
+    CHECK(authors[0].GetName() == "Herman Melville"sv);
+    CHECK(authors[1].GetName() == "Jack London"sv);
+
+    CHECK(GetTitles(catalog.GetAllBooks()) == std::vector{"Martin Eden"s, "Moby Dick"s, "White Fang"s});
+
+    const std::optional<domain::Author> london = catalog.GetAuthorByName("Jack London"sv);
+    REQUIRE(london.has_value());
+    CHECK(catalog.GetAuthorById(london->GetId())->GetName() == "Jack London"s);
+    CHECK(GetTitles(catalog.GetBooksByAuthorId(london->GetId())) == std::vector{"White Fang"s, "Martin Eden"s});
+    CHECK_FALSE(catalog.GetAuthorByName("Mark Twain"sv).has_value());
+
+    const std::vector<domain::Book> found = catalog.GetBooksByTitle("Moby Dick"sv);
+    REQUIRE(found.size() == 1);
+    CHECK(found[0].GetAuthorName() == "Herman Melville"s);
+}
+
+TEST_CASE_METHOD(Fixture, "Writes go to storage and publish a new snapshot") {
+    app::CatalogUseCases catalog{use_cases};
+    const domain::AuthorId london = catalog.GetAuthorByName("Jack London"sv)->GetId();
+    const domain::BookRows before = catalog.GetAllBooks();
+
+    catalog.AddBookByAuthorId(london, "The Call of the Wild"s, 1903, {});
+    catalog.AddAuthor("Mark Twain"s);
+    REQUIRE(catalog.EditAuthor(london, "John Griffith London"sv));
+
+    // Ранее выданный список продолжает ссылаться на старый снимок
+    CHECK(GetTitles(before) == std::vector{"Martin Eden"s, "Moby Dick"s, "White Fang"s});
+    CHECK(before[2].GetAuthorName() == "Jack London"sv);
+
+    CHECK(GetTitles(catalog.GetBooksByAuthorId(london)) == std::vector{"The Call of the Wild"s, "White Fang"s, "Martin Eden"s});
+    CHECK(catalog.GetAllAuthors().Size() == 3);
+    CHECK(catalog.GetAuthorByName("John Griffith London"sv).has_value());
+    CHECK_FALSE(catalog.GetAuthorByName("Jack London"sv).has_value());
+    CHECK(catalog.GetAllBooks()[3].GetAuthorName() == "John Griffith London"sv);
+
+    const domain::BookId white_fang = catalog.GetBooksByTitle("White Fang"sv).front().GetId();
+    REQUIRE(catalog.EditBook(white_fang, "White Fang"sv, 1910, {}));
+    CHECK(GetTitles(catalog.GetBooksByAuthorId(london)) == std::vector{"The Call of the Wild"s, "Martin Eden"s, "White Fang"s});
+    REQUIRE(catalog.DeleteBook(white_fang));
+    CHECK(catalog.GetBooksByTitle("White Fang"sv).empty());
+
+    REQUIRE(catalog.DeleteAuthor(london));
+    CHECK(GetTitles(catalog.GetAllBooks()) == std::vector{"Moby Dick"s});
+    CHECK(catalog.GetBooksByAuthorId(london).Empty());
+
+    // Снимок совпадает с тем, что строится заново из хранилища
+    catalog.Reload();
+    CHECK(GetTitles(catalog.GetAllBooks()) == std::vector{"Moby Dick"s});
+    CHECK(catalog.GetAllAuthors().Size() == 2);
+}
+
+TEST_CASE_METHOD(Fixture, "Readers see consistent snapshots while a writer publishes") {
+    app::CatalogUseCases catalog{use_cases};
+    const domain::AuthorId london = catalog.GetAuthorByName("Jack London"sv)->GetId();
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                // Книги автора в одном снимке всегда упорядочены по году
+                int prev_year = 0;
+                for (const domain::BookRow row : catalog.GetBooksByAuthorId(london)) {
+                    if (row.GetPublicationYear() < prev_year || row.GetAuthorName() != "Jack London"sv) {
+                        ++inconsistent;
+                    }
+                    prev_year = row.GetPublicationYear();
+                }
+            }
+        });
+    }
+    for (int year = 1910; year < 1960; ++year) {
+        catalog.AddBookByAuthorId(london, "Volume "s + std::to_string(year), year, {});
+    }
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(inconsistent == 0);
+    CHECK(catalog.GetBooksByAuthorId(london).Size() == 52);
+}
+
+TEST_CASE("Catalog rereads its own writes from the primary") {
+    mock::Storage storage;
+    mock::CountingUnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    app::CatalogUseCases catalog{use_cases_impl};
+    factory.reads = 0;
+    factory.replica_reads = 0;
+
+    const domain::AuthorId london = catalog.AddAuthor("Jack London"s);
+    catalog.AddBookByAuthorId(london, "White Fang"s, 1906, {});
+    catalog.AddBookByAuthorName("Herman Melville"s, "Moby Dick"s, 1851, {});
+    CHECK(catalog.EditAuthor(london, "John Griffith London"sv));
+    CHECK(factory.reads > 0);
+    CHECK(factory.replica_reads == 0);
+    CHECK_FALSE(app::PrimaryReadScope::IsActive());
+
+    CHECK(catalog.GetBooksByAuthorId(london).Size() == 1);
+    CHECK(use_cases_impl.GetAuthorById(london)->GetName() == "John Griffith London"s);
+    CHECK(factory.replica_reads == 1);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/app/identity_map_unit_of_work.h"
+#include "../src/app/shared_unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct Fixture {
+    Fixture() {
+        storage.Reserve(64);
+        app::UseCasesImpl setup{mock_factory};
+        const std::vector<std::string> tags{"adventure"s, "classic"s};
+        setup.AddBookByAuthorName("Jack London"s, "White Fang"s, 1906, tags);
+        london = setup.GetAuthorByName("Jack London"sv)->GetId();
+        white_fang = setup.GetBooksByTitle("White Fang"sv).front().GetId();
+    }
+
+    // Счётчики, набранные за время выполнения fn
+    template <typename Fn>
+    app::QueryCounters Measure(Fn&& fn) {
+        const app::QueryCounters before = factory.GetCounters();
+        fn();
+        const app::QueryCounters after = factory.GetCounters();
+        return {after.reads - before.reads, after.hits - before.hits, after.writes - before.writes};
+    }
+
+    mock::Storage storage;
+    mock::UnitOfWorkFactory mock_factory{storage};
+    app::IdentityMapUnitOfWorkFactory factory{mock_factory};
+    app::UseCasesImpl use_cases{factory};
+    domain::AuthorId london;
+    domain::BookId white_fang;
+};
+
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "Repeated lookups in one unit of work are served from the identity map") {
+    app::IdentityMapUnitOfWork uow{mock_factory.CreateUnitOfWork()};
+
+    REQUIRE(uow.GetAuthorRepository().GetAuthorById(london)->GetName() == "Jack London"s);
+    REQUIRE(uow.GetAuthorRepository().GetAuthorById(london)->GetName() == "Jack London"s);
+    CHECK_FALSE(uow.GetAuthorRepository().GetAuthorById(domain::AuthorId::New()));
+    REQUIRE(uow.GetBookRepository().GetBookById(white_fang)->GetAuthorName() == "Jack London"s);
+    REQUIRE(uow.GetBookRepository().GetBookById(white_fang));
+    CHECK(uow.GetBookTagRepository().GetTags(white_fang) == std::vector{"adventure"s, "classic"s});
+    CHECK(uow.GetBookTagRepository().GetTags(white_fang) == std::vector{"adventure"s, "classic"s});
+
+    CHECK(uow.GetCounters().reads == 4);
+    CHECK(uow.GetCounters().hits == 3);
+}
+
+TEST_CASE_METHOD(Fixture, "Writes through the unit of work update the identity map") {
+    app::IdentityMapUnitOfWork uow{mock_factory.CreateUnitOfWork()};
+    REQUIRE(uow.GetBookRepository().GetBookById(white_fang));
+    REQUIRE(uow.GetBookTagRepository().GetTags(white_fang).size() == 2);
+
+    uow.GetBookRepository().Edit(white_fang, "White Fang (1906)"sv, 1907);
+    uow.GetBookTagRepository().DeleteByBookId(white_fang);
+    uow.GetBookTagRepository().Save(white_fang, "wolf"sv);
+    uow.GetBookTagRepository().Save(white_fang, "north"sv);
+
+    const std::optional<domain::Book> book = uow.GetBookRepository().GetBookById(white_fang);
+    REQUIRE(book);
+    CHECK(book->GetTitle() == "White Fang (1906)"s);
+    CHECK(book->GetPublicationYear() == 1907);
+    CHECK(book->GetAuthorName() == "Jack London"s);
+    CHECK(uow.GetBookTagRepository().GetTags(white_fang) == std::vector{"north"s, "wolf"s});
+    CHECK(uow.GetCounters().reads == 2);
+    CHECK(uow.GetCounters().writes == 4);
+
+    uow.GetBookTagRepository().DeleteByBookId(white_fang);
+    uow.GetBookRepository().DeleteBooksByAuthorId(london);
+    uow.GetAuthorRepository().Delete(london);
+    CHECK_FALSE(uow.GetBookRepository().GetBookById(white_fang));
+    CHECK_FALSE(uow.GetAuthorRepository().GetAuthorById(london));
+    CHECK(uow.GetCounters().reads == 2);
+}
+
+TEST_CASE_METHOD(Fixture, "Round trips per use case") {
+    CHECK(Measure([&] { use_cases.GetBook(white_fang); }).reads == 2);
+
+    const std::vector<std::string> tags{"wolf"s};
+    const app::QueryCounters edit_book = Measure([&] {
+        use_cases.EditBook(white_fang, "White Fang"sv, 1906, tags);
+    });
+    // Книга и её прежние теги, которые EditBook возвращает вызывающему
+    CHECK(edit_book.reads == 2);
+    CHECK(edit_book.writes == 3);
+
+    const app::QueryCounters edit_author = Measure([&] { use_cases.EditAuthor(london, "J. London"sv); });
+    CHECK(edit_author.reads == 1);
+    CHECK(edit_author.writes == 1);
+}
+
+TEST_CASE_METHOD(Fixture, "A shared transaction reads each entity once") {
+    // Так пакетный режим выполняет несколько команд в одной транзакции
+    app::SharedUnitOfWorkFactory shared{factory};
+    app::UseCasesImpl batch_use_cases{shared};
+    const app::QueryCounters counters = Measure([&] {
+        const domain::AuthorId id = batch_use_cases.GetAuthorByName("Jack London"sv)->GetId();
+        CHECK(batch_use_cases.EditAuthor(id, "J. London"sv));
+        REQUIRE(batch_use_cases.GetBook(white_fang));
+        CHECK(batch_use_cases.EditBook(white_fang, "White Fang"sv, 1907, {}));
+        CHECK(batch_use_cases.GetBook(white_fang)->GetPublicationYear() == 1907);
+        shared.CommitShared();
+    });
+    // В базу уходят GetAuthorByName, первые GetBookById и GetTags, а также книга с блокировкой
+    // и её теги в EditBook; автор в EditAuthor и повторный GetBook читаются из карты
+    CHECK(counters.reads == 5);
+    CHECK(counters.hits == 3);
+    CHECK(storage.GetAuthorName(london) == "J. London"sv);
+}
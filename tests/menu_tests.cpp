@@ -0,0 +1,76 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/menu/menu.h"
+#include "../src/util/string_util.h"
+
+using namespace std::literals;
+
+TEST_CASE("Menu dispatches commands with trimmed arguments") {
+    std::istringstream input{"  ShowBook   The Call of the Wild  \nShowBooks\nUnknown x\n\nExit\nShowBooks\n"s};
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+
+    std::vector<std::string> calls;
+    menu.AddAction("ShowBook"s, "<title>"s, "Show book"s, [&calls](std::string_view title) {
+        calls.emplace_back("ShowBook:"s.append(title));
+        return true;
+    });
+    menu.AddAction("ShowBooks"s, {}, "Show books"s, [&calls](std::string_view args) {
+        calls.emplace_back("ShowBooks:"s.append(args));
+        return true;
+    });
+    menu.AddAction("Exit"s, {}, "Exit program"s, [](std::string_view) {
+        return false;
+    });
+    CHECK_THROWS_AS(menu.AddAction("Exit"s, {}, {}, [](std::string_view) { return false; }), std::invalid_argument);
+
+    menu.Run();
+    CHECK(calls == std::vector{"ShowBook:The Call of the Wild"s, "ShowBooks:"s});
+    CHECK(output.str() == "Command 'Unknown' has not been found.\nInvalid command\n"s);
+
+    std::ostringstream help;
+    menu::Menu help_menu{input, help};
+    help_menu.AddAction("b"s, "<x>"s, "second"s, [](std::string_view) { return true; });
+    help_menu.AddAction("a"s, {}, "first"s, [](std::string_view) { return true; });
+    help_menu.ShowInstructions();
+    CHECK(help.str() == "a     first\nb <x> second\n"s);
+}
+
+TEST_CASE("String view helpers") {
+    CHECK(util::Trim(" \t x y \r\n"sv) == "x y"sv);
+    CHECK(util::Trim("   "sv).empty());
+    CHECK(util::SplitFirstWord("  AddBook  1906   White Fang "sv) == std::pair{"AddBook"sv, "1906   White Fang"sv});
+    CHECK(util::ParseInt(" 1906 "sv) == 1906);
+    CHECK_FALSE(util::ParseInt("19x"sv).has_value());
+    CHECK_FALSE(util::ParseInt(""sv).has_value());
+}
+
+TEST_CASE("Menu dispatch throughput", "[!benchmark]") {
+    constexpr int kCommands = 10'000;
+    std::string script;
+    for (int i = 0; i < kCommands; ++i) {
+        script += "ShowBook The Call of the Wild\n"sv;
+    }
+    std::ostringstream output;
+    std::size_t parsed = 0;
+
+    BENCHMARK("10k ShowBook commands") {
+        std::istringstream input{script};
+        menu::Menu menu{input, output};
+        for (std::string_view name : {"AddAuthor"sv, "AddBook"sv, "ShowAuthors"sv, "ShowBooks"sv, "ShowAuthorBooks"sv,
+                                      "DeleteAuthor"sv, "EditAuthor"sv, "DeleteBook"sv, "EditBook"sv}) {
+            menu.AddAction(std::string{name}, {}, {}, [](std::string_view) { return true; });
+        }
+        menu.AddAction("ShowBook"s, "<title>"s, "Show book"s, [&parsed](std::string_view title) {
+            parsed += title.size();
+            return true;
+        });
+        menu.Run();
+        return parsed;
+    };
+}
@@ -0,0 +1,163 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/book.h"
+#include "../src/metrics/metrics.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+using metrics::Histogram;
+
+TEST_CASE("Histogram buckets cover values with bounded relative error") {
+    CHECK(Histogram::BucketIndex(0) == 0);
+    CHECK(Histogram::BucketIndex(15) == 15);
+    CHECK(Histogram::BucketIndex(UINT64_MAX) == Histogram::kBucketCount - 1);
+
+    for (std::uint64_t value : {16ull, 17ull, 1000ull, 123456789ull, 1ull << 40, (1ull << 63) + 5}) {
+        const std::size_t index = Histogram::BucketIndex(value);
+        CHECK(Histogram::BucketLowerBound(index) <= value);
+        CHECK(Histogram::BucketUpperBound(index) >= value);
+        CHECK(Histogram::BucketUpperBound(index) - Histogram::BucketLowerBound(index) <= value / 8);
+    }
+}
+
+TEST_CASE("Histogram quantiles") {
+    Histogram histogram;
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        histogram.Record(i * 1000);
+    }
+    CHECK(histogram.total_count == 1000);
+    CHECK(histogram.max == 1'000'000);
+    const std::uint64_t p50 = histogram.ValueAtQuantile(0.5);
+    CHECK(p50 >= 500'000);
+    CHECK(p50 <= 500'000 + 500'000 / 8);
+    CHECK(histogram.ValueAtQuantile(1.0) == 1'000'000);
+}
+
+TEST_CASE("ScopedCall records calls, errors and rows") {
+    metrics::CallStats& stats = metrics::Registry::Get().Register("test", "ScopedCall");
+    {
+        metrics::ScopedCall call{stats, true};
+        CHECK(metrics::CurrentUseCase() == "ScopedCall");
+        call.SetRows(3);
+    }
+    CHECK(metrics::CurrentUseCase().empty());
+    try {
+        metrics::ScopedCall call{stats};
+        throw std::runtime_error("failure");
+    } catch (const std::runtime_error&) {
+    }
+
+    const metrics::CallSnapshot snapshot = stats.Snapshot();
+    CHECK(snapshot.calls == 2);
+    CHECK(snapshot.errors == 1);
+    CHECK(snapshot.rows == 3);
+    CHECK(snapshot.latency_ns.total_count == 2);
+
+    std::ostringstream out;
+    metrics::Registry::Get().WritePrometheus(out);
+    CHECK(out.str().find("bookypedia_calls_total{kind=\"test\",name=\"ScopedCall\"} 2") != std::string::npos);
+}
+
+TEST_CASE("Gauges keep the last value and are exported") {
+    metrics::Gauge& gauge = metrics::Registry::Get().RegisterGauge("test_queue");
+    CHECK(&metrics::Registry::Get().RegisterGauge("test_queue") == &gauge);
+    gauge.Set(7);
+    gauge.Set(5);
+    CHECK(gauge.Get() == 5);
+
+    std::ostringstream out;
+    metrics::Registry::Get().WritePrometheus(out);
+    CHECK(out.str().find("bookypedia_gauge{name=\"test_queue\"} 5") != std::string::npos);
+}
+
+TEST_CASE("ScopedCall overhead", "[!benchmark]") {
+    metrics::CallStats& stats = metrics::Registry::Get().Register("benchmark", "ScopedCall");
+    BENCHMARK("instrumented empty call") {
+        metrics::ScopedCall call{stats, true};
+        call.SetRows(1);
+    };
+}
+
+namespace {
+
+// Хранилище со 100 книгами и id одной из них для замеров GetBook
+struct GetBookFixture {
+    GetBookFixture() {
+        for (int i = 0; i < 100; ++i) {
+            use_cases.AddBookByAuthorName("Author "s + std::to_string(i % 10), "Book "s + std::to_string(i), 1900 + i,
+                                          std::vector{"tag "s + std::to_string(i % 7)});
+        }
+        id = use_cases.GetBooksByTitle("Book 50"sv).front().GetId();
+    }
+
+    // Те же шаги, что в UseCasesImpl::GetBook, без ScopedCall. Чтобы и репозитории
+    // не вели учёт, вызывается при storage.instrumented == false
+    std::optional<domain::Book> GetBookWithoutMetrics() {
+        std::unique_ptr<app::UnitOfWork> uow = factory.CreateReadOnlyUnitOfWork();
+        std::optional<domain::Book> book = uow->GetBookRepository().GetBookById(id);
+        book->SetTags(uow->GetBookTagRepository().GetTags(id));
+        uow->Commit();
+        return book;
+    }
+
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    domain::BookId id;
+};
+
+}  // namespace
+
+TEST_CASE("ScopedCall overhead on the GetBook path", "[!benchmark]") {
+    GetBookFixture fixture;
+    BENCHMARK("GetBook without instrumentation") {
+        return fixture.GetBookWithoutMetrics();
+    };
+    // Учёт use case, обоих запросов репозиториев и транзакции, как с PostgreSQL
+    fixture.storage.instrumented = true;
+    BENCHMARK("GetBook through UseCasesImpl with repository calls instrumented") {
+        return fixture.use_cases.GetBook(fixture.id);
+    };
+}
+
+TEST_CASE("Profiled calls record CPU time and counters") {
+    metrics::CallStats& stats = metrics::Registry::Get().Register("test", "Profiled");
+    {
+        metrics::ScopedCall call{stats};
+    }
+    CHECK(stats.Snapshot().profiled_calls == 0);
+
+    metrics::SetProfilingEnabled(true);
+    {
+        metrics::ScopedCall call{stats, true};
+        volatile std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < 1'000'000; ++i) {
+            sum = sum + i;
+        }
+    }
+    metrics::SetProfilingEnabled(false);
+
+    const metrics::CallSnapshot snapshot = stats.Snapshot();
+    CHECK(snapshot.calls == 2);
+    CHECK(snapshot.profiled_calls == 1);
+    CHECK(snapshot.profile.cpu_ns > 0);
+    CHECK(snapshot.profile.cpu_ns <= snapshot.profiled_wall_ns + 10'000'000);
+    if (metrics::PerfCounters::GetAvailableEvents() & (1u << metrics::PerfCounters::kInstructions)) {
+        CHECK(snapshot.profile.instructions >= 1'000'000);
+    }
+
+    std::ostringstream out;
+    metrics::Registry::Get().WriteProfile(out);
+    CHECK(out.str().find("Profiled") != std::string::npos);
+    CHECK(out.str().find("ScopedCall") == std::string::npos);
+}
@@ -0,0 +1,621 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../src/app/unit_of_work.h"
+#include "../src/domain/author.h"
+#include "../src/domain/book.h"
+#include "../src/domain/book_tag.h"
+#include "../src/domain/statistics.h"
+#include "../src/metrics/metrics.h"
+
+namespace mock {
+
+/**
+ * Хранилище в памяти, общее для всех репозиториев и единиц работы.
+ * Порядок выдачи повторяет запросы PostgreSQL-реализации.
+ */
+struct Storage {
+    std::vector<domain::Author> authors;
+    // Помеченные удалёнными: не видны чтениям, пока их не вычистят
+    std::vector<domain::Author> deleted_authors;
+    std::vector<domain::Book> books;
+    std::vector<std::pair<domain::BookId, std::string>> tags;
+    std::size_t commits = 0;
+    // Блокировка строк книг для GetBookByIdForUpdate: одна на всё хранилище,
+    // держится до фиксации или отмены единицы работы
+    std::mutex book_rows;
+
+    // Для замеров стоимости метрик на пути GetBook: учитывать ли запросы и транзакции
+    // в metrics так же, как репозитории PostgreSQL
+    bool instrumented = false;
+
+    // Резервирует место заранее, чтобы рост векторов не попадал в замеры аллокаций
+    void Reserve(std::size_t size) {
+        authors.reserve(size);
+        books.reserve(size);
+        tags.reserve(size);
+    }
+
+    std::string_view GetAuthorName(const domain::AuthorId& id) const {
+        const auto it = std::find_if(authors.begin(), authors.end(), [&id](const domain::Author& author) {
+            return author.GetId() == id;
+        });
+        return it == authors.end() ? std::string_view{} : std::string_view{it->GetName()};
+    }
+
+    // Книги помеченных удалёнными авторов скрыты от чтений
+    bool IsVisible(const domain::Book& book) const {
+        return std::any_of(authors.begin(), authors.end(), [&book](const domain::Author& author) {
+            return author.GetId() == book.GetAuthorId();
+        });
+    }
+
+    domain::Book WithAuthorName(const domain::Book& book) const {
+        return {book.GetId(), book.GetAuthorId(), book.GetTitle(), book.GetPublicationYear(),
+                std::string{GetAuthorName(book.GetAuthorId())}};
+    }
+};
+
+// Запрос к хранилищу, устроенный как запрос репозитория PostgreSQL: при storage.instrumented
+// он учитывается в stats
+class RepositoryCall {
+public:
+    RepositoryCall(const Storage& storage, metrics::CallStats& stats) {
+        if (storage.instrumented) {
+            call_.emplace(stats);
+        }
+    }
+
+    RepositoryCall(const RepositoryCall&) = delete;
+    RepositoryCall& operator=(const RepositoryCall&) = delete;
+
+private:
+    std::optional<metrics::ScopedCall> call_;
+};
+
+class AuthorVectorSource : public domain::AuthorRowSource {
+public:
+    explicit AuthorVectorSource(std::vector<domain::Author> authors) noexcept
+    : authors_{std::move(authors)}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return authors_.size();
+    }
+
+    domain::AuthorId GetId(std::size_t row) const override {
+        return authors_[row].GetId();
+    }
+
+    std::string_view GetName(std::size_t row) const noexcept override {
+        return authors_[row].GetName();
+    }
+
+private:
+    std::vector<domain::Author> authors_;
+};
+
+// Книги должны быть с именами авторов (Storage::WithAuthorName)
+class BookVectorSource : public domain::BookRowSource {
+public:
+    explicit BookVectorSource(std::vector<domain::Book> books) noexcept
+    : books_{std::move(books)}
+    {
+
+    }
+
+    std::size_t Size() const noexcept override {
+        return books_.size();
+    }
+
+    domain::BookId GetId(std::size_t row) const override {
+        return books_[row].GetId();
+    }
+
+    domain::AuthorId GetAuthorId(std::size_t row) const override {
+        return books_[row].GetAuthorId();
+    }
+
+    std::string_view GetTitle(std::size_t row) const noexcept override {
+        return books_[row].GetTitle();
+    }
+
+    int GetPublicationYear(std::size_t row) const override {
+        return books_[row].GetPublicationYear();
+    }
+
+    std::string_view GetAuthorName(std::size_t row) const noexcept override {
+        return *books_[row].GetAuthorName();
+    }
+
+private:
+    std::vector<domain::Book> books_;
+};
+
+class AuthorRepository : public domain::AuthorRepository {
+public:
+    explicit AuthorRepository(Storage& storage)
+    : storage_{storage}
+    {
+
+    }
+
+    void Save(const domain::Author& author) override {
+        storage_.authors.push_back(author);
+    }
+
+    void Edit(const domain::AuthorId& id, std::string_view new_name) override {
+        for (domain::Author& author : storage_.authors) {
+            if (author.GetId() == id) {
+                author = domain::Author{id, std::string{new_name}};
+            }
+        }
+    }
+
+    void Delete(const domain::AuthorId& id) override {
+        std::erase_if(storage_.authors, [&id](const domain::Author& author) {
+            return author.GetId() == id;
+        });
+        std::erase_if(storage_.deleted_authors, [&id](const domain::Author& author) {
+            return author.GetId() == id;
+        });
+    }
+
+    void MarkDeleted(const domain::AuthorId& id) override {
+        const auto it = std::find_if(storage_.authors.begin(), storage_.authors.end(), [&id](const domain::Author& author) {
+            return author.GetId() == id;
+        });
+        if (it != storage_.authors.end()) {
+            storage_.deleted_authors.push_back(std::move(*it));
+            storage_.authors.erase(it);
+        }
+    }
+
+    domain::AuthorRows GetAllAuthors() const override {
+        std::vector<domain::Author> authors = storage_.authors;
+        std::sort(authors.begin(), authors.end(), [](const domain::Author& lhs, const domain::Author& rhs) {
+            return lhs.GetName() < rhs.GetName();
+        });
+        return domain::AuthorRows{std::make_unique<AuthorVectorSource>(std::move(authors))};
+    }
+
+    domain::AuthorRows GetAuthorsByNamePrefix(std::string_view prefix, std::size_t limit) const override {
+        std::vector<domain::Author> authors;
+        for (const domain::Author& author : storage_.authors) {
+            if (author.GetName().starts_with(prefix)) {
+                authors.push_back(author);
+            }
+        }
+        std::sort(authors.begin(), authors.end(), [](const domain::Author& lhs, const domain::Author& rhs) {
+            return lhs.GetName() < rhs.GetName();
+        });
+        if (authors.size() > limit) {
+            authors.erase(authors.begin() + static_cast<std::ptrdiff_t>(limit), authors.end());
+        }
+        return domain::AuthorRows{std::make_unique<AuthorVectorSource>(std::move(authors))};
+    }
+
+    std::optional<domain::Author> GetAuthorByName(std::string_view name) const override {
+        for (const domain::Author& author : storage_.authors) {
+            if (author.GetName() == name) {
+                return author;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<domain::Author> GetAuthorById(const domain::AuthorId& id) const override {
+        for (const domain::Author& author : storage_.authors) {
+            if (author.GetId() == id) {
+                return author;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<domain::AuthorId> GetDeletedAuthorIds() const override {
+        std::vector<domain::AuthorId> ids;
+        for (const domain::Author& author : storage_.deleted_authors) {
+            ids.push_back(author.GetId());
+        }
+        return ids;
+    }
+
+private:
+    Storage& storage_;
+};
+
+class BookRepository : public domain::BookRepository {
+public:
+    explicit BookRepository(Storage& storage)
+    : storage_{storage}
+    {
+
+    }
+
+    void Save(const domain::Book& book) override {
+        storage_.books.push_back(book);
+    }
+
+    void Edit(const domain::BookId& id, std::string_view title, int publication_year) override {
+        for (domain::Book& book : storage_.books) {
+            if (book.GetId() == id) {
+                book = domain::Book{id, book.GetAuthorId(), std::string{title}, publication_year};
+            }
+        }
+    }
+
+    void Delete(const domain::BookId& id) override {
+        std::erase_if(storage_.books, [&id](const domain::Book& book) {
+            return book.GetId() == id;
+        });
+    }
+
+    std::optional<domain::Book> GetBookById(const domain::BookId& id) override {
+        static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookRepository::GetBookById");
+        const RepositoryCall call{storage_, stats};
+        for (const domain::Book& book : storage_.books) {
+            if (book.GetId() == id && storage_.IsVisible(book)) {
+                return storage_.WithAuthorName(book);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<domain::Book> GetBookByIdForUpdate(const domain::BookId& id) override {
+        if (!book_rows_lock_.owns_lock()) {
+            book_rows_lock_ = std::unique_lock{storage_.book_rows};
+        }
+        return GetBookById(id);
+    }
+
+    std::vector<domain::Book> GetBooksByTitle(std::string_view title) override {
+        std::vector<domain::Book> books;
+        for (const domain::Book& book : storage_.books) {
+            if (book.GetTitle() == title && storage_.IsVisible(book)) {
+                books.push_back(storage_.WithAuthorName(book));
+            }
+        }
+        std::sort(books.begin(), books.end(), [](const domain::Book& lhs, const domain::Book& rhs) {
+            if (lhs.GetAuthorName() != rhs.GetAuthorName()) {
+                return lhs.GetAuthorName() < rhs.GetAuthorName();
+            }
+            return lhs.GetPublicationYear() < rhs.GetPublicationYear();
+        });
+        return books;
+    }
+
+    domain::BookRows GetAllBooks() override {
+        std::vector<const domain::Book*> books;
+        books.reserve(storage_.books.size());
+        for (const domain::Book& book : storage_.books) {
+            if (storage_.IsVisible(book)) {
+                books.push_back(&book);
+            }
+        }
+        std::sort(books.begin(), books.end(), [](const domain::Book* lhs, const domain::Book* rhs) {
+            return lhs->GetTitle() < rhs->GetTitle();
+        });
+
+        return MakeRows(books);
+    }
+
+    domain::BookRows GetBooksByAuthorId(const domain::AuthorId& author_id) const override {
+        std::vector<const domain::Book*> books;
+        for (const domain::Book& book : storage_.books) {
+            if (book.GetAuthorId() == author_id && storage_.IsVisible(book)) {
+                books.push_back(&book);
+            }
+        }
+        std::sort(books.begin(), books.end(), [](const domain::Book* lhs, const domain::Book* rhs) {
+            return lhs->GetPublicationYear() < rhs->GetPublicationYear();
+        });
+        return MakeRows(books);
+    }
+
+    domain::BookRows GetBooksByYearRange(int from, int to) const override {
+        std::vector<const domain::Book*> books;
+        for (const domain::Book& book : storage_.books) {
+            if (book.GetPublicationYear() >= from && book.GetPublicationYear() <= to && storage_.IsVisible(book)) {
+                books.push_back(&book);
+            }
+        }
+        std::sort(books.begin(), books.end(), [this](const domain::Book* lhs, const domain::Book* rhs) {
+            using Key = std::tuple<int, std::string_view, std::string_view>;
+            return Key{lhs->GetPublicationYear(), lhs->GetTitle(), storage_.GetAuthorName(lhs->GetAuthorId())}
+                 < Key{rhs->GetPublicationYear(), rhs->GetTitle(), storage_.GetAuthorName(rhs->GetAuthorId())};
+        });
+        return MakeRows(books);
+    }
+
+    domain::BookRows GetBooksByTitlePrefix(std::string_view prefix, std::size_t limit) const override {
+        std::vector<const domain::Book*> books;
+        for (const domain::Book& book : storage_.books) {
+            if (book.GetTitle().starts_with(prefix) && storage_.IsVisible(book)) {
+                books.push_back(&book);
+            }
+        }
+        std::sort(books.begin(), books.end(), [this](const domain::Book* lhs, const domain::Book* rhs) {
+            using Key = std::tuple<std::string_view, std::string_view, int>;
+            return Key{lhs->GetTitle(), storage_.GetAuthorName(lhs->GetAuthorId()), lhs->GetPublicationYear()}
+                 < Key{rhs->GetTitle(), storage_.GetAuthorName(rhs->GetAuthorId()), rhs->GetPublicationYear()};
+        });
+        books.resize(std::min(books.size(), limit));
+        return MakeRows(books);
+    }
+
+    std::vector<domain::BookId> GetBookIdsByAuthorId(const domain::AuthorId& author_id, std::size_t limit) const override {
+        std::vector<domain::BookId> ids;
+        for (const domain::Book& book : storage_.books) {
+            if (ids.size() == limit) {
+                break;
+            }
+            if (book.GetAuthorId() == author_id) {
+                ids.push_back(book.GetId());
+            }
+        }
+        return ids;
+    }
+
+    void DeleteBooksByAuthorId(const domain::AuthorId& author_id) override {
+        std::erase_if(storage_.books, [&author_id](const domain::Book& book) {
+            return book.GetAuthorId() == author_id;
+        });
+    }
+
+    void ReleaseLocks() noexcept {
+        if (book_rows_lock_.owns_lock()) {
+            book_rows_lock_.unlock();
+        }
+    }
+
+private:
+    domain::BookRows MakeRows(const std::vector<const domain::Book*>& books) const {
+        std::vector<domain::Book> rows;
+        rows.reserve(books.size());
+        for (const domain::Book* book : books) {
+            rows.push_back(storage_.WithAuthorName(*book));
+        }
+        return domain::BookRows{std::make_unique<BookVectorSource>(std::move(rows))};
+    }
+
+    Storage& storage_;
+    std::unique_lock<std::mutex> book_rows_lock_;
+};
+
+class BookTagRepository : public domain::BookTagRepository {
+public:
+    explicit BookTagRepository(Storage& storage)
+    : storage_{storage}
+    {
+
+    }
+
+    void Save(const domain::BookId& book_id, std::string_view tag) override {
+        storage_.tags.emplace_back(book_id, std::string{tag});
+    }
+
+    void DeleteByBookId(const domain::BookId& book_id) override {
+        std::erase_if(storage_.tags, [&book_id](const auto& tag) {
+            return tag.first == book_id;
+        });
+    }
+
+    std::vector<std::string> GetTags(const domain::BookId& book_id) const override {
+        static metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kRepository, "BookTagRepository::GetTags");
+        const RepositoryCall call{storage_, stats};
+        std::vector<std::string> tags;
+        for (const auto& [id, tag] : storage_.tags) {
+            if (id == book_id) {
+                tags.push_back(tag);
+            }
+        }
+        std::sort(tags.begin(), tags.end());
+        return tags;
+    }
+
+    std::vector<domain::TagBookCount> GetTagCountsByAuthorId(const domain::AuthorId& author_id) const override {
+        std::map<std::string, std::int64_t> counts;
+        for (const auto& [id, tag] : storage_.tags) {
+            for (const domain::Book& book : storage_.books) {
+                if (book.GetId() == id && book.GetAuthorId() == author_id) {
+                    ++counts[tag];
+                }
+            }
+        }
+        std::vector<domain::TagBookCount> tags;
+        for (const auto& [tag, books] : counts) {
+            tags.push_back({tag, books});
+        }
+        return tags;
+    }
+
+private:
+    Storage& storage_;
+};
+
+// Считает статистику по хранилищу при каждом запросе; счётчики в базе с ним всегда сходятся.
+// Как и в базе, книги и теги авторов, помеченных удалёнными, не учитываются
+class StatisticsRepository : public domain::StatisticsRepository {
+public:
+    explicit StatisticsRepository(Storage& storage)
+    : storage_{storage}
+    {
+
+    }
+
+    domain::CatalogTotals GetTotals() const override {
+        const std::int64_t books = std::count_if(storage_.books.begin(), storage_.books.end(), [this](const domain::Book& book) {
+            return storage_.IsVisible(book);
+        });
+        return {static_cast<std::int64_t>(storage_.authors.size()), books, static_cast<std::int64_t>(CountTags().size())};
+    }
+
+    std::vector<domain::AuthorBookCount> GetTopAuthors(std::size_t limit) const override {
+        std::vector<domain::AuthorBookCount> authors;
+        for (const domain::Author& author : storage_.authors) {
+            const std::int64_t books = std::count_if(storage_.books.begin(), storage_.books.end(), [&author](const domain::Book& book) {
+                return book.GetAuthorId() == author.GetId();
+            });
+            if (books != 0) {
+                authors.push_back({author.GetId(), author.GetName(), books});
+            }
+        }
+        std::sort(authors.begin(), authors.end(), [](const domain::AuthorBookCount& lhs, const domain::AuthorBookCount& rhs) {
+            return std::tie(rhs.books, *lhs.author_id) < std::tie(lhs.books, *rhs.author_id);
+        });
+        if (authors.size() > limit) {
+            authors.erase(authors.begin() + static_cast<std::ptrdiff_t>(limit), authors.end());
+        }
+        return authors;
+    }
+
+    std::vector<domain::TagBookCount> GetTopTags(std::size_t limit) const override {
+        return GetTopTagsByPrefix({}, limit);
+    }
+
+    std::vector<domain::TagBookCount> GetTopTagsByPrefix(std::string_view prefix, std::size_t limit) const override {
+        std::vector<domain::TagBookCount> tags;
+        for (const auto& [tag, books] : CountTags()) {
+            if (tag.starts_with(prefix)) {
+                tags.push_back({tag, books});
+            }
+        }
+        std::sort(tags.begin(), tags.end(), [](const domain::TagBookCount& lhs, const domain::TagBookCount& rhs) {
+            return std::tie(rhs.books, lhs.tag) < std::tie(lhs.books, rhs.tag);
+        });
+        tags.resize(std::min(tags.size(), limit));
+        return tags;
+    }
+
+    std::vector<domain::YearBookCount> GetBooksPerYear() const override {
+        std::map<int, std::int64_t> counts;
+        for (const domain::Book& book : storage_.books) {
+            if (storage_.IsVisible(book)) {
+                ++counts[book.GetPublicationYear()];
+            }
+        }
+        std::vector<domain::YearBookCount> years;
+        for (const auto& [year, books] : counts) {
+            years.push_back({year, books});
+        }
+        return years;
+    }
+
+    domain::StatisticsDrift Verify() const override {
+        return {};
+    }
+
+    void Rebuild() override {
+    }
+
+private:
+    std::map<std::string, std::int64_t> CountTags() const {
+        std::map<std::string, std::int64_t> counts;
+        for (const auto& [book_id, tag] : storage_.tags) {
+            const auto book = std::find_if(storage_.books.begin(), storage_.books.end(), [&book_id](const domain::Book& b) {
+                return b.GetId() == book_id;
+            });
+            if (book != storage_.books.end() && storage_.IsVisible(*book)) {
+                ++counts[tag];
+            }
+        }
+        return counts;
+    }
+
+    Storage& storage_;
+};
+
+class UnitOfWork : public app::UnitOfWork {
+public:
+    explicit UnitOfWork(Storage& storage)
+    : storage_{storage}, authors_{storage}, books_{storage}, book_tags_{storage}, statistics_{storage}
+    {
+
+    }
+
+    void Commit() override {
+        ++storage_.commits;
+        if (storage_.instrumented) {
+            metrics::Registry::Get().CountTransaction();
+        }
+        books_.ReleaseLocks();
+    }
+
+    domain::AuthorRepository& GetAuthorRepository() override {
+        return authors_;
+    }
+
+    domain::BookRepository& GetBookRepository() override {
+        return books_;
+    }
+
+    domain::BookTagRepository& GetBookTagRepository() override {
+        return book_tags_;
+    }
+
+    domain::StatisticsRepository& GetStatisticsRepository() override {
+        return statistics_;
+    }
+
+private:
+    Storage& storage_;
+    AuthorRepository authors_;
+    BookRepository books_;
+    BookTagRepository book_tags_;
+    StatisticsRepository statistics_;
+};
+
+class UnitOfWorkFactory : public app::UnitOfWorkFactory {
+public:
+    explicit UnitOfWorkFactory(Storage& storage)
+    : storage_{storage}
+    {
+
+    }
+
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
+        return std::make_unique<UnitOfWork>(storage_);
+    }
+
+private:
+    Storage& storage_;
+};
+
+// Считает единицы работы, которые запрашивают use case'ы; replica_reads — единицы только
+// для чтения, открытые вне app::PrimaryReadScope
+class CountingUnitOfWorkFactory : public UnitOfWorkFactory {
+public:
+    using UnitOfWorkFactory::UnitOfWorkFactory;
+
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
+        ++writes;
+        return UnitOfWorkFactory::CreateUnitOfWork();
+    }
+
+    std::unique_ptr<app::UnitOfWork> CreateReadOnlyUnitOfWork() override {
+        ++reads;
+        replica_reads += !app::PrimaryReadScope::IsActive();
+        return UnitOfWorkFactory::CreateUnitOfWork();
+    }
+
+    int writes = 0;
+    int reads = 0;
+    int replica_reads = 0;
+};
+
+}  // namespace mock
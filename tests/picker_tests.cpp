@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/app/catalog_use_cases.h"
+#include "../src/app/k_way_merge.h"
+#include "../src/app/sharded_unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::vector<std::string> GetNames(const domain::AuthorRows& rows) {
+    std::vector<std::string> names;
+    for (const domain::AuthorRow row : rows) {
+        names.emplace_back(row.GetName());
+    }
+    return names;
+}
+
+std::vector<std::string> GetTitles(const domain::BookRows& rows) {
+    std::vector<std::string> titles;
+    for (const domain::BookRow row : rows) {
+        titles.emplace_back(std::string{row.GetTitle()} + " by "s + std::string{row.GetAuthorName()});
+    }
+    return titles;
+}
+
+void AddCatalog(app::UseCases& use_cases) {
+    use_cases.AddBookByAuthorName("Mark Twain"s, "Tom Sawyer"s, 1876, {});
+    use_cases.AddBookByAuthorName("Jack London"s, "White Fang"s, 1906, {});
+    const domain::AuthorId london = use_cases.GetAuthorByName("Jack London"sv)->GetId();
+    use_cases.AddBookByAuthorId(london, "The Sea-Wolf"s, 1904, {});
+    use_cases.AddBookByAuthorName("Jules Verne"s, "The Mysterious Island"s, 1875, {});
+    use_cases.AddBookByAuthorName("Herman Melville"s, "Typee"s, 1846, {});
+    use_cases.AddBookByAuthorName("Jerome K. Jerome"s, "Three Men in a Boat"s, 1889, {});
+    use_cases.AddBookByAuthorName("Jane Austen"s, "The Watsons"s, 1804, {});
+    use_cases.AddAuthor("J_ Percent%"s);
+}
+
+}  // namespace
+
+TEST_CASE("Prefix lookups return the first matches in order") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    AddCatalog(use_cases);
+
+    CHECK(GetNames(use_cases.GetAuthorsByNamePrefix("J"sv, 10))
+          == std::vector{"J_ Percent%"s, "Jack London"s, "Jane Austen"s, "Jerome K. Jerome"s, "Jules Verne"s});
+    CHECK(GetNames(use_cases.GetAuthorsByNamePrefix("Ja"sv, 1)) == std::vector{"Jack London"s});
+    CHECK(GetNames(use_cases.GetAuthorsByNamePrefix("J_"sv, 10)) == std::vector{"J_ Percent%"s});
+    CHECK(use_cases.GetAuthorsByNamePrefix("j"sv, 10).Size() == 0);
+    CHECK(use_cases.GetAuthorsByNamePrefix({}, 3).Size() == 3);
+
+    CHECK(GetTitles(use_cases.GetBooksByTitlePrefix("T"sv, 4)) == std::vector{
+        "The Mysterious Island by Jules Verne"s, "The Sea-Wolf by Jack London"s, "The Watsons by Jane Austen"s,
+        "Three Men in a Boat by Jerome K. Jerome"s
+    });
+    CHECK(GetTitles(use_cases.GetBooksByTitlePrefix("Ty"sv, 10)) == std::vector{"Typee by Herman Melville"s});
+    CHECK(use_cases.GetBooksByTitlePrefix("T"sv, 0).Size() == 0);
+
+    // Книги удалённого автора не находятся до очистки
+    CHECK(use_cases.DeleteAuthor(use_cases.GetAuthorByName("Herman Melville"sv)->GetId()));
+    CHECK(use_cases.GetBooksByTitlePrefix("Ty"sv, 10).Size() == 0);
+}
+
+TEST_CASE("Catalog snapshot and shards answer prefix lookups like a single database") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    AddCatalog(use_cases);
+    app::CatalogUseCases catalog{use_cases};
+
+    std::array<mock::Storage, 3> shard_storages;
+    std::vector<mock::UnitOfWorkFactory> shard_factories{
+        mock::UnitOfWorkFactory{shard_storages[0]}, mock::UnitOfWorkFactory{shard_storages[1]},
+        mock::UnitOfWorkFactory{shard_storages[2]}
+    };
+    app::ShardedUnitOfWorkFactory sharded_factory{{&shard_factories[0], &shard_factories[1], &shard_factories[2]}};
+    app::UseCasesImpl sharded{sharded_factory};
+    AddCatalog(sharded);
+
+    for (const std::string_view prefix : {""sv, "J"sv, "Ja"sv, "T"sv, "The "sv, "x"sv}) {
+        for (const std::size_t limit : {0u, 1u, 3u, 100u}) {
+            const std::vector<std::string> authors = GetNames(use_cases.GetAuthorsByNamePrefix(prefix, limit));
+            CHECK(GetNames(catalog.GetAuthorsByNamePrefix(prefix, limit)) == authors);
+            CHECK(GetNames(sharded.GetAuthorsByNamePrefix(prefix, limit)) == authors);
+
+            const std::vector<std::string> books = GetTitles(use_cases.GetBooksByTitlePrefix(prefix, limit));
+            CHECK(GetTitles(catalog.GetBooksByTitlePrefix(prefix, limit)) == books);
+            CHECK(GetTitles(sharded.GetBooksByTitlePrefix(prefix, limit)) == books);
+        }
+    }
+}
+
+TEST_CASE("k-way merge stops after the limit") {
+    const std::vector<std::vector<int>> parts{{1, 4, 7}, {2, 5}, {3, 6, 9}};
+    const std::vector<std::size_t> sizes{3, 2, 3};
+    const std::vector<app::RowRef> order = app::MergeSorted(sizes, [&parts](const app::RowRef& lhs, const app::RowRef& rhs) {
+        return parts[lhs.part][lhs.index] < parts[rhs.part][rhs.index];
+    }, 4);
+    std::vector<int> merged;
+    for (const app::RowRef& ref : order) {
+        merged.push_back(parts[ref.part][ref.index]);
+    }
+    CHECK(merged == std::vector{1, 2, 3, 4});
+}
+
+TEST_CASE("Pickers list only the authors and books matching the entered prefix") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    AddCatalog(use_cases);
+    for (int i = 0; i < 25; ++i) {
+        use_cases.AddAuthor("Anonymous "s + static_cast<char>('a' + i));
+    }
+
+    std::istringstream input{
+        "ShowAuthorBooks\nJa\n1\n"
+        "ShowBook\nThe S\n1\n"
+        "DeleteBook\nTy\n\n"
+        "DeleteAuthor\nAnon\n\n"
+        "EditBook\nNo such title\n"s
+    };
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    ui::View view{menu, use_cases, input, output};
+    menu.Run();
+
+    std::string expected_anonymous;
+    for (int i = 0; i < 20; ++i) {
+        expected_anonymous += std::to_string(i + 1) + " Anonymous "s + static_cast<char>('a' + i) + "\n"s;
+    }
+    CHECK(output.str() ==
+        "Select author:\n"
+        "Enter the beginning of the name or empty line to list the first authors:\n"
+        "1 Jack London\n"
+        "2 Jane Austen\n"
+        "Enter author # or empty line to cancel\n"
+        "1 The Sea-Wolf, 1904\n"
+        "2 White Fang, 1906\n"
+        "Enter the beginning of the title or empty line to list the first books:\n"
+        "1 The Sea-Wolf by Jack London, 1904\n"
+        "Enter book # or empty line to cancel\n"
+        "Title: The Sea-Wolf\n"
+        "Author: Jack London\n"
+        "Publication year: 1904\n"
+        "Enter the beginning of the title or empty line to list the first books:\n"
+        "1 Typee by Herman Melville, 1846\n"
+        "Enter book # or empty line to cancel\n"
+        "Select author:\n"
+        "Enter the beginning of the name or empty line to list the first authors:\n"s
+        + expected_anonymous +
+        "Only the first 20 matches are shown\n"
+        "Enter author # or empty line to cancel\n"
+        "Enter the beginning of the title or empty line to list the first books:\n"
+        "No books found\n"
+        "Book not found\n"s);
+    CHECK(use_cases.GetBooksByTitle("Typee"sv).size() == 1);
+}
@@ -0,0 +1,249 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/app/purge_worker.h"
+#include "../src/app/sharded_unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "../src/metrics/metrics.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Автор с count книгами, у каждой по два тега
+domain::AuthorId AddAuthorWithBooks(app::UseCases& use_cases, const std::string& name, int count) {
+    use_cases.AddAuthor(name);
+    const domain::AuthorId id = use_cases.GetAuthorByName(name)->GetId();
+    for (int i = 0; i < count; ++i) {
+        use_cases.AddBookByAuthorId(id, name + " "s + std::to_string(i), 1900 + i, std::vector{"a"s, "b"s});
+    }
+    return id;
+}
+
+std::size_t CountBooks(const mock::Storage& storage, const domain::AuthorId& author_id) {
+    return std::count_if(storage.books.begin(), storage.books.end(), [&author_id](const domain::Book& book) {
+        return book.GetAuthorId() == author_id;
+    });
+}
+
+// Хранилище, в котором удаление тегов книг одного автора всегда завершается ошибкой
+class FailingTagsFactory : public app::UnitOfWorkFactory {
+public:
+    FailingTagsFactory(mock::Storage& storage, domain::AuthorId failing_author)
+    : storage_{storage}, failing_author_{failing_author}
+    {
+
+    }
+
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
+        return std::make_unique<UnitOfWork>(storage_, failing_author_);
+    }
+
+private:
+    class UnitOfWork : public mock::UnitOfWork {
+    public:
+        UnitOfWork(mock::Storage& storage, domain::AuthorId failing_author)
+        : mock::UnitOfWork{storage}, tags_{storage, failing_author, mock::UnitOfWork::GetBookTagRepository()}
+        {
+
+        }
+
+        domain::BookTagRepository& GetBookTagRepository() override {
+            return tags_;
+        }
+
+    private:
+        class Tags : public domain::BookTagRepository {
+        public:
+            Tags(mock::Storage& storage, domain::AuthorId failing_author, domain::BookTagRepository& inner)
+            : storage_{storage}, failing_author_{failing_author}, inner_{inner}
+            {
+
+            }
+
+            void Save(const domain::BookId& book_id, std::string_view tag) override {
+                inner_.Save(book_id, tag);
+            }
+
+            void DeleteByBookId(const domain::BookId& book_id) override {
+                for (const domain::Book& book : storage_.books) {
+                    if (book.GetId() == book_id && book.GetAuthorId() == failing_author_) {
+                        throw std::runtime_error("Tags are locked"s);
+                    }
+                }
+                inner_.DeleteByBookId(book_id);
+            }
+
+            std::vector<std::string> GetTags(const domain::BookId& book_id) const override {
+                return inner_.GetTags(book_id);
+            }
+
+            std::vector<domain::TagBookCount> GetTagCountsByAuthorId(const domain::AuthorId& author_id) const override {
+                return inner_.GetTagCountsByAuthorId(author_id);
+            }
+
+        private:
+            mock::Storage& storage_;
+            domain::AuthorId failing_author_;
+            domain::BookTagRepository& inner_;
+        };
+
+        Tags tags_;
+    };
+
+    mock::Storage& storage_;
+    domain::AuthorId failing_author_;
+};
+
+}  // namespace
+
+TEST_CASE("Deleted author is hidden at once and purged in batches") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    const domain::AuthorId london = AddAuthorWithBooks(use_cases, "Jack London"s, 5);
+    AddAuthorWithBooks(use_cases, "Mark Twain"s, 1);
+
+    CHECK(use_cases.DeleteAuthor(london));
+    CHECK_FALSE(use_cases.GetAuthorById(london));
+    CHECK_FALSE(use_cases.GetAuthorByName("Jack London"sv));
+    CHECK(use_cases.GetAllAuthors().Size() == 1);
+    CHECK(use_cases.GetAllBooks().Size() == 1);
+    CHECK(use_cases.GetBooksByAuthorId(london).Empty());
+    CHECK(use_cases.GetBooksByTitle("Jack London 0"sv).empty());
+    CHECK(CountBooks(storage, london) == 5);
+
+    // Имя освобождается сразу, не дожидаясь очистки
+    use_cases.AddAuthor("Jack London"s);
+    const domain::AuthorId new_london = use_cases.GetAuthorByName("Jack London"sv)->GetId();
+    CHECK(new_london != london);
+
+    CHECK(app::PurgeNextBatch(factory, 2));
+    CHECK(CountBooks(storage, london) == 3);
+    CHECK(storage.tags.size() == 8);
+    CHECK(app::PurgeNextBatch(factory, 2));
+    CHECK(CountBooks(storage, london) == 1);
+    CHECK(storage.deleted_authors.size() == 1);
+    CHECK(app::PurgeNextBatch(factory, 2));
+    CHECK(CountBooks(storage, london) == 0);
+    CHECK(storage.deleted_authors.empty());
+    CHECK(storage.tags.size() == 2);
+    CHECK(metrics::Registry::Get().RegisterGauge("purge_backlog_authors"sv).Get() == 0);
+
+    CHECK_FALSE(app::PurgeNextBatch(factory, 2));
+    CHECK(storage.authors.size() == 2);
+    CHECK(storage.books.size() == 1);
+    CHECK(use_cases.GetAuthorById(new_london));
+}
+
+TEST_CASE("Purge worker resumes an interrupted purge") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    const domain::AuthorId london = AddAuthorWithBooks(use_cases, "Jack London"s, 4);
+    const domain::AuthorId twain = AddAuthorWithBooks(use_cases, "Mark Twain"s, 2);
+    CHECK(use_cases.DeleteAuthor(london));
+    CHECK(use_cases.DeleteAuthor(twain));
+
+    // Прежний процесс успел одну порцию; пометки остались в хранилище
+    CHECK(app::PurgeNextBatch(factory, 1));
+    metrics::Gauge& backlog = metrics::Registry::Get().RegisterGauge("purge_backlog_authors"sv);
+    CHECK(backlog.Get() == 2);
+
+    {
+        app::PurgeWorker worker{factory, {.batch_size = 1, .batch_pause = 1ms, .idle_period = 1ms}};
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (backlog.Get() != 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    CHECK(backlog.Get() == 0);
+    CHECK(storage.authors.empty());
+    CHECK(storage.deleted_authors.empty());
+    CHECK(storage.books.empty());
+    CHECK(storage.tags.empty());
+}
+
+TEST_CASE("Failing author is deferred and does not block the rest of the queue") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    const domain::AuthorId london = AddAuthorWithBooks(use_cases, "Jack London"s, 2);
+    const domain::AuthorId twain = AddAuthorWithBooks(use_cases, "Mark Twain"s, 2);
+    CHECK(use_cases.DeleteAuthor(london));
+    CHECK(use_cases.DeleteAuthor(twain));
+
+    FailingTagsFactory failing{storage, london};
+    app::PurgeBackoff backoff{1h, 2h};
+    // Первый в очереди падает и откладывается, следующий вызов берёт второго
+    CHECK_THROWS_AS(app::PurgeNextBatch(failing, 10, &backoff), std::runtime_error);
+    CHECK(CountBooks(storage, london) == 2);
+    CHECK(backoff.IsDeferred(london, app::PurgeBackoff::Clock::now()));
+    CHECK(app::PurgeNextBatch(failing, 10, &backoff));
+    CHECK(CountBooks(storage, twain) == 0);
+    CHECK(storage.deleted_authors.size() == 1);
+    // В очереди остался только отложенный автор
+    CHECK_FALSE(app::PurgeNextBatch(failing, 10, &backoff));
+
+    // После паузы автор пробуется снова, и пауза растёт до предела
+    const auto now = app::PurgeBackoff::Clock::now();
+    backoff.OnFailure(london, now);
+    CHECK(backoff.IsDeferred(london, now + 90min));
+    backoff.OnFailure(london, now);
+    CHECK(backoff.IsDeferred(london, now + 110min));
+    CHECK_FALSE(backoff.IsDeferred(london, now + 2h));
+    CHECK_FALSE(backoff.IsDeferred(twain, now));
+
+    // Когда ошибка ушла, автор дочищается; успех забывает отсрочку
+    app::PurgeBackoff retry{0ms, 0ms};
+    CHECK_THROWS_AS(app::PurgeNextBatch(failing, 10, &retry), std::runtime_error);
+    CHECK(app::PurgeNextBatch(factory, 10, &retry));
+    CHECK(storage.deleted_authors.empty());
+    CHECK(storage.books.empty());
+    CHECK_FALSE(retry.IsDeferred(london, app::PurgeBackoff::Clock::now() - 1h));
+}
+
+TEST_CASE("Purge over shards removes books from the author's shard") {
+    std::array<mock::Storage, 3> storages;
+    std::vector<mock::UnitOfWorkFactory> factories;
+    std::vector<app::UnitOfWorkFactory*> pointers;
+    factories.reserve(storages.size());
+    for (mock::Storage& storage : storages) {
+        pointers.push_back(&factories.emplace_back(storage));
+    }
+    app::ShardedUnitOfWorkFactory factory{pointers};
+    app::UseCasesImpl use_cases{factory};
+
+    std::vector<domain::AuthorId> authors;
+    for (int i = 0; i < 6; ++i) {
+        authors.push_back(AddAuthorWithBooks(use_cases, "Author "s + std::to_string(i), 3));
+    }
+    for (std::size_t i = 0; i < authors.size(); i += 2) {
+        CHECK(use_cases.DeleteAuthor(authors[i]));
+    }
+    CHECK(use_cases.GetAllBooks().Size() == 9);
+
+    int batches = 0;
+    while (app::PurgeNextBatch(factory, 2)) {
+        ++batches;
+    }
+    CHECK(batches == 6);
+
+    std::size_t books = 0;
+    for (const mock::Storage& storage : storages) {
+        CHECK(storage.deleted_authors.empty());
+        books += storage.books.size();
+        CHECK(storage.tags.size() == 2 * storage.books.size());
+    }
+    CHECK(books == 9);
+    CHECK(use_cases.GetAllAuthors().Size() == 3);
+}
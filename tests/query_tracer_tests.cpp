@@ -0,0 +1,42 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+#include "../src/metrics/metrics.h"
+#include "../src/postgres/query_tracer.h"
+
+using namespace std::literals;
+
+TEST_CASE("Slow queries are logged with the originating use case") {
+    std::ostringstream log;
+    postgres::QueryTracer tracer{postgres::QueryTracingConfig{10ms}, log};
+
+    postgres::QueryTrace fast{.statement = "BookRepository::GetAllBooks"sv, .duration = 1ms, .rows = 5};
+    tracer.Record(fast);
+    CHECK(log.str().empty());
+
+    metrics::CallStats& stats = metrics::Registry::Get().Register(metrics::kUseCase, "GetAllBooks"sv);
+    {
+        metrics::ScopedCall call{stats, true};
+        postgres::QueryTrace slow{.statement = "BookRepository::GetAllBooks"sv, .duration = 15ms, .rows = 5};
+        tracer.Record(slow);
+    }
+    CHECK(log.str() == "slow_query statement=BookRepository::GetAllBooks params=0 rows=5 duration_us=15000 "
+                       "use_case=GetAllBooks status=ok\n");
+}
+
+TEST_CASE("Query sampling rate") {
+    std::ostringstream log;
+    postgres::QueryTracer never{postgres::QueryTracingConfig{10ms, 0.0}, log};
+    postgres::QueryTracer always{postgres::QueryTracingConfig{10ms, 1.0}, log};
+    postgres::QueryTracer half{postgres::QueryTracingConfig{10ms, 0.5}, log};
+
+    int sampled = 0;
+    for (int i = 0; i < 10000; ++i) {
+        CHECK_FALSE(never.ShouldSample());
+        CHECK(always.ShouldSample());
+        sampled += half.ShouldSample() ? 1 : 0;
+    }
+    CHECK(sampled > 4000);
+    CHECK(sampled < 6000);
+}
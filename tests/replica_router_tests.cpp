@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/app/use_cases_impl.h"
+#include "../src/postgres/replica_router.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+TEST_CASE("LSN text form round-trips") {
+    CHECK(postgres::ParseLsn("0/0"sv) == 0u);
+    CHECK(postgres::ParseLsn("16/B374D848"sv) == 0x16'B374D848u);
+    CHECK(postgres::ParseLsn("16/b374d848"sv) == 0x16'B374D848u);
+    CHECK(postgres::FormatLsn(0x16'B374D848u) == "16/B374D848"s);
+    CHECK(postgres::FormatLsn(0) == "0/0"s);
+
+    CHECK_FALSE(postgres::ParseLsn(""sv));
+    CHECK_FALSE(postgres::ParseLsn("16B374D848"sv));
+    CHECK_FALSE(postgres::ParseLsn("16/"sv));
+    CHECK_FALSE(postgres::ParseLsn("16/XYZ"sv));
+    CHECK_FALSE(postgres::ParseLsn("1/123456789"sv));
+}
+
+TEST_CASE("Replica settings are parsed from environment strings") {
+    CHECK(postgres::ParseUrlList("postgres://r1/db; host=r2 dbname=db ;;"sv)
+          == std::vector{"postgres://r1/db"s, "host=r2 dbname=db"s});
+    CHECK(postgres::ParseUrlList(""sv).empty());
+
+    CHECK(postgres::ParseReplicaRouting("round-robin"sv) == postgres::ReplicaRouting::kRoundRobin);
+    CHECK(postgres::ParseReplicaRouting("least-loaded"sv) == postgres::ReplicaRouting::kLeastLoaded);
+    CHECK_THROWS_AS(postgres::ParseReplicaRouting("random"sv), std::invalid_argument);
+    CHECK_THROWS_AS(postgres::ReplicaRouter(postgres::ReplicaRouter::kMaxReplicas + 1,
+                                            postgres::ReplicaRouting::kRoundRobin),
+                    std::invalid_argument);
+}
+
+TEST_CASE("Round-robin routing ignores load") {
+    postgres::ReplicaRouter router{3, postgres::ReplicaRouting::kRoundRobin};
+    const std::array<std::size_t, 3> in_use{5, 0, 0};
+    CHECK(router.Pick(in_use) == 0);
+    CHECK(router.Pick(in_use) == 1);
+    CHECK(router.Pick(in_use) == 2);
+    CHECK(router.Pick(in_use) == 0);
+}
+
+TEST_CASE("Least-loaded routing prefers idle replicas and rotates between equals") {
+    postgres::ReplicaRouter router{3, postgres::ReplicaRouting::kLeastLoaded};
+    CHECK(router.Pick(std::array<std::size_t, 3>{4, 1, 2}) == 1);
+    CHECK(router.Pick(std::array<std::size_t, 3>{4, 1, 0}) == 2);
+
+    const std::array<std::size_t, 3> equal{1, 1, 1};
+    std::array<int, 3> picks{};
+    for (int i = 0; i < 30; ++i) {
+        ++picks[router.Pick(equal)];
+    }
+    CHECK(picks == std::array{10, 10, 10});
+}
+
+TEST_CASE("Observed log positions only move forward") {
+    postgres::ReplicaRouter router{2, postgres::ReplicaRouting::kRoundRobin};
+    CHECK(router.GetCommitLsn() == 0);
+    CHECK(router.GetReplayedLsn(0) == 0);
+
+    router.NoteCommitLsn(100);
+    router.NoteCommitLsn(50);
+    CHECK(router.GetCommitLsn() == 100);
+
+    router.NoteReplayedLsn(1, 120);
+    router.NoteReplayedLsn(1, 90);
+    CHECK(router.GetReplayedLsn(0) == 0);
+    CHECK(router.GetReplayedLsn(1) == 120);
+}
+
+TEST_CASE("Only use cases that read go to read-only units of work") {
+    mock::Storage storage;
+    mock::CountingUnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+
+    use_cases.AddAuthor("Jack London"s);
+    CHECK(factory.writes == 1);
+    CHECK(factory.reads == 0);
+
+    const auto author = use_cases.GetAuthorByName("Jack London"sv);
+    REQUIRE(author);
+    use_cases.GetAuthorById(author->GetId());
+    use_cases.GetAllAuthors();
+    use_cases.AddBookByAuthorId(author->GetId(), "White Fang"s, 1906, {});
+    const domain::BookRows books = use_cases.GetAllBooks();
+    REQUIRE(books.Size() == 1);
+    use_cases.GetBook((*books.begin()).GetId());
+    use_cases.GetBooksByTitle("White Fang"sv);
+    use_cases.GetBooksByAuthorId(author->GetId());
+    use_cases.GetBooksByYearRange(1900, 1909);
+    CHECK(factory.writes == 2);
+    CHECK(factory.reads == 8);
+
+    use_cases.EditAuthor(author->GetId(), "J. London"sv);
+    CHECK(factory.writes == 3);
+    CHECK(factory.reads == 8);
+}
@@ -0,0 +1,322 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/app/k_way_merge.h"
+#include "../src/app/shard_rebalance.h"
+#include "../src/app/sharded_unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Несколько независимых баз в памяти
+template <std::size_t N>
+struct Shards {
+    std::array<mock::Storage, N> storages;
+    std::vector<mock::UnitOfWorkFactory> factories = MakeFactories();
+
+    std::vector<app::UnitOfWorkFactory*> Pointers(std::size_t count = N) {
+        std::vector<app::UnitOfWorkFactory*> pointers;
+        for (std::size_t i = 0; i < count; ++i) {
+            pointers.push_back(&factories[i]);
+        }
+        return pointers;
+    }
+
+private:
+    std::vector<mock::UnitOfWorkFactory> MakeFactories() {
+        std::vector<mock::UnitOfWorkFactory> factories;
+        for (mock::Storage& storage : storages) {
+            factories.emplace_back(storage);
+        }
+        return factories;
+    }
+};
+
+template <std::size_t N>
+std::size_t ShardOfStorage(const Shards<N>& shards, const domain::AuthorId& id) {
+    for (std::size_t i = 0; i < N; ++i) {
+        const auto& authors = shards.storages[i].authors;
+        if (std::any_of(authors.begin(), authors.end(), [&id](const domain::Author& a) { return a.GetId() == id; })) {
+            return i;
+        }
+    }
+    return N;
+}
+
+// Шард с пулом из одного соединения: единица работы держит его до удаления.
+// Вместо вечного ожидания бросает исключение, чтобы взаимная блокировка провалила тест
+class SingleConnectionFactory : public app::UnitOfWorkFactory {
+public:
+    explicit SingleConnectionFactory(app::UnitOfWorkFactory& inner)
+    : inner_{inner}
+    {
+
+    }
+
+    std::unique_ptr<app::UnitOfWork> CreateUnitOfWork() override {
+        std::unique_lock lock{connection_, std::defer_lock};
+        if (!lock.try_lock_for(5s)) {
+            throw std::runtime_error("Shard connection wait timed out"s);
+        }
+        return std::make_unique<Connection>(std::move(lock), inner_.CreateUnitOfWork());
+    }
+
+private:
+    class Connection : public app::UnitOfWork {
+    public:
+        Connection(std::unique_lock<std::timed_mutex> lock, std::unique_ptr<app::UnitOfWork> inner)
+        : lock_{std::move(lock)}, inner_{std::move(inner)}
+        {
+
+        }
+
+        void Commit() override {
+            inner_->Commit();
+        }
+
+        domain::AuthorRepository& GetAuthorRepository() override {
+            return inner_->GetAuthorRepository();
+        }
+
+        domain::BookRepository& GetBookRepository() override {
+            return inner_->GetBookRepository();
+        }
+
+        domain::BookTagRepository& GetBookTagRepository() override {
+            return inner_->GetBookTagRepository();
+        }
+
+        domain::StatisticsRepository& GetStatisticsRepository() override {
+            return inner_->GetStatisticsRepository();
+        }
+
+    private:
+        // Соединение возвращается в пул после удаления единицы работы
+        std::unique_lock<std::timed_mutex> lock_;
+        std::unique_ptr<app::UnitOfWork> inner_;
+    };
+
+    app::UnitOfWorkFactory& inner_;
+    std::timed_mutex connection_;
+};
+
+}  // namespace
+
+TEST_CASE("Authors are spread evenly and only move to added shards") {
+    constexpr int kAuthors = 20000;
+    std::array<int, 4> per_shard{};
+    int moved = 0;
+    for (int i = 0; i < kAuthors; ++i) {
+        const domain::AuthorId id = domain::AuthorId::New();
+        const std::size_t before = app::ShardOfAuthor(id, 3);
+        const std::size_t after = app::ShardOfAuthor(id, 4);
+        CHECK(before == app::ShardOfAuthor(id, 3));
+        ++per_shard[after];
+        if (before != after) {
+            ++moved;
+            CHECK(after == 3);
+        }
+    }
+    for (const int count : per_shard) {
+        CHECK(count > kAuthors / 4 * 9 / 10);
+        CHECK(count < kAuthors / 4 * 11 / 10);
+    }
+    CHECK(moved == per_shard[3]);
+    CHECK(app::ShardOfAuthor(domain::AuthorId::New(), 1) == 0);
+}
+
+TEST_CASE("k-way merge interleaves sorted parts stably") {
+    const std::vector<std::vector<int>> parts{{1, 4, 7}, {}, {2, 4, 8, 9}, {0, 4}};
+    std::vector<std::size_t> sizes;
+    for (const auto& part : parts) {
+        sizes.push_back(part.size());
+    }
+    const std::vector<app::RowRef> order = app::MergeSorted(sizes, [&parts](const app::RowRef& lhs, const app::RowRef& rhs) {
+        return parts[lhs.part][lhs.index] < parts[rhs.part][rhs.index];
+    });
+
+    std::vector<int> merged;
+    std::vector<std::uint32_t> fours;
+    for (const app::RowRef& ref : order) {
+        merged.push_back(parts[ref.part][ref.index]);
+        if (merged.back() == 4) {
+            fours.push_back(ref.part);
+        }
+    }
+    CHECK(merged == std::vector{0, 1, 2, 4, 4, 4, 7, 8, 9});
+    CHECK(fours == std::vector<std::uint32_t>{0, 2, 3});
+}
+
+TEST_CASE("Use cases over shards keep each author on one shard and merge listings") {
+    Shards<3> shards;
+    app::ShardedUnitOfWorkFactory factory{shards.Pointers()};
+    app::UseCasesImpl use_cases{factory};
+
+    const std::vector<std::string> names{"Jack London"s, "Herman Melville"s, "Leo Tolstoy"s, "Mark Twain"s,
+                                         "Jules Verne"s, "Anton Chekhov"s};
+    for (const std::string& name : names) {
+        use_cases.AddBookByAuthorName(name, "Stories"s, 1900, std::vector{"classic"s});
+        const auto author = use_cases.GetAuthorByName(name);
+        REQUIRE(author);
+        use_cases.AddBookByAuthorId(author->GetId(), name + " collected"s, 1910, {});
+    }
+    CHECK_THROWS_AS(use_cases.AddAuthor("Mark Twain"s), std::invalid_argument);
+
+    std::size_t total_books = 0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const mock::Storage& storage = shards.storages[i];
+        total_books += storage.books.size();
+        for (const domain::Author& author : storage.authors) {
+            CHECK(app::ShardOfAuthor(author.GetId(), 3) == i);
+        }
+        for (const domain::Book& book : storage.books) {
+            CHECK(app::ShardOfAuthor(book.GetAuthorId(), 3) == i);
+        }
+        for (const auto& [book_id, tag] : storage.tags) {
+            CHECK(std::any_of(storage.books.begin(), storage.books.end(), [&](const domain::Book& b) {
+                return b.GetId() == book_id;
+            }));
+        }
+    }
+    CHECK(total_books == 12);
+
+    std::vector<std::string> listed;
+    for (const domain::AuthorRow row : use_cases.GetAllAuthors()) {
+        listed.emplace_back(row.GetName());
+    }
+    std::vector<std::string> sorted = names;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(listed == sorted);
+
+    std::vector<std::string> titles;
+    for (const domain::BookRow row : use_cases.GetAllBooks()) {
+        titles.emplace_back(row.GetTitle());
+    }
+    CHECK(titles.size() == 12);
+    CHECK(std::is_sorted(titles.begin(), titles.end()));
+
+    std::vector<int> years;
+    for (const domain::BookRow row : use_cases.GetBooksByYearRange(1900, 1905)) {
+        years.push_back(row.GetPublicationYear());
+        CHECK(row.GetTitle() == "Stories"sv);
+    }
+    CHECK(years == std::vector<int>(names.size(), 1900));
+    CHECK(use_cases.GetBooksByYearRange(1900, 1910).Size() == 12);
+    CHECK(use_cases.GetBooksByYearRange(1911, 2000).Empty());
+
+    const std::vector<domain::Book> stories = use_cases.GetBooksByTitle("Stories"sv);
+    REQUIRE(stories.size() == names.size());
+    CHECK(std::is_sorted(stories.begin(), stories.end(), [](const domain::Book& lhs, const domain::Book& rhs) {
+        return lhs.GetAuthorName() < rhs.GetAuthorName();
+    }));
+
+    const domain::Book& story = stories.front();
+    const std::optional<domain::Book> found = use_cases.GetBook(story.GetId());
+    REQUIRE(found);
+    CHECK(found->GetTags() == std::vector{"classic"s});
+    CHECK(use_cases.EditBook(story.GetId(), "Tales"sv, 1901, std::vector{"short"s}));
+    CHECK(use_cases.GetBook(story.GetId())->GetTags() == std::vector{"short"s});
+
+    CHECK(use_cases.DeleteAuthor(story.GetAuthorId()));
+    CHECK_FALSE(use_cases.GetAuthorById(story.GetAuthorId()));
+    CHECK_FALSE(use_cases.GetBook(story.GetId()));
+    CHECK(use_cases.GetAllBooks().Size() == 10);
+}
+
+TEST_CASE("Concurrent writes to different shards do not deadlock on connections") {
+    Shards<2> shards;
+    std::array<SingleConnectionFactory, 2> pools{SingleConnectionFactory{shards.factories[0]},
+                                                SingleConnectionFactory{shards.factories[1]}};
+    app::ShardedUnitOfWorkFactory factory{{&pools[0], &pools[1]}};
+    app::UseCasesImpl use_cases{factory};
+
+    // По автору на каждом шарде: правка берёт шард автора и проверяет имя на всех шардах
+    std::array<domain::AuthorId, 2> authors{};
+    std::array<bool, 2> found{};
+    for (int i = 0; !(found[0] && found[1]); ++i) {
+        const domain::AuthorId id = use_cases.AddAuthor("Author "s + std::to_string(i));
+        const std::size_t shard = app::ShardOfAuthor(id, 2);
+        if (!found[shard]) {
+            authors[shard] = id;
+            found[shard] = true;
+        }
+    }
+
+    std::array<std::thread, 2> writers;
+    std::array<int, 2> edited{};
+    for (std::size_t shard = 0; shard < 2; ++shard) {
+        writers[shard] = std::thread{[&, shard] {
+            try {
+                for (int i = 0; i < 200; ++i) {
+                    const std::string name = "Writer "s + std::to_string(shard) + " edit "s + std::to_string(i);
+                    edited[shard] += use_cases.EditAuthor(authors[shard], name) ? 1 : 0;
+                }
+            } catch (const std::runtime_error&) {
+                // Исключение из потока завершило бы процесс: провал виден по счётчику правок
+            }
+        }};
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    CHECK(edited == std::array{200, 200});
+    CHECK(use_cases.GetAuthorById(authors[1])->GetName() == "Writer 1 edit 199"s);
+}
+
+TEST_CASE("Rebalancing moves authors with their books to added shards") {
+    Shards<3> shards;
+    {
+        app::ShardedUnitOfWorkFactory factory{shards.Pointers(2)};
+        app::UseCasesImpl use_cases{factory};
+        for (int i = 0; i < 60; ++i) {
+            use_cases.AddBookByAuthorName("Author "s + std::to_string(i), "Book "s + std::to_string(i), 2000 + i,
+                                          std::vector{"a"s, "b"s});
+        }
+    }
+    CHECK(shards.storages[2].authors.empty());
+
+    const app::RebalanceStats dry = app::RebalanceShards(shards.Pointers(), true);
+    CHECK(dry.authors_checked == 60);
+    CHECK(dry.authors_moved > 0);
+    CHECK(shards.storages[2].authors.empty());
+
+    const app::RebalanceStats stats = app::RebalanceShards(shards.Pointers());
+    CHECK(stats.authors_moved == dry.authors_moved);
+    CHECK(stats.books_moved == dry.authors_moved);
+    CHECK(stats.tags_moved == 2 * dry.authors_moved);
+    CHECK(shards.storages[2].authors.size() == stats.authors_moved);
+    CHECK(shards.storages[2].books.size() == stats.books_moved);
+    CHECK(shards.storages[2].tags.size() == stats.tags_moved);
+
+    std::size_t authors = 0;
+    std::size_t books = 0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        authors += shards.storages[i].authors.size();
+        books += shards.storages[i].books.size();
+        for (const domain::Author& author : shards.storages[i].authors) {
+            CHECK(ShardOfStorage(shards, author.GetId()) == app::ShardOfAuthor(author.GetId(), 3));
+        }
+    }
+    CHECK(authors == 60);
+    CHECK(books == 60);
+    CHECK(app::RebalanceShards(shards.Pointers()).authors_moved == 0);
+
+    app::ShardedUnitOfWorkFactory factory{shards.Pointers()};
+    app::UseCasesImpl use_cases{factory};
+    for (const domain::Author& author : shards.storages[2].authors) {
+        CHECK(use_cases.GetBooksByAuthorId(author.GetId()).Size() == 1);
+    }
+}
@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../src/app/sharded_unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/statistics.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+void AddBook(app::UseCases& use_cases, std::string_view author, std::string title, int year,
+             const std::vector<std::string>& tags) {
+    if (!use_cases.GetAuthorByName(author)) {
+        use_cases.AddAuthor(std::string{author});
+    }
+    use_cases.AddBookByAuthorId(use_cases.GetAuthorByName(author)->GetId(), std::move(title), year, tags);
+}
+
+// Каталог, в котором у авторов и тегов разное число книг
+void Fill(app::UseCases& use_cases) {
+    const std::vector<std::string> classic{"classic"s};
+    const std::vector<std::string> sea{"classic"s, "sea"s};
+    AddBook(use_cases, "Jack London"sv, "White Fang"s, 1906, classic);
+    AddBook(use_cases, "Jack London"sv, "The Sea-Wolf"s, 1904, sea);
+    AddBook(use_cases, "Jack London"sv, "Martin Eden"s, 1909, {});
+    AddBook(use_cases, "Herman Melville"sv, "Moby Dick"s, 1851, sea);
+    AddBook(use_cases, "Herman Melville"sv, "Typee"s, 1846, {});
+    AddBook(use_cases, "Mark Twain"sv, "Tom Sawyer"s, 1876, classic);
+    use_cases.AddAuthor("Leo Tolstoy"s);
+}
+
+}  // namespace
+
+TEST_CASE("Statistics count books per author, tag and year") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    Fill(use_cases);
+
+    const domain::CatalogStatistics statistics = use_cases.GetStatistics(2);
+    CHECK(statistics.totals.authors == 4);
+    CHECK(statistics.totals.books == 6);
+    CHECK(statistics.totals.tags == 2);
+
+    REQUIRE(statistics.top_authors.size() == 2);
+    CHECK(statistics.top_authors[0].name == "Jack London"s);
+    CHECK(statistics.top_authors[0].books == 3);
+    CHECK(statistics.top_authors[1].name == "Herman Melville"s);
+    CHECK(statistics.top_authors[1].books == 2);
+
+    REQUIRE(statistics.top_tags.size() == 2);
+    CHECK(statistics.top_tags[0].tag == "classic"s);
+    CHECK(statistics.top_tags[0].books == 4);
+    CHECK(statistics.top_tags[1].tag == "sea"s);
+    CHECK(statistics.top_tags[1].books == 2);
+
+    REQUIRE(statistics.books_per_year.size() == 6);
+    CHECK(statistics.books_per_year.front().publication_year == 1846);
+    CHECK(statistics.books_per_year.back().publication_year == 1909);
+
+    // Удалённый автор и его книги пропадают из всех счётчиков сразу, не дожидаясь очистки
+    CHECK(use_cases.DeleteAuthor(use_cases.GetAuthorByName("Jack London"sv)->GetId()));
+    CHECK(storage.books.size() == 6);
+    const domain::CatalogStatistics after_delete = use_cases.GetStatistics(10);
+    CHECK(after_delete.totals.authors == 3);
+    CHECK(after_delete.totals.books == 3);
+    CHECK(after_delete.totals.tags == 2);
+    REQUIRE(after_delete.top_authors.size() == 2);
+    CHECK(after_delete.top_authors[0].name == "Herman Melville"s);
+    REQUIRE(after_delete.top_tags.size() == 2);
+    CHECK(after_delete.top_tags[0].books == 2);
+    CHECK(after_delete.top_tags[1].books == 1);
+    CHECK(after_delete.books_per_year.size() == 3);
+    CHECK(after_delete.books_per_year.back().publication_year == 1876);
+}
+
+TEST_CASE("Statistics over shards match a single database") {
+    mock::Storage single_storage;
+    mock::UnitOfWorkFactory single_factory{single_storage};
+    app::UseCasesImpl single{single_factory};
+    Fill(single);
+
+    std::array<mock::Storage, 3> storages;
+    std::vector<mock::UnitOfWorkFactory> factories;
+    std::vector<app::UnitOfWorkFactory*> pointers;
+    factories.reserve(storages.size());
+    for (mock::Storage& storage : storages) {
+        pointers.push_back(&factories.emplace_back(storage));
+    }
+    app::ShardedUnitOfWorkFactory sharded_factory{pointers};
+    app::UseCasesImpl sharded{sharded_factory};
+    Fill(sharded);
+
+    for (const std::size_t top : {1u, 2u, 10u}) {
+        const domain::CatalogStatistics expected = single.GetStatistics(top);
+        const domain::CatalogStatistics actual = sharded.GetStatistics(top);
+        CHECK(actual.totals.authors == expected.totals.authors);
+        CHECK(actual.totals.books == expected.totals.books);
+        CHECK(actual.totals.tags == expected.totals.tags);
+
+        REQUIRE(actual.top_authors.size() == expected.top_authors.size());
+        for (std::size_t i = 0; i < actual.top_authors.size(); ++i) {
+            CHECK(actual.top_authors[i].books == expected.top_authors[i].books);
+        }
+        CHECK(actual.top_authors.front().name == expected.top_authors.front().name);
+
+        REQUIRE(actual.top_tags.size() == expected.top_tags.size());
+        for (std::size_t i = 0; i < actual.top_tags.size(); ++i) {
+            CHECK(actual.top_tags[i].tag == expected.top_tags[i].tag);
+            CHECK(actual.top_tags[i].books == expected.top_tags[i].books);
+        }
+
+        REQUIRE(actual.books_per_year.size() == expected.books_per_year.size());
+        for (std::size_t i = 0; i < actual.books_per_year.size(); ++i) {
+            CHECK(actual.books_per_year[i].publication_year == expected.books_per_year[i].publication_year);
+            CHECK(actual.books_per_year[i].books == expected.books_per_year[i].books);
+        }
+    }
+    CHECK(sharded_factory.CreateUnitOfWork()->GetStatisticsRepository().Verify().Empty());
+}
+
+TEST_CASE("ShowStatistics prints totals, tops and years") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases{factory};
+    AddBook(use_cases, "Jack London"sv, "White Fang"s, 1906, {"adventure"s, "classic"s});
+    AddBook(use_cases, "Jack London"sv, "Martin Eden"s, 1909, {"classic"s});
+    AddBook(use_cases, "Mark Twain"sv, "Tom Sawyer"s, 1876, {"classic"s});
+
+    std::istringstream input{"ShowStatistics 1\nShowStatistics zero\n"s};
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    ui::View view{menu, use_cases, input, output};
+    menu.Run();
+    CHECK(output.str() ==
+        "Authors: 2, books: 3, tags: 2\n"
+        "Top authors:\n"
+        "1 Jack London, 2 books\n"
+        "Top tags:\n"
+        "1 classic, 3 books\n"
+        "Books by year:\n"
+        "1876: 1\n"
+        "1906: 1\n"
+        "1909: 1\n"
+        "Invalid number of top entries\n"s);
+}
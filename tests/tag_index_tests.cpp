@@ -0,0 +1,289 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../src/app/search_use_cases.h"
+#include "../src/app/tag_index.h"
+#include "../src/app/unit_of_work.h"
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/search.h"
+#include "../src/domain/statistics.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::vector<std::string> Names(const std::vector<domain::TagBookCount>& tags) {
+    std::vector<std::string> names;
+    for (const domain::TagBookCount& tag : tags) {
+        names.push_back(tag.tag);
+    }
+    return names;
+}
+
+// Ожидаемый ответ Complete, посчитанный перебором
+std::vector<domain::TagBookCount> CompleteByScan(
+    const std::map<std::string, std::int64_t>& counts, std::string_view prefix, std::size_t limit
+) {
+    std::vector<domain::TagBookCount> tags;
+    for (const auto& [tag, books] : counts) {
+        if (books > 0 && tag.starts_with(prefix)) {
+            tags.push_back({tag, books});
+        }
+    }
+    std::sort(tags.begin(), tags.end(), [](const domain::TagBookCount& lhs, const domain::TagBookCount& rhs) {
+        return std::tie(rhs.books, lhs.tag) < std::tie(lhs.books, rhs.tag);
+    });
+    tags.resize(std::min(tags.size(), limit));
+    return tags;
+}
+
+}  // namespace
+
+TEST_CASE("Tag index completes a prefix with the most used tags") {
+    app::TagIndex index{{{"sea"s, 2}, {"science"s, 5}, {"classic"s, 4}, {"satire"s, 5}, {"sci-fi"s, 1}, {"scary"s, 0}}};
+    CHECK(Names(index.Complete("s"sv, 3)) == std::vector{"satire"s, "science"s, "sea"s});
+    CHECK(Names(index.Complete("sc"sv, 10)) == std::vector{"science"s, "sci-fi"s});
+    CHECK(Names(index.Complete({}, 2)) == std::vector{"satire"s, "science"s});
+    CHECK(index.Complete("x"sv, 10).empty());
+    CHECK(index.Complete("s"sv, 0).empty());
+
+    index.Add("sci-fi"sv, 5);
+    index.Add("satire"sv, -5);
+    index.Add("scary"sv, 1);
+    const std::vector<domain::TagBookCount> tags = index.Complete("s"sv, 10);
+    CHECK(Names(tags) == std::vector{"sci-fi"s, "science"s, "sea"s, "scary"s});
+    CHECK(tags.front().books == 6);
+}
+
+TEST_CASE("Tag index matches a full scan after random updates") {
+    std::mt19937 random{42};
+    const auto random_tag = [&random] {
+        std::string tag(std::uniform_int_distribution<std::size_t>{1, 4}(random), 'a');
+        for (char& c : tag) {
+            c = static_cast<char>('a' + std::uniform_int_distribution<int>{0, 3}(random));
+        }
+        return tag;
+    };
+
+    std::map<std::string, std::int64_t> counts;
+    for (int i = 0; i < 50; ++i) {
+        counts[random_tag()] += 1;
+    }
+    std::vector<domain::TagBookCount> initial;
+    for (const auto& [tag, books] : counts) {
+        initial.push_back({tag, books});
+    }
+    app::TagIndex index{initial};
+    for (int i = 0; i < 5000; ++i) {
+        const std::string tag = random_tag();
+        // Чаще добавления, чтобы теги не кончались; вычитается только имеющееся
+        const std::int64_t delta = counts[tag] > 0 && random() % 3 == 0 ? -1 : 1 + static_cast<std::int64_t>(random() % 3);
+        counts[tag] += delta;
+        index.Add(tag, delta);
+
+        if (i % 50 == 0) {
+            const std::string prefix = random() % 4 == 0 ? ""s : random_tag().substr(0, 2);
+            const std::size_t limit = 1 + random() % 8;
+            const std::vector<domain::TagBookCount> expected = CompleteByScan(counts, prefix, limit);
+            const std::vector<domain::TagBookCount> actual = index.Complete(prefix, limit);
+            REQUIRE(Names(actual) == Names(expected));
+            for (std::size_t j = 0; j < actual.size(); ++j) {
+                CHECK(actual[j].books == expected[j].books);
+            }
+        }
+    }
+    CHECK(index.MemoryUsage() > 0);
+}
+
+TEST_CASE("New tags are merged into the index without losing counts") {
+    app::TagIndex index{{{"m"s, 1}}};
+    for (std::size_t i = 0; i <= app::TagIndex::kMaxPending + 1; ++i) {
+        index.Add("tag "s + std::to_string(i), static_cast<std::int64_t>(i % 7 + 1));
+    }
+    index.Add("m"sv, 10);
+    CHECK(index.Size() == app::TagIndex::kMaxPending + 3);
+    CHECK(Names(index.Complete({}, 1)) == std::vector{"m"s});
+    const std::vector<domain::TagBookCount> tags = index.Complete("tag 1"sv, 3);
+    CHECK(Names(tags) == std::vector{"tag 1000"s, "tag 1007"s, "tag 1014"s});
+    CHECK(tags.front().books == 7);
+}
+
+TEST_CASE("Search use cases keep tag completion in sync with book writes") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    use_cases_impl.AddAuthor("Jack London"s);
+    const domain::AuthorId london = use_cases_impl.GetAuthorByName("Jack London"sv)->GetId();
+    use_cases_impl.AddBookByAuthorId(london, "White Fang"s, 1906, std::vector{"adventure"s, "classic"s});
+
+    app::SearchUseCases search{use_cases_impl};
+    search.AddBookByAuthorId(london, "The Sea-Wolf"s, 1904, std::vector{"adventure"s, "sea"s});
+    search.AddBookByAuthorName("Mark Twain"s, "Tom Sawyer"s, 1876, std::vector{"adventure"s, "classic"s});
+    CHECK(Names(search.CompleteTag("a"sv, 10)) == std::vector{"adventure"s});
+    CHECK(Names(search.CompleteTag({}, 10)) == std::vector{"adventure"s, "classic"s, "sea"s});
+
+    const domain::BookId sea_wolf = search.GetBooksByTitle("The Sea-Wolf"sv).front().GetId();
+    CHECK(search.EditBook(sea_wolf, "The Sea-Wolf"sv, 1904, std::vector{"sailing"s}));
+    CHECK(Names(search.CompleteTag("s"sv, 10)) == std::vector{"sailing"s});
+    const domain::BookId white_fang = search.GetBooksByTitle("White Fang"sv).front().GetId();
+    CHECK(search.DeleteBook(white_fang));
+    CHECK_FALSE(search.DeleteBook(white_fang));
+
+    // Индекс совпадает с подсчётом по хранилищу
+    for (const std::string_view prefix : {""sv, "a"sv, "c"sv, "s"sv}) {
+        const std::vector<domain::TagBookCount> expected = use_cases_impl.CompleteTag(prefix, 10);
+        const std::vector<domain::TagBookCount> actual = search.CompleteTag(prefix, 10);
+        REQUIRE(Names(actual) == Names(expected));
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            CHECK(actual[i].books == expected[i].books);
+        }
+    }
+}
+
+TEST_CASE("Deleting an author removes the tags of all their books from completion") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    app::SearchUseCases search{use_cases_impl};
+    search.AddBookByAuthorName("Jack London"s, "White Fang"s, 1906, std::vector{"adventure"s, "wolves"s});
+    const domain::AuthorId london = search.GetAuthorByName("Jack London"sv)->GetId();
+    search.AddBookByAuthorId(london, "The Sea-Wolf"s, 1904, std::vector{"adventure"s, "sea"s});
+    search.AddBookByAuthorName("Mark Twain"s, "Tom Sawyer"s, 1876, std::vector{"adventure"s});
+    CHECK(search.CompleteTag("a"sv, 10).front().books == 3);
+
+    // Книги остаются в хранилище до очистки, но их теги уже не подсказываются
+    CHECK(search.DeleteAuthor(london));
+    CHECK(storage.books.size() == 3);
+    const std::vector<domain::TagBookCount> tags = search.CompleteTag({}, 10);
+    CHECK(Names(tags) == std::vector{"adventure"s});
+    CHECK(tags.front().books == 1);
+    for (const std::string_view prefix : {""sv, "a"sv, "s"sv, "w"sv}) {
+        const std::vector<domain::TagBookCount> expected = use_cases_impl.CompleteTag(prefix, 10);
+        const std::vector<domain::TagBookCount> actual = search.CompleteTag(prefix, 10);
+        REQUIRE(Names(actual) == Names(expected));
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            CHECK(actual[i].books == expected[i].books);
+        }
+    }
+    CHECK_FALSE(search.DeleteAuthor(london));
+    CHECK(search.CompleteTag({}, 10).front().books == 1);
+}
+
+TEST_CASE("Search use cases take the old tags of a written book from the write itself") {
+    mock::Storage storage;
+    mock::CountingUnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    app::SearchUseCases search{use_cases_impl};
+    const domain::AuthorId london = search.AddAuthor("Jack London"s);
+    const domain::BookId white_fang = search.AddBookByAuthorId(london, "White Fang"s, 1906, std::vector{"wolves"s});
+    const domain::BookId sea_wolf = search.AddBookByAuthorId(london, "The Sea-Wolf"s, 1904, std::vector{"sea"s});
+    for (int year = 1910; year < 1920; ++year) {
+        search.AddBookByAuthorId(london, "Volume "s + std::to_string(year), year, std::vector{"letters"s});
+    }
+    factory.reads = 0;
+    factory.replica_reads = 0;
+
+    // Прежние теги читаются в транзакции самой записи, отдельного чтения нет
+    const std::optional<domain::Book> edited = search.EditBook(white_fang, "White Fang"sv, 1906, std::vector{"adventure"s});
+    REQUIRE(edited);
+    CHECK(edited->GetTags() == std::vector{"wolves"s});
+    const std::optional<domain::Book> deleted = search.DeleteBook(sea_wolf);
+    REQUIRE(deleted);
+    CHECK(deleted->GetTags() == std::vector{"sea"s});
+    CHECK(factory.reads == 0);
+    // Книги и теги автора читаются двумя запросами, сколько бы книг у него ни было
+    CHECK(search.DeleteAuthor(london));
+    CHECK(factory.reads == 2);
+    CHECK(factory.replica_reads == 0);
+    CHECK(search.CompleteTag({}, 10).empty());
+}
+
+TEST_CASE("Concurrent edits of one book reach the search indexes in commit order") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    app::SearchUseCases search{use_cases_impl};
+    const domain::AuthorId london = search.AddAuthor("Jack London"s);
+    const domain::BookId white_fang = search.AddBookByAuthorId(london, "White Fang"s, 1906, std::vector{"wolves"s});
+
+    constexpr int kWriters = 4;
+    constexpr int kEdits = 200;
+    std::array<std::vector<std::string>, kWriters> old_tags;
+    std::array<std::thread, kWriters> writers;
+    for (int writer = 0; writer < kWriters; ++writer) {
+        writers[writer] = std::thread{[&, writer] {
+            for (int edit = 0; edit < kEdits; ++edit) {
+                const std::string name = "edition "s + std::to_string(writer) + "-"s + std::to_string(edit);
+                const std::optional<domain::Book> book = search.EditBook(white_fang, name, 1906, std::vector{name, "classic"s});
+                if (!book) {
+                    continue;
+                }
+                for (const std::string& tag : book->GetTags()) {
+                    if (tag != "classic"sv) {
+                        old_tags[writer].push_back(tag);
+                    }
+                }
+            }
+        }};
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+
+    // Каждая запись видит теги ровно одной предыдущей: ни одна правка не прочитана дважды
+    // и ни одна не потеряна
+    std::vector<std::string> seen;
+    for (const std::vector<std::string>& tags : old_tags) {
+        seen.insert(seen.end(), tags.begin(), tags.end());
+    }
+    std::sort(seen.begin(), seen.end());
+    CHECK(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+    CHECK(seen.size() == kWriters * kEdits);
+
+    const std::vector<domain::TagBookCount> expected = use_cases_impl.CompleteTag({}, 10);
+    const std::vector<domain::TagBookCount> actual = search.CompleteTag({}, 10);
+    REQUIRE(Names(actual) == Names(expected));
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        CHECK(actual[i].books == expected[i].books);
+    }
+    // В индексе названий — название последней зафиксированной правки
+    const std::string title = use_cases_impl.GetBook(white_fang)->GetTitle();
+    const std::vector<domain::FuzzyMatch> matches = search.FuzzyFind(title, 1);
+    REQUIRE(matches.size() == 1);
+    CHECK(matches.front().text == title);
+}
+
+TEST_CASE("CompleteTag prints suggestions") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    app::SearchUseCases use_cases{use_cases_impl};
+    use_cases.AddBookByAuthorName("Jack London"s, "White Fang"s, 1906, std::vector{"science fiction"s, "sea"s});
+    use_cases.AddBookByAuthorName("Mark Twain"s, "Tom Sawyer"s, 1876, std::vector{"sea"s});
+
+    std::istringstream input{"CompleteTag s\nCompleteTag   science   f\nCompleteTag x\n"s};
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    ui::View view{menu, use_cases, input, output};
+    menu.Run();
+    CHECK(output.str() ==
+        "1 sea, 2 books\n"
+        "2 science fiction, 1 books\n"
+        "1 science fiction, 1 books\n"
+        "No tags found\n"s);
+}
@@ -1,16 +1,152 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/string_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
 #include "../src/util/tagged_uuid.h"
 
+using namespace std::literals;
 using util::TaggedUUID;
 
 namespace {
 struct TestTag {};
 using TestUUID = TaggedUUID<TestTag>;
+
+struct TimeOrderedTag {
+    static constexpr util::UUIDVersion kUUIDVersion = util::UUIDVersion::kTimeOrdered;
+};
+using TimeOrderedUUID = TaggedUUID<TimeOrderedTag>;
 }  // namespace
 
 TEST_CASE("UUID-String conversion") {
     auto uuid = TestUUID::New();
     auto s = uuid.ToString();
     CHECK(TestUUID::FromString(s) == uuid);
-}
\ No newline at end of file
+}
+
+TEST_CASE("UUID version and variant bits") {
+    const TestUUID random = TestUUID::New();
+    CHECK((*random).version() == boost::uuids::uuid::version_random_number_based);
+    CHECK((*random).variant() == boost::uuids::uuid::variant_rfc_4122);
+    CHECK(random != TestUUID::New());
+
+    const TimeOrderedUUID ordered = TimeOrderedUUID::New();
+    CHECK(((*ordered).data[6] >> 4) == 7);
+    CHECK((*ordered).variant() == boost::uuids::uuid::variant_rfc_4122);
+}
+
+TEST_CASE("Time-ordered UUIDs increase and carry the current time") {
+    const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    TimeOrderedUUID prev = TimeOrderedUUID::New();
+    std::uint64_t ms = 0;
+    for (int i = 0; i < 6; ++i) {
+        ms = (ms << 8) | (*prev).data[i];
+    }
+    CHECK(ms >= static_cast<std::uint64_t>(now_ms));
+    CHECK(ms < static_cast<std::uint64_t>(now_ms) + 1000);
+
+    // Больше 4096 идентификаторов подряд: проверяется и переполнение счётчика
+    for (int i = 0; i < 10'000; ++i) {
+        const TimeOrderedUUID next = TimeOrderedUUID::New();
+        REQUIRE(*prev < *next);
+        prev = next;
+    }
+}
+
+TEST_CASE("UUID generation cost", "[!benchmark]") {
+    BENCHMARK("boost::uuids::random_generator per call") {
+        return boost::uuids::random_generator()();
+    };
+    BENCHMARK("thread-local UUIDv4") {
+        return TestUUID::New();
+    };
+    BENCHMARK("thread-local UUIDv7") {
+        return TimeOrderedUUID::New();
+    };
+}
+
+TEST_CASE("UUID hex formatting matches boost and round-trips") {
+    for (int i = 0; i < 1000; ++i) {
+        const boost::uuids::uuid uuid = boost::uuids::random_generator()();
+        const std::string expected = boost::uuids::to_string(uuid);
+
+        char simd[util::kUUIDStringSize];
+        char scalar[util::kUUIDStringSize];
+        CHECK(util::detail::FormatUUID(uuid.data, simd) == simd + util::kUUIDStringSize);
+        util::detail::FormatUUIDScalar(uuid.data, scalar);
+        REQUIRE(std::string_view{simd, util::kUUIDStringSize} == expected);
+        REQUIRE(std::string_view{scalar, util::kUUIDStringSize} == expected);
+
+        boost::uuids::uuid parsed;
+        REQUIRE(util::detail::ParseUUID(expected, parsed.data));
+        REQUIRE(parsed == uuid);
+        REQUIRE(util::detail::ParseUUIDScalar(expected, parsed.data));
+        REQUIRE(parsed == uuid);
+    }
+
+    const std::string upper = "0A1B2C3D-4E5F-6A7B-8C9D-AEBFCFDFEFFF"s;
+    CHECK(TestUUID::FromString(upper).ToString() == "0a1b2c3d-4e5f-6a7b-8c9d-aebfcfdfefff"s);
+}
+
+TEST_CASE("UUID parsing is strict") {
+    const std::string valid = "0a1b2c3d-4e5f-6a7b-8c9d-aebfcfdfefff"s;
+    std::vector<std::string> invalid{
+        ""s,
+        valid.substr(1),
+        valid + "0"s,
+        "{"s + valid + "}"s,
+        "0a1b2c3d4e5f6a7b8c9daebfcfdfefff"s,
+        "0a1b2c3d-4e5f-6a7b-8c9d_aebfcfdfefff"s,
+    };
+    // Каждый недопустимый символ на каждой позиции с цифрой
+    for (std::size_t pos : {0u, 7u, 9u, 20u, 35u}) {
+        for (char c : "gG/:@`\x80 -"sv) {
+            std::string str = valid;
+            str[pos] = c;
+            invalid.push_back(str);
+        }
+    }
+    for (const std::string& str : invalid) {
+        std::uint8_t out[16];
+        CHECK_FALSE(util::detail::ParseUUID(str, out));
+        CHECK_FALSE(util::detail::ParseUUIDScalar(str, out));
+        CHECK_FALSE(TestUUID::TryFromString(str).has_value());
+    }
+    CHECK_THROWS_AS(TestUUID::FromString("not a uuid"sv), std::invalid_argument);
+}
+
+TEST_CASE("UUID hex conversion cost", "[!benchmark]") {
+    const TestUUID id = TestUUID::New();
+    const std::string text = id.ToString();
+    char buffer[util::kUUIDStringSize];
+
+    BENCHMARK("boost::uuids::to_string") {
+        return boost::uuids::to_string(*id);
+    };
+    BENCHMARK("TaggedUUID::ToString") {
+        return id.ToString();
+    };
+    BENCHMARK("FormatUUID into buffer") {
+        return util::detail::FormatUUID((*id).data, buffer);
+    };
+    BENCHMARK("FormatUUIDScalar into buffer") {
+        return util::detail::FormatUUIDScalar((*id).data, buffer);
+    };
+    BENCHMARK("boost::uuids::string_generator") {
+        return boost::uuids::string_generator{}(text);
+    };
+    BENCHMARK("TaggedUUID::FromString") {
+        return TestUUID::FromString(text);
+    };
+    BENCHMARK("ParseUUIDScalar") {
+        boost::uuids::uuid uuid;
+        util::detail::ParseUUIDScalar(text, uuid.data);
+        return uuid;
+    };
+}
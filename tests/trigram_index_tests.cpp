@@ -0,0 +1,257 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../src/app/search_use_cases.h"
+#include "../src/app/trigram_index.h"
+#include "../src/app/use_cases_impl.h"
+#include "../src/domain/search.h"
+#include "../src/menu/menu.h"
+#include "../src/ui/view.h"
+#include "mock_repositories.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Scored = std::pair<double, std::string>;
+
+std::vector<Scored> Scores(const std::vector<domain::FuzzyMatch>& matches) {
+    std::vector<Scored> scores;
+    for (const domain::FuzzyMatch& match : matches) {
+        scores.emplace_back(match.similarity, match.text);
+    }
+    return scores;
+}
+
+// Ожидаемый ответ Find, посчитанный перебором
+std::vector<Scored> FindByScan(
+    const std::map<std::size_t, std::string>& titles, std::string_view text, std::size_t limit, double threshold
+) {
+    std::vector<Scored> scores;
+    if (text.size() > app::TrigramIndex::kMaxTextSize || app::TrigramIndex::Trigrams(text).empty()) {
+        return scores;
+    }
+    for (const auto& [id, title] : titles) {
+        const double similarity = app::TrigramIndex::Similarity(text, title);
+        if (similarity >= threshold) {
+            scores.emplace_back(similarity, title);
+        }
+    }
+    std::sort(scores.begin(), scores.end(), [](const Scored& lhs, const Scored& rhs) {
+        return std::tie(rhs.first, lhs.second) < std::tie(lhs.first, rhs.second);
+    });
+    scores.resize(std::min(scores.size(), limit));
+    return scores;
+}
+
+}  // namespace
+
+TEST_CASE("Trigrams follow pg_trgm word padding") {
+    const auto trigram = [](std::string_view chars) {
+        return static_cast<std::uint32_t>(
+            (static_cast<unsigned char>(chars[0]) << 16) | (static_cast<unsigned char>(chars[1]) << 8)
+            | static_cast<unsigned char>(chars[2])
+        );
+    };
+    std::vector<std::uint32_t> expected{trigram("  c"sv), trigram(" ca"sv), trigram("cat"sv), trigram("at "sv)};
+    std::sort(expected.begin(), expected.end());
+    CHECK(app::TrigramIndex::Trigrams("Cat"sv) == expected);
+    CHECK(app::TrigramIndex::Trigrams(" cat, CAT!"sv) == expected);
+    CHECK(app::TrigramIndex::Trigrams(" -- "sv).empty());
+
+    CHECK(app::TrigramIndex::Similarity("White Fang"sv, "white fang"sv) == 1.0);
+    CHECK(app::TrigramIndex::Similarity("cat"sv, "cap"sv) == 2.0 / 6.0);
+    CHECK(app::TrigramIndex::Similarity("cat"sv, "dog"sv) == 0.0);
+    CHECK(app::TrigramIndex::Similarity(""sv, ""sv) == 0.0);
+}
+
+TEST_CASE("Trigram index finds misspelled titles and names") {
+    app::TrigramIndex index;
+    const domain::BookId white_fang = domain::BookId::New();
+    const domain::BookId sea_wolf = domain::BookId::New();
+    const domain::AuthorId london = domain::AuthorId::New();
+    const domain::AuthorId twain = domain::AuthorId::New();
+    index.Set(white_fang, "White Fang"sv, london, 1906);
+    index.Set(sea_wolf, "The Sea-Wolf"sv, london, 1904);
+    index.Set(domain::BookId::New(), "Tom Sawyer"sv, twain, 1876);
+    index.Set(london, "Jack London"sv);
+    index.Set(twain, "Mark Twain"sv);
+    CHECK(index.Size() == 5);
+
+    std::vector<domain::FuzzyMatch> matches = index.Find("White Fnag"sv, 10);
+    REQUIRE(matches.size() == 1);
+    CHECK(std::get<domain::BookId>(matches.front().id) == white_fang);
+    CHECK(matches.front().text == "White Fang"s);
+    CHECK(matches.front().similarity == app::TrigramIndex::Similarity("White Fnag"sv, "White Fang"sv));
+    CHECK(matches.front().author_name == "Jack London"s);
+    CHECK(matches.front().publication_year == 1906);
+
+    matches = index.Find("jack londn"sv, 10);
+    REQUIRE_FALSE(matches.empty());
+    CHECK(std::get<domain::AuthorId>(matches.front().id) == london);
+
+    CHECK(index.Find("sea wolf"sv, 10).front().text == "The Sea-Wolf"s);
+    CHECK(index.Find("White Fnag"sv, 0).empty());
+    CHECK(index.Find("?!"sv, 10).empty());
+    CHECK(index.Find("qqq"sv, 10).empty());
+
+    // Записи разных видов с одним идентификатором не путаются
+    CHECK(index.Contains(white_fang));
+    CHECK_FALSE(index.Contains(domain::AuthorId{*white_fang}));
+    index.Erase(domain::AuthorId{*white_fang});
+    CHECK(index.Contains(white_fang));
+
+    index.Set(sea_wolf, "The Call of the Wild"sv, london, 1903);
+    CHECK(index.Find("sea wolf"sv, 10).empty());
+    CHECK(index.Find("call of the wilt"sv, 1).front().text == "The Call of the Wild"s);
+    index.Erase(white_fang);
+    CHECK_FALSE(index.Contains(white_fang));
+    CHECK(index.Find("White Fang"sv, 10).empty());
+    CHECK(index.Size() == 4);
+
+    // Книга показывает текущее имя автора, а год меняется без переиндексации названия
+    index.Set(london, "John Griffith London"sv);
+    index.Set(sea_wolf, "The Call of the Wild"sv, london, 1904);
+    matches = index.Find("call of the wild"sv, 1);
+    REQUIRE(matches.size() == 1);
+    CHECK(matches.front().author_name == "John Griffith London"s);
+    CHECK(matches.front().publication_year == 1904);
+    CHECK(index.Size() == 4);
+
+    CHECK_THROWS_AS(
+        index.Set(white_fang, std::string(app::TrigramIndex::kMaxTextSize + 1, 'a'), london, 1906), std::length_error
+    );
+    // Запрос длиннее kMaxTextSize тоже не принимается, даже если похож на запись
+    index.Set(white_fang, "aaaa"sv, london, 1906);
+    CHECK(index.Find(std::string(app::TrigramIndex::kMaxTextSize, 'a'), 10).size() == 1);
+    CHECK(index.Find(std::string(app::TrigramIndex::kMaxTextSize + 1, 'a'), 10).empty());
+}
+
+TEST_CASE("Trigram index matches a full scan after random updates") {
+    std::mt19937 random{42};
+    const auto random_text = [&random] {
+        std::string text;
+        const int words = std::uniform_int_distribution<int>{1, 3}(random);
+        for (int i = 0; i < words; ++i) {
+            std::string word(std::uniform_int_distribution<std::size_t>{1, 6}(random), 'a');
+            for (char& c : word) {
+                c = static_cast<char>('a' + std::uniform_int_distribution<int>{0, 5}(random));
+            }
+            text += (i == 0 ? ""s : " "s) + word;
+        }
+        return text;
+    };
+
+    app::TrigramIndex index;
+    const domain::AuthorId author = domain::AuthorId::New();
+    // Тексты по номеру идентификатора в ids
+    std::map<std::size_t, std::string> titles;
+    std::vector<domain::BookId> ids;
+    // Удалений больше kMinCompaction, так что индекс уплотняется по ходу теста
+    for (std::size_t i = 0; i < 3 * app::TrigramIndex::kMinCompaction; ++i) {
+        if (titles.size() > 500 && random() % 2 == 0) {
+            const std::size_t number = random() % ids.size();
+            index.Erase(ids[number]);
+            titles.erase(number);
+        } else if (!ids.empty() && random() % 4 == 0) {
+            const std::size_t number = random() % ids.size();
+            const std::string text = random_text();
+            index.Set(ids[number], text, author, 2000);
+            titles[number] = text;
+        } else {
+            ids.push_back(domain::BookId::New());
+            const std::string text = random_text();
+            index.Set(ids.back(), text, author, 2000);
+            titles[ids.size() - 1] = text;
+        }
+
+        if (i % 20 == 0) {
+            const std::string text = random_text();
+            const std::size_t limit = 1 + random() % 10;
+            // Низкий порог берёт кандидатов из большинства списков, высокий — из немногих коротких
+            for (const double threshold : {0.1, app::TrigramIndex::kDefaultThreshold, 0.6}) {
+                REQUIRE(Scores(index.Find(text, limit, threshold)) == FindByScan(titles, text, limit, threshold));
+            }
+        }
+    }
+    CHECK(index.Size() == titles.size());
+    index.ShrinkToFit();
+    CHECK(index.MemoryUsage() > 0);
+}
+
+TEST_CASE("Search use cases keep fuzzy search in sync with writes") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    use_cases_impl.AddBookByAuthorName("Jack London"s, "White Fang"s, 1906, {});
+
+    app::SearchUseCases search{use_cases_impl};
+    search.AddBookByAuthorName("Mark Twain"s, "Tom Sawyer"s, 1876, {});
+    const domain::AuthorId london = search.GetAuthorByName("Jack London"sv)->GetId();
+    search.AddBookByAuthorId(london, "The Sea-Wolf"s, 1904, {});
+    search.AddAuthor("Jules Verne"s);
+    CHECK(search.FuzzyFind("Tom Sawyr"sv, 1).front().text == "Tom Sawyer"s);
+    CHECK(search.FuzzyFind("Jules Vern"sv, 1).front().text == "Jules Verne"s);
+
+    const domain::AuthorId verne = search.GetAuthorByName("Jules Verne"sv)->GetId();
+    CHECK(search.EditAuthor(verne, "Herman Melville"sv));
+    CHECK(search.FuzzyFind("Jules Vern"sv, 10).empty());
+    const domain::BookId sea_wolf = search.GetBooksByTitle("The Sea-Wolf"sv).front().GetId();
+    CHECK(search.EditBook(sea_wolf, "The Call of the Wild"sv, 1903, {}));
+    CHECK(search.FuzzyFind("Sea Wolf"sv, 10).empty());
+    const domain::BookId sawyer = search.GetBooksByTitle("Tom Sawyer"sv).front().GetId();
+    CHECK(search.DeleteBook(sawyer));
+    CHECK(search.FuzzyFind("Tom Sawyer"sv, 10).empty());
+
+    // Книги удалённого автора уходят из индекса вместе с ним
+    CHECK(search.DeleteAuthor(london));
+    CHECK(search.FuzzyFind("White Fang"sv, 10).empty());
+    CHECK(search.FuzzyFind("The Call of the Wild"sv, 10).empty());
+
+    // Индекс совпадает с перебором хранилища
+    search.AddBookByAuthorName("Jane Austen"s, "Emma"s, 1815, {});
+    search.AddBookByAuthorId(verne, "Moby Dick"s, 1851, {});
+    const domain::BookId emma = search.GetBooksByTitle("Emma"sv).front().GetId();
+    CHECK(search.EditBook(emma, "Emma"sv, 1816, {}));
+    for (const std::string_view text : {"Herman Melvil"sv, "Emma"sv, "Austen Jane"sv, "Wild"sv, "Fang"sv, "Moby Dik"sv}) {
+        const std::vector<domain::FuzzyMatch> expected = use_cases_impl.FuzzyFind(text, 10);
+        const std::vector<domain::FuzzyMatch> actual = search.FuzzyFind(text, 10);
+        REQUIRE(Scores(actual) == Scores(expected));
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            CHECK(actual[i].id == expected[i].id);
+            CHECK(actual[i].author_name == expected[i].author_name);
+            CHECK(actual[i].publication_year == expected[i].publication_year);
+        }
+    }
+}
+
+TEST_CASE("FuzzyFind prints authors and books") {
+    mock::Storage storage;
+    mock::UnitOfWorkFactory factory{storage};
+    app::UseCasesImpl use_cases_impl{factory};
+    app::SearchUseCases use_cases{use_cases_impl};
+    use_cases.AddBookByAuthorName("Jack London"s, "White Fang"s, 1906, {});
+    use_cases.AddBookByAuthorName("Jack Londonson"s, "Jack London's Letters"s, 1965, {});
+
+    std::istringstream input{"FuzzyFind Whte Fang\nFuzzyFind jack londn\nFuzzyFind xyz\n"s};
+    std::ostringstream output;
+    menu::Menu menu{input, output};
+    ui::View view{menu, use_cases, input, output};
+    menu.Run();
+    CHECK(output.str() ==
+        "1 White Fang by Jack London, 1906\n"
+        "1 Jack London (author)\n"
+        "2 Jack Londonson (author)\n"
+        "3 Jack London's Letters by Jack Londonson, 1965\n"
+        "Nothing found\n"s);
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <string_view>
+
+#include "../src/postgres/write_batch.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::string Escape(std::string_view value) {
+    std::string escaped;
+    for (const char c : value) {
+        escaped += c;
+        if (c == '\'') {
+            escaped += '\'';
+        }
+    }
+    return escaped;
+}
+
+const domain::AuthorId kLondon = domain::AuthorId::FromString("00000000-0000-0000-0000-00000000000a"sv);
+const domain::AuthorId kMelville = domain::AuthorId::FromString("00000000-0000-0000-0000-00000000000b"sv);
+const domain::BookId kWhiteFang = domain::BookId::FromString("00000000-0000-0000-0000-000000000001"sv);
+const domain::BookId kMobyDick = domain::BookId::FromString("00000000-0000-0000-0000-000000000002"sv);
+
+}  // namespace
+
+TEST_CASE("AddBookByAuthorName is flushed as one statement per table") {
+    postgres::WriteBatch batch;
+    batch.SaveAuthor(domain::Author{kLondon, "Jack London"s});
+    batch.SaveBook(domain::Book{kWhiteFang, kLondon, "White Fang"s, 1906});
+    batch.SaveTag(kWhiteFang, "novel"sv);
+    batch.SaveTag(kWhiteFang, "adventure"sv);
+    CHECK(batch.Size() == 4);
+
+    CHECK(batch.BuildStatement(Escape) ==
+        "INSERT INTO authors (id, name) VALUES ('00000000-0000-0000-0000-00000000000a', 'Jack London')"
+        " ON CONFLICT (id) DO UPDATE SET name = EXCLUDED.name;\n"
+        "DELETE FROM books USING (VALUES ('00000000-0000-0000-0000-000000000001'::uuid, 1906)) AS v(id, publication_year)"
+        " WHERE books.id = v.id AND books.publication_year <> v.publication_year;\n"
+        "INSERT INTO books (id, author_id, title, publication_year) VALUES ('00000000-0000-0000-0000-000000000001',"
+        " '00000000-0000-0000-0000-00000000000a', 'White Fang', 1906) ON CONFLICT (id, publication_year) DO UPDATE SET"
+        " author_id = EXCLUDED.author_id, title = EXCLUDED.title;\n"
+        "INSERT INTO book_tags (book_id, tag) VALUES ('00000000-0000-0000-0000-000000000001', 'adventure'),"
+        " ('00000000-0000-0000-0000-000000000001', 'novel');\n"s);
+
+    batch.Clear();
+    CHECK(batch.Empty());
+    CHECK(batch.BuildStatement(Escape).empty());
+}
+
+TEST_CASE("EditBook deletes old tags before inserting new ones") {
+    postgres::WriteBatch batch;
+    batch.EditBook(kWhiteFang, "Moby 'Dick'"sv, 1851);
+    batch.DeleteTagsByBookId(kWhiteFang);
+    batch.SaveTag(kWhiteFang, "sea"sv);
+
+    const std::string sql = batch.BuildStatement(Escape);
+    CHECK(sql ==
+        "DELETE FROM book_tags WHERE book_id IN ('00000000-0000-0000-0000-000000000001');\n"
+        "UPDATE books SET title = v.title, publication_year = v.publication_year FROM (VALUES"
+        " ('00000000-0000-0000-0000-000000000001'::uuid, 'Moby ''Dick''', 1851)) AS v(id, title, publication_year)"
+        " WHERE books.id = v.id;\n"
+        "INSERT INTO book_tags (book_id, tag) VALUES ('00000000-0000-0000-0000-000000000001', 'sea');\n"s);
+}
+
+TEST_CASE("Repeated changes of one entity are coalesced") {
+    postgres::WriteBatch batch;
+
+    // Правка ещё не записанного автора меняет строку вставки
+    batch.SaveAuthor(domain::Author{kMelville, "H. Melville"s});
+    batch.EditAuthor(kMelville, "Herman Melville"sv);
+    batch.EditAuthor(kLondon, "Jack London"sv);
+    CHECK(batch.Size() == 2);
+    const std::string authors = batch.BuildStatement(Escape);
+    CHECK(authors.find("'Herman Melville'") != std::string::npos);
+    CHECK(authors.find("'H. Melville'") == std::string::npos);
+    // Переименование существующего автора отправляется раньше вставки нового
+    CHECK(authors.find("UPDATE authors") < authors.find("INSERT INTO authors"));
+    batch.Clear();
+
+    // Удаление отменяет ожидающие вставки книги и её тегов
+    batch.SaveBook(domain::Book{kMobyDick, kMelville, "Moby Dick"s, 1851});
+    batch.SaveTag(kMobyDick, "sea"sv);
+    batch.DeleteTagsByBookId(kMobyDick);
+    batch.DeleteBook(kMobyDick);
+    const std::string deleted = batch.BuildStatement(Escape);
+    CHECK(deleted ==
+        "DELETE FROM book_tags WHERE book_id IN ('00000000-0000-0000-0000-000000000002');\n"
+        "DELETE FROM books WHERE id IN ('00000000-0000-0000-0000-000000000002');\n"s);
+    batch.Clear();
+
+    // DeleteAuthor: теги, книги и автор удаляются в порядке внешних ключей
+    batch.SaveBook(domain::Book{kWhiteFang, kLondon, "White Fang"s, 1906});
+    batch.DeleteTagsByBookId(kWhiteFang);
+    batch.DeleteBooksByAuthorId(kLondon);
+    batch.DeleteAuthor(kLondon);
+    const std::string author_deleted = batch.BuildStatement(Escape);
+    CHECK(author_deleted.find("INSERT") == std::string::npos);
+    CHECK(author_deleted.find("DELETE FROM book_tags") < author_deleted.find("DELETE FROM books WHERE author_id"));
+    CHECK(author_deleted.find("DELETE FROM books WHERE author_id") < author_deleted.find("DELETE FROM authors"));
+    batch.Clear();
+
+    // Пометка об удалении идёт после вставки того же автора
+    batch.MarkAuthorDeleted(kLondon);
+    batch.SaveAuthor(domain::Author{kLondon, "Jack London"s});
+    batch.MarkAuthorDeleted(kLondon);
+    const std::string tombstoned = batch.BuildStatement(Escape);
+    CHECK(tombstoned.find("INSERT INTO authors") < tombstoned.find("UPDATE authors SET deleted_at"));
+    CHECK(tombstoned.substr(tombstoned.find("UPDATE authors SET deleted_at")) ==
+        "UPDATE authors SET deleted_at = now() WHERE deleted_at IS NULL AND id IN"
+        " ('00000000-0000-0000-0000-00000000000a');\n"s);
+}
+
+TEST_CASE("Deleting an author's books drops the pending tags of their unsaved books") {
+    postgres::WriteBatch batch;
+    batch.SaveBook(domain::Book{kWhiteFang, kLondon, "White Fang"s, 1906});
+    batch.SaveTag(kWhiteFang, "wolves"sv);
+    batch.SaveBook(domain::Book{kMobyDick, kMelville, "Moby Dick"s, 1851});
+    batch.SaveTag(kMobyDick, "sea"sv);
+
+    // Теги книги Лондона не переживают её вставку, теги книги Мелвилла остаются
+    batch.DeleteBooksByAuthorId(kLondon);
+    CHECK(batch.Size() == 3);
+    const std::string sql = batch.BuildStatement(Escape);
+    CHECK(sql.find("'wolves'") == std::string::npos);
+    CHECK(sql.find("'00000000-0000-0000-0000-000000000001'") == std::string::npos);
+    CHECK(sql.find(
+        "INSERT INTO book_tags (book_id, tag) VALUES ('00000000-0000-0000-0000-000000000002', 'sea');\n"sv
+    ) != std::string::npos);
+    CHECK(sql.find("DELETE FROM books WHERE author_id IN ('00000000-0000-0000-0000-00000000000a');\n"sv) == 0);
+}
+
+TEST_CASE("Saving a book with another year replaces its row in the old partition") {
+    postgres::WriteBatch batch;
+    batch.SaveBook(domain::Book{kWhiteFang, kLondon, "White Fang"s, 1906});
+    batch.SaveBook(domain::Book{kWhiteFang, kLondon, "White Fang"s, 1907});
+    CHECK(batch.Size() == 1);
+
+    const std::string sql = batch.BuildStatement(Escape);
+    CHECK(sql.find("1906") == std::string::npos);
+    // Строка с прежним годом удаляется до вставки: ON CONFLICT (id, publication_year) её не заменит
+    const std::size_t stale = sql.find(
+        "DELETE FROM books USING (VALUES ('00000000-0000-0000-0000-000000000001'::uuid, 1907))"sv
+    );
+    REQUIRE(stale != std::string::npos);
+    CHECK(stale < sql.find("INSERT INTO books"));
+    CHECK(sql.find("books.publication_year <> v.publication_year") != std::string::npos);
+}